@@ -16,8 +16,7 @@ struct Quad
 
 const short WIDTH = 800;
 const short HEIGHT = 600;
-auto lookAtMatrix = re::lookAt(re::Vec3d(0.0f, 0.0f, 6.0f), re::Vec3d(0.0f, 0.0f, 0.0f), re::Vec3d(0.0f, 1.0f, 0.0f));
-auto perspectiveMatrix = re::perspective(45.0f, static_cast<float>(WIDTH) / HEIGHT, 0.3f, 100.0f);
+re::Camera camera;
 
 std::vector<re::Vec3d> vertices;
 std::vector<re::Vec3d> normals;
@@ -169,7 +168,7 @@ void render(float angle)
 
 	glMatrixMode(GL_MODELVIEW);
 	glLoadIdentity();
-	glLoadMatrixf(static_cast<float*>(perspectiveMatrix * lookAtMatrix));
+	glLoadMatrixf(static_cast<const float*>(camera.getViewProjectionMatrix()));
 	
 	re::Matrix4 rotation;
 	rotation.setRotation(re::toRadians(angle), re::toRadians(angle), 0);
@@ -202,6 +201,10 @@ void main()
 	setUpOpenGl();
 	createTorus(16, 30);
 
+	// Matrices are computed once and reused by every frame, as the camera doesn't move.
+	camera.lookAt(re::Vec3d(0.0f, 0.0f, 6.0f), re::Vec3d(0.0f, 0.0f, 0.0f), re::Vec3d(0.0f, 1.0f, 0.0f));
+	camera.setPerspective(45.0f, static_cast<float>(WIDTH) / HEIGHT, 0.3f, 100.0f);
+
 	SDL_Event windowEvent;
 	float angle = 0;
 
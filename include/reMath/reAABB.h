@@ -0,0 +1,124 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reAABB.h
+// Project:     reMath
+// Description: Definition of AABB (axis-aligned bounding box) class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __RE_MATH_AABB__
+#define __RE_MATH_AABB__
+
+#include "reVec3d.h"
+#include <cstddef>
+
+namespace re
+{
+	class Matrix4;
+
+	/**
+	 * @brief Axis-aligned bounding box.
+	 */
+	class AABB
+	{
+	public:
+		/**
+		 * @brief Default constructor. Creates an empty box, which any expand() call replaces.
+		 */
+		AABB();
+
+		/**
+		 * @brief Constructs a box from its corners.
+		 *
+		 * @param minValue Minimum corner
+		 * @param maxValue Maximum corner
+		 */
+		AABB(const Vec3d& minValue, const Vec3d& maxValue);
+
+		/**
+		 * @brief Destructor.
+		 */
+		virtual ~AABB() = default;
+
+		/**
+		 * @brief Creates a box enclosing the points.
+		 *
+		 * @param points Points array
+		 * @param count Number of points
+		 * @return Bounding box
+		 */
+		static AABB fromPoints(const Vec3d* points, size_t count);
+
+		/**
+		 * @brief Checks if the box is empty (has min greater than max on any axis).
+		 */
+		bool isEmpty() const;
+
+		/**
+		 * @brief Grows the box to enclose the point.
+		 */
+		void expand(const Vec3d& point);
+
+		/**
+		 * @brief Grows the box to enclose another box.
+		 */
+		void expand(const AABB& box);
+
+		/**
+		 * @brief Returns the box center.
+		 */
+		Vec3d getCenter() const;
+
+		/**
+		 * @brief Returns the box half sizes.
+		 */
+		Vec3d getExtents() const;
+
+		/**
+		 * @brief Returns the box surface area, the cost metric of bounding volume hierarchies.
+		 */
+		float getSurfaceArea() const;
+
+		/**
+		 * @brief Checks if a point is inside the box.
+		 *
+		 * @param point Point to test
+		 * @return True if the point is inside or on the boundary, False otherwise
+		 */
+		bool contains(const Vec3d& point) const;
+
+		/**
+		 * @brief Checks if two boxes overlap. Touching boxes overlap.
+		 *
+		 * @param box Second box
+		 * @return True if the boxes overlap, False otherwise
+		 */
+		bool overlaps(const AABB& box) const;
+
+		/**
+		 * @brief Ray slab test.
+		 *
+		 * @param origin Ray origin
+		 * @param inverseDirection Reciprocal of the ray direction components
+		 * @param maxDistance Maximum ray parameter
+		 * @param distance Output ray parameter of the entry point (0 if the origin is inside)
+		 * @return True if the ray hits the box within [0, maxDistance], False otherwise
+		 */
+		bool intersectsRay(const Vec3d& origin, const Vec3d& inverseDirection, float maxDistance, float& distance) const;
+
+		/**
+		 * @brief Replaces the box with the bounds of the transformed box.
+		 *
+		 * @param matrix Transformation matrix
+		 */
+		void transform(const Matrix4& matrix);
+
+	public:
+		Vec3d min;
+		Vec3d max;
+	};
+}
+
+#endif // __RE_MATH_AABB__
@@ -0,0 +1,185 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reBatch.h
+// Project:     reMath
+// Description: Definition of batch math kernels operating on arrays
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __RE_MATH_BATCH__
+#define __RE_MATH_BATCH__
+
+#include <cstddef>
+
+namespace re
+{
+	class Vec3d;
+	class Matrix3;
+	class Matrix4;
+	class Quaternion;
+	class FrameArena;
+
+	/**
+	 * @brief Transforms an array of points by the matrix in place (same as Vec3d *= Matrix4).
+	 * Large arrays are split between the threads of the current executor.
+	 *
+	 * @param matrix Transformation matrix
+	 * @param points Points array
+	 * @param count Number of points
+	 */
+	void transformN(const Matrix4& matrix, Vec3d* points, size_t count);
+
+	/**
+	 * @brief Transforms an array of points by the matrix.
+	 *
+	 * @param matrix Transformation matrix
+	 * @param input Source points array
+	 * @param output Destination points array (may be the same as input)
+	 * @param count Number of points
+	 */
+	void transformN(const Matrix4& matrix, const Vec3d* input, Vec3d* output, size_t count);
+
+	/**
+	 * @brief Transforms an array of points by the matrix into a new array allocated from the arena.
+	 *
+	 * @param matrix Transformation matrix
+	 * @param input Source points array
+	 * @param count Number of points
+	 * @param arena Arena to allocate the result from
+	 * @return Transformed points array, valid until the arena is reset
+	 */
+	Vec3d* transformN(const Matrix4& matrix, const Vec3d* input, size_t count, FrameArena& arena);
+
+	/**
+	 * @brief Normalizes an array of vectors in place. Zero vectors stay zero.
+	 *
+	 * @param vectors Vectors array
+	 * @param count Number of vectors
+	 */
+	void normalizeN(Vec3d* vectors, size_t count);
+
+	/**
+	 * @brief Normalizes an array of vectors in place using the fast reciprocal square root,
+	 * four vectors per SSE instruction. Max length error is 5e-7. Zero vectors stay zero.
+	 *
+	 * @param vectors Vectors array
+	 * @param count Number of vectors
+	 */
+	void normalizeFastN(Vec3d* vectors, size_t count);
+
+	/**
+	 * @brief Normalizes an array of quaternions in place.
+	 *
+	 * @param quaternions Quaternions array
+	 * @param count Number of quaternions
+	 */
+	void normalizeN(Quaternion* quaternions, size_t count);
+
+	/**
+	 * @brief Normalizes an array of quaternions in place using the fast reciprocal square root,
+	 * four quaternions per SSE instruction. Max length error is 5e-7.
+	 *
+	 * @param quaternions Quaternions array
+	 * @param count Number of quaternions
+	 */
+	void normalizeFastN(Quaternion* quaternions, size_t count);
+
+	/**
+	 * @brief Performs spherical linear interpolation of two quaternion arrays (e.g. two poses).
+	 *
+	 * @param from Source quaternions
+	 * @param to Target quaternions
+	 * @param scale Interpolation factor
+	 * @param output Result quaternions (may be the same as from or to)
+	 * @param count Number of quaternions
+	 */
+	void slerpN(const Quaternion* from, const Quaternion* to, float scale, Quaternion* output, size_t count);
+
+	/**
+	 * @brief Converts an array of rotation matrices to quaternions (same as Quaternion::fromMatrix()).
+	 * Shepperd's case selection is done with SSE masks, four matrices per instruction.
+	 *
+	 * @param matrices Orthonormal rotation matrices
+	 * @param output Result quaternions
+	 * @param count Number of matrices
+	 */
+	void toQuaternionN(const Matrix3* matrices, Quaternion* output, size_t count);
+
+	/**
+	 * @brief Converts the rotation parts of an array of matrices (e.g. a bone palette) to
+	 * quaternions, the matrices must not be scaled.
+	 *
+	 * @param matrices Rigid transformation matrices
+	 * @param output Result quaternions
+	 * @param count Number of matrices
+	 */
+	void toQuaternionN(const Matrix4* matrices, Quaternion* output, size_t count);
+
+	/**
+	 * @brief Rotates an array of vectors by the quaternion in place (same as Quaternion::rotate()),
+	 * four vectors per SSE instruction.
+	 *
+	 * @param rotation Normalized rotation quaternion
+	 * @param vectors Vectors array
+	 * @param count Number of vectors
+	 */
+	void rotateN(const Quaternion& rotation, Vec3d* vectors, size_t count);
+
+	/**
+	 * @brief Rotates every vector by its own quaternion in place, four vectors per SSE instruction.
+	 *
+	 * @param rotations Normalized rotation quaternions
+	 * @param vectors Vectors array
+	 * @param count Number of vectors
+	 */
+	void rotateN(const Quaternion* rotations, Vec3d* vectors, size_t count);
+
+	/**
+	 * @brief Calculates shortest arc rotations between two arrays of directions (same as
+	 * Quaternion::fromTo()), four rotations per SSE instruction.
+	 *
+	 * @param from Source directions
+	 * @param to Target directions
+	 * @param output Result quaternions
+	 * @param count Number of directions
+	 */
+	void fromToN(const Vec3d* from, const Vec3d* to, Quaternion* output, size_t count);
+
+	/**
+	 * @brief Builds quaternions from arrays of axes and angles (same as Quaternion::fromAxisAngle()).
+	 *
+	 * @param axes Normalized rotation axes
+	 * @param angles Rotation angles (in radians)
+	 * @param output Result quaternions
+	 * @param count Number of rotations
+	 */
+	void fromAxisAngleN(const Vec3d* axes, const float* angles, Quaternion* output, size_t count);
+
+	/**
+	 * @brief Calculates area-weighted smooth vertex normals of a triangle mesh.
+	 * Scratch memory is taken from the thread-local arena and returned before exit.
+	 *
+	 * @param vertices Vertex positions
+	 * @param vertexCount Number of vertices
+	 * @param indices Triangle vertex indices, three per triangle
+	 * @param triangleCount Number of triangles
+	 * @param normals Output normals, one per vertex
+	 */
+	void computeNormals(const Vec3d* vertices, size_t vertexCount, const unsigned int* indices, size_t triangleCount, Vec3d* normals);
+
+	/**
+	 * @brief Calculates area-weighted smooth vertex normals of a triangle mesh.
+	 *
+	 * @param vertices Vertex positions
+	 * @param vertexCount Number of vertices
+	 * @param indices Triangle vertex indices, three per triangle
+	 * @param triangleCount Number of triangles
+	 * @param normals Output normals, one per vertex
+	 * @param scratch Arena for the temporary face normals
+	 */
+	void computeNormals(const Vec3d* vertices, size_t vertexCount, const unsigned int* indices, size_t triangleCount, Vec3d* normals, FrameArena& scratch);
+}
+
+#endif // __RE_MATH_BATCH__
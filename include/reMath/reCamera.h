@@ -0,0 +1,209 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reCamera.h
+// Project:     reMath
+// Description: Definition of Camera class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __RE_MATH_CAMERA__
+#define __RE_MATH_CAMERA__
+
+#include "reVec3d.h"
+#include "reMatrix4.h"
+
+namespace re
+{
+	/**
+	 * @brief Camera Class.
+	 * Holds the view and projection parameters and lazily caches the matrices and frustum planes
+	 * derived from them. Setters only invalidate what depends on the changed parameters, so
+	 * querying an unchanged camera costs nothing.
+	 * Lazy getters are not thread-safe; call update() before sharing a camera between threads.
+	 */
+	class Camera
+	{
+	public:
+		/**
+		 * @brief Depth range the projection maps to.
+		 */
+		enum DepthMode
+		{
+			// OpenGL convention, near plane maps to -1 and far plane to 1.
+			DEPTH_STANDARD,
+
+			// Reversed [0, 1] depth (glClipControl or D3D), near plane maps to 1 and far plane to 0.
+			// Spreads float depth precision evenly over the distance.
+			DEPTH_REVERSED
+		};
+
+		/**
+		 * @brief Frustum plane indices.
+		 */
+		enum FrustumPlane
+		{
+			PLANE_LEFT,
+			PLANE_RIGHT,
+			PLANE_BOTTOM,
+			PLANE_TOP,
+			PLANE_NEAR,
+			PLANE_FAR,
+			PLANE_COUNT
+		};
+
+		/**
+		 * @brief Default constructor. Camera is located at the origin looking along -Z
+		 * with 45 degrees perspective projection.
+		 */
+		Camera();
+
+		/**
+		 * @brief Destructor.
+		 */
+		virtual ~Camera() = default;
+
+		/**
+		 * @brief Sets all the view parameters at once.
+		 *
+		 * @param eye Eye position
+		 * @param target View center position
+		 * @param up Up direction vector
+		 */
+		void lookAt(const Vec3d& eye, const Vec3d& target, const Vec3d& up);
+
+		/**
+		 * @brief Sets eye position.
+		 */
+		void setEye(const Vec3d& eye);
+
+		/**
+		 * @brief Sets view center position.
+		 */
+		void setTarget(const Vec3d& target);
+
+		/**
+		 * @brief Sets up direction vector.
+		 */
+		void setUp(const Vec3d& up);
+
+		/**
+		 * @brief Sets all the perspective projection parameters at once.
+		 *
+		 * @param fovy Field of view angle, in degrees, in the y direction
+		 * @param aspect Aspect ratio is the ratio of x (width) to y (height)
+		 * @param zNear Distance from the viewer to the near clipping plane (always positive)
+		 * @param zFar Distance from the viewer to the far clipping plane (0 - infinite far plane)
+		 */
+		void setPerspective(float fovy, float aspect, float zNear, float zFar);
+
+		/**
+		 * @brief Sets field of view angle, in degrees, in the y direction.
+		 */
+		void setFov(float fovy);
+
+		/**
+		 * @brief Sets aspect ratio of x (width) to y (height).
+		 */
+		void setAspect(float aspect);
+
+		/**
+		 * @brief Sets near and far clipping plane distances (zFar = 0 - infinite far plane).
+		 */
+		void setClipPlanes(float zNear, float zFar);
+
+		/**
+		 * @brief Sets projection depth range mode.
+		 */
+		void setDepthMode(DepthMode mode);
+
+		// View and projection parameters.
+		const Vec3d& getEye() const;
+		const Vec3d& getTarget() const;
+		const Vec3d& getUp() const;
+		float getFov() const;
+		float getAspect() const;
+		float getNear() const;
+		float getFar() const;
+		DepthMode getDepthMode() const;
+
+		/**
+		 * @brief Returns the view matrix (same as re::lookAt()).
+		 */
+		const Matrix4& getViewMatrix() const;
+
+		/**
+		 * @brief Returns the projection matrix (same as re::perspective() for finite standard depth).
+		 */
+		const Matrix4& getProjectionMatrix() const;
+
+		/**
+		 * @brief Returns the combined projection * view matrix.
+		 */
+		const Matrix4& getViewProjectionMatrix() const;
+
+		/**
+		 * @brief Returns the camera-to-world matrix.
+		 */
+		const Matrix4& getInverseViewMatrix() const;
+
+		/**
+		 * @brief Returns the clip-to-view space matrix.
+		 */
+		const Matrix4& getInverseProjectionMatrix() const;
+
+		/**
+		 * @brief Returns the clip-to-world space matrix.
+		 */
+		const Matrix4& getInverseViewProjectionMatrix() const;
+
+		/**
+		 * @brief Returns a world space frustum plane as normalized (a, b, c, d) coefficients.
+		 * Points inside the frustum satisfy a * x + b * y + c * z + d >= 0.
+		 *
+		 * @param plane Plane index
+		 * @return Pointer to four plane coefficients
+		 */
+		const float* getFrustumPlane(FrustumPlane plane) const;
+
+		/**
+		 * @brief Checks if a sphere intersects the view frustum.
+		 *
+		 * @param center Sphere center
+		 * @param radius Sphere radius
+		 * @return True if the sphere is at least partially inside the frustum, False otherwise
+		 */
+		bool isSphereVisible(const Vec3d& center, float radius) const;
+
+		/**
+		 * @brief Recomputes everything which was invalidated, so that the following queries are
+		 * read-only and may be done from several threads.
+		 */
+		void update() const;
+
+	private:
+		void invalidate(unsigned int flags);
+
+	private:
+		Vec3d eye_;
+		Vec3d target_;
+		Vec3d up_;
+		float fovy_;
+		float aspect_;
+		float near_;
+		float far_;
+		DepthMode depthMode_;
+
+		mutable unsigned int dirty_;
+		mutable Matrix4 view_;
+		mutable Matrix4 projection_;
+		mutable Matrix4 viewProjection_;
+		mutable Matrix4 inverseView_;
+		mutable Matrix4 inverseProjection_;
+		mutable Matrix4 inverseViewProjection_;
+		mutable float planes_[PLANE_COUNT][4];
+	};
+}
+
+#endif // __RE_MATH_CAMERA__
@@ -0,0 +1,219 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reConvex.h
+// Project:     reMath
+// Description: Definition of convex shapes and GJK/EPA collision queries
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __RE_MATH_CONVEX__
+#define __RE_MATH_CONVEX__
+
+#include "reVec3d.h"
+#include "reOBB.h"
+#include <cstddef>
+
+namespace re
+{
+	/**
+	 * @brief Convex shape described by its support function.
+	 * Rounded shapes are split into a core shape and a radius: the queries run on the cores and
+	 * add the radii afterwards, which is exact and much faster than iterating on curved surfaces.
+	 */
+	class ConvexShape
+	{
+	public:
+		/**
+		 * @brief Destructor.
+		 */
+		virtual ~ConvexShape() = default;
+
+		/**
+		 * @brief Returns the point of the core shape furthest along the direction.
+		 *
+		 * @param direction Search direction (not necessarily normalized)
+		 * @return Support point
+		 */
+		virtual Vec3d supportCore(const Vec3d& direction) const = 0;
+
+		/**
+		 * @brief Returns the radius added around the core shape.
+		 */
+		virtual float getRadius() const;
+
+		/**
+		 * @brief Returns the point of the full (rounded) shape furthest along the direction.
+		 *
+		 * @param direction Search direction (not necessarily normalized)
+		 * @return Support point
+		 */
+		Vec3d support(const Vec3d& direction) const;
+	};
+
+	/**
+	 * @brief Sphere, a point core with a radius.
+	 */
+	class ConvexSphere : public ConvexShape
+	{
+	public:
+		ConvexSphere(const Vec3d& centerValue, float radiusValue);
+
+		Vec3d supportCore(const Vec3d& direction) const override;
+		float getRadius() const override;
+
+	public:
+		Vec3d center;
+		float radius;
+	};
+
+	/**
+	 * @brief Oriented box.
+	 */
+	class ConvexBox : public ConvexShape
+	{
+	public:
+		explicit ConvexBox(const OBB& boxValue);
+
+		Vec3d supportCore(const Vec3d& direction) const override;
+
+	public:
+		OBB box;
+	};
+
+	/**
+	 * @brief Capsule, a segment core with a radius.
+	 */
+	class ConvexCapsule : public ConvexShape
+	{
+	public:
+		ConvexCapsule(const Vec3d& startValue, const Vec3d& endValue, float radiusValue);
+
+		Vec3d supportCore(const Vec3d& direction) const override;
+		float getRadius() const override;
+
+	public:
+		Vec3d start;
+		Vec3d end;
+		float radius;
+	};
+
+	/**
+	 * @brief Convex hull of a point array. Points are not copied and must outlive the shape.
+	 */
+	class ConvexHull : public ConvexShape
+	{
+	public:
+		ConvexHull(const Vec3d* pointsValue, size_t countValue);
+
+		Vec3d supportCore(const Vec3d& direction) const override;
+
+	public:
+		const Vec3d* points;
+		size_t count;
+	};
+
+	/**
+	 * @brief GJK simplex, up to four Minkowski difference vertices.
+	 * Pass the simplex of the previous frame to the queries to warm-start them: vertices are
+	 * re-evaluated along their stored search directions, so a pair which barely moved converges
+	 * in one or two iterations.
+	 */
+	struct Simplex
+	{
+		struct Vertex
+		{
+			Vec3d point;
+			Vec3d pointA;
+			Vec3d pointB;
+			Vec3d direction;
+		};
+
+		Vertex vertices[4];
+		float weights[4];
+		int count = 0;
+	};
+
+	/**
+	 * @brief Result of the distance query.
+	 */
+	struct DistanceResult
+	{
+		// Shapes touch or intersect.
+		bool intersecting;
+
+		// Distance between the shapes, 0 if intersecting.
+		float distance;
+
+		// Closest points on the shapes (only valid if not intersecting).
+		Vec3d pointA;
+		Vec3d pointB;
+
+		// Number of GJK iterations done.
+		int iterations;
+	};
+
+	/**
+	 * @brief Result of the penetration query.
+	 */
+	struct PenetrationResult
+	{
+		// Shapes intersect.
+		bool intersecting;
+
+		// Penetration depth, moving the second shape by normal * depth separates the shapes.
+		float depth;
+
+		// Unit penetration direction from the first shape to the second one.
+		Vec3d normal;
+
+		// Deepest points of the shapes inside each other.
+		Vec3d pointA;
+		Vec3d pointB;
+	};
+
+	/**
+	 * @brief GJK boolean intersection test, stops as soon as a separating direction is found.
+	 *
+	 * @param a First shape
+	 * @param b Second shape
+	 * @param simplex Optional simplex cache for warm-starting, updated by the call
+	 * @return True if the shapes touch or intersect, False otherwise
+	 */
+	bool gjkIntersect(const ConvexShape& a, const ConvexShape& b, Simplex* simplex = nullptr);
+
+	/**
+	 * @brief GJK distance and closest points query.
+	 *
+	 * @param a First shape
+	 * @param b Second shape
+	 * @param simplex Optional simplex cache for warm-starting, updated by the call
+	 * @return Query result
+	 */
+	DistanceResult gjkDistance(const ConvexShape& a, const ConvexShape& b, Simplex* simplex = nullptr);
+
+	/**
+	 * @brief Penetration depth query. Shapes with overlapping rounded parts only are resolved
+	 * directly from the GJK result, intersecting cores are expanded by EPA.
+	 *
+	 * @param a First shape
+	 * @param b Second shape
+	 * @param simplex Optional simplex cache for warm-starting, updated by the call
+	 * @return Query result
+	 */
+	PenetrationResult epaPenetration(const ConvexShape& a, const ConvexShape& b, Simplex* simplex = nullptr);
+
+	/**
+	 * @brief Batch distance query over shape pairs, parallelized with parallelFor().
+	 *
+	 * @param a First shapes array
+	 * @param b Second shapes array
+	 * @param simplices Optional simplex caches array, one per pair (nullptr - no warm start)
+	 * @param results Output results array
+	 * @param count Number of pairs
+	 */
+	void gjkDistanceN(const ConvexShape* const* a, const ConvexShape* const* b, Simplex* simplices, DistanceResult* results, size_t count);
+}
+
+#endif // __RE_MATH_CONVEX__
@@ -0,0 +1,153 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reCubicSpline3.h
+// Project:     reMath
+// Description: Definition of CubicSpline3 class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __RE_MATH_CUBIC_SPLINE3__
+#define __RE_MATH_CUBIC_SPLINE3__
+
+#include "reVec3d.h"
+#include <cstddef>
+#include <vector>
+
+namespace re
+{
+	/**
+	 * @brief Piecewise cubic 3D curve. Control points of every basis are converted to power basis
+	 * coefficients once in the constructor, so evaluation is the same Horner scheme for all of them
+	 * and batch evaluation handles four parameters per SSE instruction.
+	 * Segment i covers the parameters [i, i + 1]. An optional arc length table, solved once for
+	 * uniform distance steps within every segment, maps distances to parameters with a binary
+	 * search over the segments and a cubic interpolation, without any iterations.
+	 */
+	class CubicSpline3
+	{
+	public:
+		enum Basis
+		{
+			// Segments of four points (p0, c0, c1, p1), consecutive segments share the end point.
+			BASIS_BEZIER,
+
+			// Centripetal Catmull-Rom through every point, free of cusps and self-intersections
+			// within a segment. Tangents are continuous in direction, their length changes at the
+			// points with the knot spacing. End segments mirror their neighbour points.
+			BASIS_CATMULL_ROM,
+
+			// Interleaved position and tangent pairs, tangents are per unit of the parameter.
+			BASIS_HERMITE
+		};
+
+		/**
+		 * @brief Default arc length table resolution.
+		 */
+		static const size_t ARC_LENGTH_SAMPLES = 16;
+
+		/**
+		 * @brief Constructs a curve from the control points.
+		 *
+		 * @param points Control points (3n + 1 for Bezier, n + 1 for Catmull-Rom, 2n + 2 for Hermite)
+		 * @param count Number of control points, incomplete trailing segments are ignored
+		 * @param basis Spline basis
+		 * @param arcLengthSamples Arc length table entries per segment, zero skips the table
+		 */
+		CubicSpline3(const Vec3d* points, size_t count, Basis basis, size_t arcLengthSamples = ARC_LENGTH_SAMPLES);
+
+		/**
+		 * @brief Returns the number of segments, the curve parameter range is [0, segment count].
+		 */
+		size_t getSegmentCount() const;
+
+		/**
+		 * @brief Evaluates the curve position.
+		 *
+		 * @param time Curve parameter, clamped to [0, segment count]
+		 * @return Position (origin for an empty curve)
+		 */
+		Vec3d evaluate(float time) const;
+
+		/**
+		 * @brief Evaluates the curve derivative by the parameter.
+		 *
+		 * @param time Curve parameter, clamped to [0, segment count]
+		 * @return Tangent vector
+		 */
+		Vec3d evaluateTangent(float time) const;
+
+		/**
+		 * @brief Evaluates the curve positions at many parameters with SSE in parallel.
+		 *
+		 * @param times Curve parameters
+		 * @param output Result positions
+		 * @param count Number of parameters
+		 */
+		void evaluateN(const float* times, Vec3d* output, size_t count) const;
+
+		/**
+		 * @brief Returns the curve length, zero without the arc length table.
+		 */
+		float getLength() const;
+
+		/**
+		 * @brief Converts a distance along the curve to the curve parameter with the arc length table.
+		 *
+		 * @param distance Distance from the curve start, clamped to [0, length]
+		 * @return Curve parameter
+		 */
+		float getParameter(float distance) const;
+
+		/**
+		 * @brief Evaluates the curve positions at many distances along the curve, for constant
+		 * speed traversal. Requires the arc length table.
+		 *
+		 * @param distances Distances from the curve start
+		 * @param output Result positions
+		 * @param count Number of distances
+		 */
+		void evaluateAtDistanceN(const float* distances, Vec3d* output, size_t count) const;
+
+		/**
+		 * @brief Appends a polyline approximating the curve. Segments are subdivided adaptively
+		 * until their control polygons are flat, straight parts produce a single line.
+		 *
+		 * @param tolerance Maximum distance between the curve and the polyline
+		 * @param polyline Output points, including both curve ends
+		 */
+		void flatten(float tolerance, std::vector<Vec3d>& polyline) const;
+
+	private:
+		// Power basis coefficients a + b * u + c * u^2 + d * u^3 in x, y and z rows, so that one
+		// row loads into an SSE register and four rows transpose into coefficient vectors.
+		struct Segment
+		{
+			float rows[3][4];
+		};
+
+		// Curve parameter at a distance step and its derivative by the distance, scaled to one step.
+		struct ArcLengthSample
+		{
+			float parameter;
+			float slope;
+		};
+
+		void addSegment(const Vec3d& start, const Vec3d& startTangent, const Vec3d& end, const Vec3d& endTangent);
+		void buildArcLengthTable(size_t samples);
+		void evaluateBlock(const float* times, Vec3d* output, size_t count) const;
+
+	private:
+		std::vector<Segment> segments_;
+
+		// Samples at uniform distance steps of every segment, cubic Hermite interpolated, and the
+		// distances of the segment ends from the curve start.
+		std::vector<ArcLengthSample> arcLengths_;
+		std::vector<float> segmentEnds_;
+		size_t arcLengthSamples_ = 0;
+		float length_ = 0.f;
+	};
+}
+
+#endif // __RE_MATH_CUBIC_SPLINE3__
@@ -0,0 +1,109 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reDecomposition.h
+// Project:     reMath
+// Description: Definition of batch 3x3 matrix decompositions
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __RE_MATH_DECOMPOSITION__
+#define __RE_MATH_DECOMPOSITION__
+
+#include "reVec3d.h"
+#include "reMatrix3.h"
+#include "reQuaternion.h"
+#include <cstddef>
+
+namespace re
+{
+	class Matrix4;
+
+	/**
+	 * @brief Translation, rotation and scale of an affine matrix, matrix = T * R * S.
+	 */
+	struct TransformComponents
+	{
+		Vec3d translation;
+		Quaternion rotation;
+
+		// Scale along the local axes, mirroring matrices have a negative component.
+		Vec3d scale;
+
+		// Set when the axes are not orthogonal, so T * R * S only approximates the matrix.
+		bool sheared;
+	};
+
+	/**
+	 * @brief Eigen decomposition of symmetric matrices, matrix = vectors * diag(values) * vectors^T.
+	 * Runs six sweeps of cyclic Jacobi with approximate Givens rotations accumulated into a
+	 * quaternion (McAdams et al. 2011), which has no branches or divisions, so the same code runs
+	 * on four matrices at once in SSE lanes. Groups of matrices are processed in parallel.
+	 *
+	 * @param matrices Symmetric matrices array (the symmetric part is used)
+	 * @param count Number of matrices
+	 * @param values Output eigenvalues, in descending order
+	 * @param vectors Output rotation matrices with the eigenvectors in columns
+	 */
+	void eigenSymmetricN(const Matrix3* matrices, size_t count, Vec3d* values, Matrix3* vectors);
+
+	/**
+	 * @brief Singular value decomposition, matrix = u * diag(sigma) * v^T. The eigen decomposition
+	 * of matrix^T * matrix gives v, and the Givens QR decomposition of matrix * v gives u and
+	 * sigma. Both u and v are rotations, so for matrices with a negative determinant the
+	 * smallest singular value is negative, as needed for polar decomposition.
+	 *
+	 * @param matrices Matrices array
+	 * @param count Number of matrices
+	 * @param u Output left rotations
+	 * @param sigma Output singular values, in descending order of magnitude
+	 * @param v Output right rotations
+	 */
+	void svdN(const Matrix3* matrices, size_t count, Matrix3* u, Vec3d* sigma, Matrix3* v);
+
+	/**
+	 * @brief Polar decomposition, matrix = rotation * stretch with a symmetric stretch.
+	 * The rotation is the closest one to the matrix, computed from the SVD as u * v^T.
+	 *
+	 * @param matrix Matrix to decompose
+	 * @param rotation Output rotation
+	 * @param stretch Output symmetric stretch matrix, v * diag(sigma) * v^T
+	 */
+	void polarDecomposition(const Matrix3& matrix, Matrix3& rotation, Matrix3& stretch);
+
+	/**
+	 * @brief Batch polar decomposition, four matrices per SSE register like svdN().
+	 *
+	 * @param matrices Matrices array
+	 * @param count Number of matrices
+	 * @param rotations Output rotations
+	 * @param stretches Output symmetric stretch matrices
+	 */
+	void polarDecompositionN(const Matrix3* matrices, size_t count, Matrix3* rotations, Matrix3* stretches);
+
+	/**
+	 * @brief Splits an affine matrix into translation, rotation and scale.
+	 * Matrices with orthogonal axes take a fast path: the axis lengths are the scale and the
+	 * normalized axes convert to a quaternion, mirroring goes to the x scale. Sheared or
+	 * degenerate matrices fall back to the polar decomposition, where the scale is the diagonal
+	 * of the stretch and mirroring goes to the smallest axis.
+	 *
+	 * @param matrix Affine matrix
+	 * @param shearTolerance Largest cosine between the axes that counts as orthogonal
+	 * @return Transform components
+	 */
+	TransformComponents decompose(const Matrix4& matrix, float shearTolerance = 1e-4f);
+
+	/**
+	 * @brief Splits affine matrices into translation, rotation and scale in parallel.
+	 *
+	 * @param matrices Affine matrices array
+	 * @param count Number of matrices
+	 * @param components Output transform components
+	 * @param shearTolerance Largest cosine between the axes that counts as orthogonal
+	 */
+	void decomposeN(const Matrix4* matrices, size_t count, TransformComponents* components, float shearTolerance = 1e-4f);
+}
+
+#endif // __RE_MATH_DECOMPOSITION__
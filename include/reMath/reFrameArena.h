@@ -0,0 +1,136 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reFrameArena.h
+// Project:     reMath
+// Description: Definition of FrameArena class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __RE_MATH_FRAME_ARENA__
+#define __RE_MATH_FRAME_ARENA__
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace re
+{
+	/**
+	 * @brief Linear allocator for per-frame temporary objects and batch scratch buffers.
+	 * Allocation is a pointer bump, memory is released all at once by reset(). When a frame needs
+	 * more than the current capacity, overflow blocks are allocated and merged into a single block
+	 * on the next reset(), so in steady state the arena does no heap allocations at all.
+	 * Object destructors are never called, so only objects which don't own resources belong here.
+	 */
+	class FrameArena
+	{
+	public:
+		/**
+		 * @brief Default alignment of allocations, suitable for SIMD loads.
+		 */
+		static const size_t DEFAULT_ALIGNMENT = 16;
+
+		/**
+		 * @brief Allocation position which can be restored with rewind().
+		 */
+		struct Marker
+		{
+			size_t block;
+			size_t offset;
+		};
+
+		/**
+		 * @brief Constructs an arena.
+		 *
+		 * @param capacity Initial capacity in bytes (0 - allocate on first use)
+		 */
+		explicit FrameArena(size_t capacity = 0);
+
+		/**
+		 * @brief Destructor. Releases all the memory blocks.
+		 */
+		~FrameArena();
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena& operator = (const FrameArena&) = delete;
+
+		/**
+		 * @brief Allocates a block of raw memory.
+		 *
+		 * @param size Number of bytes
+		 * @param alignment Alignment in bytes (power of two)
+		 * @return Pointer to the allocated memory
+		 */
+		void* allocate(size_t size, size_t alignment = DEFAULT_ALIGNMENT);
+
+		/**
+		 * @brief Allocates and default-constructs an array of objects.
+		 *
+		 * @param count Number of objects
+		 * @return Pointer to the first object
+		 */
+		template <typename T>
+		T* allocate(size_t count)
+		{
+			const size_t alignment = alignof(T) > DEFAULT_ALIGNMENT ? alignof(T) : DEFAULT_ALIGNMENT;
+			T* result = static_cast<T*>(allocate(sizeof(T) * count, alignment));
+
+			for (size_t i = 0; i < count; i++)
+				new (result + i) T();
+
+			return result;
+		}
+
+		/**
+		 * @brief Returns the current allocation position.
+		 */
+		Marker mark() const;
+
+		/**
+		 * @brief Releases everything allocated after the marker was taken.
+		 *
+		 * @param marker Position returned by mark()
+		 */
+		void rewind(const Marker& marker);
+
+		/**
+		 * @brief Releases all the allocations. Overflow blocks are merged into one block large
+		 * enough for the whole previous frame.
+		 */
+		void reset();
+
+		/**
+		 * @brief Returns the number of bytes allocated since the last reset.
+		 */
+		size_t used() const;
+
+		/**
+		 * @brief Returns the total number of bytes in all the memory blocks.
+		 */
+		size_t capacity() const;
+
+		/**
+		 * @brief Returns the arena of the calling thread, e.g. for scratch memory of parallelFor() workers.
+		 */
+		static FrameArena& threadLocal();
+
+	private:
+		struct Block
+		{
+			unsigned char* data;
+			size_t size;
+		};
+
+		void addBlock(size_t size);
+		void release();
+
+	private:
+		std::vector<Block> blocks_;
+		size_t block_ = 0;
+		size_t offset_ = 0;
+	};
+}
+
+#endif // __RE_MATH_FRAME_ARENA__
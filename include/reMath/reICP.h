@@ -0,0 +1,94 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reICP.h
+// Project:     reMath
+// Description: Definition of iterative closest point registration
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __RE_MATH_ICP__
+#define __RE_MATH_ICP__
+
+#include "reVec3d.h"
+#include "reMatrix4.h"
+#include <cfloat>
+#include <cstddef>
+
+namespace re
+{
+	class KdTree;
+
+	/**
+	 * @brief Registration settings.
+	 */
+	struct RegistrationSettings
+	{
+		// Maximum number of iterations.
+		int maxIterations = 50;
+
+		// Registration stops when the error changes by less than this fraction of the initial error.
+		float tolerance = 1e-5f;
+
+		// Correspondences further apart than this are rejected.
+		float maxDistance = FLT_MAX;
+
+		// Correspondences further apart than this multiple of the median distance are rejected (0 - off).
+		float rejectionFactor = 3.f;
+
+		// Target normals, switch the error metric from point-to-point to point-to-plane (may be nullptr).
+		const Vec3d* targetNormals = nullptr;
+	};
+
+	/**
+	 * @brief Registration result.
+	 */
+	struct RegistrationResult
+	{
+		// Rigid transformation moving the source onto the target.
+		Matrix4 transform;
+
+		// RMS distance (point-to-plane distance with normals) of the inliers in the last iteration.
+		float error = 0.f;
+
+		int iterations = 0;
+		size_t inlierCount = 0;
+		bool converged = false;
+	};
+
+	/**
+	 * @brief Registers a point cloud to another with the iterative closest point algorithm.
+	 * Every iteration transforms the source, finds the closest target points with a parallel
+	 * batch search, rejects outliers and solves for the rigid transformation in closed form:
+	 * Horn's quaternion method for point-to-point, or a linearized least squares step for
+	 * point-to-plane error, which converges in far fewer iterations on smooth surfaces.
+	 * The sums of both solvers are reduced in parallel.
+	 *
+	 * @param source Source points array
+	 * @param sourceCount Number of source points
+	 * @param target Target points array
+	 * @param targetTree Tree built over the target points
+	 * @param initial Initial transformation estimate
+	 * @param settings Registration settings
+	 * @return Registration result
+	 */
+	RegistrationResult icp(const Vec3d* source, size_t sourceCount, const Vec3d* target, const KdTree& targetTree,
+		const Matrix4& initial = Matrix4(), const RegistrationSettings& settings = RegistrationSettings());
+
+	/**
+	 * @brief Registers a point cloud to another, building the tree over the target points.
+	 *
+	 * @param source Source points array
+	 * @param sourceCount Number of source points
+	 * @param target Target points array
+	 * @param targetCount Number of target points
+	 * @param initial Initial transformation estimate
+	 * @param settings Registration settings
+	 * @return Registration result
+	 */
+	RegistrationResult icp(const Vec3d* source, size_t sourceCount, const Vec3d* target, size_t targetCount,
+		const Matrix4& initial = Matrix4(), const RegistrationSettings& settings = RegistrationSettings());
+}
+
+#endif // __RE_MATH_ICP__
@@ -0,0 +1,88 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reIntegrator.h
+// Project:     reMath
+// Description: Definition of rigid body integration kernels
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __RE_MATH_INTEGRATOR__
+#define __RE_MATH_INTEGRATOR__
+
+#include "reVec3d.h"
+#include <cstddef>
+
+namespace re
+{
+	class Matrix3;
+	class Quaternion;
+
+	/**
+	 * @brief Rigid body states as a structure of arrays, element i of every array belongs to body i.
+	 * Velocities, forces and torques are in world space, optional arrays may be nullptr.
+	 */
+	struct RigidBodies
+	{
+		Vec3d* positions = nullptr;
+
+		// Normalized body to world rotations.
+		Quaternion* orientations = nullptr;
+
+		Vec3d* linearVelocities = nullptr;
+		Vec3d* angularVelocities = nullptr;
+
+		// Accumulated forces and torques (optional).
+		const Vec3d* forces = nullptr;
+		const Vec3d* torques = nullptr;
+
+		// Inverse masses, zero for static and kinematic bodies (optional, unit masses by default).
+		const float* inverseMasses = nullptr;
+
+		// Inverse inertia tensors in body space, required for torques and world tensors.
+		const Matrix3* localInverseInertias = nullptr;
+
+		// Inverse inertia tensors in world space, R * I^-1 * R^T updated with the orientations (optional).
+		Matrix3* worldInverseInertias = nullptr;
+
+		// Acceleration of every body with a non-zero inverse mass.
+		Vec3d gravity = Vec3d(0.f);
+
+		size_t count = 0;
+	};
+
+	/**
+	 * @brief Advances the bodies with semi-implicit (symplectic) Euler: velocities are updated
+	 * from the forces first, then positions and orientations from the new velocities. Both steps
+	 * are fused into one pass over the arrays, four bodies per SSE instruction, and large
+	 * arrays are split between the threads of the current executor.
+	 *
+	 * @param bodies Body states
+	 * @param timeStep Time step (in seconds)
+	 */
+	void integrateN(const RigidBodies& bodies, float timeStep);
+
+	/**
+	 * @brief Updates the velocities from gravity, forces and torques (the kick step). Torques are
+	 * brought to body space, where the inertia is constant, and back with the orientations.
+	 * Together with driftN() it builds the leapfrog (kick-drift-kick) scheme for forces that
+	 * depend on the positions: kickN(dt / 2), driftN(dt), update the forces, kickN(dt / 2).
+	 *
+	 * @param bodies Body states
+	 * @param timeStep Time step (in seconds)
+	 */
+	void kickN(const RigidBodies& bodies, float timeStep);
+
+	/**
+	 * @brief Updates the positions and orientations from the velocities (the drift step).
+	 * Orientations are rotated by the exponential map of the angular velocity, exact for any
+	 * constant angular velocity, renormalized, and the world inverse inertia tensors rebuilt.
+	 *
+	 * @param bodies Body states
+	 * @param timeStep Time step (in seconds)
+	 */
+	void driftN(const RigidBodies& bodies, float timeStep);
+}
+
+#endif // __RE_MATH_INTEGRATOR__
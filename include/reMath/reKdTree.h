@@ -0,0 +1,126 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reKdTree.h
+// Project:     reMath
+// Description: Definition of KdTree (k-d tree) class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __RE_MATH_KD_TREE__
+#define __RE_MATH_KD_TREE__
+
+#include "reVec3d.h"
+#include <cstddef>
+#include <vector>
+
+namespace re
+{
+	/**
+	 * @brief Static k-d tree over a point cloud for nearest neighbour, k-NN and radius searches.
+	 * The layout is implicit: points are reordered so that every range has its median along the
+	 * split axis in the middle, with the smaller points before it and the larger ones after it.
+	 * Children of a range are the halves around the median, so there are no node pointers and
+	 * only the split axis is stored per point. Small ranges are leaves scanned linearly.
+	 * The top levels are split in parallel, and all distances are squared.
+	 */
+	class KdTree
+	{
+	public:
+		/**
+		 * @brief Invalid point index.
+		 */
+		static const unsigned int INVALID = 0xFFFFFFFF;
+
+		/**
+		 * @brief Builds the tree, the points are copied.
+		 *
+		 * @param points Points array
+		 * @param count Number of points
+		 */
+		void build(const Vec3d* points, size_t count);
+
+		/**
+		 * @brief Returns the number of points.
+		 */
+		size_t getPointCount() const;
+
+		/**
+		 * @brief Finds the nearest point.
+		 *
+		 * @param point Query point
+		 * @param distanceSquared Output squared distance to the nearest point (may be nullptr)
+		 * @return Index of the nearest point, INVALID if the tree is empty
+		 */
+		unsigned int findNearest(const Vec3d& point, float* distanceSquared = nullptr) const;
+
+		/**
+		 * @brief Finds the k nearest points, ordered by distance. Candidates are kept in a max-heap
+		 * bounded to k entries, whose top prunes the search.
+		 *
+		 * @param point Query point
+		 * @param k Number of points to find
+		 * @param indices Output point indices (k entries)
+		 * @param distancesSquared Output squared distances (k entries, may be nullptr)
+		 * @return Number of points found, less than k only if the tree has fewer points
+		 */
+		size_t findNearest(const Vec3d& point, size_t k, unsigned int* indices, float* distancesSquared = nullptr) const;
+
+		/**
+		 * @brief Appends the points within a radius, in no particular order.
+		 *
+		 * @param point Query point
+		 * @param radius Search radius
+		 * @param result Output point indices
+		 */
+		void findInRadius(const Vec3d& point, float radius, std::vector<unsigned int>& result) const;
+
+		/**
+		 * @brief Finds the nearest points of many query points in parallel.
+		 *
+		 * @param points Query points array
+		 * @param count Number of query points
+		 * @param indices Output nearest point indices
+		 * @param distancesSquared Output squared distances (may be nullptr)
+		 */
+		void findNearestN(const Vec3d* points, size_t count, unsigned int* indices, float* distancesSquared = nullptr) const;
+
+		/**
+		 * @brief Finds the k nearest points of many query points in parallel. Results of query i
+		 * start at i * k, entries past the number of points in the tree are INVALID.
+		 *
+		 * @param points Query points array
+		 * @param count Number of query points
+		 * @param k Number of points to find per query
+		 * @param indices Output point indices (count * k entries)
+		 * @param distancesSquared Output squared distances (count * k entries, may be nullptr)
+		 */
+		void findNearestN(const Vec3d* points, size_t count, size_t k, unsigned int* indices, float* distancesSquared = nullptr) const;
+
+	private:
+		struct Entry
+		{
+			float d[3];
+			unsigned int index;
+		};
+
+		struct Range
+		{
+			size_t begin;
+			size_t end;
+		};
+
+		void split(const Range& range);
+		void buildRange(const Range& range);
+
+		template <typename Visitor>
+		void search(const float point[3], float& maxDistanceSquared, Visitor& visitor) const;
+
+	private:
+		std::vector<Entry> entries_;
+		std::vector<unsigned char> axes_;
+	};
+}
+
+#endif // __RE_MATH_KD_TREE__
@@ -0,0 +1,146 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reLBVH.h
+// Project:     reMath
+// Description: Definition of LBVH (linear bounding volume hierarchy) class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __RE_MATH_LBVH__
+#define __RE_MATH_LBVH__
+
+#include "reVec3d.h"
+#include "reAABB.h"
+#include <cstddef>
+#include <vector>
+
+namespace re
+{
+	/**
+	 * @brief Linear bounding volume hierarchy, cheap enough to rebuild from scratch every frame.
+	 * Primitives are sorted by the Morton codes of their centroids and the binary radix tree over
+	 * the sorted codes is emitted with every internal node built independently (Karras 2012).
+	 * Node bounds are then merged bottom-up, each internal node by the thread arriving second.
+	 * All stages run in parallel through the current executor.
+	 * Tree quality is lower than that of a SAH build, in exchange for a build linear in time.
+	 */
+	class LBVH
+	{
+	public:
+		/**
+		 * @brief Invalid node index.
+		 */
+		static const unsigned int INVALID = 0xFFFFFFFF;
+
+		/**
+		 * @brief Tree node. The root is node 0, N primitives make N - 1 internal nodes and N leaves.
+		 */
+		struct Node
+		{
+			AABB bounds;
+			unsigned int parent;
+
+			// Child nodes of internal nodes, leaves keep the primitive index in left and INVALID in right.
+			unsigned int left;
+			unsigned int right;
+		};
+
+		/**
+		 * @brief Builds the tree over primitive bounding boxes.
+		 *
+		 * @param boxes Primitive bounds array
+		 * @param count Number of primitives
+		 */
+		void build(const AABB* boxes, size_t count);
+
+		/**
+		 * @brief Builds the tree over an indexed triangle mesh, primitive indices are triangle indices.
+		 *
+		 * @param vertices Vertices array
+		 * @param indices Indices array, three per triangle
+		 * @param triangleCount Number of triangles
+		 */
+		void build(const Vec3d* vertices, const unsigned int* indices, size_t triangleCount);
+
+		/**
+		 * @brief Updates the bounds of moved primitives without changing the hierarchy. Leaves are
+		 * updated in parallel and internal nodes merged bottom-up as in the build, which is much
+		 * cheaper than a rebuild as long as the primitives keep their neighbours.
+		 * Rotations swap a child of a node with a grandchild when that shrinks the surface area
+		 * of the changed child (Kopta 2012), which slows down the quality decay of deforming
+		 * meshes. They never make a subtree deeper.
+		 *
+		 * @param boxes Primitive bounds array, same count and order as in the build
+		 * @param rotate Apply tree rotations
+		 */
+		void refit(const AABB* boxes, bool rotate = false);
+
+		/**
+		 * @brief Updates the bounds of a deformed triangle mesh with the same topology as in the build.
+		 *
+		 * @param vertices Vertices array
+		 * @param indices Indices array, three per triangle
+		 * @param rotate Apply tree rotations
+		 */
+		void refit(const Vec3d* vertices, const unsigned int* indices, bool rotate = false);
+
+		/**
+		 * @brief Returns the surface area heuristic cost of the tree: node surface areas relative to
+		 * the root, weighted by the traversal and intersection costs. Lower is better.
+		 */
+		float getCost() const;
+
+		/**
+		 * @brief Returns the tree cost right after the last build. Once getCost() grows past this
+		 * by a chosen factor (around 1.5 for typical deformations), queries slow down enough
+		 * to make a rebuild pay off.
+		 */
+		float getBuildCost() const;
+
+		/**
+		 * @brief Returns the tree nodes.
+		 */
+		const std::vector<Node>& getNodes() const;
+
+		/**
+		 * @brief Returns the number of primitives.
+		 */
+		size_t getPrimitiveCount() const;
+
+		/**
+		 * @brief Returns the bounds of all primitives.
+		 */
+		AABB getBounds() const;
+
+		/**
+		 * @brief Appends the primitives whose bounds overlap a box.
+		 *
+		 * @param box Query box
+		 * @param result Output primitive indices
+		 */
+		void queryOverlap(const AABB& box, std::vector<unsigned int>& result) const;
+
+		/**
+		 * @brief Appends the primitives whose bounds are hit by a ray.
+		 *
+		 * @param origin Ray origin
+		 * @param direction Ray direction
+		 * @param maxDistance Maximum ray parameter
+		 * @param result Output primitive indices
+		 */
+		void queryRay(const Vec3d& origin, const Vec3d& direction, float maxDistance, std::vector<unsigned int>& result) const;
+
+	private:
+		void buildTree(const AABB* boxes);
+		void refitNodes(bool rotate);
+
+	private:
+		std::vector<Node> nodes_;
+		size_t primitiveCount_ = 0;
+		float buildCost_ = 0.f;
+	};
+}
+
+#endif // __RE_MATH_LBVH__
@@ -18,5 +18,26 @@
 #include "reMatrix4.h"
 #include "reQuaternion.h"
 #include "reMathUtil.h"
+#include "reCamera.h"
+#include "reParallel.h"
+#include "reFrameArena.h"
+#include "reBatch.h"
+#include "reOBB.h"
+#include "reConvex.h"
+#include "reAABB.h"
+#include "reSweepAndPrune.h"
+#include "reOctree.h"
+#include "reMorton.h"
+#include "reLBVH.h"
+#include "reKdTree.h"
+#include "reICP.h"
+#include "reDecomposition.h"
+#include "reQuaternionSpline.h"
+#include "reCubicSpline3.h"
+#include "reIntegrator.h"
+#include "reParticleBuffer.h"
+#include "reOcclusionBuffer.h"
+#include "rePlane.h"
+#include "reSphere.h"
 
 #endif // __RE_MATH__
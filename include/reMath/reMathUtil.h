@@ -11,6 +11,16 @@
 #ifndef __RE_MATH_UTIL__
 #define __RE_MATH_UTIL__
 
+// SSE is available on all x64 targets and on x86 builds with /arch:SSE or higher.
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || defined(__SSE__)
+#define RE_MATH_SSE
+#endif
+
+// BMI2 (pdep/pext) is enabled by -mbmi2 or -march, and on MSVC x64 by /arch:AVX2.
+#if defined(__BMI2__) || (defined(_M_X64) && defined(__AVX2__))
+#define RE_MATH_BMI2
+#endif
+
 namespace re
 {
 	/**
@@ -63,6 +73,17 @@ namespace re
 	 */
 	unsigned char getLowNibble(unsigned char byte);
 
+	/**
+	 * @brief Fast approximate reciprocal square root.
+	 * Uses the rsqrtss instruction refined by one Newton-Raphson step where SSE is available,
+	 * and an integer initial guess refined by three steps otherwise.
+	 * Max relative error is 4e-7 for all positive normal values (values below FLT_MIN overflow).
+	 *
+	 * @param value Positive value
+	 * @return Approximation of 1 / sqrt(value)
+	 */
+	float rsqrtFast(float value);
+
 	/**
 	 * @brief Calculates a perspective projection matrix.
 	 *
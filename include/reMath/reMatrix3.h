@@ -63,14 +63,21 @@ namespace re
 		// Inverse matrix
 		void inverse();
 
+		// Returns inversed matrix leaving original intact
+		Matrix3 toInversed() const;*/
+
 		// Transpose matrix
 		void transpose();
 
-		// Returns inversed matrix leaving original intact
-		Matrix3 toInversed() const;
-
 		// Returns transposed matrix leaving original intact
-		Matrix3 toTransposed() const;*/
+		Matrix3 toTransposed() const;
+
+		// Eigen decomposition of a symmetric matrix: values in descending order, vectors in columns of a rotation.
+		void eigenSymmetric(Vec3d& values, Matrix3& vectors) const;
+
+		// Singular value decomposition, matrix = u * diag(sigma) * v^T with rotations u and v.
+		// Singular values are in descending order of magnitude, the last one is negative for reflections.
+		void svd(Matrix3& u, Vec3d& sigma, Matrix3& v) const;
 
 		// Apply matrix rotation to a vactor.
 		void rotate(float& x, float& y, float& z) const;
@@ -116,14 +123,14 @@ namespace re
 		//----------------------
 
 		// Returns result of matrices multiplication.
-		/*Matrix3 operator * (const Matrix3& matrix);
+		Matrix3 operator * (const Matrix3& matrix) const;
 
 
 		// Compound assignment operators.
 		//-------------------------------
 
 		// Performs matrices multiplication.
-		void operator *= (const Matrix3& matrix);*/
+		void operator *= (const Matrix3& matrix);
 
 
 		// Conversion operators.
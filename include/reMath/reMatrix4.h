@@ -57,9 +57,12 @@ namespace re
 		void setScale(const Vec3d& s);
 		void setScale(float scale);
 
-		// Get scaling value.
+		// Get uniform scaling value (length of the x axis, negative for mirroring matrices).
 		float getScale() const;
 
+		// Get scaling values (lengths of the axes, x is negative for mirroring matrices).
+		Vec3d getScales() const;
+
 		// Get euler rotation angles (in radians).
 		Vec3d getEulers() const;
 
@@ -0,0 +1,112 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reMorton.h
+// Project:     reMath
+// Description: Definition of Morton code (Z-order curve) functions
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __RE_MATH_MORTON__
+#define __RE_MATH_MORTON__
+
+#include "reVec3d.h"
+#include "reAABB.h"
+#include <cstddef>
+
+namespace re
+{
+	/**
+	 * @brief Number of bits per coordinate in 30-bit Morton codes.
+	 */
+	const int MORTON_BITS = 10;
+
+	/**
+	 * @brief Number of bits per coordinate in 63-bit Morton codes.
+	 */
+	const int MORTON_BITS64 = 21;
+
+	/**
+	 * @brief Interleaves three 10-bit coordinates into a 30-bit Morton code, x goes to the lowest bit.
+	 * Uses the BMI2 pdep instruction when RE_MATH_BMI2 is defined and magic bit masks otherwise.
+	 *
+	 * @param x X coordinate (higher bits are ignored)
+	 * @param y Y coordinate (higher bits are ignored)
+	 * @param z Z coordinate (higher bits are ignored)
+	 * @return Morton code
+	 */
+	unsigned int mortonEncode(unsigned int x, unsigned int y, unsigned int z);
+
+	/**
+	 * @brief Splits a 30-bit Morton code into its coordinates.
+	 *
+	 * @param code Morton code
+	 * @param x Output x coordinate
+	 * @param y Output y coordinate
+	 * @param z Output z coordinate
+	 */
+	void mortonDecode(unsigned int code, unsigned int& x, unsigned int& y, unsigned int& z);
+
+	/**
+	 * @brief Interleaves three 21-bit coordinates into a 63-bit Morton code, x goes to the lowest bit.
+	 *
+	 * @param x X coordinate (higher bits are ignored)
+	 * @param y Y coordinate (higher bits are ignored)
+	 * @param z Z coordinate (higher bits are ignored)
+	 * @return Morton code
+	 */
+	unsigned long long mortonEncode64(unsigned int x, unsigned int y, unsigned int z);
+
+	/**
+	 * @brief Splits a 63-bit Morton code into its coordinates.
+	 *
+	 * @param code Morton code
+	 * @param x Output x coordinate
+	 * @param y Output y coordinate
+	 * @param z Output z coordinate
+	 */
+	void mortonDecode64(unsigned long long code, unsigned int& x, unsigned int& y, unsigned int& z);
+
+	/**
+	 * @brief Returns the 30-bit Morton code of a point quantized to a 1024^3 grid over the bounds.
+	 * Points outside of the bounds are clamped to them.
+	 *
+	 * @param point Point
+	 * @param bounds Grid bounds
+	 * @return Morton code
+	 */
+	unsigned int mortonCode(const Vec3d& point, const AABB& bounds);
+
+	/**
+	 * @brief Returns the 63-bit Morton code of a point quantized to a 2097152^3 grid over the bounds.
+	 *
+	 * @param point Point
+	 * @param bounds Grid bounds
+	 * @return Morton code
+	 */
+	unsigned long long mortonCode64(const Vec3d& point, const AABB& bounds);
+
+	/**
+	 * @brief Calculates 30-bit Morton codes of points in parallel.
+	 *
+	 * @param points Points array
+	 * @param count Number of points
+	 * @param bounds Grid bounds
+	 * @param codes Output codes array
+	 */
+	void mortonCodeN(const Vec3d* points, size_t count, const AABB& bounds, unsigned int* codes);
+
+	/**
+	 * @brief Reorders points along the Z-order curve over their bounds, so that points close in
+	 * space end up close in memory. Codes are calculated in parallel and sorted with the parallel
+	 * radix sort, the order of points with equal codes is kept.
+	 *
+	 * @param points Points array, reordered in place
+	 * @param count Number of points
+	 * @param order Output original indices of the reordered points (may be nullptr)
+	 */
+	void mortonSort(Vec3d* points, size_t count, unsigned int* order = nullptr);
+}
+
+#endif // __RE_MATH_MORTON__
@@ -0,0 +1,109 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reOBB.h
+// Project:     reMath
+// Description: Definition of OBB (oriented bounding box) class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __RE_MATH_OBB__
+#define __RE_MATH_OBB__
+
+#include "reVec3d.h"
+#include "reMatrix3.h"
+#include <cstddef>
+
+namespace re
+{
+	class Matrix4;
+
+	/**
+	 * @brief Oriented bounding box.
+	 * The box axes are the columns of the rotation matrix (same layout as Matrix3::rotate() uses),
+	 * extents are the half sizes along those axes.
+	 */
+	class OBB
+	{
+	public:
+		/**
+		 * @brief Default constructor. Creates an empty box at the origin.
+		 */
+		OBB();
+
+		/**
+		 * @brief Constructs a box from its components.
+		 *
+		 * @param centerValue Box center
+		 * @param rotationValue Box orientation
+		 * @param extentsValue Half sizes along the box axes
+		 */
+		OBB(const Vec3d& centerValue, const Matrix3& rotationValue, const Vec3d& extentsValue);
+
+		/**
+		 * @brief Destructor.
+		 */
+		virtual ~OBB() = default;
+
+		/**
+		 * @brief Fits a box to a point set. The axes are the principal components of the points
+		 * covariance matrix, extents are taken from the points projected onto those axes.
+		 *
+		 * @param points Points array
+		 * @param count Number of points
+		 * @return Fitted box
+		 */
+		static OBB fromPoints(const Vec3d* points, size_t count);
+
+		/**
+		 * @brief Returns one of the box axes.
+		 *
+		 * @param index Axis index (0 - 2)
+		 * @return Unit axis vector
+		 */
+		Vec3d getAxis(int index) const;
+
+		/**
+		 * @brief Transforms the box by the matrix. Scale is taken into the extents, which is exact
+		 * unless the matrix has a shear relative to the box axes.
+		 *
+		 * @param matrix Transformation matrix
+		 */
+		void transform(const Matrix4& matrix);
+
+		/**
+		 * @brief Checks if a point is inside the box.
+		 *
+		 * @param point Point to test
+		 * @return True if the point is inside or on the boundary, False otherwise
+		 */
+		bool contains(const Vec3d& point) const;
+
+		/**
+		 * @brief Separating axis overlap test. Face axes of both boxes are tested before the more
+		 * expensive edge cross product axes, so most separated pairs exit early.
+		 *
+		 * @param box Second box
+		 * @return True if the boxes overlap, False otherwise
+		 */
+		bool overlaps(const OBB& box) const;
+
+		/**
+		 * @brief Tests one box against an array of boxes, four boxes per SSE iteration.
+		 *
+		 * @param box Box to test
+		 * @param boxes Boxes array
+		 * @param count Number of boxes
+		 * @param results Output overlap flags, one per box
+		 */
+		static void overlapN(const OBB& box, const OBB* boxes, size_t count, bool* results);
+
+	public:
+		Vec3d center;
+		Matrix3 rotation;
+		Vec3d extents;
+	};
+}
+
+#endif // __RE_MATH_OBB__
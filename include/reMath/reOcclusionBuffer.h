@@ -0,0 +1,197 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reOcclusionBuffer.h
+// Project:     reMath
+// Description: Definition of OcclusionBuffer class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __RE_MATH_OCCLUSION_BUFFER__
+#define __RE_MATH_OCCLUSION_BUFFER__
+
+#include "reMatrix4.h"
+#include <cstddef>
+#include <vector>
+
+namespace re
+{
+	class Vec3d;
+	class AABB;
+	class Camera;
+
+	/**
+	 * @brief Software occlusion culling for perspective projections, without a GPU.
+	 * Occluder meshes are rasterized into a low resolution depth buffer, then bounding boxes are
+	 * tested against it. Depth is stored as 1 / w (reciprocal view distance), which interpolates
+	 * linearly over the screen and works for any depth mode and an infinite far plane.
+	 * Tiles of TILE_SIZE pixels keep their farthest depth, so most boxes are decided per tile.
+	 *
+	 * A frame is begin(), addOccluder() calls and end(). Triangle setup (clipping, projection
+	 * and binning) and rasterization of BIN_SIZE screen bins run in parallel on the current
+	 * executor. Visibility queries after end() are read-only and may run from several threads.
+	 */
+	class OcclusionBuffer
+	{
+	public:
+		/**
+		 * @brief Tile size of the hierarchical depth level, in pixels.
+		 */
+		static const size_t TILE_SIZE = 8;
+
+		/**
+		 * @brief Screen bin size rasterized by one task, in pixels.
+		 */
+		static const size_t BIN_SIZE = 32;
+
+		/**
+		 * @brief Constructs a buffer.
+		 *
+		 * @param width Width in pixels (rounded up to a multiple of TILE_SIZE)
+		 * @param height Height in pixels (rounded up to a multiple of TILE_SIZE)
+		 */
+		OcclusionBuffer(size_t width, size_t height);
+
+		/**
+		 * @brief Returns the width in pixels.
+		 */
+		size_t getWidth() const;
+
+		/**
+		 * @brief Returns the height in pixels.
+		 */
+		size_t getHeight() const;
+
+		/**
+		 * @brief Starts a frame, dropping all occluders.
+		 *
+		 * @param viewProjection Projection * view matrix (e.g. re::perspective() * re::lookAt())
+		 * @param zNear Near clipping plane distance of the projection
+		 */
+		void begin(const Matrix4& viewProjection, float zNear);
+
+		/**
+		 * @brief Starts a frame for the camera view, dropping all occluders.
+		 */
+		void begin(const Camera& camera);
+
+		/**
+		 * @brief Adds a world space triangle mesh. Vertices are transformed to clip space four at
+		 * a time with SSE in parallel, triangles are set up in end().
+		 *
+		 * @param vertices Vertices array
+		 * @param vertexCount Number of vertices
+		 * @param indices Three vertex indices per triangle, counter-clockwise front faces
+		 * @param triangleCount Number of triangles
+		 * @param doubleSided Rasterize back faces as well (for open meshes like walls)
+		 */
+		void addOccluder(const Vec3d* vertices, size_t vertexCount, const unsigned int* indices, size_t triangleCount, bool doubleSided = false);
+
+		/**
+		 * @brief Adds a triangle mesh in model space.
+		 *
+		 * @param vertices Vertices array
+		 * @param vertexCount Number of vertices
+		 * @param indices Three vertex indices per triangle, counter-clockwise front faces
+		 * @param triangleCount Number of triangles
+		 * @param world Model to world matrix
+		 * @param doubleSided Rasterize back faces as well (for open meshes like walls)
+		 */
+		void addOccluder(const Vec3d* vertices, size_t vertexCount, const unsigned int* indices, size_t triangleCount, const Matrix4& world, bool doubleSided = false);
+
+		/**
+		 * @brief Clips, projects and rasterizes the occluders into the depth buffer and builds
+		 * the tile level.
+		 */
+		void end();
+
+		/**
+		 * @brief Returns the depth (1 / w, zero where nothing was drawn) of a pixel.
+		 *
+		 * @param x Pixel column
+		 * @param y Pixel row, from the bottom as in window coordinates
+		 */
+		float getDepth(size_t x, size_t y) const;
+
+		/**
+		 * @brief Checks if a box may be visible. The test is conservative: boxes crossing the
+		 * near plane are visible, and a box is hidden only if every pixel its projection touches
+		 * has an occluder closer than the nearest box corner.
+		 *
+		 * @param box World space box
+		 * @return False if the box is occluded or outside the view, True otherwise
+		 */
+		bool isVisible(const AABB& box) const;
+
+		/**
+		 * @brief Tests many boxes in parallel.
+		 *
+		 * @param boxes Boxes array
+		 * @param visible Output visibility of every box
+		 * @param count Number of boxes
+		 */
+		void isVisibleN(const AABB* boxes, bool* visible, size_t count) const;
+
+	private:
+		struct Occluder
+		{
+			size_t firstTriangle;
+			size_t triangleCount;
+			bool doubleSided;
+		};
+
+		// Screen triangle with edge functions and the depth plane in pixel coordinates, so that
+		// a * x + b * y + c is evaluated at the pixel center (x + 0.5, y + 0.5).
+		struct Triangle
+		{
+			float edges[3][3];
+			float depth[3];
+			int minX;
+			int minY;
+			int maxX;
+			int maxY;
+		};
+
+		// Range of an occluder triangles set up by one task, with its own triangle lists per bin.
+		struct SetupJob
+		{
+			size_t occluder;
+			size_t first;
+			size_t count;
+			std::vector<Triangle> triangles;
+			std::vector<std::vector<unsigned int>> bins;
+		};
+
+		void addOccluder(const Vec3d* vertices, size_t vertexCount, const unsigned int* indices, size_t triangleCount, const float* matrix, bool doubleSided);
+		void addTriangle(SetupJob& job, const float* a, const float* b, const float* c, bool doubleSided) const;
+		void setupTriangles(SetupJob& job) const;
+		void rasterizeBin(size_t bin);
+		bool isTileVisible(size_t tileX, size_t tileY, size_t minX, size_t minY, size_t maxX, size_t maxY, float nearest) const;
+
+	private:
+		size_t width_;
+		size_t height_;
+		size_t binColumns_;
+		size_t binRows_;
+
+		Matrix4 viewProjection_;
+		float near_ = 0.f;
+
+		// Clip space vertices of the frame and their frustum outcodes.
+		std::vector<float> clipX_;
+		std::vector<float> clipY_;
+		std::vector<float> clipW_;
+		std::vector<unsigned char> codes_;
+		std::vector<unsigned int> indices_;
+		std::vector<Occluder> occluders_;
+		std::vector<SetupJob> jobs_;
+		size_t jobCount_ = 0;
+
+		// Row-major pixel depths and the farthest (smallest) depth of every tile.
+		std::vector<float> depths_;
+		std::vector<float> tileDepths_;
+	};
+}
+
+#endif // __RE_MATH_OCCLUSION_BUFFER__
@@ -0,0 +1,162 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reOctree.h
+// Project:     reMath
+// Description: Definition of Octree (loose octree) class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __RE_MATH_OCTREE__
+#define __RE_MATH_OCTREE__
+
+#include "reVec3d.h"
+#include "reAABB.h"
+#include <cstddef>
+#include <vector>
+
+namespace re
+{
+	class Camera;
+
+	/**
+	 * @brief Loose octree indexing bounding spheres of dynamic objects.
+	 * Node bounds are twice the size of their cells, so an object is stored at the depth where
+	 * its radius fits half a cell, in the cell containing its center. Placement is computed
+	 * directly from the position, and moving an object within its cell costs nothing.
+	 * Nodes are identified by Morton locational codes (a leading 1 bit followed by three bits per
+	 * level) and kept in a pool with a free list, objects are linked into their nodes by index.
+	 */
+	class Octree
+	{
+	public:
+		/**
+		 * @brief Deepest supported level, locational codes of deeper levels don't fit 32 bits.
+		 */
+		static const int MAX_DEPTH = 10;
+
+		/**
+		 * @brief Invalid object or node index.
+		 */
+		static const unsigned int INVALID = 0xFFFFFFFF;
+
+		/**
+		 * @brief Constructs an empty tree.
+		 *
+		 * @param bounds World bounds, objects outside of them are kept in the root node
+		 * @param maxDepth Maximum node depth (up to MAX_DEPTH)
+		 */
+		explicit Octree(const AABB& bounds, int maxDepth = 8);
+
+		/**
+		 * @brief Adds an object.
+		 *
+		 * @param position Bounding sphere center
+		 * @param radius Bounding sphere radius
+		 * @return Object id
+		 */
+		unsigned int insert(const Vec3d& position, float radius);
+
+		/**
+		 * @brief Removes an object, its id is reused by later insertions.
+		 */
+		void remove(unsigned int id);
+
+		/**
+		 * @brief Moves an object. Constant time unless the object changes its node.
+		 *
+		 * @param id Object id
+		 * @param position New bounding sphere center
+		 * @param radius New bounding sphere radius
+		 */
+		void move(unsigned int id, const Vec3d& position, float radius);
+
+		/**
+		 * @brief Returns the object position.
+		 */
+		const Vec3d& getPosition(unsigned int id) const;
+
+		/**
+		 * @brief Returns the object radius.
+		 */
+		float getRadius(unsigned int id) const;
+
+		/**
+		 * @brief Returns the number of objects.
+		 */
+		size_t getObjectCount() const;
+
+		/**
+		 * @brief Returns the number of allocated nodes.
+		 */
+		size_t getNodeCount() const;
+
+		/**
+		 * @brief Appends the objects intersecting a sphere.
+		 *
+		 * @param center Sphere center
+		 * @param radius Sphere radius
+		 * @param result Output object ids
+		 */
+		void querySphere(const Vec3d& center, float radius, std::vector<unsigned int>& result) const;
+
+		/**
+		 * @brief Appends the objects intersecting the camera frustum. Nodes entirely inside the
+		 * frustum add all of their objects without testing them.
+		 *
+		 * @param camera Camera
+		 * @param result Output object ids
+		 */
+		void queryFrustum(const Camera& camera, std::vector<unsigned int>& result) const;
+
+		/**
+		 * @brief Appends the objects hit by a ray.
+		 *
+		 * @param origin Ray origin
+		 * @param direction Ray direction (unit length)
+		 * @param maxDistance Maximum hit distance
+		 * @param result Output object ids
+		 */
+		void queryRay(const Vec3d& origin, const Vec3d& direction, float maxDistance, std::vector<unsigned int>& result) const;
+
+	private:
+		struct Node
+		{
+			unsigned int key;
+			unsigned int parent;
+			unsigned int children[8];
+			unsigned int firstObject;
+			unsigned int objectCount;
+		};
+
+		struct Object
+		{
+			Vec3d position;
+			float radius;
+			unsigned int node;
+			unsigned int previous;
+			unsigned int next;
+		};
+
+		unsigned int locate(const Vec3d& position, float radius) const;
+		unsigned int acquireNode(unsigned int key);
+		void link(unsigned int id, unsigned int node);
+		void unlink(unsigned int id);
+		AABB getLooseBounds(unsigned int key) const;
+		void collect(unsigned int node, std::vector<unsigned int>& result) const;
+
+	private:
+		Vec3d origin_;
+		float size_;
+		int maxDepth_;
+		std::vector<Node> nodes_;
+		std::vector<Object> objects_;
+		unsigned int freeNodes_ = INVALID;
+		unsigned int freeObjects_ = INVALID;
+		size_t nodeCount_ = 0;
+		size_t objectCount_ = 0;
+	};
+}
+
+#endif // __RE_MATH_OCTREE__
@@ -0,0 +1,171 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reParallel.h
+// Project:     reMath
+// Description: Definition of task executors and parallel loop helpers for batch kernels
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __RE_MATH_PARALLEL__
+#define __RE_MATH_PARALLEL__
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+namespace re
+{
+	/**
+	 * @brief Size of the per-core cache slice used to split batch work into chunks.
+	 */
+	const size_t PARALLEL_CACHE_SIZE = 256 * 1024;
+
+	/**
+	 * @brief Minimum number of elements worth sending to another thread.
+	 */
+	const size_t PARALLEL_MIN_CHUNK = 1024;
+
+	/**
+	 * @brief Executor interface. Batch kernels dispatch their chunks through the current executor,
+	 * so the application can plug in its own job system instead of the built-in thread pool.
+	 */
+	class Executor
+	{
+	public:
+		/**
+		 * @brief Destructor.
+		 */
+		virtual ~Executor() = default;
+
+		/**
+		 * @brief Returns the number of threads which can execute tasks simultaneously.
+		 */
+		virtual size_t concurrency() const = 0;
+
+		/**
+		 * @brief Runs task(0) ... task(taskCount - 1) and returns when all of them are finished.
+		 * Tasks may run in any order and on any thread, including the calling one.
+		 *
+		 * @param taskCount Number of tasks
+		 * @param task Task body receiving the task index
+		 */
+		virtual void run(size_t taskCount, const std::function<void(size_t)>& task) = 0;
+	};
+
+	/**
+	 * @brief Executor running all the tasks on the calling thread.
+	 */
+	class SerialExecutor : public Executor
+	{
+	public:
+		size_t concurrency() const override;
+		void run(size_t taskCount, const std::function<void(size_t)>& task) override;
+	};
+
+	/**
+	 * @brief Built-in thread pool executor. Idle workers and the calling thread grab the next
+	 * unclaimed task from a shared counter, so uneven chunks are balanced automatically.
+	 * Nested run() calls from inside a task are executed serially on the calling worker.
+	 */
+	class ThreadPool : public Executor
+	{
+	public:
+		/**
+		 * @brief Creates a pool. The calling thread participates in run(), so threadCount - 1
+		 * worker threads are spawned.
+		 *
+		 * @param threadCount Total number of threads (0 - use hardware concurrency)
+		 */
+		explicit ThreadPool(size_t threadCount = 0);
+
+		/**
+		 * @brief Destructor. Stops and joins the worker threads.
+		 */
+		~ThreadPool() override;
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator = (const ThreadPool&) = delete;
+
+		size_t concurrency() const override;
+		void run(size_t taskCount, const std::function<void(size_t)>& task) override;
+
+	private:
+		void workerLoop();
+		void execute(const std::function<void(size_t)>& task, size_t taskCount);
+
+	private:
+		std::vector<std::thread> workers_;
+		std::mutex runMutex_;
+		std::mutex mutex_;
+		std::condition_variable wake_;
+		std::condition_variable done_;
+		const std::function<void(size_t)>* task_ = nullptr;
+		size_t taskCount_ = 0;
+		std::atomic<size_t> nextTask_;
+		std::atomic<size_t> finishedTasks_;
+		size_t activeWorkers_ = 0;
+		size_t generation_ = 0;
+		bool stop_ = false;
+	};
+
+	/**
+	 * @brief Sets the executor used by all batch kernels.
+	 *
+	 * @param executor Executor to use (nullptr - restore the default serial executor)
+	 */
+	void setExecutor(Executor* executor);
+
+	/**
+	 * @brief Returns the executor used by batch kernels.
+	 */
+	Executor& getExecutor();
+
+	/**
+	 * @brief Calculates the number of elements per chunk, so that a chunk fits the per-core cache
+	 * slice while still giving every thread several chunks to balance the load.
+	 *
+	 * @param count Total number of elements
+	 * @param bytesPerElement Number of bytes read and written per element
+	 * @param concurrency Number of threads
+	 * @return Number of elements per chunk
+	 */
+	size_t chunkSize(size_t count, size_t bytesPerElement, size_t concurrency);
+
+	/**
+	 * @brief Splits [0, count) into cache-sized chunks and runs them through the current executor.
+	 * Small inputs run serially on the calling thread.
+	 *
+	 * @param count Number of elements
+	 * @param bytesPerElement Number of bytes read and written per element
+	 * @param body Loop body receiving the [begin, end) range of the chunk
+	 */
+	void parallelFor(size_t count, size_t bytesPerElement, const std::function<void(size_t, size_t)>& body);
+
+	/**
+	 * @brief Stable LSD radix sort of keys with an optional payload. Digit histograms and scatters
+	 * of each pass run in parallel blocks, passes where all keys share the digit are skipped.
+	 * Scratch buffers are taken from the thread-local FrameArena.
+	 *
+	 * @param keys Keys array, sorted in place
+	 * @param values Values array permuted along with the keys (may be nullptr)
+	 * @param count Number of elements
+	 */
+	void radixSort(unsigned int* keys, unsigned int* values, size_t count);
+
+	/**
+	 * @brief Stable LSD radix sort of 64-bit keys with an optional payload.
+	 *
+	 * @param keys Keys array, sorted in place
+	 * @param values Values array permuted along with the keys (may be nullptr)
+	 * @param count Number of elements
+	 */
+	void radixSort(unsigned long long* keys, unsigned int* values, size_t count);
+}
+
+#endif // __RE_MATH_PARALLEL__
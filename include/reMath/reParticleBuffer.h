@@ -0,0 +1,213 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reParticleBuffer.h
+// Project:     reMath
+// Description: Definition of ParticleBuffer class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __RE_MATH_PARTICLE_BUFFER__
+#define __RE_MATH_PARTICLE_BUFFER__
+
+#include "reVec3d.h"
+#include <cstddef>
+#include <vector>
+
+namespace re
+{
+	/**
+	 * @brief Forces and colliders applied by ParticleBuffer::update().
+	 */
+	struct ParticleForces
+	{
+		// Acceleration of every particle.
+		Vec3d gravity = Vec3d(0.f);
+
+		// Linear drag coefficient (per second), velocities decay by exp(-drag * dt).
+		float drag = 0.f;
+
+		// Curl noise acceleration magnitude (0 - off), spatial frequency and time of the noise field.
+		float noiseStrength = 0.f;
+		float noiseFrequency = 1.f;
+		float noiseTime = 0.f;
+
+		// Collision planes, four coefficients (a, b, c, d) each, particles stay on the positive side (may be nullptr).
+		const float* planes = nullptr;
+		size_t planeCount = 0;
+
+		// Spherical obstacles, particles stay outside of them (may be nullptr).
+		const Vec3d* sphereCenters = nullptr;
+		const float* sphereRadii = nullptr;
+		size_t sphereCount = 0;
+
+		// Fraction of the normal velocity kept after a collision and of the tangential velocity removed by it.
+		float restitution = 0.5f;
+		float friction = 0.f;
+	};
+
+	/**
+	 * @brief Particle store with every attribute in its own array (structure of arrays), so that
+	 * the update kernels load four particles per SSE instruction without gathers or Vec3d objects.
+	 * Kernels run over cache-sized chunks split between the threads of the current executor.
+	 * Dead particles stay in place until compact() removes them all in a single pass.
+	 */
+	class ParticleBuffer
+	{
+	public:
+		enum Stream
+		{
+			STREAM_POSITION_X,
+			STREAM_POSITION_Y,
+			STREAM_POSITION_Z,
+			STREAM_VELOCITY_X,
+			STREAM_VELOCITY_Y,
+			STREAM_VELOCITY_Z,
+			STREAM_AGE,
+			STREAM_LIFETIME,
+			STREAM_COUNT
+		};
+
+		/**
+		 * @brief Constructs an empty buffer.
+		 *
+		 * @param capacity Maximum number of particles
+		 */
+		explicit ParticleBuffer(size_t capacity);
+
+		/**
+		 * @brief Returns the number of particles, including the dead ones until compact().
+		 */
+		size_t getCount() const;
+
+		/**
+		 * @brief Returns the maximum number of particles.
+		 */
+		size_t getCapacity() const;
+
+		/**
+		 * @brief Adds a particle of zero age.
+		 *
+		 * @param position Initial position
+		 * @param velocity Initial velocity
+		 * @param color Packed color
+		 * @param lifetime Age at which the particle dies (in seconds)
+		 * @return False if the buffer is full
+		 */
+		bool emit(const Vec3d& position, const Vec3d& velocity, unsigned int color, float lifetime);
+
+		/**
+		 * @brief Removes all particles.
+		 */
+		void clear();
+
+		/**
+		 * @brief Returns the particle position.
+		 */
+		Vec3d getPosition(size_t index) const;
+
+		/**
+		 * @brief Returns the particle velocity.
+		 */
+		Vec3d getVelocity(size_t index) const;
+
+		/**
+		 * @brief Returns the particle color.
+		 */
+		unsigned int getColor(size_t index) const;
+
+		/**
+		 * @brief Returns the particle age.
+		 */
+		float getAge(size_t index) const;
+
+		/**
+		 * @brief Returns an attribute array of all particles (e.g. for rendering).
+		 */
+		const float* getStream(Stream stream) const;
+
+		/**
+		 * @brief Returns the colors array of all particles.
+		 */
+		const unsigned int* getColors() const;
+
+		/**
+		 * @brief Adds a constant acceleration to the velocities.
+		 *
+		 * @param acceleration Acceleration
+		 * @param timeStep Time step (in seconds)
+		 */
+		void applyGravity(const Vec3d& acceleration, float timeStep);
+
+		/**
+		 * @brief Applies linear drag to the velocities.
+		 *
+		 * @param drag Drag coefficient (per second)
+		 * @param timeStep Time step (in seconds)
+		 */
+		void applyDrag(float drag, float timeStep);
+
+		/**
+		 * @brief Accelerates the particles along a divergence-free noise field, the curl of a
+		 * potential built from plane waves in scattered directions. Particles swirl around
+		 * without gathering in sinks or spreading from sources.
+		 *
+		 * @param strength Acceleration magnitude
+		 * @param frequency Spatial frequency of the field
+		 * @param time Field time, the waves travel with it
+		 * @param timeStep Time step (in seconds)
+		 */
+		void applyCurlNoise(float strength, float frequency, float time, float timeStep);
+
+		/**
+		 * @brief Moves the particles by their velocities and ages them.
+		 *
+		 * @param timeStep Time step (in seconds)
+		 */
+		void integrate(float timeStep);
+
+		/**
+		 * @brief Pushes the particles behind a plane back onto it and reflects their velocities.
+		 *
+		 * @param plane Plane coefficients (a, b, c, d) with a unit normal
+		 * @param restitution Fraction of the normal velocity kept
+		 * @param friction Fraction of the tangential velocity removed
+		 */
+		void collidePlane(const float* plane, float restitution, float friction);
+
+		/**
+		 * @brief Pushes the particles inside a sphere out to its surface and reflects their velocities.
+		 *
+		 * @param center Sphere center
+		 * @param radius Sphere radius
+		 * @param restitution Fraction of the normal velocity kept
+		 * @param friction Fraction of the tangential velocity removed
+		 */
+		void collideSphere(const Vec3d& center, float radius, float restitution, float friction);
+
+		/**
+		 * @brief Runs the whole step: gravity, noise, drag, integration and collisions. All kernels
+		 * process a chunk while it is in the cache before moving to the next one.
+		 *
+		 * @param forces Forces and colliders
+		 * @param timeStep Time step (in seconds)
+		 */
+		void update(const ParticleForces& forces, float timeStep);
+
+		/**
+		 * @brief Removes the particles which outlived their lifetime by stream compaction, keeping
+		 * the order of the living ones. Attribute arrays are compacted in parallel.
+		 *
+		 * @return Number of removed particles
+		 */
+		size_t compact();
+
+	private:
+		std::vector<float> streams_[STREAM_COUNT];
+		std::vector<unsigned int> colors_;
+		size_t count_ = 0;
+	};
+}
+
+#endif // __RE_MATH_PARTICLE_BUFFER__
@@ -0,0 +1,182 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        rePlane.h
+// Project:     reMath
+// Description: Definition of Plane class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __RE_MATH_PLANE__
+#define __RE_MATH_PLANE__
+
+#include "reVec3d.h"
+#include <cstddef>
+
+namespace re
+{
+	class Matrix4;
+	class Sphere;
+
+	/**
+	 * @brief Plane of the points with normal.dot(point) + d = 0. Points with a positive signed
+	 * distance are in front of the plane, the same convention as Camera frustum planes use.
+	 */
+	class Plane
+	{
+	public:
+		/**
+		 * @brief Point classification bits, a point set spanning the plane has both of them.
+		 */
+		enum Side
+		{
+			SIDE_ON = 0,
+			SIDE_FRONT = 1,
+			SIDE_BACK = 2,
+			SIDE_SPANNING = SIDE_FRONT | SIDE_BACK
+		};
+
+		/**
+		 * @brief Default constructor. Creates the XZ plane facing +Y.
+		 */
+		Plane();
+
+		/**
+		 * @brief Constructs a plane from its coefficients.
+		 *
+		 * @param normalValue Plane normal
+		 * @param dValue Plane offset, minus the distance of the plane from the origin along the normal
+		 */
+		Plane(const Vec3d& normalValue, float dValue);
+
+		/**
+		 * @brief Constructs a plane through a point.
+		 *
+		 * @param normalValue Plane normal
+		 * @param point Point on the plane
+		 */
+		Plane(const Vec3d& normalValue, const Vec3d& point);
+
+		/**
+		 * @brief Constructs a plane from four (a, b, c, d) coefficients (e.g. Camera::getFrustumPlane()).
+		 */
+		explicit Plane(const float* coefficients);
+
+		/**
+		 * @brief Destructor.
+		 */
+		virtual ~Plane() = default;
+
+		/**
+		 * @brief Creates a normalized plane through three points, facing the side they are
+		 * counter-clockwise from.
+		 *
+		 * @param a First point
+		 * @param b Second point
+		 * @param c Third point
+		 * @return Plane through the points
+		 */
+		static Plane fromPoints(const Vec3d& a, const Vec3d& b, const Vec3d& c);
+
+		/**
+		 * @brief Fits a normalized plane to a point set by least squares. The normal is the
+		 * principal component of the points covariance with the smallest variance.
+		 *
+		 * @param points Points array
+		 * @param count Number of points
+		 * @return Fitted plane through the points centroid
+		 */
+		static Plane fromPoints(const Vec3d* points, size_t count);
+
+		/**
+		 * @brief Scales the plane to a unit normal, so that distances are Euclidean.
+		 */
+		void normalize();
+
+		/**
+		 * @brief Returns the signed distance of a point, in normal length units.
+		 */
+		float distance(const Vec3d& point) const;
+
+		/**
+		 * @brief Returns the closest point on the plane (the plane must be normalized).
+		 */
+		Vec3d project(const Vec3d& point) const;
+
+		/**
+		 * @brief Classifies a point.
+		 *
+		 * @param point Point
+		 * @param epsilon Plane thickness, points closer than it are on the plane
+		 * @return SIDE_FRONT, SIDE_BACK or SIDE_ON
+		 */
+		Side classify(const Vec3d& point, float epsilon = 0.f) const;
+
+		/**
+		 * @brief Classifies a sphere (the plane must be normalized). An empty sphere is classified
+		 * as a point at its center.
+		 *
+		 * @param sphere Sphere
+		 * @return SIDE_FRONT, SIDE_BACK or SIDE_SPANNING if the plane cuts the sphere, SIDE_ON for
+		 * an empty sphere on the plane
+		 */
+		Side classify(const Sphere& sphere) const;
+
+		/**
+		 * @brief Ray plane intersection.
+		 *
+		 * @param origin Ray origin
+		 * @param direction Ray direction
+		 * @param distance Output ray parameter of the hit point
+		 * @return True if the ray hits the plane at a non-negative parameter, False otherwise
+		 */
+		bool intersectsRay(const Vec3d& origin, const Vec3d& direction, float& distance) const;
+
+		/**
+		 * @brief Transforms the plane by an affine matrix and normalizes it. Normals transform by
+		 * the inverse transpose of the matrix, which keeps them perpendicular under non-uniform
+		 * scale and shear.
+		 *
+		 * @param matrix Transformation matrix
+		 */
+		void transform(const Matrix4& matrix);
+
+		/**
+		 * @brief Transforms many planes, the inverse transpose is computed once.
+		 *
+		 * @param matrix Transformation matrix
+		 * @param planes Planes array
+		 * @param count Number of planes
+		 */
+		static void transformN(const Matrix4& matrix, Plane* planes, size_t count);
+
+		/**
+		 * @brief Computes signed distances of many points, four points per SSE iteration in parallel.
+		 *
+		 * @param plane Plane
+		 * @param points Points array
+		 * @param count Number of points
+		 * @param distances Output signed distances, one per point
+		 */
+		static void distanceN(const Plane& plane, const Vec3d* points, size_t count, float* distances);
+
+		/**
+		 * @brief Classifies a point set (e.g. polygon vertices for clipping or BSP splitting),
+		 * four points per SSE iteration. Stops as soon as the set is known to span the plane.
+		 *
+		 * @param plane Plane
+		 * @param points Points array
+		 * @param count Number of points
+		 * @param epsilon Plane thickness, points closer than it are on the plane
+		 * @return Bits of the sides the points are on, SIDE_ON if all of them are on the plane
+		 */
+		static Side classifyN(const Plane& plane, const Vec3d* points, size_t count, float epsilon = 0.f);
+
+	public:
+		Vec3d normal;
+		float d;
+	};
+}
+
+#endif // __RE_MATH_PLANE__
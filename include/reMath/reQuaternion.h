@@ -14,6 +14,7 @@
 namespace re
 {
 	class Vec3d;
+	class Matrix3;
 	class Matrix4;
 
 	// Quaternion Class.
@@ -42,11 +43,24 @@ namespace re
 		void set(const Vec3d& vector);
 
 		// Get quaternion from Euler angles.
-		static Quaternion fromEulers(Vec3d& vector);
+		static Quaternion fromEulers(const Vec3d& vector);
 		static Quaternion fromEulerXRotation(float angle);
 		static Quaternion fromEulerYRotation(float angle);
 		static Quaternion fromEulerZRotation(float angle);
 
+		// Get quaternion from rotation matrix using Shepperd's method (the matrix must be orthonormal, see decompose() otherwise).
+		static Quaternion fromMatrix(const Matrix3& matrix);
+		static Quaternion fromMatrix(const Matrix4& matrix);
+
+		// Get quaternion rotating by angle (in radians) around the normalized axis.
+		static Quaternion fromAxisAngle(const Vec3d& axis, float angle);
+
+		// Get shortest arc quaternion rotating one direction onto another, no trigonometry involved.
+		static Quaternion fromTo(const Vec3d& from, const Vec3d& to);
+
+		// Get quaternion turning -Z axis to forward and Y axis towards up (orientation of a camera set by re::lookAt()).
+		static Quaternion lookRotation(const Vec3d& forward, const Vec3d& up);
+
 		// Calculate the W component when only X, Y, and Z are given.
 		void computeW();
 
@@ -59,12 +73,39 @@ namespace re
 		// Get quaternion magnitutde.
 		float length() const;
 
+		// Get squared quaternion magnitude.
+		float lengthSquared() const;
+
 		// Normalize quaternion.
 		void normalize();
 
+		// Normalize quaternion using the fast reciprocal square root, max length error is 5e-7.
+		void normalizeFast();
+
 		// Negate quaternion.
 		void negate();
 
+		// Conjugate quaternion (inverse rotation of a normalized quaternion).
+		void conjugate();
+
+		// Inverse quaternion.
+		void inverse();
+
+		// Returns conjugated quaternion leaving original intact.
+		Quaternion toConjugated() const;
+
+		// Returns inversed quaternion leaving original intact.
+		Quaternion toInversed() const;
+
+		// Natural logarithm, for a normalized quaternion it is (axis * angle / 2, 0).
+		Quaternion log() const;
+
+		// Exponent, the inverse of log().
+		Quaternion exp() const;
+
+		// Split into swing and twist around the normalized axis, quaternion = swing * twist.
+		void swingTwist(const Vec3d& axis, Quaternion& swing, Quaternion& twist) const;
+
 		// Return the result of Spherical Linear Interpolation between two quaternions scaled by factor.
 		Quaternion slerp(const Quaternion& quaternion, float scale) const;
 
@@ -74,6 +115,11 @@ namespace re
 		// Calculate dot product and return the result.
 		float dot(const Quaternion& quaternion) const;
 
+		// Apply quaternion rotation to a vector without building a matrix (the quaternion must be normalized).
+		void rotate(float& xValue, float& yValue, float& zValue) const;
+		void rotate(float* vector) const;
+		void rotate(Vec3d& vector) const;
+
 
 		// Comparison operators.
 		//----------------------
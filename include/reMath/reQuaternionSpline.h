@@ -0,0 +1,107 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reQuaternionSpline.h
+// Project:     reMath
+// Description: Definition of QuaternionSpline class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __RE_MATH_QUATERNION_SPLINE__
+#define __RE_MATH_QUATERNION_SPLINE__
+
+#include "reQuaternion.h"
+#include <cstddef>
+#include <vector>
+
+namespace re
+{
+	/**
+	 * @brief Smooth rotation curve over a sequence of quaternion keys at uniform times.
+	 * Keys are flipped into one hemisphere and everything that depends only on the keys (SQUAD
+	 * inner quaternions, slerp angles, B-spline rotation deltas) is computed once in the
+	 * constructor, so an evaluation costs a few sines and quaternion products.
+	 */
+	class QuaternionSpline
+	{
+	public:
+		enum Interpolation
+		{
+			// Spherical quadrangle interpolation, C1 continuous and passes through the keys.
+			INTERPOLATION_SQUAD,
+
+			// Cumulative cubic B-spline (Kim, Kim and Shin 1995), C2 continuous and approximates
+			// the keys like a regular B-spline does with its control points.
+			INTERPOLATION_BSPLINE
+		};
+
+		/**
+		 * @brief Constructs a curve from the keys.
+		 *
+		 * @param keys Normalized rotation keys
+		 * @param count Number of keys
+		 * @param interpolation Interpolation type
+		 */
+		QuaternionSpline(const Quaternion* keys, size_t count, Interpolation interpolation = INTERPOLATION_SQUAD);
+
+		/**
+		 * @brief Returns the number of keys.
+		 */
+		size_t getKeyCount() const;
+
+		/**
+		 * @brief Returns the interpolation type.
+		 */
+		Interpolation getInterpolation() const;
+
+		/**
+		 * @brief Evaluates the curve.
+		 *
+		 * @param time Curve parameter, key i is at time i, clamped to [0, key count - 1]
+		 * @return Normalized rotation (identity for an empty curve)
+		 */
+		Quaternion evaluate(float time) const;
+
+		/**
+		 * @brief Evaluates the curve at many times in parallel.
+		 *
+		 * @param times Curve parameters
+		 * @param output Result rotations
+		 * @param count Number of times
+		 */
+		void evaluateN(const float* times, Quaternion* output, size_t count) const;
+
+	private:
+		// Slerp angle of a quaternion pair, a zero inverse sine means lerp for close quaternions.
+		struct Arc
+		{
+			float angle;
+			float inverseSine;
+		};
+
+		// Rotation between consecutive keys as axis and angle, log(key[i - 1]^-1 * key[i]) * 2.
+		struct Delta
+		{
+			float axis[3];
+			float angle;
+		};
+
+		Quaternion evaluateSquad(size_t segment, float fraction) const;
+		Quaternion evaluateBSpline(size_t segment, float fraction) const;
+
+	private:
+		Interpolation interpolation_;
+		std::vector<Quaternion> keys_;
+
+		// SQUAD inner quaternions and slerp arcs between the keys and between the inner quaternions.
+		std::vector<Quaternion> inner_;
+		std::vector<Arc> keyArcs_;
+		std::vector<Arc> innerArcs_;
+
+		// B-spline deltas, deltas_[i] rotates key i - 1 to key i with indices clamped to the keys.
+		std::vector<Delta> deltas_;
+	};
+}
+
+#endif // __RE_MATH_QUATERNION_SPLINE__
@@ -0,0 +1,114 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reSphere.h
+// Project:     reMath
+// Description: Definition of Sphere class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __RE_MATH_SPHERE__
+#define __RE_MATH_SPHERE__
+
+#include "reVec3d.h"
+#include <cstddef>
+
+namespace re
+{
+	class Matrix4;
+
+	/**
+	 * @brief Bounding sphere.
+	 */
+	class Sphere
+	{
+	public:
+		/**
+		 * @brief Default constructor. Creates an empty sphere (negative radius), which any
+		 * expand() call replaces.
+		 */
+		Sphere();
+
+		/**
+		 * @brief Constructs a sphere.
+		 *
+		 * @param centerValue Sphere center
+		 * @param radiusValue Sphere radius
+		 */
+		Sphere(const Vec3d& centerValue, float radiusValue);
+
+		/**
+		 * @brief Destructor.
+		 */
+		virtual ~Sphere() = default;
+
+		/**
+		 * @brief Creates a sphere enclosing the points with Ritter's algorithm: the farthest pair
+		 * of the axis extreme points gives the initial sphere, a second pass grows it to every
+		 * point outside. Linear time, usually 5 - 20% larger than the minimal sphere.
+		 *
+		 * @param points Points array
+		 * @param count Number of points
+		 * @return Bounding sphere
+		 */
+		static Sphere fromPoints(const Vec3d* points, size_t count);
+
+		/**
+		 * @brief Creates the minimal sphere enclosing the points with Welzl's algorithm, in its
+		 * iterative form over the points in random order (expected linear time). Every sphere
+		 * found is defined by up to four points on its boundary.
+		 *
+		 * @param points Points array
+		 * @param count Number of points
+		 * @return Minimal bounding sphere
+		 */
+		static Sphere fromPointsMinimal(const Vec3d* points, size_t count);
+
+		/**
+		 * @brief Checks if the sphere is empty (has a negative radius).
+		 */
+		bool isEmpty() const;
+
+		/**
+		 * @brief Grows the sphere to enclose the point, moving the center towards it by the
+		 * least amount (Ritter's update).
+		 */
+		void expand(const Vec3d& point);
+
+		/**
+		 * @brief Grows the sphere to the smallest sphere enclosing both spheres.
+		 */
+		void expand(const Sphere& sphere);
+
+		/**
+		 * @brief Checks if a point is inside the sphere.
+		 *
+		 * @param point Point to test
+		 * @return True if the point is inside or on the boundary, False otherwise or if the sphere is empty
+		 */
+		bool contains(const Vec3d& point) const;
+
+		/**
+		 * @brief Checks if two spheres intersect. Touching spheres intersect, empty ones never do.
+		 *
+		 * @param sphere Second sphere
+		 * @return True if the spheres intersect, False otherwise
+		 */
+		bool intersects(const Sphere& sphere) const;
+
+		/**
+		 * @brief Transforms the sphere by the matrix. The radius is scaled by the longest matrix
+		 * axis, so the result encloses the transformed sphere under non-uniform scale.
+		 *
+		 * @param matrix Transformation matrix
+		 */
+		void transform(const Matrix4& matrix);
+
+	public:
+		Vec3d center;
+		float radius;
+	};
+}
+
+#endif // __RE_MATH_SPHERE__
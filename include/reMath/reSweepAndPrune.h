@@ -0,0 +1,148 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reSweepAndPrune.h
+// Project:     reMath
+// Description: Definition of SweepAndPrune broad phase class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __RE_MATH_SWEEP_AND_PRUNE__
+#define __RE_MATH_SWEEP_AND_PRUNE__
+
+#include "reAABB.h"
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace re
+{
+	/**
+	 * @brief Sweep-and-prune broad phase.
+	 * Box endpoints are kept sorted along one or three axes. Objects move little between frames,
+	 * so update() re-sorts them with an insertion sort in nearly linear time, and every swap of a
+	 * min and a max endpoint is an overlap change of that pair. Only those changes are reported.
+	 * With one axis the pairs overlapping on it are kept as candidates and checked on all axes
+	 * every update, which is cheaper when the objects are spread along that axis.
+	 * Frames where most objects teleport should call rebuild() instead, which radix sorts the
+	 * endpoints from scratch.
+	 */
+	class SweepAndPrune
+	{
+	public:
+		/**
+		 * @brief Overlapping pair of object ids, first < second.
+		 */
+		struct Pair
+		{
+			unsigned int first;
+			unsigned int second;
+		};
+
+		/**
+		 * @brief Constructs an empty broad phase.
+		 *
+		 * @param axisCount Number of sorted axes, 1 (x only) or 3
+		 */
+		explicit SweepAndPrune(int axisCount = 3);
+
+		/**
+		 * @brief Adds an object. Its pairs are reported by the next update().
+		 *
+		 * @param box Object bounds
+		 * @return Object id
+		 */
+		unsigned int add(const AABB& box);
+
+		/**
+		 * @brief Removes an object. Its pairs are reported as removed by the next update()
+		 * and the id is reused after that.
+		 *
+		 * @param id Object id
+		 */
+		void remove(unsigned int id);
+
+		/**
+		 * @brief Sets new object bounds, taken into account by the next update().
+		 *
+		 * @param id Object id
+		 * @param box Object bounds
+		 */
+		void setBox(unsigned int id, const AABB& box);
+
+		/**
+		 * @brief Returns object bounds.
+		 */
+		const AABB& getBox(unsigned int id) const;
+
+		/**
+		 * @brief Incrementally re-sorts the endpoints and collects the pair changes.
+		 */
+		void update();
+
+		/**
+		 * @brief Re-sorts the endpoints from scratch with the parallel radix sort and collects
+		 * the pair changes. Faster than update() when the order changed a lot.
+		 */
+		void rebuild();
+
+		/**
+		 * @brief Returns the pairs which started overlapping during the last update() or rebuild().
+		 */
+		const std::vector<Pair>& getAddedPairs() const;
+
+		/**
+		 * @brief Returns the pairs which stopped overlapping during the last update() or rebuild().
+		 */
+		const std::vector<Pair>& getRemovedPairs() const;
+
+		/**
+		 * @brief Returns the number of currently overlapping pairs.
+		 */
+		size_t getPairCount() const;
+
+		/**
+		 * @brief Checks if two objects currently overlap.
+		 */
+		bool isOverlapping(unsigned int first, unsigned int second) const;
+
+	private:
+		struct Endpoint
+		{
+			float value;
+
+			// Object id shifted left by one, the lowest bit is set for the max endpoints.
+			unsigned int data;
+		};
+
+		enum State : unsigned char
+		{
+			STATE_FREE,
+			STATE_ACTIVE,
+			STATE_REMOVED
+		};
+
+		void processRemovals();
+		void beginOverlap(unsigned int first, unsigned int second);
+		void endOverlap(unsigned int first, unsigned int second);
+		void checkCandidates();
+
+	private:
+		int axisCount_;
+		std::vector<AABB> boxes_;
+		std::vector<State> states_;
+		std::vector<unsigned int> freeIds_;
+		std::vector<Endpoint> endpoints_[3];
+
+		// Pairs overlapping on the sorted axes, the value is set if they overlap on all axes.
+		std::unordered_map<unsigned long long, bool> pairs_;
+		size_t pairCount_ = 0;
+		bool hasRemovals_ = false;
+
+		std::vector<Pair> added_;
+		std::vector<Pair> removed_;
+	};
+}
+
+#endif // __RE_MATH_SWEEP_AND_PRUNE__
@@ -108,6 +108,13 @@ namespace re
 		 */
 		float length() const;
 
+		/**
+		 * @brief Get squared vector magnitude, cheaper than length() for comparisons.
+		 * 
+		 * @return Squared vector length
+		 */
+		float lengthSquared() const;
+
 		/**
 		 * @brief Calculate absolute distance to another vector.
 		 * 
@@ -116,6 +123,14 @@ namespace re
 		 */
 		float distanceTo(const Vec2d& vector) const;
 
+		/**
+		 * @brief Calculate squared distance to another vector, cheaper than distanceTo() for comparisons.
+		 * 
+		 * @param vector Second vector
+		 * @return Squared distance between two vectors
+		 */
+		float distanceSquaredTo(const Vec2d& vector) const;
+
 		/**
 		 * @brief Parallel vectors check.
 		 * 
@@ -129,6 +144,12 @@ namespace re
 		 */
 		void normalize();
 
+		/**
+		 * @brief Normalize vector using the fast reciprocal square root (see rsqrtFast()).
+		 * The resulting length differs from 1 by at most 5e-7. Denormal lengths take the exact path.
+		 */
+		void normalizeFast();
+
 		/**
 		 * @brief Nagate vector.
 		 */
@@ -41,15 +41,24 @@ namespace re
 		// Get vector magnitutde.
 		float length() const;
 
+		// Get squared vector magnitude, cheaper than length() for comparisons.
+		float lengthSquared() const;
+
 		// Calculate absolute distance to another vector.
 		float distanceTo(const Vec3d& vector) const;
 
+		// Calculate squared distance to another vector, cheaper than distanceTo() for comparisons.
+		float distanceSquaredTo(const Vec3d& vector) const;
+
 		// Parallel vectors check.
 		bool isParallel(const Vec3d& vector) const;
 
 		// Normalize vector
 		void normalize();
 
+		// Normalize vector using the fast reciprocal square root, max length error is 5e-7.
+		void normalizeFast();
+
 		// Nagate vector
 		void negate();
 
@@ -0,0 +1,314 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reVecExpr.h
+// Project:     reMath
+// Description: Opt-in expression templates for fused vector arithmetic
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __RE_MATH_VEC_EXPR__
+#define __RE_MATH_VEC_EXPR__
+
+#include "reVec2d.h"
+#include "reVec3d.h"
+#include "reQuaternion.h"
+#include <cstddef>
+#include <cassert>
+
+namespace re
+{
+	/**
+	 * @brief Lazy expression layer over Vec2d, Vec3d, Quaternion and raw float arrays.
+	 * Arithmetic on expressions only records the operation tree, nothing is computed until the
+	 * expression is assigned, so a chain like a + (b - a) * t compiles into a single fused loop
+	 * without any intermediate vector objects.
+	 *
+	 * Example:
+	 *     re::expr::assign(result, re::expr::ref(a) + (re::expr::ref(b) - re::expr::ref(a)) * t);
+	 */
+	namespace expr
+	{
+		/**
+		 * @brief Dimension value used by expressions which length is only known at runtime.
+		 */
+		const size_t DYNAMIC = 0;
+
+		/**
+		 * @brief Base class of all the expressions (CRTP).
+		 */
+		template <typename E>
+		struct Expression
+		{
+			/**
+			 * @brief Returns the derived expression.
+			 */
+			const E& self() const
+			{
+				return static_cast<const E&>(*this);
+			}
+		};
+
+		/**
+		 * @brief Leaf expression reading components from memory.
+		 */
+		template <size_t N>
+		class Ref : public Expression<Ref<N>>
+		{
+		public:
+			static const size_t dimension = N;
+
+			/**
+			 * @brief Constructs a reference to the data array.
+			 *
+			 * @param data Source data pointer
+			 * @param count Number of elements (only used for dynamic expressions)
+			 */
+			explicit Ref(const float* data, size_t count = N) : data_(data), size_(count) {}
+
+			float operator [] (size_t index) const { return data_[index]; }
+			size_t size() const { return size_; }
+
+		private:
+			const float* data_;
+			size_t size_;
+		};
+
+		/**
+		 * @brief Scalar value broadcast to every component.
+		 */
+		class Scalar : public Expression<Scalar>
+		{
+		public:
+			static const size_t dimension = DYNAMIC;
+
+			explicit Scalar(float value) : value_(value) {}
+
+			float operator [] (size_t) const { return value_; }
+			size_t size() const { return 0; }
+
+		private:
+			float value_;
+		};
+
+		/**
+		 * @brief Component-wise operation functors.
+		 */
+		struct Add { static float apply(float a, float b) { return a + b; } };
+		struct Sub { static float apply(float a, float b) { return a - b; } };
+		struct Mul { static float apply(float a, float b) { return a * b; } };
+		struct Div { static float apply(float a, float b) { return a / b; } };
+
+		/**
+		 * @brief Component-wise binary operation of two expressions.
+		 */
+		template <typename L, typename R, typename Op>
+		class Binary : public Expression<Binary<L, R, Op>>
+		{
+		public:
+			static_assert(L::dimension == R::dimension || L::dimension == DYNAMIC || R::dimension == DYNAMIC,
+				"Expression dimensions mismatch");
+
+			static const size_t dimension = L::dimension != DYNAMIC ? L::dimension : R::dimension;
+
+			Binary(const L& left, const R& right) : left_(left), right_(right) {}
+
+			float operator [] (size_t index) const { return Op::apply(left_[index], right_[index]); }
+			size_t size() const { return left_.size() ? left_.size() : right_.size(); }
+
+		private:
+			const L left_;
+			const R right_;
+		};
+
+		/**
+		 * @brief Component-wise negation of an expression.
+		 */
+		template <typename E>
+		class Negate : public Expression<Negate<E>>
+		{
+		public:
+			static const size_t dimension = E::dimension;
+
+			explicit Negate(const E& expression) : expression_(expression) {}
+
+			float operator [] (size_t index) const { return -expression_[index]; }
+			size_t size() const { return expression_.size(); }
+
+		private:
+			const E expression_;
+		};
+
+		// Leaf constructors.
+		//-------------------
+
+		/**
+		 * @brief Wraps a 2D vector into an expression.
+		 */
+		inline Ref<2> ref(const Vec2d& vector) { return Ref<2>(vector.d); }
+
+		/**
+		 * @brief Wraps a 3D vector into an expression.
+		 */
+		inline Ref<3> ref(const Vec3d& vector) { return Ref<3>(vector.d); }
+
+		/**
+		 * @brief Wraps a quaternion into a 4-component expression.
+		 */
+		inline Ref<4> ref(const Quaternion& quaternion) { return Ref<4>(quaternion.d); }
+
+		/**
+		 * @brief Wraps a float array (e.g. a single component stream of a SoA buffer) into an expression.
+		 *
+		 * @param data Source array pointer
+		 * @param count Number of elements in the array
+		 */
+		inline Ref<DYNAMIC> stream(const float* data, size_t count) { return Ref<DYNAMIC>(data, count); }
+
+		// Arithmetic operators.
+		//----------------------
+
+		template <typename L, typename R>
+		Binary<L, R, Add> operator + (const Expression<L>& left, const Expression<R>& right)
+		{
+			return Binary<L, R, Add>(left.self(), right.self());
+		}
+
+		template <typename L, typename R>
+		Binary<L, R, Sub> operator - (const Expression<L>& left, const Expression<R>& right)
+		{
+			return Binary<L, R, Sub>(left.self(), right.self());
+		}
+
+		template <typename L, typename R>
+		Binary<L, R, Mul> operator * (const Expression<L>& left, const Expression<R>& right)
+		{
+			return Binary<L, R, Mul>(left.self(), right.self());
+		}
+
+		template <typename L>
+		Binary<L, Scalar, Mul> operator * (const Expression<L>& left, float value)
+		{
+			return Binary<L, Scalar, Mul>(left.self(), Scalar(value));
+		}
+
+		template <typename R>
+		Binary<Scalar, R, Mul> operator * (float value, const Expression<R>& right)
+		{
+			return Binary<Scalar, R, Mul>(Scalar(value), right.self());
+		}
+
+		template <typename L>
+		Binary<L, Scalar, Div> operator / (const Expression<L>& left, float value)
+		{
+			return Binary<L, Scalar, Div>(left.self(), Scalar(value));
+		}
+
+		template <typename L>
+		Binary<L, Scalar, Add> operator + (const Expression<L>& left, float value)
+		{
+			return Binary<L, Scalar, Add>(left.self(), Scalar(value));
+		}
+
+		template <typename L>
+		Binary<L, Scalar, Sub> operator - (const Expression<L>& left, float value)
+		{
+			return Binary<L, Scalar, Sub>(left.self(), Scalar(value));
+		}
+
+		template <typename E>
+		Negate<E> operator - (const Expression<E>& expression)
+		{
+			return Negate<E>(expression.self());
+		}
+
+		/**
+		 * @brief Linear interpolation expression: a + (b - a) * t.
+		 */
+		template <typename A, typename B>
+		auto lerp(const Expression<A>& a, const Expression<B>& b, float t) -> decltype(a + (b - a) * t)
+		{
+			return a + (b - a) * t;
+		}
+
+		// Evaluation.
+		//------------
+
+		/**
+		 * @brief Evaluates the expression into the destination array in a single pass.
+		 *
+		 * @param destination Destination components
+		 * @param count Number of components to evaluate
+		 * @param expression Expression to evaluate
+		 */
+		template <typename E>
+		void assign(float* destination, size_t count, const Expression<E>& expression)
+		{
+			const E& e = expression.self();
+			assert(!e.size() || e.size() >= count);
+
+			for (size_t i = 0; i < count; ++i)
+				destination[i] = e[i];
+		}
+
+		/**
+		 * @brief Evaluates the expression into a 2D vector.
+		 */
+		template <typename E>
+		void assign(Vec2d& destination, const Expression<E>& expression)
+		{
+			static_assert(E::dimension == 2, "Expression is not two-dimensional");
+			assign(destination.d, 2, expression);
+		}
+
+		/**
+		 * @brief Evaluates the expression into a 3D vector.
+		 */
+		template <typename E>
+		void assign(Vec3d& destination, const Expression<E>& expression)
+		{
+			static_assert(E::dimension == 3, "Expression is not three-dimensional");
+			assign(destination.d, 3, expression);
+		}
+
+		/**
+		 * @brief Evaluates the expression into a quaternion.
+		 */
+		template <typename E>
+		void assign(Quaternion& destination, const Expression<E>& expression)
+		{
+			static_assert(E::dimension == 4, "Expression is not four-dimensional");
+			assign(destination.d, 4, expression);
+		}
+
+		/**
+		 * @brief Evaluates the expression into a new object of type T (Vec2d, Vec3d or Quaternion).
+		 */
+		template <typename T, typename E>
+		T evaluate(const Expression<E>& expression)
+		{
+			T result;
+			assign(result, expression);
+			return result;
+		}
+
+		/**
+		 * @brief Calculates the dot product of two expressions without materializing them.
+		 */
+		template <typename L, typename R>
+		float dot(const Expression<L>& left, const Expression<R>& right)
+		{
+			static_assert(L::dimension != DYNAMIC || R::dimension != DYNAMIC, "Dot product requires a fixed dimension");
+			const size_t count = L::dimension != DYNAMIC ? L::dimension : R::dimension;
+
+			float result = 0;
+			for (size_t i = 0; i < count; ++i)
+				result += left.self()[i] * right.self()[i];
+
+			return result;
+		}
+	}
+}
+
+#endif // __RE_MATH_VEC_EXPR__
@@ -0,0 +1,156 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reAABB.cpp
+// Project:     reMath
+// Description: Implementation of AABB (axis-aligned bounding box) class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "reMath/reAABB.h"
+#include "reMath/reMatrix4.h"
+#include <cfloat>
+#include <cmath>
+
+re::AABB::AABB() :
+	min(FLT_MAX, FLT_MAX, FLT_MAX),
+	max(-FLT_MAX, -FLT_MAX, -FLT_MAX)
+{
+}
+
+
+re::AABB::AABB(const Vec3d& minValue, const Vec3d& maxValue) :
+	min(minValue),
+	max(maxValue)
+{
+}
+
+
+re::AABB re::AABB::fromPoints(const Vec3d* points, size_t count)
+{
+	AABB result;
+
+	for (size_t i = 0; i < count; i++)
+		result.expand(points[i]);
+
+	return result;
+}
+
+
+bool re::AABB::isEmpty() const
+{
+	return min.x > max.x || min.y > max.y || min.z > max.z;
+}
+
+
+void re::AABB::expand(const Vec3d& point)
+{
+	for (int i = 0; i < 3; i++)
+	{
+		min.d[i] = point.d[i] < min.d[i] ? point.d[i] : min.d[i];
+		max.d[i] = point.d[i] > max.d[i] ? point.d[i] : max.d[i];
+	}
+}
+
+
+void re::AABB::expand(const AABB& box)
+{
+	for (int i = 0; i < 3; i++)
+	{
+		min.d[i] = box.min.d[i] < min.d[i] ? box.min.d[i] : min.d[i];
+		max.d[i] = box.max.d[i] > max.d[i] ? box.max.d[i] : max.d[i];
+	}
+}
+
+
+re::Vec3d re::AABB::getCenter() const
+{
+	return (min + max) * 0.5f;
+}
+
+
+re::Vec3d re::AABB::getExtents() const
+{
+	return (max - min) * 0.5f;
+}
+
+
+float re::AABB::getSurfaceArea() const
+{
+	if (isEmpty())
+		return 0.f;
+
+	const Vec3d size = max - min;
+	return 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+
+bool re::AABB::contains(const Vec3d& point) const
+{
+	return point.x >= min.x && point.x <= max.x &&
+		point.y >= min.y && point.y <= max.y &&
+		point.z >= min.z && point.z <= max.z;
+}
+
+
+bool re::AABB::overlaps(const AABB& box) const
+{
+	return min.x <= box.max.x && max.x >= box.min.x &&
+		min.y <= box.max.y && max.y >= box.min.y &&
+		min.z <= box.max.z && max.z >= box.min.z;
+}
+
+
+bool re::AABB::intersectsRay(const Vec3d& origin, const Vec3d& inverseDirection, float maxDistance, float& distance) const
+{
+	float enter = 0.f;
+	float leave = maxDistance;
+
+	for (int i = 0; i < 3; i++)
+	{
+		float t0 = (min.d[i] - origin.d[i]) * inverseDirection.d[i];
+		float t1 = (max.d[i] - origin.d[i]) * inverseDirection.d[i];
+
+		if (t0 > t1)
+		{
+			const float t = t0;
+			t0 = t1;
+			t1 = t;
+		}
+
+		// Written so that NaN from a zero direction on the slab boundary keeps the old bounds.
+		enter = t0 > enter ? t0 : enter;
+		leave = t1 < leave ? t1 : leave;
+
+		if (enter > leave)
+			return false;
+	}
+
+	distance = enter;
+	return true;
+}
+
+
+void re::AABB::transform(const Matrix4& matrix)
+{
+	if (isEmpty())
+		return;
+
+	// Arvo's method: every matrix element adds its smallest and largest contribution.
+	const Vec3d oldMin(min);
+	const Vec3d oldMax(max);
+
+	for (int i = 0; i < 3; i++)
+	{
+		min.d[i] = max.d[i] = matrix[12 + i];
+
+		for (int j = 0; j < 3; j++)
+		{
+			const float a = matrix[j * 4 + i] * oldMin.d[j];
+			const float b = matrix[j * 4 + i] * oldMax.d[j];
+			min.d[i] += a < b ? a : b;
+			max.d[i] += a < b ? b : a;
+		}
+	}
+}
@@ -0,0 +1,451 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reBatch.cpp
+// Project:     reMath
+// Description: Implementation of batch math kernels operating on arrays
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "reMath/reBatch.h"
+#include "reMath/reVec3d.h"
+#include "reMath/reMatrix3.h"
+#include "reMath/reMatrix4.h"
+#include "reMath/reQuaternion.h"
+#include "reMath/reParallel.h"
+#include "reMath/reFrameArena.h"
+#include "reMath/reMathUtil.h"
+#include "reSimd.h"
+#include <cfloat>
+#include <cmath>
+
+#ifdef RE_MATH_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+#ifdef RE_MATH_SSE
+	using namespace re::simd;
+#endif
+
+	// Shared by the Matrix3 and Matrix4 conversions, Stride is the matrix column size.
+	template <int Stride, typename Matrix>
+	void toQuaternions(const Matrix* matrices, re::Quaternion* output, size_t count)
+	{
+		re::parallelFor(count, sizeof(Matrix) + sizeof(re::Quaternion), [=](size_t begin, size_t end)
+		{
+			size_t i = begin;
+
+#ifdef RE_MATH_SSE
+			for (; i + 4 <= end; i += 4)
+			{
+				// Element (row, column) of four matrices in one register.
+				const float* data[4];
+
+				for (int lane = 0; lane < 4; lane++)
+					data[lane] = static_cast<const float*>(matrices[i + lane]);
+
+				const auto element = [&data](int row, int column)
+				{
+					const int index = column * Stride + row;
+					return _mm_setr_ps(data[0][index], data[1][index], data[2][index], data[3][index]);
+				};
+
+				const __m128 m00 = element(0, 0);
+				const __m128 m11 = element(1, 1);
+				const __m128 m22 = element(2, 2);
+				const __m128 m01 = element(0, 1);
+				const __m128 m10 = element(1, 0);
+				const __m128 m02 = element(0, 2);
+				const __m128 m20 = element(2, 0);
+				const __m128 m12 = element(1, 2);
+				const __m128 m21 = element(2, 1);
+
+				const __m128 a = _mm_sub_ps(m21, m12);
+				const __m128 b = _mm_sub_ps(m02, m20);
+				const __m128 c = _mm_sub_ps(m10, m01);
+				const __m128 d = _mm_add_ps(m01, m10);
+				const __m128 e = _mm_add_ps(m02, m20);
+				const __m128 f = _mm_add_ps(m12, m21);
+
+				// Same case order as the scalar version: w, x, y, z, the first largest wins.
+				const __m128 traceW = _mm_add_ps(_mm_add_ps(m00, m11), m22);
+				const __m128 traceX = _mm_sub_ps(_mm_sub_ps(m00, m11), m22);
+				const __m128 traceY = _mm_sub_ps(_mm_sub_ps(m11, m00), m22);
+				const __m128 traceZ = _mm_sub_ps(_mm_sub_ps(m22, m00), m11);
+
+				const __m128 one = _mm_set1_ps(1.f);
+				__m128 largest = traceW;
+				__m128 x = a, y = b, z = c, w = _mm_add_ps(one, traceW);
+
+				Mask4 mask{ _mm_cmpgt_ps(traceX, largest) };
+				largest = select(mask, traceX, largest).v;
+				x = select(mask, _mm_add_ps(one, traceX), x).v;
+				y = select(mask, d, y).v;
+				z = select(mask, e, z).v;
+				w = select(mask, a, w).v;
+
+				mask.m = _mm_cmpgt_ps(traceY, largest);
+				largest = select(mask, traceY, largest).v;
+				x = select(mask, d, x).v;
+				y = select(mask, _mm_add_ps(one, traceY), y).v;
+				z = select(mask, f, z).v;
+				w = select(mask, b, w).v;
+
+				mask.m = _mm_cmpgt_ps(traceZ, largest);
+				largest = select(mask, traceZ, largest).v;
+				x = select(mask, e, x).v;
+				y = select(mask, f, y).v;
+				z = select(mask, _mm_add_ps(one, traceZ), z).v;
+				w = select(mask, c, w).v;
+
+				const __m128 scale = _mm_div_ps(_mm_set1_ps(0.5f), _mm_sqrt_ps(_mm_add_ps(one, largest)));
+				x = _mm_mul_ps(x, scale);
+				y = _mm_mul_ps(y, scale);
+				z = _mm_mul_ps(z, scale);
+				w = _mm_mul_ps(w, scale);
+
+				const __m128 length = rsqrtFast4(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)),
+					_mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w))));
+				x = _mm_mul_ps(x, length);
+				y = _mm_mul_ps(y, length);
+				z = _mm_mul_ps(z, length);
+				w = _mm_mul_ps(w, length);
+
+				_MM_TRANSPOSE4_PS(x, y, z, w);
+				_mm_storeu_ps(output[i].d, x);
+				_mm_storeu_ps(output[i + 1].d, y);
+				_mm_storeu_ps(output[i + 2].d, z);
+				_mm_storeu_ps(output[i + 3].d, w);
+			}
+#endif
+
+			for (; i < end; i++)
+				output[i] = re::Quaternion::fromMatrix(matrices[i]);
+		});
+	}
+}
+
+
+void re::transformN(const Matrix4& matrix, Vec3d* points, size_t count)
+{
+	transformN(matrix, points, points, count);
+}
+
+
+void re::transformN(const Matrix4& matrix, const Vec3d* input, Vec3d* output, size_t count)
+{
+	const auto* m = static_cast<const float*>(matrix);
+
+	parallelFor(count, sizeof(Vec3d) * 2, [=](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			const float x = input[i].x;
+			const float y = input[i].y;
+			const float z = input[i].z;
+			output[i].x = x * m[0] + y * m[4] + z * m[8] + m[12];
+			output[i].y = x * m[1] + y * m[5] + z * m[9] + m[13];
+			output[i].z = x * m[2] + y * m[6] + z * m[10] + m[14];
+		}
+	});
+}
+
+
+re::Vec3d* re::transformN(const Matrix4& matrix, const Vec3d* input, size_t count, FrameArena& arena)
+{
+	Vec3d* output = arena.allocate<Vec3d>(count);
+	transformN(matrix, input, output, count);
+	return output;
+}
+
+
+void re::normalizeN(Vec3d* vectors, size_t count)
+{
+	parallelFor(count, sizeof(Vec3d), [=](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+			vectors[i].normalize();
+	});
+}
+
+
+void re::normalizeFastN(Vec3d* vectors, size_t count)
+{
+	parallelFor(count, sizeof(Vec3d), [=](size_t begin, size_t end)
+	{
+		size_t i = begin;
+
+#ifdef RE_MATH_SSE
+		for (; i + 4 <= end; i += 4)
+		{
+			__m128 x, y, z;
+			load4(vectors + i, x, y, z);
+			const __m128 squared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+
+			// Zero and denormal lengths are rare, the scalar path normalizes them exactly.
+			if (_mm_movemask_ps(_mm_cmplt_ps(squared, _mm_set1_ps(FLT_MIN))))
+			{
+				for (size_t j = i; j < i + 4; j++)
+					vectors[j].normalizeFast();
+
+				continue;
+			}
+
+			const __m128 scale = rsqrtFast4(squared);
+			store4(_mm_mul_ps(x, scale), _mm_mul_ps(y, scale), _mm_mul_ps(z, scale), vectors + i);
+		}
+#endif
+
+		for (; i < end; i++)
+			vectors[i].normalizeFast();
+	});
+}
+
+
+void re::normalizeN(Quaternion* quaternions, size_t count)
+{
+	parallelFor(count, sizeof(Quaternion), [=](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+			quaternions[i].normalize();
+	});
+}
+
+
+void re::normalizeFastN(Quaternion* quaternions, size_t count)
+{
+	parallelFor(count, sizeof(Quaternion), [=](size_t begin, size_t end)
+	{
+		size_t i = begin;
+
+#ifdef RE_MATH_SSE
+		for (; i + 4 <= end; i += 4)
+		{
+			// Transpose four quaternions into component registers.
+			Quaternion* q = quaternions + i;
+			__m128 x = _mm_loadu_ps(q[0].d);
+			__m128 y = _mm_loadu_ps(q[1].d);
+			__m128 z = _mm_loadu_ps(q[2].d);
+			__m128 w = _mm_loadu_ps(q[3].d);
+			_MM_TRANSPOSE4_PS(x, y, z, w);
+
+			const __m128 squared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)),
+				_mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w)));
+
+			// Zero quaternions become identity and denormal lengths are normalized exactly, both
+			// on the scalar path.
+			if (_mm_movemask_ps(_mm_cmplt_ps(squared, _mm_set1_ps(FLT_MIN))))
+			{
+				for (size_t j = 0; j < 4; j++)
+					q[j].normalizeFast();
+
+				continue;
+			}
+
+			const __m128 scale = rsqrtFast4(squared);
+			x = _mm_mul_ps(x, scale);
+			y = _mm_mul_ps(y, scale);
+			z = _mm_mul_ps(z, scale);
+			w = _mm_mul_ps(w, scale);
+
+			_MM_TRANSPOSE4_PS(x, y, z, w);
+			_mm_storeu_ps(q[0].d, x);
+			_mm_storeu_ps(q[1].d, y);
+			_mm_storeu_ps(q[2].d, z);
+			_mm_storeu_ps(q[3].d, w);
+		}
+#endif
+
+		for (; i < end; i++)
+			quaternions[i].normalizeFast();
+	});
+}
+
+
+void re::slerpN(const Quaternion* from, const Quaternion* to, float scale, Quaternion* output, size_t count)
+{
+	parallelFor(count, sizeof(Quaternion) * 3, [=](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+			output[i] = from[i].slerp(to[i], scale);
+	});
+}
+
+
+void re::toQuaternionN(const Matrix3* matrices, Quaternion* output, size_t count)
+{
+	toQuaternions<3>(matrices, output, count);
+}
+
+
+void re::toQuaternionN(const Matrix4* matrices, Quaternion* output, size_t count)
+{
+	toQuaternions<4>(matrices, output, count);
+}
+
+
+void re::rotateN(const Quaternion& rotation, Vec3d* vectors, size_t count)
+{
+	const Quaternion q(rotation);
+
+	parallelFor(count, sizeof(Vec3d), [=](size_t begin, size_t end)
+	{
+		size_t i = begin;
+
+#ifdef RE_MATH_SSE
+		const __m128 qx = _mm_set1_ps(q.x);
+		const __m128 qy = _mm_set1_ps(q.y);
+		const __m128 qz = _mm_set1_ps(q.z);
+		const __m128 qw = _mm_set1_ps(q.w);
+
+		for (; i + 4 <= end; i += 4)
+		{
+			__m128 x, y, z;
+			load4(vectors + i, x, y, z);
+			rotate4(qx, qy, qz, qw, x, y, z);
+			store4(x, y, z, vectors + i);
+		}
+#endif
+
+		for (; i < end; i++)
+			q.rotate(vectors[i]);
+	});
+}
+
+
+void re::rotateN(const Quaternion* rotations, Vec3d* vectors, size_t count)
+{
+	parallelFor(count, sizeof(Vec3d) + sizeof(Quaternion), [=](size_t begin, size_t end)
+	{
+		size_t i = begin;
+
+#ifdef RE_MATH_SSE
+		for (; i + 4 <= end; i += 4)
+		{
+			const Quaternion* q = rotations + i;
+			__m128 qx = _mm_loadu_ps(q[0].d);
+			__m128 qy = _mm_loadu_ps(q[1].d);
+			__m128 qz = _mm_loadu_ps(q[2].d);
+			__m128 qw = _mm_loadu_ps(q[3].d);
+			_MM_TRANSPOSE4_PS(qx, qy, qz, qw);
+
+			__m128 x, y, z;
+			load4(vectors + i, x, y, z);
+			rotate4(qx, qy, qz, qw, x, y, z);
+			store4(x, y, z, vectors + i);
+		}
+#endif
+
+		for (; i < end; i++)
+			rotations[i].rotate(vectors[i]);
+	});
+}
+
+
+void re::fromToN(const Vec3d* from, const Vec3d* to, Quaternion* output, size_t count)
+{
+	parallelFor(count, sizeof(Vec3d) * 2 + sizeof(Quaternion), [=](size_t begin, size_t end)
+	{
+		size_t i = begin;
+
+#ifdef RE_MATH_SSE
+		for (; i + 4 <= end; i += 4)
+		{
+			__m128 fx, fy, fz, tx, ty, tz;
+			load4(from + i, fx, fy, fz);
+			load4(to + i, tx, ty, tz);
+
+			const __m128 lengths = _mm_sqrt_ps(_mm_mul_ps(
+				_mm_add_ps(_mm_add_ps(_mm_mul_ps(fx, fx), _mm_mul_ps(fy, fy)), _mm_mul_ps(fz, fz)),
+				_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, tx), _mm_mul_ps(ty, ty)), _mm_mul_ps(tz, tz))));
+			const __m128 cosine = _mm_add_ps(_mm_add_ps(_mm_mul_ps(fx, tx), _mm_mul_ps(fy, ty)), _mm_mul_ps(fz, tz));
+			__m128 w = _mm_add_ps(cosine, lengths);
+
+			// Opposite directions turn around a perpendicular axis, picked as in Quaternion::fromTo().
+			const Mask4 opposite{ _mm_cmple_ps(w, _mm_mul_ps(lengths, _mm_set1_ps(0.000001f))) };
+			const __m128 sign = _mm_set1_ps(-0.f);
+			const Mask4 useZ{ _mm_cmpgt_ps(_mm_andnot_ps(sign, fx), _mm_andnot_ps(sign, fz)) };
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 perpendicularX = select(useZ, _mm_xor_ps(fy, sign), zero).v;
+			const __m128 perpendicularY = select(useZ, fx, _mm_xor_ps(fz, sign)).v;
+			const __m128 perpendicularZ = select(useZ, zero, fy).v;
+
+			__m128 x = select(opposite, perpendicularX, _mm_sub_ps(_mm_mul_ps(fy, tz), _mm_mul_ps(fz, ty))).v;
+			__m128 y = select(opposite, perpendicularY, _mm_sub_ps(_mm_mul_ps(fz, tx), _mm_mul_ps(fx, tz))).v;
+			__m128 z = select(opposite, perpendicularZ, _mm_sub_ps(_mm_mul_ps(fx, ty), _mm_mul_ps(fy, tx))).v;
+			w = _mm_andnot_ps(opposite.m, w);
+
+			// Zero length input gives identity, same as normalize().
+			const __m128 squared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)),
+				_mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w)));
+			const __m128 scale = rsqrtFast4(squared);
+			x = _mm_mul_ps(x, scale);
+			y = _mm_mul_ps(y, scale);
+			z = _mm_mul_ps(z, scale);
+			w = _mm_or_ps(_mm_mul_ps(w, scale), _mm_and_ps(_mm_cmplt_ps(squared, _mm_set1_ps(FLT_MIN)), _mm_set1_ps(1.f)));
+
+			_MM_TRANSPOSE4_PS(x, y, z, w);
+			_mm_storeu_ps(output[i].d, x);
+			_mm_storeu_ps(output[i + 1].d, y);
+			_mm_storeu_ps(output[i + 2].d, z);
+			_mm_storeu_ps(output[i + 3].d, w);
+		}
+#endif
+
+		for (; i < end; i++)
+			output[i] = Quaternion::fromTo(from[i], to[i]);
+	});
+}
+
+
+void re::fromAxisAngleN(const Vec3d* axes, const float* angles, Quaternion* output, size_t count)
+{
+	parallelFor(count, sizeof(Vec3d) + sizeof(float) + sizeof(Quaternion), [=](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+			output[i] = Quaternion::fromAxisAngle(axes[i], angles[i]);
+	});
+}
+
+
+void re::computeNormals(const Vec3d* vertices, size_t vertexCount, const unsigned int* indices, size_t triangleCount, Vec3d* normals)
+{
+	FrameArena& scratch = FrameArena::threadLocal();
+	const auto marker = scratch.mark();
+	computeNormals(vertices, vertexCount, indices, triangleCount, normals, scratch);
+	scratch.rewind(marker);
+}
+
+
+void re::computeNormals(const Vec3d* vertices, size_t vertexCount, const unsigned int* indices, size_t triangleCount, Vec3d* normals, FrameArena& scratch)
+{
+	// Face normals are independent and computed in parallel, their length is twice the triangle area.
+	Vec3d* faces = scratch.allocate<Vec3d>(triangleCount);
+
+	parallelFor(triangleCount, sizeof(unsigned int) * 3 + sizeof(Vec3d) * 4, [=](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			const Vec3d& a = vertices[indices[i * 3]];
+			const Vec3d& b = vertices[indices[i * 3 + 1]];
+			const Vec3d& c = vertices[indices[i * 3 + 2]];
+			faces[i] = (b - a).cross(c - a);
+		}
+	});
+
+	// Scattering to the shared vertices is cheap and stays serial to avoid write conflicts.
+	for (size_t i = 0; i < vertexCount; i++)
+		normals[i].set(0.f);
+
+	for (size_t i = 0; i < triangleCount; i++)
+	{
+		normals[indices[i * 3]] += faces[i];
+		normals[indices[i * 3 + 1]] += faces[i];
+		normals[indices[i * 3 + 2]] += faces[i];
+	}
+
+	normalizeN(normals, vertexCount);
+}
@@ -0,0 +1,379 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reCamera.cpp
+// Project:     reMath
+// Description: Implementation of Camera class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "reMath/reCamera.h"
+#include "reMath/reMathUtil.h"
+#include <cmath>
+
+namespace
+{
+	// Cached values, each flag also invalidates everything computed from it.
+	const unsigned int DIRTY_VIEW = 1 << 0;
+	const unsigned int DIRTY_PROJECTION = 1 << 1;
+	const unsigned int DIRTY_VIEW_PROJECTION = 1 << 2;
+	const unsigned int DIRTY_INVERSE_VIEW = 1 << 3;
+	const unsigned int DIRTY_INVERSE_PROJECTION = 1 << 4;
+	const unsigned int DIRTY_INVERSE_VIEW_PROJECTION = 1 << 5;
+	const unsigned int DIRTY_FRUSTUM = 1 << 6;
+
+	const unsigned int DIRTY_VIEW_DEPENDENT = DIRTY_VIEW | DIRTY_VIEW_PROJECTION | DIRTY_INVERSE_VIEW |
+		DIRTY_INVERSE_VIEW_PROJECTION | DIRTY_FRUSTUM;
+	const unsigned int DIRTY_PROJECTION_DEPENDENT = DIRTY_PROJECTION | DIRTY_VIEW_PROJECTION | DIRTY_INVERSE_PROJECTION |
+		DIRTY_INVERSE_VIEW_PROJECTION | DIRTY_FRUSTUM;
+	const unsigned int DIRTY_ALL = DIRTY_VIEW_DEPENDENT | DIRTY_PROJECTION_DEPENDENT;
+
+	// Full 4x4 product, Matrix4 multiplication operator assumes an affine right-hand matrix.
+	void multiply(const re::Matrix4& left, const re::Matrix4& right, re::Matrix4& result)
+	{
+		for (int column = 0; column < 4; column++)
+			for (int row = 0; row < 4; row++)
+				result[column * 4 + row] =
+					left[row] * right[column * 4] +
+					left[4 + row] * right[column * 4 + 1] +
+					left[8 + row] * right[column * 4 + 2] +
+					left[12 + row] * right[column * 4 + 3];
+	}
+}
+
+
+re::Camera::Camera() :
+	eye_(0.f, 0.f, 0.f),
+	target_(0.f, 0.f, -1.f),
+	up_(0.f, 1.f, 0.f),
+	fovy_(45.f),
+	aspect_(1.f),
+	near_(0.1f),
+	far_(10000.f),
+	depthMode_(DEPTH_STANDARD),
+	dirty_(DIRTY_ALL)
+{
+}
+
+
+void re::Camera::lookAt(const Vec3d& eye, const Vec3d& target, const Vec3d& up)
+{
+	eye_ = eye;
+	target_ = target;
+	up_ = up;
+	invalidate(DIRTY_VIEW_DEPENDENT);
+}
+
+
+void re::Camera::setEye(const Vec3d& eye)
+{
+	eye_ = eye;
+	invalidate(DIRTY_VIEW_DEPENDENT);
+}
+
+
+void re::Camera::setTarget(const Vec3d& target)
+{
+	target_ = target;
+	invalidate(DIRTY_VIEW_DEPENDENT);
+}
+
+
+void re::Camera::setUp(const Vec3d& up)
+{
+	up_ = up;
+	invalidate(DIRTY_VIEW_DEPENDENT);
+}
+
+
+void re::Camera::setPerspective(float fovy, float aspect, float zNear, float zFar)
+{
+	fovy_ = fovy;
+	aspect_ = aspect;
+	near_ = zNear;
+	far_ = zFar;
+	invalidate(DIRTY_PROJECTION_DEPENDENT);
+}
+
+
+void re::Camera::setFov(float fovy)
+{
+	fovy_ = fovy;
+	invalidate(DIRTY_PROJECTION_DEPENDENT);
+}
+
+
+void re::Camera::setAspect(float aspect)
+{
+	aspect_ = aspect;
+	invalidate(DIRTY_PROJECTION_DEPENDENT);
+}
+
+
+void re::Camera::setClipPlanes(float zNear, float zFar)
+{
+	near_ = zNear;
+	far_ = zFar;
+	invalidate(DIRTY_PROJECTION_DEPENDENT);
+}
+
+
+void re::Camera::setDepthMode(DepthMode mode)
+{
+	depthMode_ = mode;
+	invalidate(DIRTY_PROJECTION_DEPENDENT);
+}
+
+
+const re::Vec3d& re::Camera::getEye() const
+{
+	return eye_;
+}
+
+
+const re::Vec3d& re::Camera::getTarget() const
+{
+	return target_;
+}
+
+
+const re::Vec3d& re::Camera::getUp() const
+{
+	return up_;
+}
+
+
+float re::Camera::getFov() const
+{
+	return fovy_;
+}
+
+
+float re::Camera::getAspect() const
+{
+	return aspect_;
+}
+
+
+float re::Camera::getNear() const
+{
+	return near_;
+}
+
+
+float re::Camera::getFar() const
+{
+	return far_;
+}
+
+
+re::Camera::DepthMode re::Camera::getDepthMode() const
+{
+	return depthMode_;
+}
+
+
+const re::Matrix4& re::Camera::getViewMatrix() const
+{
+	if (dirty_ & DIRTY_VIEW)
+	{
+		view_ = re::lookAt(eye_, target_, up_);
+		dirty_ &= ~DIRTY_VIEW;
+	}
+
+	return view_;
+}
+
+
+const re::Matrix4& re::Camera::getProjectionMatrix() const
+{
+	if (dirty_ & DIRTY_PROJECTION)
+	{
+		const bool infinite = far_ <= 0.f;
+
+		if (depthMode_ == DEPTH_STANDARD && !infinite)
+		{
+			projection_ = perspective(fovy_, aspect_, near_, far_);
+		}
+		else
+		{
+			const float f = 1.f / tan(toRadians(fovy_) / 2.f);
+
+			projection_.loadIdentity();
+			projection_[0] = f / aspect_;
+			projection_[5] = f;
+			projection_[11] = -1.f;
+			projection_[15] = 0.f;
+
+			if (depthMode_ == DEPTH_STANDARD)
+			{
+				// Limit of the standard projection as zFar goes to infinity.
+				projection_[10] = -1.f;
+				projection_[14] = -2.f * near_;
+			}
+			else if (infinite)
+			{
+				projection_[10] = 0.f;
+				projection_[14] = near_;
+			}
+			else
+			{
+				projection_[10] = near_ / (far_ - near_);
+				projection_[14] = far_ * near_ / (far_ - near_);
+			}
+		}
+
+		dirty_ &= ~DIRTY_PROJECTION;
+	}
+
+	return projection_;
+}
+
+
+const re::Matrix4& re::Camera::getViewProjectionMatrix() const
+{
+	if (dirty_ & DIRTY_VIEW_PROJECTION)
+	{
+		// View matrix is affine, so the regular multiplication is exact here.
+		viewProjection_ = getProjectionMatrix() * getViewMatrix();
+		dirty_ &= ~DIRTY_VIEW_PROJECTION;
+	}
+
+	return viewProjection_;
+}
+
+
+const re::Matrix4& re::Camera::getInverseViewMatrix() const
+{
+	if (dirty_ & DIRTY_INVERSE_VIEW)
+	{
+		// View matrix is orthonormal: inverse rotation is the transpose, translation is -R^T * t.
+		const Matrix4& view = getViewMatrix();
+		inverseView_.loadIdentity();
+
+		for (int i = 0; i < 3; i++)
+		{
+			for (int j = 0; j < 3; j++)
+				inverseView_[i * 4 + j] = view[j * 4 + i];
+
+			inverseView_[12 + i] = -(view[i * 4] * view[12] + view[i * 4 + 1] * view[13] + view[i * 4 + 2] * view[14]);
+		}
+
+		dirty_ &= ~DIRTY_INVERSE_VIEW;
+	}
+
+	return inverseView_;
+}
+
+
+const re::Matrix4& re::Camera::getInverseProjectionMatrix() const
+{
+	if (dirty_ & DIRTY_INVERSE_PROJECTION)
+	{
+		// Projection only has five non-zero elements, its inverse is written directly.
+		const Matrix4& projection = getProjectionMatrix();
+		inverseProjection_.loadIdentity();
+		inverseProjection_[0] = 1.f / projection[0];
+		inverseProjection_[5] = 1.f / projection[5];
+		inverseProjection_[10] = 0.f;
+		inverseProjection_[11] = 1.f / projection[14];
+		inverseProjection_[14] = -1.f;
+		inverseProjection_[15] = projection[10] / projection[14];
+		dirty_ &= ~DIRTY_INVERSE_PROJECTION;
+	}
+
+	return inverseProjection_;
+}
+
+
+const re::Matrix4& re::Camera::getInverseViewProjectionMatrix() const
+{
+	if (dirty_ & DIRTY_INVERSE_VIEW_PROJECTION)
+	{
+		multiply(getInverseViewMatrix(), getInverseProjectionMatrix(), inverseViewProjection_);
+		dirty_ &= ~DIRTY_INVERSE_VIEW_PROJECTION;
+	}
+
+	return inverseViewProjection_;
+}
+
+
+const float* re::Camera::getFrustumPlane(FrustumPlane plane) const
+{
+	if (dirty_ & DIRTY_FRUSTUM)
+	{
+		// Planes are extracted from the rows of the view-projection matrix (Gribb & Hartmann).
+		const Matrix4& m = getViewProjectionMatrix();
+		float rows[4][4];
+
+		for (int row = 0; row < 4; row++)
+			for (int column = 0; column < 4; column++)
+				rows[row][column] = m[column * 4 + row];
+
+		const float* w = rows[3];
+		const bool reversed = depthMode_ == DEPTH_REVERSED;
+
+		for (int i = 0; i < 4; i++)
+		{
+			planes_[PLANE_LEFT][i] = w[i] + rows[0][i];
+			planes_[PLANE_RIGHT][i] = w[i] - rows[0][i];
+			planes_[PLANE_BOTTOM][i] = w[i] + rows[1][i];
+			planes_[PLANE_TOP][i] = w[i] - rows[1][i];
+
+			// Standard depth is -w <= z <= w, reversed one is 0 <= z <= w with near at w.
+			planes_[PLANE_NEAR][i] = reversed ? w[i] - rows[2][i] : w[i] + rows[2][i];
+			planes_[PLANE_FAR][i] = reversed ? rows[2][i] : w[i] - rows[2][i];
+		}
+
+		for (auto& p : planes_)
+		{
+			const float length = sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+
+			// Infinite far plane degenerates into a plane which every point is in front of.
+			if (length > 0.000001f)
+			{
+				p[0] /= length;
+				p[1] /= length;
+				p[2] /= length;
+				p[3] /= length;
+			}
+			else
+			{
+				p[0] = p[1] = p[2] = 0.f;
+				p[3] = 1.f;
+			}
+		}
+
+		dirty_ &= ~DIRTY_FRUSTUM;
+	}
+
+	return planes_[plane];
+}
+
+
+bool re::Camera::isSphereVisible(const Vec3d& center, float radius) const
+{
+	for (int i = 0; i < PLANE_COUNT; i++)
+	{
+		const float* p = getFrustumPlane(static_cast<FrustumPlane>(i));
+
+		if (p[0] * center.x + p[1] * center.y + p[2] * center.z + p[3] < -radius)
+			return false;
+	}
+
+	return true;
+}
+
+
+void re::Camera::update() const
+{
+	getInverseViewProjectionMatrix();
+	getFrustumPlane(PLANE_LEFT);
+}
+
+
+void re::Camera::invalidate(unsigned int flags)
+{
+	dirty_ |= flags;
+}
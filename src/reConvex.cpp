@@ -0,0 +1,847 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reConvex.cpp
+// Project:     reMath
+// Description: Implementation of convex shapes and GJK/EPA collision queries
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "reMath/reConvex.h"
+#include "reMath/reParallel.h"
+#include <cfloat>
+#include <cmath>
+
+namespace
+{
+	using Vertex = re::Simplex::Vertex;
+
+	const int GJK_MAX_ITERATIONS = 64;
+
+	// Relative distance improvement below which GJK is considered converged.
+	const float GJK_TOLERANCE = 0.000001f;
+
+	// Squared distance at which the origin is considered to lie on the simplex.
+	const float GJK_TOUCH_EPSILON = 0.0000000001f;
+
+	const int EPA_MAX_VERTICES = 64;
+	const int EPA_MAX_FACES = EPA_MAX_VERTICES * 2;
+	const int EPA_MAX_EDGES = EPA_MAX_FACES * 3;
+
+	// Distance improvement below which EPA is considered converged.
+	const float EPA_TOLERANCE = 0.0001f;
+
+	// Closest feature of a simplex to the origin: vertex indices and barycentric weights.
+	struct Feature
+	{
+		int indices[4];
+		float weights[4];
+		int count;
+	};
+
+	struct Face
+	{
+		int v[3];
+		re::Vec3d normal;
+		float distance;
+	};
+
+	struct Edge
+	{
+		int a;
+		int b;
+	};
+
+	void computeVertex(const re::ConvexShape& a, const re::ConvexShape& b, const re::Vec3d& direction, Vertex& vertex)
+	{
+		vertex.direction = direction;
+		vertex.pointA = a.supportCore(direction);
+		vertex.pointB = b.supportCore(-direction);
+		vertex.point = vertex.pointA - vertex.pointB;
+	}
+
+	Feature makeFeature(int i0, float w0)
+	{
+		Feature result;
+		result.indices[0] = i0;
+		result.weights[0] = w0;
+		result.count = 1;
+		return result;
+	}
+
+	Feature makeFeature(int i0, float w0, int i1, float w1)
+	{
+		Feature result = makeFeature(i0, w0);
+		result.indices[1] = i1;
+		result.weights[1] = w1;
+		result.count = 2;
+		return result;
+	}
+
+	re::Vec3d featurePoint(const Vertex* vertices, const Feature& feature)
+	{
+		re::Vec3d result(0.f, 0.f, 0.f);
+
+		for (int i = 0; i < feature.count; i++)
+			result += vertices[feature.indices[i]].point * feature.weights[i];
+
+		return result;
+	}
+
+	Feature closestOnSegment(const Vertex* vertices, int i0, int i1)
+	{
+		const re::Vec3d& a = vertices[i0].point;
+		const re::Vec3d ab = vertices[i1].point - a;
+		const float denominator = ab.lengthSquared();
+
+		if (denominator <= FLT_MIN)
+			return makeFeature(i0, 1.f);
+
+		const float t = -a.dot(ab) / denominator;
+
+		if (t <= 0.f)
+			return makeFeature(i0, 1.f);
+
+		if (t >= 1.f)
+			return makeFeature(i1, 1.f);
+
+		return makeFeature(i0, 1.f - t, i1, t);
+	}
+
+	// Voronoi region search from Ericson's Real-Time Collision Detection, 5.1.5.
+	Feature closestOnTriangle(const Vertex* vertices, int i0, int i1, int i2)
+	{
+		const re::Vec3d& a = vertices[i0].point;
+		const re::Vec3d& b = vertices[i1].point;
+		const re::Vec3d& c = vertices[i2].point;
+		const re::Vec3d ab = b - a;
+		const re::Vec3d ac = c - a;
+
+		const float d1 = -ab.dot(a);
+		const float d2 = -ac.dot(a);
+
+		if (d1 <= 0.f && d2 <= 0.f)
+			return makeFeature(i0, 1.f);
+
+		const float d3 = -ab.dot(b);
+		const float d4 = -ac.dot(b);
+
+		if (d3 >= 0.f && d4 <= d3)
+			return makeFeature(i1, 1.f);
+
+		const float vc = d1 * d4 - d3 * d2;
+
+		if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f)
+		{
+			const float v = d1 / (d1 - d3);
+			return makeFeature(i0, 1.f - v, i1, v);
+		}
+
+		const float d5 = -ab.dot(c);
+		const float d6 = -ac.dot(c);
+
+		if (d6 >= 0.f && d5 <= d6)
+			return makeFeature(i2, 1.f);
+
+		const float vb = d5 * d2 - d1 * d6;
+
+		if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f)
+		{
+			const float w = d2 / (d2 - d6);
+			return makeFeature(i0, 1.f - w, i2, w);
+		}
+
+		const float va = d3 * d6 - d5 * d4;
+
+		if (va <= 0.f && d4 - d3 >= 0.f && d5 - d6 >= 0.f)
+		{
+			const float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+			return makeFeature(i1, 1.f - w, i2, w);
+		}
+
+		const float denominator = va + vb + vc;
+
+		// Degenerate triangle, the closest point is on one of its edges.
+		if (denominator <= FLT_MIN)
+		{
+			Feature best = closestOnSegment(vertices, i0, i1);
+			float bestDistance = featurePoint(vertices, best).lengthSquared();
+
+			const Feature edges[2] = { closestOnSegment(vertices, i1, i2), closestOnSegment(vertices, i0, i2) };
+
+			for (const auto& edge : edges)
+			{
+				const float distance = featurePoint(vertices, edge).lengthSquared();
+
+				if (distance < bestDistance)
+				{
+					best = edge;
+					bestDistance = distance;
+				}
+			}
+
+			return best;
+		}
+
+		const float v = vb / denominator;
+		const float w = vc / denominator;
+
+		Feature result = makeFeature(i0, 1.f - v - w, i1, v);
+		result.indices[2] = i2;
+		result.weights[2] = w;
+		result.count = 3;
+		return result;
+	}
+
+	Feature closestOnTetrahedron(const Vertex* vertices)
+	{
+		// Faces with the vertex opposite to each of them.
+		static const int FACES[4][4] = { { 0, 1, 2, 3 }, { 0, 3, 1, 2 }, { 0, 2, 3, 1 }, { 1, 3, 2, 0 } };
+
+		Feature best;
+		float bestDistance = FLT_MAX;
+		bool inside = true;
+
+		for (const auto& face : FACES)
+		{
+			const re::Vec3d& a = vertices[face[0]].point;
+			const re::Vec3d normal = (vertices[face[1]].point - a).cross(vertices[face[2]].point - a);
+			const float signOrigin = -a.dot(normal);
+			const float signOpposite = (vertices[face[3]].point - a).dot(normal);
+
+			// Flat tetrahedron has no inside, every face is a candidate.
+			const bool degenerate = signOpposite * signOpposite <= FLT_EPSILON * normal.lengthSquared() * (vertices[face[3]].point - a).lengthSquared();
+
+			if (!degenerate && signOrigin * signOpposite >= 0.f)
+				continue;
+
+			inside = false;
+
+			const Feature feature = closestOnTriangle(vertices, face[0], face[1], face[2]);
+			const float distance = featurePoint(vertices, feature).lengthSquared();
+
+			if (distance < bestDistance)
+			{
+				best = feature;
+				bestDistance = distance;
+			}
+		}
+
+		if (inside)
+		{
+			for (int i = 0; i < 4; i++)
+			{
+				best.indices[i] = i;
+				best.weights[i] = 0.25f;
+			}
+
+			best.count = 4;
+		}
+
+		return best;
+	}
+
+	// Reduces the simplex to its feature closest to the origin, returns False if the origin is inside.
+	bool reduceSimplex(re::Simplex& simplex, re::Vec3d& closest)
+	{
+		Feature feature;
+
+		switch (simplex.count)
+		{
+		case 1:
+			feature = makeFeature(0, 1.f);
+			break;
+
+		case 2:
+			feature = closestOnSegment(simplex.vertices, 0, 1);
+			break;
+
+		case 3:
+			feature = closestOnTriangle(simplex.vertices, 0, 1, 2);
+			break;
+
+		default:
+			feature = closestOnTetrahedron(simplex.vertices);
+			break;
+		}
+
+		closest = featurePoint(simplex.vertices, feature);
+
+		Vertex vertices[4];
+
+		for (int i = 0; i < feature.count; i++)
+			vertices[i] = simplex.vertices[feature.indices[i]];
+
+		for (int i = 0; i < feature.count; i++)
+		{
+			simplex.vertices[i] = vertices[i];
+			simplex.weights[i] = feature.weights[i];
+		}
+
+		simplex.count = feature.count;
+		return feature.count < 4;
+	}
+
+	struct GjkState
+	{
+		re::Vec3d closest;
+		float distanceSquared;
+		bool separated;
+		int iterations;
+	};
+
+	// Runs GJK on the shape cores. With a positive margin the search stops as soon as the
+	// distance is proven to be larger than the margin.
+	GjkState runGjk(const re::ConvexShape& a, const re::ConvexShape& b, re::Simplex& simplex, float margin)
+	{
+		GjkState state;
+		state.separated = false;
+		state.iterations = 0;
+
+		if (simplex.count > 0 && simplex.count <= 4)
+		{
+			for (int i = 0; i < simplex.count; i++)
+				computeVertex(a, b, simplex.vertices[i].direction, simplex.vertices[i]);
+		}
+		else
+		{
+			computeVertex(a, b, re::Vec3d(1.f, 0.f, 0.f), simplex.vertices[0]);
+			simplex.count = 1;
+		}
+
+		float lastDistance = FLT_MAX;
+
+		for (; state.iterations < GJK_MAX_ITERATIONS; state.iterations++)
+		{
+			if (!reduceSimplex(simplex, state.closest))
+			{
+				state.distanceSquared = 0.f;
+				return state;
+			}
+
+			state.distanceSquared = state.closest.lengthSquared();
+
+			if (state.distanceSquared <= GJK_TOUCH_EPSILON || state.distanceSquared >= lastDistance)
+				return state;
+
+			lastDistance = state.distanceSquared;
+
+			Vertex vertex;
+			computeVertex(a, b, -state.closest, vertex);
+
+			// Support plane bounds the distance from below.
+			const float bound = state.closest.dot(vertex.point);
+
+			if (margin >= 0.f && bound > 0.f && bound * bound > state.distanceSquared * margin * margin)
+			{
+				state.separated = true;
+				return state;
+			}
+
+			if (state.distanceSquared - bound <= GJK_TOLERANCE * state.distanceSquared)
+				return state;
+
+			for (int i = 0; i < simplex.count; i++)
+			{
+				if (simplex.vertices[i].point == vertex.point)
+					return state;
+			}
+
+			simplex.vertices[simplex.count++] = vertex;
+		}
+
+		return state;
+	}
+
+	void witnessPoints(const re::Simplex& simplex, re::Vec3d& pointA, re::Vec3d& pointB)
+	{
+		pointA.set(0.f);
+		pointB.set(0.f);
+
+		for (int i = 0; i < simplex.count; i++)
+		{
+			pointA += simplex.vertices[i].pointA * simplex.weights[i];
+			pointB += simplex.vertices[i].pointB * simplex.weights[i];
+		}
+	}
+
+	re::Vec3d perpendicular(const re::Vec3d& vector)
+	{
+		const float x = fabs(vector.x);
+		const float y = fabs(vector.y);
+		const float z = fabs(vector.z);
+		const re::Vec3d axis = x <= y && x <= z ? re::Vec3d(1.f, 0.f, 0.f) : y <= z ? re::Vec3d(0.f, 1.f, 0.f) : re::Vec3d(0.f, 0.f, 1.f);
+		return vector.cross(axis);
+	}
+
+	// Grows the GJK simplex which has the origin on its boundary into a tetrahedron. Returns False
+	// if the Minkowski difference is flat, normal is then set to the direction perpendicular to it.
+	bool expandSimplex(const re::ConvexShape& a, const re::ConvexShape& b, Vertex* vertices, int& count, re::Vec3d& normal)
+	{
+		const float epsilon = 0.000001f;
+
+		while (count < 4)
+		{
+			re::Vec3d directions[6];
+			int directionCount = 0;
+
+			if (count == 1)
+			{
+				directions[0].set(1.f, 0.f, 0.f);
+				directions[1].set(-1.f, 0.f, 0.f);
+				directions[2].set(0.f, 1.f, 0.f);
+				directions[3].set(0.f, -1.f, 0.f);
+				directions[4].set(0.f, 0.f, 1.f);
+				directions[5].set(0.f, 0.f, -1.f);
+				directionCount = 6;
+				normal.set(0.f, 1.f, 0.f);
+			}
+			else if (count == 2)
+			{
+				const re::Vec3d line = vertices[1].point - vertices[0].point;
+				const re::Vec3d side = perpendicular(line);
+				const re::Vec3d up = line.cross(side);
+				directions[0] = side;
+				directions[1] = -side;
+				directions[2] = up;
+				directions[3] = -up;
+				directionCount = 4;
+				normal = side;
+			}
+			else
+			{
+				normal = (vertices[1].point - vertices[0].point).cross(vertices[2].point - vertices[0].point);
+				directions[0] = normal;
+				directions[1] = -normal;
+				directionCount = 2;
+			}
+
+			bool added = false;
+
+			for (int i = 0; i < directionCount && !added; i++)
+			{
+				Vertex& vertex = vertices[count];
+				computeVertex(a, b, directions[i], vertex);
+
+				// New vertex has to extend the simplex dimension.
+				float offset = 0.f;
+
+				if (count == 1)
+					offset = vertex.point.distanceSquaredTo(vertices[0].point);
+				else if (count == 2)
+					offset = (vertex.point - vertices[0].point).cross(vertices[1].point - vertices[0].point).lengthSquared();
+				else
+					offset = fabs((vertex.point - vertices[0].point).dot(normal));
+
+				if (offset > epsilon)
+				{
+					count++;
+					added = true;
+				}
+			}
+
+			if (!added)
+			{
+				const float length = normal.length();
+				normal = length > 0.f ? normal * (1.f / length) : re::Vec3d(0.f, 1.f, 0.f);
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool makeFace(const Vertex* vertices, int a, int b, int c, Face& face)
+	{
+		face.v[0] = a;
+		face.v[1] = b;
+		face.v[2] = c;
+		face.normal = (vertices[b].point - vertices[a].point).cross(vertices[c].point - vertices[a].point);
+
+		const float length = face.normal.length();
+
+		if (length <= FLT_MIN)
+			return false;
+
+		face.normal /= length;
+		face.distance = face.normal.dot(vertices[a].point);
+		return true;
+	}
+
+	// Returns false if the edge buffer is full.
+	bool addHorizonEdge(Edge* edges, int& count, int a, int b)
+	{
+		// Edge shared by two removed faces is inside the hole, drop both directions.
+		for (int i = 0; i < count; i++)
+		{
+			if (edges[i].a == b && edges[i].b == a)
+			{
+				edges[i] = edges[--count];
+				return true;
+			}
+		}
+
+		if (count == EPA_MAX_EDGES)
+			return false;
+
+		edges[count++] = { a, b };
+		return true;
+	}
+
+	int closestFace(const Face* faces, int count)
+	{
+		int result = 0;
+
+		for (int i = 1; i < count; i++)
+		{
+			if (faces[i].distance < faces[result].distance)
+				result = i;
+		}
+
+		return result;
+	}
+
+	void barycentric(const re::Vec3d& point, const re::Vec3d& a, const re::Vec3d& b, const re::Vec3d& c, float* weights)
+	{
+		const re::Vec3d v0 = b - a;
+		const re::Vec3d v1 = c - a;
+		const re::Vec3d v2 = point - a;
+		const float d00 = v0.dot(v0);
+		const float d01 = v0.dot(v1);
+		const float d11 = v1.dot(v1);
+		const float d20 = v2.dot(v0);
+		const float d21 = v2.dot(v1);
+		const float denominator = d00 * d11 - d01 * d01;
+
+		if (fabs(denominator) <= FLT_MIN)
+		{
+			weights[0] = 1.f;
+			weights[1] = weights[2] = 0.f;
+			return;
+		}
+
+		weights[1] = (d11 * d20 - d01 * d21) / denominator;
+		weights[2] = (d00 * d21 - d01 * d20) / denominator;
+		weights[0] = 1.f - weights[1] - weights[2];
+	}
+
+	// Expanding polytope algorithm on the shape cores, starting from a simplex enclosing the origin.
+	void runEpa(const re::ConvexShape& a, const re::ConvexShape& b, const re::Simplex& simplex, re::PenetrationResult& result)
+	{
+		Vertex vertices[EPA_MAX_VERTICES];
+		Face faces[EPA_MAX_FACES];
+		Edge edges[EPA_MAX_EDGES];
+		int vertexCount = simplex.count;
+
+		for (int i = 0; i < vertexCount; i++)
+			vertices[i] = simplex.vertices[i];
+
+		if (!expandSimplex(a, b, vertices, vertexCount, result.normal))
+		{
+			// Flat Minkowski difference, the cores only touch along its normal.
+			result.depth = 0.f;
+			result.pointA = vertices[0].pointA;
+			result.pointB = vertices[0].pointB;
+			return;
+		}
+
+		// Orient the tetrahedron faces outwards.
+		static const int TETRAHEDRON[4][4] = { { 0, 1, 2, 3 }, { 0, 3, 1, 2 }, { 0, 2, 3, 1 }, { 1, 3, 2, 0 } };
+		int faceCount = 0;
+
+		for (const auto& t : TETRAHEDRON)
+		{
+			const re::Vec3d normal = (vertices[t[1]].point - vertices[t[0]].point).cross(vertices[t[2]].point - vertices[t[0]].point);
+			const bool flip = normal.dot(vertices[t[3]].point - vertices[t[0]].point) > 0.f;
+
+			if (makeFace(vertices, t[0], flip ? t[2] : t[1], flip ? t[1] : t[2], faces[faceCount]))
+				faceCount++;
+		}
+
+		while (faceCount > 0)
+		{
+			const int closest = closestFace(faces, faceCount);
+
+			if (vertexCount == EPA_MAX_VERTICES)
+				break;
+
+			Vertex& vertex = vertices[vertexCount];
+			computeVertex(a, b, faces[closest].normal, vertex);
+
+			if (vertex.point.dot(faces[closest].normal) - faces[closest].distance <= EPA_TOLERANCE)
+				break;
+
+			auto isVisible = [&](const Face& face)
+			{
+				return face.normal.dot(vertex.point - vertices[face.v[0]].point) > 0.f;
+			};
+
+			// Collect the horizon around the faces the new vertex sees. The polytope only changes
+			// once the new faces are known to fit, an overflow keeps the last closed polytope.
+			int edgeCount = 0;
+			int visibleCount = 0;
+			bool fits = true;
+
+			for (int i = 0; i < faceCount && fits; i++)
+			{
+				const Face& face = faces[i];
+
+				if (isVisible(face))
+				{
+					visibleCount++;
+					fits = addHorizonEdge(edges, edgeCount, face.v[0], face.v[1]) &&
+						addHorizonEdge(edges, edgeCount, face.v[1], face.v[2]) &&
+						addHorizonEdge(edges, edgeCount, face.v[2], face.v[0]);
+				}
+			}
+
+			if (!fits || faceCount - visibleCount + edgeCount > EPA_MAX_FACES)
+				break;
+
+			// Remove the visible faces and close the hole with a fan to the new vertex.
+			int kept = 0;
+
+			for (int i = 0; i < faceCount; i++)
+			{
+				if (!isVisible(faces[i]))
+					faces[kept++] = faces[i];
+			}
+
+			faceCount = kept;
+
+			for (int i = 0; i < edgeCount; i++)
+			{
+				if (makeFace(vertices, edges[i].a, edges[i].b, vertexCount, faces[faceCount]))
+					faceCount++;
+			}
+
+			vertexCount++;
+		}
+
+		if (faceCount == 0)
+		{
+			result.depth = 0.f;
+			result.normal.set(0.f, 1.f, 0.f);
+			result.pointA = vertices[0].pointA;
+			result.pointB = vertices[0].pointB;
+			return;
+		}
+
+		const Face& face = faces[closestFace(faces, faceCount)];
+		float weights[3];
+		barycentric(face.normal * face.distance, vertices[face.v[0]].point, vertices[face.v[1]].point, vertices[face.v[2]].point, weights);
+
+		result.depth = face.distance;
+		result.normal = face.normal;
+		result.pointA.set(0.f);
+		result.pointB.set(0.f);
+
+		for (int i = 0; i < 3; i++)
+		{
+			result.pointA += vertices[face.v[i]].pointA * weights[i];
+			result.pointB += vertices[face.v[i]].pointB * weights[i];
+		}
+	}
+}
+
+
+float re::ConvexShape::getRadius() const
+{
+	return 0.f;
+}
+
+
+re::Vec3d re::ConvexShape::support(const Vec3d& direction) const
+{
+	Vec3d result = supportCore(direction);
+	const float radius = getRadius();
+	const float length = direction.length();
+
+	if (radius > 0.f && length > 0.f)
+		result += direction * (radius / length);
+
+	return result;
+}
+
+
+re::ConvexSphere::ConvexSphere(const Vec3d& centerValue, float radiusValue) :
+	center(centerValue),
+	radius(radiusValue)
+{
+}
+
+
+re::Vec3d re::ConvexSphere::supportCore(const Vec3d& /*direction*/) const
+{
+	return center;
+}
+
+
+float re::ConvexSphere::getRadius() const
+{
+	return radius;
+}
+
+
+re::ConvexBox::ConvexBox(const OBB& boxValue) :
+	box(boxValue)
+{
+}
+
+
+re::Vec3d re::ConvexBox::supportCore(const Vec3d& direction) const
+{
+	Vec3d result = box.center;
+
+	for (int i = 0; i < 3; i++)
+	{
+		const Vec3d axis = box.getAxis(i);
+		result += axis * (direction.dot(axis) >= 0.f ? box.extents.d[i] : -box.extents.d[i]);
+	}
+
+	return result;
+}
+
+
+re::ConvexCapsule::ConvexCapsule(const Vec3d& startValue, const Vec3d& endValue, float radiusValue) :
+	start(startValue),
+	end(endValue),
+	radius(radiusValue)
+{
+}
+
+
+re::Vec3d re::ConvexCapsule::supportCore(const Vec3d& direction) const
+{
+	return direction.dot(end - start) >= 0.f ? end : start;
+}
+
+
+float re::ConvexCapsule::getRadius() const
+{
+	return radius;
+}
+
+
+re::ConvexHull::ConvexHull(const Vec3d* pointsValue, size_t countValue) :
+	points(pointsValue),
+	count(countValue)
+{
+}
+
+
+re::Vec3d re::ConvexHull::supportCore(const Vec3d& direction) const
+{
+	if (!count)
+		return Vec3d(0.f, 0.f, 0.f);
+
+	size_t best = 0;
+	float bestDistance = points[0].dot(direction);
+
+	for (size_t i = 1; i < count; i++)
+	{
+		const float distance = points[i].dot(direction);
+
+		if (distance > bestDistance)
+		{
+			best = i;
+			bestDistance = distance;
+		}
+	}
+
+	return points[best];
+}
+
+
+bool re::gjkIntersect(const ConvexShape& a, const ConvexShape& b, Simplex* simplex)
+{
+	Simplex local;
+	Simplex& s = simplex ? *simplex : local;
+	const float margin = a.getRadius() + b.getRadius();
+	const GjkState state = runGjk(a, b, s, margin);
+
+	return !state.separated && state.distanceSquared <= margin * margin + GJK_TOUCH_EPSILON;
+}
+
+
+re::DistanceResult re::gjkDistance(const ConvexShape& a, const ConvexShape& b, Simplex* simplex)
+{
+	Simplex local;
+	Simplex& s = simplex ? *simplex : local;
+	const float radiusA = a.getRadius();
+	const float radiusB = b.getRadius();
+	const GjkState state = runGjk(a, b, s, -1.f);
+
+	DistanceResult result;
+	result.iterations = state.iterations;
+	witnessPoints(s, result.pointA, result.pointB);
+
+	const float distance = sqrt(state.distanceSquared);
+	result.intersecting = state.distanceSquared <= GJK_TOUCH_EPSILON || distance <= radiusA + radiusB;
+
+	if (result.intersecting)
+	{
+		result.distance = 0.f;
+		return result;
+	}
+
+	// Move the core closest points onto the rounded surfaces.
+	const Vec3d normal = (result.pointB - result.pointA) * (1.f / distance);
+	result.distance = distance - radiusA - radiusB;
+	result.pointA += normal * radiusA;
+	result.pointB -= normal * radiusB;
+	return result;
+}
+
+
+re::PenetrationResult re::epaPenetration(const ConvexShape& a, const ConvexShape& b, Simplex* simplex)
+{
+	Simplex local;
+	Simplex& s = simplex ? *simplex : local;
+	const float radiusA = a.getRadius();
+	const float radiusB = b.getRadius();
+	const float margin = radiusA + radiusB;
+	const GjkState state = runGjk(a, b, s, margin);
+
+	PenetrationResult result;
+	result.intersecting = false;
+	result.depth = 0.f;
+
+	if (state.separated)
+		return result;
+
+	if (state.distanceSquared > GJK_TOUCH_EPSILON)
+	{
+		// Cores are apart, only the rounded parts overlap.
+		const float distance = sqrt(state.distanceSquared);
+
+		if (distance > margin)
+			return result;
+
+		witnessPoints(s, result.pointA, result.pointB);
+		result.normal = (result.pointB - result.pointA) * (1.f / distance);
+		result.depth = margin - distance;
+	}
+	else
+	{
+		// Rounding inflates the Minkowski difference evenly, so it just adds to the core depth.
+		runEpa(a, b, s, result);
+		result.depth += margin;
+	}
+
+	result.intersecting = true;
+	result.pointA += result.normal * radiusA;
+	result.pointB -= result.normal * radiusB;
+	return result;
+}
+
+
+void re::gjkDistanceN(const ConvexShape* const* a, const ConvexShape* const* b, Simplex* simplices, DistanceResult* results, size_t count)
+{
+	parallelFor(count, sizeof(DistanceResult) + sizeof(Simplex), [=](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+			results[i] = gjkDistance(*a[i], *b[i], simplices ? simplices + i : nullptr);
+	});
+}
@@ -0,0 +1,433 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reCubicSpline3.cpp
+// Project:     reMath
+// Description: Implementation of CubicSpline3 class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "reMath/reCubicSpline3.h"
+#include "reMath/reParallel.h"
+#include "reMath/reMathUtil.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#ifdef RE_MATH_SSE
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	// Catmull-Rom knot intervals below this are coincident points.
+	const float KNOT_EPSILON = 0.0001f;
+
+	// Subdivision depth limit of flatten(), 2^16 lines per segment.
+	const int MAX_SUBDIVISION = 16;
+
+	// Newton iterations per arc length table sample.
+	const int NEWTON_ITERATIONS = 3;
+
+	// Distances converted to parameters per evaluateAtDistanceN() block.
+	const size_t DISTANCE_BLOCK = 64;
+
+	// Three point Gauss-Legendre quadrature nodes on [0, 1] and their weights.
+	const float GAUSS_NODES[3] = { 0.11270166f, 0.5f, 0.88729834f };
+	const float GAUSS_WEIGHTS[3] = { 0.27777778f, 0.44444444f, 0.27777778f };
+
+	inline float horner(const float* c, float u)
+	{
+		return c[0] + u * (c[1] + u * (c[2] + u * c[3]));
+	}
+
+	inline float derivative(const float* c, float u)
+	{
+		return c[1] + u * (2.f * c[2] + u * 3.f * c[3]);
+	}
+
+	// Splits a parameter into the segment index and the fraction within it.
+	inline size_t locate(float time, size_t segmentCount, float& fraction)
+	{
+		const float last = static_cast<float>(segmentCount - 1);
+		time = time > 0.f ? time : 0.f;
+		time = time < static_cast<float>(segmentCount) ? time : static_cast<float>(segmentCount);
+
+		const float index = floorf(time < last ? time : last);
+		fraction = time - index;
+		return static_cast<size_t>(index);
+	}
+
+	// Catmull-Rom knot interval with the centripetal parametrization.
+	inline float knotInterval(const re::Vec3d& first, const re::Vec3d& second)
+	{
+		return sqrtf(first.distanceTo(second));
+	}
+
+	inline float speed(const float rows[3][4], float u)
+	{
+		const float dx = derivative(rows[0], u);
+		const float dy = derivative(rows[1], u);
+		const float dz = derivative(rows[2], u);
+		return sqrtf(dx * dx + dy * dy + dz * dz);
+	}
+
+	// Length of a short piece of a segment by Gauss-Legendre quadrature.
+	inline float arcLength(const float rows[3][4], float start, float end)
+	{
+		float length = 0.f;
+
+		for (int i = 0; i < 3; i++)
+			length += GAUSS_WEIGHTS[i] * speed(rows, start + GAUSS_NODES[i] * (end - start));
+
+		return length * (end - start);
+	}
+
+	float distanceSquaredToChord(const re::Vec3d& point, const re::Vec3d& start, const re::Vec3d& end)
+	{
+		const re::Vec3d chord = end - start;
+		const float lengthSquared = chord.lengthSquared();
+		float t = lengthSquared > 0.f ? (point - start).dot(chord) / lengthSquared : 0.f;
+		t = t < 0.f ? 0.f : t > 1.f ? 1.f : t;
+		return point.distanceSquaredTo(start + chord * t);
+	}
+
+	struct Bezier
+	{
+		re::Vec3d p[4];
+		int depth;
+	};
+}
+
+
+re::CubicSpline3::CubicSpline3(const Vec3d* points, size_t count, Basis basis, size_t arcLengthSamples)
+{
+	switch (basis)
+	{
+	case BASIS_BEZIER:
+		for (size_t i = 0; i + 3 < count; i += 3)
+			addSegment(points[i], (points[i + 1] - points[i]) * 3.f, points[i + 3], (points[i + 3] - points[i + 2]) * 3.f);
+
+		if (count && segments_.empty())
+			addSegment(points[0], Vec3d(0.f), points[0], Vec3d(0.f));
+
+		break;
+
+	case BASIS_CATMULL_ROM:
+		for (size_t i = 0; i + 1 < count; i++)
+		{
+			const Vec3d& p1 = points[i];
+			const Vec3d& p2 = points[i + 1];
+			const Vec3d p0 = i > 0 ? points[i - 1] : p1 * 2.f - p2;
+			const Vec3d p3 = i + 2 < count ? points[i + 2] : p2 * 2.f - p1;
+
+			float t0 = knotInterval(p0, p1);
+			float t1 = knotInterval(p1, p2);
+			float t2 = knotInterval(p2, p3);
+
+			t1 = t1 < KNOT_EPSILON ? 1.f : t1;
+			t0 = t0 < KNOT_EPSILON ? t1 : t0;
+			t2 = t2 < KNOT_EPSILON ? t1 : t2;
+
+			// Tangents of the non-uniform curve rescaled to the unit segment parameter.
+			const Vec3d m1 = ((p1 - p0) * (1.f / t0) - (p2 - p0) * (1.f / (t0 + t1)) + (p2 - p1) * (1.f / t1)) * t1;
+			const Vec3d m2 = ((p2 - p1) * (1.f / t1) - (p3 - p1) * (1.f / (t1 + t2)) + (p3 - p2) * (1.f / t2)) * t1;
+			addSegment(p1, m1, p2, m2);
+		}
+
+		if (count == 1)
+			addSegment(points[0], Vec3d(0.f), points[0], Vec3d(0.f));
+
+		break;
+
+	case BASIS_HERMITE:
+		for (size_t i = 0; i + 3 < count; i += 2)
+			addSegment(points[i], points[i + 1], points[i + 2], points[i + 3]);
+
+		if (count > 1 && segments_.empty())
+			addSegment(points[0], Vec3d(0.f), points[0], Vec3d(0.f));
+
+		break;
+	}
+
+	if (arcLengthSamples && !segments_.empty())
+		buildArcLengthTable(arcLengthSamples);
+}
+
+
+size_t re::CubicSpline3::getSegmentCount() const
+{
+	return segments_.size();
+}
+
+
+re::Vec3d re::CubicSpline3::evaluate(float time) const
+{
+	if (segments_.empty())
+		return Vec3d(0.f);
+
+	float u;
+	const Segment& segment = segments_[locate(time, segments_.size(), u)];
+	return Vec3d(horner(segment.rows[0], u), horner(segment.rows[1], u), horner(segment.rows[2], u));
+}
+
+
+re::Vec3d re::CubicSpline3::evaluateTangent(float time) const
+{
+	if (segments_.empty())
+		return Vec3d(0.f);
+
+	float u;
+	const Segment& segment = segments_[locate(time, segments_.size(), u)];
+	return Vec3d(derivative(segment.rows[0], u), derivative(segment.rows[1], u), derivative(segment.rows[2], u));
+}
+
+
+void re::CubicSpline3::evaluateN(const float* times, Vec3d* output, size_t count) const
+{
+	parallelFor(count, sizeof(float) + sizeof(Vec3d), [=](size_t begin, size_t end)
+	{
+		evaluateBlock(times + begin, output + begin, end - begin);
+	});
+}
+
+
+float re::CubicSpline3::getLength() const
+{
+	return length_;
+}
+
+
+float re::CubicSpline3::getParameter(float distance) const
+{
+	if (arcLengths_.empty() || length_ <= 0.f)
+		return 0.f;
+
+	size_t segment = std::upper_bound(segmentEnds_.begin(), segmentEnds_.end(), distance) - segmentEnds_.begin();
+	segment = segment < segmentEnds_.size() ? segment : segmentEnds_.size() - 1;
+
+	const float start = segment ? segmentEnds_[segment - 1] : 0.f;
+	const float span = segmentEnds_[segment] - start;
+	const float samples = static_cast<float>(arcLengthSamples_);
+	float position = span > 0.f ? (distance - start) / span * samples : 0.f;
+	position = position > 0.f ? position : 0.f;
+	position = position < samples ? position : samples;
+
+	size_t index = static_cast<size_t>(position);
+	index = index < arcLengthSamples_ ? index : arcLengthSamples_ - 1;
+
+	// Cubic Hermite between the samples, slopes limited to three times the secant keep it monotonic.
+	const ArcLengthSample* sample = &arcLengths_[segment * (arcLengthSamples_ + 1) + index];
+	const float delta = sample[1].parameter - sample[0].parameter;
+	const float m0 = sample[0].slope < 3.f * delta ? sample[0].slope : 3.f * delta;
+	const float m1 = sample[1].slope < 3.f * delta ? sample[1].slope : 3.f * delta;
+	const float t = position - static_cast<float>(index);
+	return static_cast<float>(segment) + sample[0].parameter + t * (m0 + t * (3.f * delta - 2.f * m0 - m1 + t * (m0 + m1 - 2.f * delta)));
+}
+
+
+void re::CubicSpline3::evaluateAtDistanceN(const float* distances, Vec3d* output, size_t count) const
+{
+	parallelFor(count, sizeof(float) + sizeof(Vec3d), [=](size_t begin, size_t end)
+	{
+		float times[DISTANCE_BLOCK];
+
+		for (size_t i = begin; i < end; i += DISTANCE_BLOCK)
+		{
+			const size_t size = end - i < DISTANCE_BLOCK ? end - i : DISTANCE_BLOCK;
+
+			for (size_t j = 0; j < size; j++)
+				times[j] = getParameter(distances[i + j]);
+
+			evaluateBlock(times, output + i, size);
+		}
+	});
+}
+
+
+void re::CubicSpline3::flatten(float tolerance, std::vector<Vec3d>& polyline) const
+{
+	if (segments_.empty())
+		return;
+
+	// Curve lies in the convex hull of its control points, so it is within the tolerance of the
+	// chord when both inner control points are.
+	const float limit = tolerance * tolerance;
+	polyline.push_back(evaluate(0.f));
+
+	for (const Segment& segment : segments_)
+	{
+		Bezier stack[MAX_SUBDIVISION + 1];
+		int top = 0;
+
+		Bezier& root = stack[top++];
+		root.p[0].set(segment.rows[0][0], segment.rows[1][0], segment.rows[2][0]);
+		root.p[1] = root.p[0] + Vec3d(segment.rows[0][1], segment.rows[1][1], segment.rows[2][1]) * (1.f / 3.f);
+		root.p[2] = root.p[1] * 2.f - root.p[0] + Vec3d(segment.rows[0][2], segment.rows[1][2], segment.rows[2][2]) * (1.f / 3.f);
+		root.p[3].set(horner(segment.rows[0], 1.f), horner(segment.rows[1], 1.f), horner(segment.rows[2], 1.f));
+		root.depth = 0;
+
+		while (top > 0)
+		{
+			const Bezier curve = stack[--top];
+			const float first = distanceSquaredToChord(curve.p[1], curve.p[0], curve.p[3]);
+			const float second = distanceSquaredToChord(curve.p[2], curve.p[0], curve.p[3]);
+
+			if ((first > second ? first : second) <= limit || curve.depth == MAX_SUBDIVISION)
+			{
+				polyline.push_back(curve.p[3]);
+				continue;
+			}
+
+			// De Casteljau split at the middle, the right half goes to the stack first.
+			const Vec3d p01 = (curve.p[0] + curve.p[1]) * 0.5f;
+			const Vec3d p12 = (curve.p[1] + curve.p[2]) * 0.5f;
+			const Vec3d p23 = (curve.p[2] + curve.p[3]) * 0.5f;
+			const Vec3d p012 = (p01 + p12) * 0.5f;
+			const Vec3d p123 = (p12 + p23) * 0.5f;
+			const Vec3d middle = (p012 + p123) * 0.5f;
+
+			Bezier& right = stack[top++];
+			right.p[0] = middle;
+			right.p[1] = p123;
+			right.p[2] = p23;
+			right.p[3] = curve.p[3];
+			right.depth = curve.depth + 1;
+
+			Bezier& left = stack[top++];
+			left.p[0] = curve.p[0];
+			left.p[1] = p01;
+			left.p[2] = p012;
+			left.p[3] = middle;
+			left.depth = curve.depth + 1;
+		}
+	}
+}
+
+
+void re::CubicSpline3::addSegment(const Vec3d& start, const Vec3d& startTangent, const Vec3d& end, const Vec3d& endTangent)
+{
+	Segment segment;
+
+	for (int i = 0; i < 3; i++)
+	{
+		segment.rows[i][0] = start.d[i];
+		segment.rows[i][1] = startTangent.d[i];
+		segment.rows[i][2] = 3.f * (end.d[i] - start.d[i]) - 2.f * startTangent.d[i] - endTangent.d[i];
+		segment.rows[i][3] = 2.f * (start.d[i] - end.d[i]) + startTangent.d[i] + endTangent.d[i];
+	}
+
+	segments_.push_back(segment);
+}
+
+
+void re::CubicSpline3::buildArcLengthTable(size_t samples)
+{
+	const float step = 1.f / static_cast<float>(samples);
+	std::vector<float> lengths(samples + 1);
+	arcLengthSamples_ = samples;
+	arcLengths_.resize(segments_.size() * (samples + 1));
+	segmentEnds_.resize(segments_.size());
+
+	for (size_t index = 0; index < segments_.size(); index++)
+	{
+		const Segment& segment = segments_[index];
+		ArcLengthSample* table = &arcLengths_[index * (samples + 1)];
+
+		// Cumulative lengths at uniform parameter steps.
+		lengths[0] = 0.f;
+
+		for (size_t i = 0; i < samples; i++)
+			lengths[i + 1] = lengths[i] + arcLength(segment.rows, i * step, (i + 1) * step);
+
+		// Parameters at uniform distance steps, the linear guess within a parameter step is refined by Newton's method.
+		const float distanceStep = lengths[samples] * step;
+		size_t interval = 0;
+
+		for (size_t i = 0; i <= samples; i++)
+		{
+			const float distance = distanceStep * static_cast<float>(i);
+
+			while (interval + 1 < samples && lengths[interval + 1] < distance)
+				interval++;
+
+			const float start = static_cast<float>(interval) * step;
+			const float span = lengths[interval + 1] - lengths[interval];
+			const float fraction = span > 0.f ? (distance - lengths[interval]) / span : 0.f;
+			float u = start + (fraction < 1.f ? fraction : 1.f) * step;
+			float velocity = speed(segment.rows, u);
+
+			for (int iteration = 0; iteration < NEWTON_ITERATIONS && velocity > 0.f; iteration++)
+			{
+				u -= (lengths[interval] + arcLength(segment.rows, start, u) - distance) / velocity;
+				u = u > start ? u : start;
+				u = u < start + step ? u : start + step;
+				velocity = speed(segment.rows, u);
+			}
+
+			// Stationary points get an unbounded slope, limited at the lookup.
+			table[i].parameter = u;
+			table[i].slope = velocity > 0.f ? distanceStep / velocity : FLT_MAX;
+		}
+
+		table[0].parameter = 0.f;
+		table[samples].parameter = 1.f;
+		length_ += lengths[samples];
+		segmentEnds_[index] = length_;
+	}
+}
+
+
+void re::CubicSpline3::evaluateBlock(const float* times, Vec3d* output, size_t count) const
+{
+	if (segments_.empty())
+	{
+		for (size_t i = 0; i < count; i++)
+			output[i].set(0.f);
+
+		return;
+	}
+
+	size_t i = 0;
+
+#ifdef RE_MATH_SSE
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 end = _mm_set1_ps(static_cast<float>(segments_.size()));
+	const __m128 last = _mm_set1_ps(static_cast<float>(segments_.size() - 1));
+
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128 time = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(times + i), zero), end);
+		const __m128i index = _mm_cvttps_epi32(_mm_min_ps(time, last));
+		const __m128 u = _mm_sub_ps(time, _mm_cvtepi32_ps(index));
+
+		int indices[4];
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(indices), index);
+		const Segment* segments[4] = { &segments_[indices[0]], &segments_[indices[1]], &segments_[indices[2]], &segments_[indices[3]] };
+		__m128 result[3];
+
+		for (int k = 0; k < 3; k++)
+		{
+			// Rows of four segments transpose into the four coefficients of four lanes.
+			__m128 a = _mm_loadu_ps(segments[0]->rows[k]);
+			__m128 b = _mm_loadu_ps(segments[1]->rows[k]);
+			__m128 c = _mm_loadu_ps(segments[2]->rows[k]);
+			__m128 d = _mm_loadu_ps(segments[3]->rows[k]);
+			_MM_TRANSPOSE4_PS(a, b, c, d);
+			result[k] = _mm_add_ps(a, _mm_mul_ps(u, _mm_add_ps(b, _mm_mul_ps(u, _mm_add_ps(c, _mm_mul_ps(u, d))))));
+		}
+
+		float x[4], y[4], z[4];
+		_mm_storeu_ps(x, result[0]);
+		_mm_storeu_ps(y, result[1]);
+		_mm_storeu_ps(z, result[2]);
+
+		for (int j = 0; j < 4; j++)
+			output[i + j].set(x[j], y[j], z[j]);
+	}
+#endif
+
+	for (; i < count; i++)
+		output[i] = evaluate(times[i]);
+}
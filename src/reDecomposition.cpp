@@ -0,0 +1,641 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reDecomposition.cpp
+// Project:     reMath
+// Description: Implementation of batch 3x3 matrix decompositions
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "reMath/reDecomposition.h"
+#include "reMath/reMathUtil.h"
+#include "reMath/reMatrix3.h"
+#include "reMath/reMatrix4.h"
+#include "reMath/reVec3d.h"
+#include "reMath/reParallel.h"
+#include "reSimd.h"
+#include <cfloat>
+#include <cmath>
+
+#ifdef RE_MATH_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+	using namespace re::simd;
+
+	const float GAMMA = 5.828427124f;		// 3 + 2 * sqrt(2)
+	const float COS_PI_8 = 0.923879532f;
+	const float SIN_PI_8 = 0.382683432f;
+
+	// Zero test of the QR pivots, relative since the SVD input is scaled to its largest entry.
+	const float QR_EPSILON = 1e-6f;
+
+	// Approximate rotations converge slower than exact ones, four sweeps leave errors around 1e-2
+	// on some random matrices and six bring all of them to float precision.
+	const int JACOBI_SWEEPS = 6;
+
+#ifdef RE_MATH_SSE
+	// Enables flush to zero and denormals are zero modes for the current thread. Off-diagonal
+	// terms decay far below FLT_MIN during the sweeps, and arithmetic on denormals is slow enough
+	// to triple the decomposition time.
+	class DenormalGuard
+	{
+	public:
+		DenormalGuard() : mode_(_mm_getcsr())
+		{
+			_mm_setcsr(mode_ | FLUSH_TO_ZERO | DENORMALS_ARE_ZERO);
+		}
+
+		~DenormalGuard()
+		{
+			_mm_setcsr(mode_);
+		}
+
+	private:
+		static const unsigned int FLUSH_TO_ZERO = 0x8000;
+		static const unsigned int DENORMALS_ARE_ZERO = 0x0040;
+
+		unsigned int mode_;
+	};
+#endif
+
+	// Matrix of lanes, m[row][column].
+	template <typename Real>
+	struct Matrix
+	{
+		Real m[3][3];
+	};
+
+	template <typename Real, typename Mask>
+	inline void conditionalSwap(Mask mask, Real& first, Real& second)
+	{
+		const Real temporary = first;
+		first = select(mask, second, first);
+		second = select(mask, temporary, second);
+	}
+
+	template <typename Real, typename Mask>
+	inline void conditionalNegativeSwap(Mask mask, Real& first, Real& second)
+	{
+		const Real temporary = -first;
+		first = select(mask, second, first);
+		second = select(mask, temporary, second);
+	}
+
+	// Quaternion (x, y, z, w) to rotation matrix.
+	template <typename Real>
+	void quaternionToMatrix(const Real q[4], Matrix<Real>& result)
+	{
+		const Real xx = q[0] * q[0], yy = q[1] * q[1], zz = q[2] * q[2];
+		const Real xy = q[0] * q[1], xz = q[0] * q[2], yz = q[1] * q[2];
+		const Real wx = q[3] * q[0], wy = q[3] * q[1], wz = q[3] * q[2];
+		const Real one(1.f);
+		const Real two(2.f);
+
+		result.m[0][0] = one - two * (yy + zz);
+		result.m[0][1] = two * (xy - wz);
+		result.m[0][2] = two * (xz + wy);
+		result.m[1][0] = two * (xy + wz);
+		result.m[1][1] = one - two * (xx + zz);
+		result.m[1][2] = two * (yz - wx);
+		result.m[2][0] = two * (xz - wy);
+		result.m[2][1] = two * (yz + wx);
+		result.m[2][2] = one - two * (xx + yy);
+	}
+
+	// One Jacobi rotation in the (0, 1) plane of the symmetric matrix s (lower triangle), with the
+	// rotation angle approximated by the Givens quaternion. The matrix is then cyclically permuted,
+	// so three calls rotate the (0, 1), (1, 2) and (0, 2) planes. Quaternion components X, Y, Z
+	// of the current plane are template arguments, which keeps the quaternion in registers.
+	template <int X, int Y, int Z, typename Real, typename Mask>
+	inline void jacobiConjugation(Real& s11, Real& s21, Real& s22, Real& s31, Real& s32, Real& s33, Real q[4])
+	{
+		Real ch = Real(2.f) * (s11 - s22);
+		Real sh = s21;
+		const Mask accurate = less(Real(GAMMA) * sh * sh, ch * ch);
+		const Real w = rsqrt(ch * ch + sh * sh);
+		ch = select(accurate, w * ch, Real(COS_PI_8));
+		sh = select(accurate, w * sh, Real(SIN_PI_8));
+
+		const Real scale = ch * ch + sh * sh;
+		const Real a = (ch * ch - sh * sh) * rsqrt(scale * scale);
+		const Real b = Real(2.f) * sh * ch * rsqrt(scale * scale);
+
+		const Real t11 = s11, t21 = s21, t22 = s22, t31 = s31, t32 = s32;
+		s11 = a * (a * t11 + b * t21) + b * (a * t21 + b * t22);
+		s21 = a * (-b * t11 + a * t21) + b * (-b * t21 + a * t22);
+		s22 = -b * (-b * t11 + a * t21) + a * (-b * t21 + a * t22);
+		s31 = a * t31 + b * t32;
+		s32 = -b * t31 + a * t32;
+
+		// Accumulates the rotation (ch, sh in the current plane) into the quaternion.
+		Real temporary[3] = { q[0] * sh, q[1] * sh, q[2] * sh };
+		sh *= q[3];
+		q[0] *= ch;
+		q[1] *= ch;
+		q[2] *= ch;
+		q[3] *= ch;
+		q[Z] += sh;
+		q[3] -= temporary[Z];
+		q[X] += temporary[Y];
+		q[Y] -= temporary[X];
+
+		// Cyclic permutation of the matrix for the next plane.
+		const Real p11 = s22, p21 = s32, p22 = s33, p31 = s21, p32 = s31, p33 = s11;
+		s11 = p11;
+		s21 = p21;
+		s22 = p22;
+		s31 = p31;
+		s32 = p32;
+		s33 = p33;
+	}
+
+	template <typename Real, typename Mask>
+	void jacobiEigen(Real& s11, Real& s21, Real& s22, Real& s31, Real& s32, Real& s33, Real q[4])
+	{
+		q[0] = q[1] = q[2] = Real(0.f);
+		q[3] = Real(1.f);
+
+		for (int sweep = 0; sweep < JACOBI_SWEEPS; sweep++)
+		{
+			jacobiConjugation<0, 1, 2, Real, Mask>(s11, s21, s22, s31, s32, s33, q);
+			jacobiConjugation<1, 2, 0, Real, Mask>(s11, s21, s22, s31, s32, s33, q);
+			jacobiConjugation<2, 0, 1, Real, Mask>(s11, s21, s22, s31, s32, s33, q);
+		}
+
+		// Normalization keeps the rotation orthonormal after the approximate steps.
+		const Real length = rsqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+
+		for (int i = 0; i < 4; i++)
+			q[i] *= length;
+	}
+
+	// Sorts the keys in descending order, swapping the columns of v (and b if given) along with
+	// them. One column of each swapped pair is negated to keep v a rotation.
+	template <typename Real, typename Mask>
+	void sortColumns(Matrix<Real>* b, Matrix<Real>& v, Real keys[3])
+	{
+		static const int PAIRS[3][2] = { { 0, 1 }, { 0, 2 }, { 1, 2 } };
+
+		for (const auto& pair : PAIRS)
+		{
+			const int first = pair[0];
+			const int second = pair[1];
+			const Mask mask = less(keys[first], keys[second]);
+
+			for (int row = 0; row < 3; row++)
+			{
+				if (b)
+					conditionalNegativeSwap<Real, Mask>(mask, b->m[row][first], b->m[row][second]);
+
+				conditionalNegativeSwap<Real, Mask>(mask, v.m[row][first], v.m[row][second]);
+			}
+
+			conditionalSwap<Real, Mask>(mask, keys[first], keys[second]);
+		}
+	}
+
+	// Givens rotation annihilating a2 against the pivot a1, as cosine and sine of the half angle.
+	template <typename Real, typename Mask>
+	void qrGivens(Real a1, Real a2, Real& ch, Real& sh)
+	{
+		const Real rho = accurateSqrt(a1 * a1 + a2 * a2);
+		sh = select(less(Real(QR_EPSILON), rho), a2, Real(0.f));
+		ch = absolute(a1) + maximum(rho, Real(QR_EPSILON));
+		conditionalSwap<Real, Mask>(less(a1, Real(0.f)), sh, ch);
+
+		const Real w = rsqrt(ch * ch + sh * sh);
+		ch *= w;
+		sh *= w;
+	}
+
+	// Applies the rotation by the angle given by (ch, sh) to rows (or columns of u) p and q.
+	template <typename Real>
+	void rotateRows(Matrix<Real>& r, Matrix<Real>& u, int p, int q, Real ch, Real sh)
+	{
+		const Real a = Real(1.f) - Real(2.f) * sh * sh;
+		const Real b = Real(2.f) * ch * sh;
+
+		for (int k = 0; k < 3; k++)
+		{
+			const Real rp = r.m[p][k];
+			const Real rq = r.m[q][k];
+			r.m[p][k] = a * rp + b * rq;
+			r.m[q][k] = -b * rp + a * rq;
+
+			const Real up = u.m[k][p];
+			const Real uq = u.m[k][q];
+			u.m[k][p] = a * up + b * uq;
+			u.m[k][q] = -b * up + a * uq;
+		}
+	}
+
+	// QR decomposition by three Givens rotations, r is left upper triangular.
+	template <typename Real, typename Mask>
+	void qrDecomposition(Matrix<Real>& r, Matrix<Real>& u)
+	{
+		for (int row = 0; row < 3; row++)
+		{
+			for (int column = 0; column < 3; column++)
+				u.m[row][column] = Real(row == column ? 1.f : 0.f);
+		}
+
+		static const int PLANES[3][2] = { { 0, 1 }, { 0, 2 }, { 1, 2 } };
+
+		for (const auto& plane : PLANES)
+		{
+			Real ch, sh;
+			qrGivens<Real, Mask>(r.m[plane[0]][plane[0]], r.m[plane[1]][plane[0]], ch, sh);
+			rotateRows(r, u, plane[0], plane[1], ch, sh);
+		}
+	}
+
+	template <typename Real, typename Mask>
+	void eigenKernel(const Matrix<Real>& a, Real values[3], Matrix<Real>& vectors)
+	{
+		const Real half(0.5f);
+		Real s11 = a.m[0][0];
+		Real s21 = half * (a.m[1][0] + a.m[0][1]);
+		Real s22 = a.m[1][1];
+		Real s31 = half * (a.m[2][0] + a.m[0][2]);
+		Real s32 = half * (a.m[2][1] + a.m[1][2]);
+		Real s33 = a.m[2][2];
+		Real q[4];
+		jacobiEigen<Real, Mask>(s11, s21, s22, s31, s32, s33, q);
+		quaternionToMatrix(q, vectors);
+
+		values[0] = s11;
+		values[1] = s22;
+		values[2] = s33;
+		sortColumns<Real, Mask>(nullptr, vectors, values);
+	}
+
+	template <typename Real, typename Mask>
+	void svdKernel(const Matrix<Real>& input, Matrix<Real>& u, Real sigma[3], Matrix<Real>& v)
+	{
+		// Scaling to the largest entry makes the QR zero test relative, and keeps the squared
+		// entries of the normal matrix in float range for tiny and huge matrices.
+		Real largest(0.f);
+
+		for (int row = 0; row < 3; row++)
+		{
+			for (int column = 0; column < 3; column++)
+				largest = maximum(largest, absolute(input.m[row][column]));
+		}
+
+		const Real inverse = select(less(Real(0.f), largest), Real(1.f) / largest, Real(0.f));
+		Matrix<Real> a;
+
+		for (int row = 0; row < 3; row++)
+		{
+			for (int column = 0; column < 3; column++)
+				a.m[row][column] = input.m[row][column] * inverse;
+		}
+
+		// Eigen decomposition of the normal matrix a^T * a gives v.
+		Real s[3][3];
+
+		for (int row = 0; row < 3; row++)
+		{
+			for (int column = 0; column <= row; column++)
+				s[row][column] = a.m[0][row] * a.m[0][column] + a.m[1][row] * a.m[1][column] + a.m[2][row] * a.m[2][column];
+		}
+
+		Real q[4];
+		jacobiEigen<Real, Mask>(s[0][0], s[1][0], s[1][1], s[2][0], s[2][1], s[2][2], q);
+		quaternionToMatrix(q, v);
+
+		// b = a * v has orthogonal columns with lengths equal to the singular values.
+		Matrix<Real> b;
+
+		for (int row = 0; row < 3; row++)
+		{
+			for (int column = 0; column < 3; column++)
+				b.m[row][column] = a.m[row][0] * v.m[0][column] + a.m[row][1] * v.m[1][column] + a.m[row][2] * v.m[2][column];
+		}
+
+		Real lengths[3];
+
+		for (int column = 0; column < 3; column++)
+			lengths[column] = b.m[0][column] * b.m[0][column] + b.m[1][column] * b.m[1][column] + b.m[2][column] * b.m[2][column];
+
+		sortColumns<Real, Mask>(&b, v, lengths);
+		qrDecomposition<Real, Mask>(b, u);
+
+		for (int i = 0; i < 3; i++)
+			sigma[i] = b.m[i][i] * largest;
+	}
+
+	// Polar decomposition from the SVD: rotation = u * v^T, stretch = v * diag(sigma) * v^T.
+	template <typename Real, typename Mask>
+	void polarKernel(const Matrix<Real>& a, Matrix<Real>& rotation, Matrix<Real>& stretch)
+	{
+		Matrix<Real> u;
+		Matrix<Real> v;
+		Real sigma[3];
+		svdKernel<Real, Mask>(a, u, sigma, v);
+
+		for (int row = 0; row < 3; row++)
+		{
+			for (int column = 0; column < 3; column++)
+			{
+				rotation.m[row][column] = u.m[row][0] * v.m[column][0] + u.m[row][1] * v.m[column][1] + u.m[row][2] * v.m[column][2];
+				stretch.m[row][column] = v.m[row][0] * sigma[0] * v.m[column][0] + v.m[row][1] * sigma[1] * v.m[column][1] + v.m[row][2] * sigma[2] * v.m[column][2];
+			}
+		}
+	}
+
+	re::Quaternion toQuaternion(const Matrix<float>& rotation)
+	{
+		const float data[9] = {
+			rotation.m[0][0], rotation.m[1][0], rotation.m[2][0],
+			rotation.m[0][1], rotation.m[1][1], rotation.m[2][1],
+			rotation.m[0][2], rotation.m[1][2], rotation.m[2][2] };
+
+		return re::Quaternion::fromMatrix(re::Matrix3(data));
+	}
+
+	void decomposeMatrix(const re::Matrix4& matrix, float shearTolerance, re::TransformComponents& result)
+	{
+		const float* data = static_cast<const float*>(matrix);
+		result.translation.set(data[12], data[13], data[14]);
+
+		// Fast path for orthogonal axes.
+		Matrix<float> rotation;
+		float scale[3];
+		bool orthogonal = true;
+
+		for (int column = 0; column < 3; column++)
+		{
+			const float* axis = data + column * 4;
+			scale[column] = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+			orthogonal = orthogonal && scale[column] > FLT_MIN;
+
+			for (int row = 0; row < 3; row++)
+				rotation.m[row][column] = orthogonal ? axis[row] / scale[column] : 0.f;
+		}
+
+		for (int first = 0; first < 3 && orthogonal; first++)
+		{
+			for (int second = first + 1; second < 3; second++)
+			{
+				const float cosine = rotation.m[0][first] * rotation.m[0][second] + rotation.m[1][first] * rotation.m[1][second] + rotation.m[2][first] * rotation.m[2][second];
+				orthogonal = orthogonal && std::fabs(cosine) <= shearTolerance;
+			}
+		}
+
+		if (orthogonal)
+		{
+			const float determinant =
+				rotation.m[0][0] * (rotation.m[1][1] * rotation.m[2][2] - rotation.m[2][1] * rotation.m[1][2]) -
+				rotation.m[0][1] * (rotation.m[1][0] * rotation.m[2][2] - rotation.m[2][0] * rotation.m[1][2]) +
+				rotation.m[0][2] * (rotation.m[1][0] * rotation.m[2][1] - rotation.m[2][0] * rotation.m[1][1]);
+
+			if (determinant < 0.f)
+			{
+				scale[0] = -scale[0];
+
+				for (int row = 0; row < 3; row++)
+					rotation.m[row][0] = -rotation.m[row][0];
+			}
+
+			result.rotation = toQuaternion(rotation);
+			result.scale.set(scale[0], scale[1], scale[2]);
+			result.sheared = false;
+			return;
+		}
+
+		Matrix<float> a;
+		Matrix<float> stretch;
+
+		for (int row = 0; row < 3; row++)
+		{
+			for (int column = 0; column < 3; column++)
+				a.m[row][column] = data[column * 4 + row];
+		}
+
+		polarKernel<float, bool>(a, rotation, stretch);
+		result.rotation = toQuaternion(rotation);
+		result.scale.set(stretch.m[0][0], stretch.m[1][1], stretch.m[2][2]);
+
+		// Degenerate matrices end up here too, they only count as sheared if the stretch isn't diagonal.
+		const float largest = std::fmax(std::fabs(stretch.m[0][0]), std::fmax(std::fabs(stretch.m[1][1]), std::fabs(stretch.m[2][2])));
+		const float offDiagonal = std::fmax(std::fabs(stretch.m[1][0]), std::fmax(std::fabs(stretch.m[2][0]), std::fabs(stretch.m[2][1])));
+		result.sheared = offDiagonal > shearTolerance * largest;
+	}
+
+	void load(const re::Matrix3& matrix, Matrix<float>& result)
+	{
+		const float* data = static_cast<const float*>(matrix);
+
+		for (int row = 0; row < 3; row++)
+		{
+			for (int column = 0; column < 3; column++)
+				result.m[row][column] = data[column * 3 + row];
+		}
+	}
+
+	void store(const Matrix<float>& matrix, re::Matrix3& result)
+	{
+		float* data = static_cast<float*>(result);
+
+		for (int row = 0; row < 3; row++)
+		{
+			for (int column = 0; column < 3; column++)
+				data[column * 3 + row] = matrix.m[row][column];
+		}
+	}
+
+#ifdef RE_MATH_SSE
+	// Matrix3 data is accessed through the conversion operator once per matrix, the elements are
+	// then transposed from array of structures into lanes.
+	void load4(const re::Matrix3* matrices, Matrix<Float4>& result)
+	{
+		const float* data[4];
+
+		for (int lane = 0; lane < 4; lane++)
+			data[lane] = static_cast<const float*>(matrices[lane]);
+
+		for (int row = 0; row < 3; row++)
+		{
+			for (int column = 0; column < 3; column++)
+			{
+				const int index = column * 3 + row;
+				result.m[row][column] = _mm_setr_ps(data[0][index], data[1][index], data[2][index], data[3][index]);
+			}
+		}
+	}
+
+	void store4(const Matrix<Float4>& matrix, re::Matrix3* result)
+	{
+		float* data[4];
+
+		for (int lane = 0; lane < 4; lane++)
+			data[lane] = static_cast<float*>(result[lane]);
+
+		for (int row = 0; row < 3; row++)
+		{
+			for (int column = 0; column < 3; column++)
+			{
+				float lanes[4];
+				_mm_storeu_ps(lanes, matrix.m[row][column].v);
+
+				for (int lane = 0; lane < 4; lane++)
+					data[lane][column * 3 + row] = lanes[lane];
+			}
+		}
+	}
+
+	void store4(const Float4 values[3], re::Vec3d* result)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			float lanes[4];
+			_mm_storeu_ps(lanes, values[i].v);
+
+			for (int lane = 0; lane < 4; lane++)
+				result[lane].d[i] = lanes[lane];
+		}
+	}
+#endif
+}
+
+
+void re::eigenSymmetricN(const Matrix3* matrices, size_t count, Vec3d* values, Matrix3* vectors)
+{
+	parallelFor(count, 2 * sizeof(Matrix3) + sizeof(Vec3d), [=](size_t begin, size_t end)
+	{
+		size_t i = begin;
+
+#ifdef RE_MATH_SSE
+		const DenormalGuard guard;
+
+		for (; i + 4 <= end; i += 4)
+		{
+			Matrix<Float4> a;
+			Matrix<Float4> v;
+			Float4 lambda[3];
+			load4(matrices + i, a);
+			eigenKernel<Float4, Mask4>(a, lambda, v);
+			store4(v, vectors + i);
+			store4(lambda, values + i);
+		}
+#endif
+
+		for (; i < end; i++)
+		{
+			Matrix<float> a;
+			Matrix<float> v;
+			float lambda[3];
+			load(matrices[i], a);
+			eigenKernel<float, bool>(a, lambda, v);
+			store(v, vectors[i]);
+			values[i].set(lambda[0], lambda[1], lambda[2]);
+		}
+	});
+}
+
+
+void re::svdN(const Matrix3* matrices, size_t count, Matrix3* u, Vec3d* sigma, Matrix3* v)
+{
+	parallelFor(count, 3 * sizeof(Matrix3) + sizeof(Vec3d), [=](size_t begin, size_t end)
+	{
+		size_t i = begin;
+
+#ifdef RE_MATH_SSE
+		const DenormalGuard guard;
+
+		for (; i + 4 <= end; i += 4)
+		{
+			Matrix<Float4> a;
+			Matrix<Float4> left;
+			Matrix<Float4> right;
+			Float4 values[3];
+			load4(matrices + i, a);
+			svdKernel<Float4, Mask4>(a, left, values, right);
+			store4(left, u + i);
+			store4(right, v + i);
+			store4(values, sigma + i);
+		}
+#endif
+
+		for (; i < end; i++)
+		{
+			Matrix<float> a;
+			Matrix<float> left;
+			Matrix<float> right;
+			float values[3];
+			load(matrices[i], a);
+			svdKernel<float, bool>(a, left, values, right);
+			store(left, u[i]);
+			store(right, v[i]);
+			sigma[i].set(values[0], values[1], values[2]);
+		}
+	});
+}
+
+
+void re::polarDecomposition(const Matrix3& matrix, Matrix3& rotation, Matrix3& stretch)
+{
+	polarDecompositionN(&matrix, 1, &rotation, &stretch);
+}
+
+
+void re::polarDecompositionN(const Matrix3* matrices, size_t count, Matrix3* rotations, Matrix3* stretches)
+{
+	parallelFor(count, 3 * sizeof(Matrix3), [=](size_t begin, size_t end)
+	{
+		size_t i = begin;
+
+#ifdef RE_MATH_SSE
+		const DenormalGuard guard;
+
+		for (; i + 4 <= end; i += 4)
+		{
+			Matrix<Float4> a;
+			Matrix<Float4> rotation;
+			Matrix<Float4> stretch;
+			load4(matrices + i, a);
+			polarKernel<Float4, Mask4>(a, rotation, stretch);
+			store4(rotation, rotations + i);
+			store4(stretch, stretches + i);
+		}
+#endif
+
+		for (; i < end; i++)
+		{
+			Matrix<float> a;
+			Matrix<float> rotation;
+			Matrix<float> stretch;
+			load(matrices[i], a);
+			polarKernel<float, bool>(a, rotation, stretch);
+			store(rotation, rotations[i]);
+			store(stretch, stretches[i]);
+		}
+	});
+}
+
+
+re::TransformComponents re::decompose(const Matrix4& matrix, float shearTolerance)
+{
+	TransformComponents result;
+	decomposeN(&matrix, 1, &result, shearTolerance);
+	return result;
+}
+
+
+void re::decomposeN(const Matrix4* matrices, size_t count, TransformComponents* components, float shearTolerance)
+{
+	parallelFor(count, sizeof(Matrix4) + sizeof(TransformComponents), [=](size_t begin, size_t end)
+	{
+#ifdef RE_MATH_SSE
+		const DenormalGuard guard;
+#endif
+
+		for (size_t i = begin; i < end; i++)
+			decomposeMatrix(matrices[i], shearTolerance, components[i]);
+	});
+}
@@ -0,0 +1,142 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reFrameArena.cpp
+// Project:     reMath
+// Description: Implementation of FrameArena class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "reMath/reFrameArena.h"
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+
+namespace
+{
+	// Size of the first block when the arena was created without capacity.
+	const size_t MIN_BLOCK_SIZE = 64 * 1024;
+}
+
+
+re::FrameArena::FrameArena(size_t capacity)
+{
+	if (capacity)
+		addBlock(capacity);
+}
+
+
+re::FrameArena::~FrameArena()
+{
+	release();
+}
+
+
+void* re::FrameArena::allocate(size_t size, size_t alignment)
+{
+	assert(alignment && !(alignment & (alignment - 1)));
+
+	while (true)
+	{
+		if (block_ < blocks_.size())
+		{
+			const Block& block = blocks_[block_];
+			const auto address = reinterpret_cast<uintptr_t>(block.data) + offset_;
+			const size_t padding = (alignment - address % alignment) % alignment;
+
+			if (offset_ + padding + size <= block.size)
+			{
+				void* result = block.data + offset_ + padding;
+				offset_ += padding + size;
+				return result;
+			}
+
+			// Continue with the next block left from the previous frames, if any.
+			if (block_ + 1 < blocks_.size())
+			{
+				block_++;
+				offset_ = 0;
+				continue;
+			}
+		}
+
+		// Out of memory - add an overflow block which will be merged on reset.
+		const size_t total = capacity();
+		addBlock(std::max(std::max(total, MIN_BLOCK_SIZE), size + alignment));
+		block_ = blocks_.size() - 1;
+		offset_ = 0;
+	}
+}
+
+
+re::FrameArena::Marker re::FrameArena::mark() const
+{
+	return { block_, offset_ };
+}
+
+
+void re::FrameArena::rewind(const Marker& marker)
+{
+	assert(marker.block < block_ || (marker.block == block_ && marker.offset <= offset_));
+	block_ = marker.block;
+	offset_ = marker.offset;
+}
+
+
+void re::FrameArena::reset()
+{
+	if (blocks_.size() > 1)
+	{
+		const size_t total = capacity();
+		release();
+		addBlock(total);
+	}
+
+	block_ = 0;
+	offset_ = 0;
+}
+
+
+size_t re::FrameArena::used() const
+{
+	size_t result = offset_;
+
+	for (size_t i = 0; i < block_ && i < blocks_.size(); i++)
+		result += blocks_[i].size;
+
+	return result;
+}
+
+
+size_t re::FrameArena::capacity() const
+{
+	size_t result = 0;
+
+	for (const auto& block : blocks_)
+		result += block.size;
+
+	return result;
+}
+
+
+re::FrameArena& re::FrameArena::threadLocal()
+{
+	thread_local FrameArena arena;
+	return arena;
+}
+
+
+void re::FrameArena::addBlock(size_t size)
+{
+	blocks_.push_back({ new unsigned char[size], size });
+}
+
+
+void re::FrameArena::release()
+{
+	for (auto& block : blocks_)
+		delete[] block.data;
+
+	blocks_.clear();
+}
@@ -0,0 +1,509 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reICP.cpp
+// Project:     reMath
+// Description: Implementation of iterative closest point registration
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "reMath/reICP.h"
+#include "reMath/reKdTree.h"
+#include "reMath/reQuaternion.h"
+#include "reMath/reParallel.h"
+#include "reMath/reFrameArena.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+	// Rigid transformation x' = R x + t, R is row-major.
+	struct Rigid
+	{
+		float r[9];
+		float t[3];
+	};
+
+	// Sums of the point-to-point solver.
+	struct PointSums
+	{
+		double count = 0.0;
+		double error = 0.0;
+		double source[3] = { 0.0, 0.0, 0.0 };
+		double target[3] = { 0.0, 0.0, 0.0 };
+		double products[9] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+
+		void operator += (const PointSums& sums)
+		{
+			count += sums.count;
+			error += sums.error;
+
+			for (int i = 0; i < 3; i++)
+			{
+				source[i] += sums.source[i];
+				target[i] += sums.target[i];
+			}
+
+			for (int i = 0; i < 9; i++)
+				products[i] += sums.products[i];
+		}
+	};
+
+	// Normal equations of the point-to-plane solver.
+	struct PlaneSums
+	{
+		double count = 0.0;
+		double error = 0.0;
+		double normal[36] = {};
+		double right[6] = {};
+
+		void operator += (const PlaneSums& sums)
+		{
+			count += sums.count;
+			error += sums.error;
+
+			for (int i = 0; i < 36; i++)
+				normal[i] += sums.normal[i];
+
+			for (int i = 0; i < 6; i++)
+				right[i] += sums.right[i];
+		}
+	};
+
+	// Sums per-element contributions in parallel blocks, the block count doesn't depend on
+	// timing so the result is deterministic.
+	template <typename Sums, typename Body>
+	Sums parallelSum(size_t count, const Body& body)
+	{
+		re::Executor& executor = re::getExecutor();
+		const size_t blockCount = std::max<size_t>(1, std::min(executor.concurrency(), count / re::PARALLEL_MIN_CHUNK));
+		const size_t blockSize = (count + blockCount - 1) / blockCount;
+		std::vector<Sums> blocks(blockCount);
+
+		executor.run(blockCount, [&](size_t block)
+		{
+			for (size_t i = block * blockSize, end = std::min(count, i + blockSize); i < end; i++)
+				body(blocks[block], i);
+		});
+
+		Sums result;
+
+		for (const Sums& sums : blocks)
+			result += sums;
+
+		return result;
+	}
+
+	// Cyclic Jacobi eigen decomposition of a symmetric 4x4 matrix, eigenvectors are columns.
+	void jacobiEigen4(double a[16], double vectors[16], double values[4])
+	{
+		for (int i = 0; i < 16; i++)
+			vectors[i] = i % 5 == 0 ? 1.0 : 0.0;
+
+		for (int sweep = 0; sweep < 50; sweep++)
+		{
+			double offDiagonal = 0.0;
+
+			for (int p = 0; p < 4; p++)
+			{
+				for (int q = p + 1; q < 4; q++)
+					offDiagonal += a[p * 4 + q] * a[p * 4 + q];
+			}
+
+			if (offDiagonal < 1e-30)
+				break;
+
+			for (int p = 0; p < 4; p++)
+			{
+				for (int q = p + 1; q < 4; q++)
+				{
+					if (std::fabs(a[p * 4 + q]) < 1e-300)
+						continue;
+
+					const double theta = (a[q * 4 + q] - a[p * 4 + p]) / (2.0 * a[p * 4 + q]);
+					const double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+					const double c = 1.0 / std::sqrt(t * t + 1.0);
+					const double s = t * c;
+
+					for (int k = 0; k < 4; k++)
+					{
+						const double kp = a[k * 4 + p];
+						const double kq = a[k * 4 + q];
+						a[k * 4 + p] = c * kp - s * kq;
+						a[k * 4 + q] = s * kp + c * kq;
+					}
+
+					for (int k = 0; k < 4; k++)
+					{
+						const double pk = a[p * 4 + k];
+						const double qk = a[q * 4 + k];
+						a[p * 4 + k] = c * pk - s * qk;
+						a[q * 4 + k] = s * pk + c * qk;
+					}
+
+					for (int k = 0; k < 4; k++)
+					{
+						const double kp = vectors[k * 4 + p];
+						const double kq = vectors[k * 4 + q];
+						vectors[k * 4 + p] = c * kp - s * kq;
+						vectors[k * 4 + q] = s * kp + c * kq;
+					}
+				}
+			}
+		}
+
+		for (int i = 0; i < 4; i++)
+			values[i] = a[i * 5];
+	}
+
+	// Solves the 6x6 system with partial pivoting, directions without constraints stay at zero.
+	void solve6(double a[36], double b[6], double x[6])
+	{
+		int rows[6] = { 0, 1, 2, 3, 4, 5 };
+		double scale = 0.0;
+
+		for (int i = 0; i < 6; i++)
+			scale = std::max(scale, std::fabs(a[i * 7]));
+
+		const double epsilon = scale * 1e-9;
+		bool valid[6];
+
+		for (int column = 0; column < 6; column++)
+		{
+			int pivot = column;
+
+			for (int row = column + 1; row < 6; row++)
+			{
+				if (std::fabs(a[rows[row] * 6 + column]) > std::fabs(a[rows[pivot] * 6 + column]))
+					pivot = row;
+			}
+
+			std::swap(rows[column], rows[pivot]);
+			const double* pivotRow = a + rows[column] * 6;
+			valid[column] = std::fabs(pivotRow[column]) > epsilon;
+
+			if (!valid[column])
+				continue;
+
+			for (int row = column + 1; row < 6; row++)
+			{
+				double* target = a + rows[row] * 6;
+				const double factor = target[column] / pivotRow[column];
+
+				for (int k = column; k < 6; k++)
+					target[k] -= factor * pivotRow[k];
+
+				b[rows[row]] -= factor * b[rows[column]];
+			}
+		}
+
+		for (int column = 5; column >= 0; column--)
+		{
+			x[column] = 0.0;
+
+			if (!valid[column])
+				continue;
+
+			const double* row = a + rows[column] * 6;
+			double sum = b[rows[column]];
+
+			for (int k = column + 1; k < 6; k++)
+				sum -= row[k] * x[k];
+
+			x[column] = sum / row[column];
+		}
+	}
+
+	re::Vec3d apply(const Rigid& rigid, const re::Vec3d& point)
+	{
+		const float* r = rigid.r;
+		return re::Vec3d(
+			r[0] * point.x + r[1] * point.y + r[2] * point.z + rigid.t[0],
+			r[3] * point.x + r[4] * point.y + r[5] * point.z + rigid.t[1],
+			r[6] * point.x + r[7] * point.y + r[8] * point.z + rigid.t[2]);
+	}
+
+	// Applies the step after the current transformation.
+	void compose(Rigid& rigid, const Rigid& step)
+	{
+		Rigid result;
+
+		for (int row = 0; row < 3; row++)
+		{
+			for (int column = 0; column < 3; column++)
+			{
+				result.r[row * 3 + column] =
+					step.r[row * 3] * rigid.r[column] +
+					step.r[row * 3 + 1] * rigid.r[3 + column] +
+					step.r[row * 3 + 2] * rigid.r[6 + column];
+			}
+
+			result.t[row] = step.r[row * 3] * rigid.t[0] + step.r[row * 3 + 1] * rigid.t[1] + step.r[row * 3 + 2] * rigid.t[2] + step.t[row];
+		}
+
+		rigid = result;
+	}
+
+	void setRotation(Rigid& rigid, const re::Quaternion& rotation)
+	{
+		// Quaternion matrices are column-major.
+		const re::Matrix4 matrix = rotation.getMatrix();
+
+		for (int row = 0; row < 3; row++)
+		{
+			for (int column = 0; column < 3; column++)
+				rigid.r[row * 3 + column] = matrix[column * 4 + row];
+		}
+	}
+
+	// Horn's method: the rotation is the eigenvector of the largest eigenvalue of a symmetric
+	// 4x4 matrix built from the cross-covariance of the centered correspondences.
+	Rigid solvePointToPoint(const PointSums& sums)
+	{
+		double source[3];
+		double target[3];
+		double s[9];
+
+		for (int i = 0; i < 3; i++)
+		{
+			source[i] = sums.source[i] / sums.count;
+			target[i] = sums.target[i] / sums.count;
+		}
+
+		for (int i = 0; i < 3; i++)
+		{
+			for (int j = 0; j < 3; j++)
+				s[i * 3 + j] = sums.products[i * 3 + j] / sums.count - source[i] * target[j];
+		}
+
+		const double xx = s[0], xy = s[1], xz = s[2];
+		const double yx = s[3], yy = s[4], yz = s[5];
+		const double zx = s[6], zy = s[7], zz = s[8];
+		double n[16] =
+		{
+			xx + yy + zz, yz - zy, zx - xz, xy - yx,
+			yz - zy, xx - yy - zz, xy + yx, zx + xz,
+			zx - xz, xy + yx, -xx + yy - zz, yz + zy,
+			xy - yx, zx + xz, yz + zy, -xx - yy + zz
+		};
+
+		double vectors[16];
+		double values[4];
+		jacobiEigen4(n, vectors, values);
+
+		int largest = 0;
+
+		for (int i = 1; i < 4; i++)
+		{
+			if (values[i] > values[largest])
+				largest = i;
+		}
+
+		re::Quaternion rotation(
+			static_cast<float>(vectors[4 + largest]),
+			static_cast<float>(vectors[8 + largest]),
+			static_cast<float>(vectors[12 + largest]),
+			static_cast<float>(vectors[largest]));
+		rotation.normalize();
+
+		Rigid result;
+		setRotation(result, rotation);
+
+		for (int i = 0; i < 3; i++)
+		{
+			const float* r = result.r + i * 3;
+			result.t[i] = static_cast<float>(target[i] - (r[0] * source[0] + r[1] * source[1] + r[2] * source[2]));
+		}
+
+		return result;
+	}
+
+	// Minimizes the linearized plane distances: the rotation is approximated by R = I + [w]x,
+	// so every correspondence gives one linear equation in (w, t).
+	Rigid solvePointToPlane(PlaneSums& sums)
+	{
+		double x[6];
+		solve6(sums.normal, sums.right, x);
+
+		const double angle = std::sqrt(x[0] * x[0] + x[1] * x[1] + x[2] * x[2]);
+		re::Quaternion rotation(0.f, 0.f, 0.f, 1.f);
+
+		if (angle > 0.0)
+		{
+			const double factor = std::sin(angle / 2.0) / angle;
+			rotation.set(
+				static_cast<float>(x[0] * factor),
+				static_cast<float>(x[1] * factor),
+				static_cast<float>(x[2] * factor),
+				static_cast<float>(std::cos(angle / 2.0)));
+		}
+
+		Rigid result;
+		setRotation(result, rotation);
+
+		for (int i = 0; i < 3; i++)
+			result.t[i] = static_cast<float>(x[3 + i]);
+
+		return result;
+	}
+}
+
+
+re::RegistrationResult re::icp(const Vec3d* source, size_t sourceCount, const Vec3d* target, const KdTree& targetTree,
+	const Matrix4& initial, const RegistrationSettings& settings)
+{
+	Rigid rigid;
+
+	for (int row = 0; row < 3; row++)
+	{
+		for (int column = 0; column < 3; column++)
+			rigid.r[row * 3 + column] = initial[column * 4 + row];
+
+		rigid.t[row] = initial[12 + row];
+	}
+
+	FrameArena& scratch = FrameArena::threadLocal();
+	const auto marker = scratch.mark();
+	Vec3d* moved = scratch.allocate<Vec3d>(sourceCount);
+	unsigned int* matches = scratch.allocate<unsigned int>(sourceCount);
+	float* distances = scratch.allocate<float>(sourceCount);
+	float* sorted = settings.rejectionFactor > 0.f ? scratch.allocate<float>(sourceCount) : nullptr;
+
+	const Vec3d* normals = settings.targetNormals;
+	const size_t minInliers = normals ? 6 : 3;
+	RegistrationResult result;
+	float previousError = FLT_MAX;
+	float initialError = 0.f;
+
+	for (result.iterations = 0; result.iterations < settings.maxIterations && sourceCount >= minInliers; )
+	{
+		result.iterations++;
+
+		parallelFor(sourceCount, 2 * sizeof(Vec3d), [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+				moved[i] = apply(rigid, source[i]);
+		});
+
+		targetTree.findNearestN(moved, sourceCount, matches, distances);
+
+		float threshold = settings.maxDistance < FLT_MAX ? settings.maxDistance * settings.maxDistance : FLT_MAX;
+
+		if (sorted)
+		{
+			std::copy(distances, distances + sourceCount, sorted);
+			std::nth_element(sorted, sorted + sourceCount / 2, sorted + sourceCount);
+			const float factor = settings.rejectionFactor * settings.rejectionFactor;
+			threshold = std::min(threshold, sorted[sourceCount / 2] * factor);
+		}
+
+		Rigid step;
+		double count;
+		double error;
+
+		if (normals)
+		{
+			PlaneSums sums = parallelSum<PlaneSums>(sourceCount, [&](PlaneSums& block, size_t i)
+			{
+				if (distances[i] > threshold)
+					return;
+
+				const Vec3d& point = moved[i];
+				const Vec3d& normal = normals[matches[i]];
+				const Vec3d arm = point.cross(normal);
+				const double row[6] = { arm.x, arm.y, arm.z, normal.x, normal.y, normal.z };
+				const double residual = (point - target[matches[i]]).dot(normal);
+
+				for (int j = 0; j < 6; j++)
+				{
+					for (int k = 0; k < 6; k++)
+						block.normal[j * 6 + k] += row[j] * row[k];
+
+					block.right[j] -= row[j] * residual;
+				}
+
+				block.count += 1.0;
+				block.error += residual * residual;
+			});
+
+			count = sums.count;
+			error = sums.error;
+
+			if (count >= minInliers)
+				step = solvePointToPlane(sums);
+		}
+		else
+		{
+			const PointSums sums = parallelSum<PointSums>(sourceCount, [&](PointSums& block, size_t i)
+			{
+				if (distances[i] > threshold)
+					return;
+
+				const Vec3d& point = moved[i];
+				const Vec3d& match = target[matches[i]];
+
+				for (int j = 0; j < 3; j++)
+				{
+					block.source[j] += point.d[j];
+					block.target[j] += match.d[j];
+
+					for (int k = 0; k < 3; k++)
+						block.products[j * 3 + k] += static_cast<double>(point.d[j]) * match.d[k];
+				}
+
+				block.count += 1.0;
+				block.error += distances[i];
+			});
+
+			count = sums.count;
+			error = sums.error;
+
+			if (count >= minInliers)
+				step = solvePointToPoint(sums);
+		}
+
+		result.inlierCount = static_cast<size_t>(count);
+
+		if (count < minInliers)
+			break;
+
+		result.error = static_cast<float>(std::sqrt(error / count));
+		compose(rigid, step);
+
+		if (result.iterations == 1)
+			initialError = result.error;
+
+		// Changes relative to the initial error also stop the iterations at the noise floor,
+		// where the error fluctuates around a tiny value.
+		if (std::fabs(previousError - result.error) <= settings.tolerance * std::max(initialError, FLT_MIN))
+		{
+			result.converged = true;
+			break;
+		}
+
+		previousError = result.error;
+	}
+
+	scratch.rewind(marker);
+
+	for (int row = 0; row < 3; row++)
+	{
+		for (int column = 0; column < 3; column++)
+			result.transform[column * 4 + row] = rigid.r[row * 3 + column];
+
+		result.transform[12 + row] = rigid.t[row];
+	}
+
+	return result;
+}
+
+
+re::RegistrationResult re::icp(const Vec3d* source, size_t sourceCount, const Vec3d* target, size_t targetCount,
+	const Matrix4& initial, const RegistrationSettings& settings)
+{
+	KdTree tree;
+	tree.build(target, targetCount);
+	return icp(source, sourceCount, target, tree, initial, settings);
+}
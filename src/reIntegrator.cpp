@@ -0,0 +1,361 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reIntegrator.cpp
+// Project:     reMath
+// Description: Implementation of rigid body integration kernels
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "reMath/reIntegrator.h"
+#include "reMath/reMatrix3.h"
+#include "reMath/reMatrix4.h"
+#include "reMath/reQuaternion.h"
+#include "reMath/reParallel.h"
+#include "reMath/reMathUtil.h"
+#include "reSimd.h"
+#include <cmath>
+
+#ifdef RE_MATH_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+	// Bytes of the body state touched by a step, for the parallel chunk size.
+	const size_t BODY_BYTES = sizeof(re::Vec3d) * 6 + sizeof(re::Quaternion) + sizeof(re::Matrix3) * 2 + sizeof(float);
+
+	void kick(const re::RigidBodies& bodies, size_t i, float timeStep)
+	{
+		const float inverseMass = bodies.inverseMasses ? bodies.inverseMasses[i] : 1.f;
+
+		if (inverseMass > 0.f)
+		{
+			re::Vec3d acceleration(bodies.gravity);
+
+			if (bodies.forces)
+				acceleration += bodies.forces[i] * inverseMass;
+
+			bodies.linearVelocities[i] += acceleration * timeStep;
+		}
+
+		if (bodies.torques && bodies.localInverseInertias)
+		{
+			const re::Quaternion& orientation = bodies.orientations[i];
+			re::Vec3d acceleration(bodies.torques[i]);
+			orientation.toConjugated().rotate(acceleration);
+			bodies.localInverseInertias[i].rotate(acceleration);
+			orientation.rotate(acceleration);
+			bodies.angularVelocities[i] += acceleration * timeStep;
+		}
+	}
+
+	void drift(const re::RigidBodies& bodies, size_t i, float timeStep)
+	{
+		bodies.positions[i] += bodies.linearVelocities[i] * timeStep;
+
+		// World space angular velocity rotates by exp(w * dt / 2) from the left.
+		const re::Vec3d& velocity = bodies.angularVelocities[i];
+		const float half = 0.5f * timeStep;
+		re::Quaternion& orientation = bodies.orientations[i];
+		orientation = re::Quaternion(velocity.x * half, velocity.y * half, velocity.z * half, 0.f).exp() * orientation;
+		orientation.normalize();
+
+		if (bodies.worldInverseInertias && bodies.localInverseInertias)
+		{
+			const re::Matrix3 rotation(orientation.getMatrix());
+			bodies.worldInverseInertias[i] = rotation * bodies.localInverseInertias[i] * rotation.toTransposed();
+		}
+	}
+
+#ifdef RE_MATH_SSE
+	using namespace re::simd;
+
+	// Largest squared half angle of a step evaluated by the series, error of the truncated terms is below 3e-8.
+	const float SERIES_LIMIT = 0.61685028f;
+
+	inline __m128 multiplyAdd(__m128 a, __m128 b, __m128 c)
+	{
+		return _mm_add_ps(_mm_mul_ps(a, b), c);
+	}
+
+	inline void loadQuaternions(const re::Quaternion* q, __m128& x, __m128& y, __m128& z, __m128& w)
+	{
+		x = _mm_loadu_ps(q[0].d);
+		y = _mm_loadu_ps(q[1].d);
+		z = _mm_loadu_ps(q[2].d);
+		w = _mm_loadu_ps(q[3].d);
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+	}
+
+	inline void storeQuaternions(__m128 x, __m128 y, __m128 z, __m128 w, re::Quaternion* q)
+	{
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		_mm_storeu_ps(q[0].d, x);
+		_mm_storeu_ps(q[1].d, y);
+		_mm_storeu_ps(q[2].d, z);
+		_mm_storeu_ps(q[3].d, w);
+	}
+
+	// Gathers the column-major elements of four matrices, m[column * 3 + row].
+	inline void loadMatrices(const re::Matrix3* matrices, __m128 m[9])
+	{
+		const float* a = static_cast<const float*>(matrices[0]);
+		const float* b = static_cast<const float*>(matrices[1]);
+		const float* c = static_cast<const float*>(matrices[2]);
+		const float* d = static_cast<const float*>(matrices[3]);
+
+		for (int k = 0; k < 9; k++)
+			m[k] = _mm_setr_ps(a[k], b[k], c[k], d[k]);
+	}
+
+	inline void storeMatrices(const __m128 m[9], re::Matrix3* matrices)
+	{
+		float lanes[9][4];
+
+		for (int k = 0; k < 9; k++)
+			_mm_storeu_ps(lanes[k], m[k]);
+
+		for (int j = 0; j < 4; j++)
+		{
+			float* data = static_cast<float*>(matrices[j]);
+
+			for (int k = 0; k < 9; k++)
+				data[k] = lanes[k][j];
+		}
+	}
+
+	// Rotation matrix of four normalized quaternions, the same layout as Quaternion::getMatrix().
+	inline void rotationMatrices(__m128 x, __m128 y, __m128 z, __m128 w, __m128 r[9])
+	{
+		const __m128 one = _mm_set1_ps(1.f);
+		const __m128 x2 = _mm_add_ps(x, x);
+		const __m128 y2 = _mm_add_ps(y, y);
+		const __m128 z2 = _mm_add_ps(z, z);
+		const __m128 xx = _mm_mul_ps(x, x2);
+		const __m128 yy = _mm_mul_ps(y, y2);
+		const __m128 zz = _mm_mul_ps(z, z2);
+		const __m128 xy = _mm_mul_ps(x, y2);
+		const __m128 xz = _mm_mul_ps(x, z2);
+		const __m128 yz = _mm_mul_ps(y, z2);
+		const __m128 xw = _mm_mul_ps(w, x2);
+		const __m128 yw = _mm_mul_ps(w, y2);
+		const __m128 zw = _mm_mul_ps(w, z2);
+
+		r[0] = _mm_sub_ps(one, _mm_add_ps(yy, zz));
+		r[1] = _mm_add_ps(xy, zw);
+		r[2] = _mm_sub_ps(xz, yw);
+		r[3] = _mm_sub_ps(xy, zw);
+		r[4] = _mm_sub_ps(one, _mm_add_ps(xx, zz));
+		r[5] = _mm_add_ps(yz, xw);
+		r[6] = _mm_add_ps(xz, yw);
+		r[7] = _mm_sub_ps(yz, xw);
+		r[8] = _mm_sub_ps(one, _mm_add_ps(xx, yy));
+	}
+
+	// Four symmetric products r * m * r^T of column-major matrices.
+	inline void conjugateMatrices(const __m128 r[9], const __m128 m[9], __m128 result[9])
+	{
+		__m128 t[9];
+
+		for (int column = 0; column < 3; column++)
+		{
+			for (int row = 0; row < 3; row++)
+			{
+				t[column * 3 + row] = multiplyAdd(r[row], m[column * 3],
+					multiplyAdd(r[3 + row], m[column * 3 + 1], _mm_mul_ps(r[6 + row], m[column * 3 + 2])));
+			}
+		}
+
+		for (int column = 0; column < 3; column++)
+		{
+			for (int row = column; row < 3; row++)
+			{
+				result[column * 3 + row] = multiplyAdd(t[row], r[column],
+					multiplyAdd(t[3 + row], r[3 + column], _mm_mul_ps(t[6 + row], r[6 + column])));
+				result[row * 3 + column] = result[column * 3 + row];
+			}
+		}
+	}
+
+	// Rotation of exp(w * dt / 2), cos(angle) and sin(angle) / angle come from their series in the squared angle.
+	inline void exponentialMap(__m128& x, __m128& y, __m128& z, __m128& w)
+	{
+		const __m128 squared = multiplyAdd(x, x, multiplyAdd(y, y, _mm_mul_ps(z, z)));
+		__m128 sine = multiplyAdd(squared, _mm_set1_ps(1.f / 362880.f), _mm_set1_ps(-1.f / 5040.f));
+		sine = multiplyAdd(squared, sine, _mm_set1_ps(1.f / 120.f));
+		sine = multiplyAdd(squared, sine, _mm_set1_ps(-1.f / 6.f));
+		sine = multiplyAdd(squared, sine, _mm_set1_ps(1.f));
+
+		__m128 cosine = multiplyAdd(squared, _mm_set1_ps(1.f / 40320.f), _mm_set1_ps(-1.f / 720.f));
+		cosine = multiplyAdd(squared, cosine, _mm_set1_ps(1.f / 24.f));
+		cosine = multiplyAdd(squared, cosine, _mm_set1_ps(-0.5f));
+		cosine = multiplyAdd(squared, cosine, _mm_set1_ps(1.f));
+
+		// Rotations over a quarter turn per step are rare, their lanes go through the library functions.
+		if (_mm_movemask_ps(_mm_cmpgt_ps(squared, _mm_set1_ps(SERIES_LIMIT))))
+		{
+			float angles[4], sines[4], cosines[4];
+			_mm_storeu_ps(angles, squared);
+			_mm_storeu_ps(sines, sine);
+			_mm_storeu_ps(cosines, cosine);
+
+			for (int j = 0; j < 4; j++)
+			{
+				if (angles[j] > SERIES_LIMIT)
+				{
+					const float angle = sqrtf(angles[j]);
+					sines[j] = sinf(angle) / angle;
+					cosines[j] = cosf(angle);
+				}
+			}
+
+			sine = _mm_loadu_ps(sines);
+			cosine = _mm_loadu_ps(cosines);
+		}
+
+		x = _mm_mul_ps(x, sine);
+		y = _mm_mul_ps(y, sine);
+		z = _mm_mul_ps(z, sine);
+		w = cosine;
+	}
+#endif
+
+	template<bool Kick, bool Drift>
+	void integrate(const re::RigidBodies& bodies, size_t begin, size_t end, float timeStep)
+	{
+		size_t i = begin;
+
+#ifdef RE_MATH_SSE
+		const __m128 step = _mm_set1_ps(timeStep);
+		const bool torques = bodies.torques && bodies.localInverseInertias;
+		const bool inertias = bodies.worldInverseInertias && bodies.localInverseInertias;
+
+		for (; i + 4 <= end; i += 4)
+		{
+			__m128 qx, qy, qz, qw, vx, vy, vz, wx, wy, wz;
+			loadQuaternions(bodies.orientations + i, qx, qy, qz, qw);
+			load4(bodies.linearVelocities + i, vx, vy, vz);
+			load4(bodies.angularVelocities + i, wx, wy, wz);
+
+			if (Kick)
+			{
+				// Static bodies get a zero step.
+				const __m128 inverseMass = bodies.inverseMasses ? _mm_loadu_ps(bodies.inverseMasses + i) : _mm_set1_ps(1.f);
+				const __m128 linearStep = _mm_and_ps(_mm_cmpgt_ps(inverseMass, _mm_setzero_ps()), step);
+				__m128 ax = _mm_set1_ps(bodies.gravity.x);
+				__m128 ay = _mm_set1_ps(bodies.gravity.y);
+				__m128 az = _mm_set1_ps(bodies.gravity.z);
+
+				if (bodies.forces)
+				{
+					__m128 fx, fy, fz;
+					load4(bodies.forces + i, fx, fy, fz);
+					ax = multiplyAdd(fx, inverseMass, ax);
+					ay = multiplyAdd(fy, inverseMass, ay);
+					az = multiplyAdd(fz, inverseMass, az);
+				}
+
+				vx = multiplyAdd(ax, linearStep, vx);
+				vy = multiplyAdd(ay, linearStep, vy);
+				vz = multiplyAdd(az, linearStep, vz);
+				store4(vx, vy, vz, bodies.linearVelocities + i);
+
+				if (torques)
+				{
+					// Torque to body space, through the inverse inertia and back to world space.
+					__m128 tx, ty, tz, m[9];
+					load4(bodies.torques + i, tx, ty, tz);
+					const __m128 sign = _mm_set1_ps(-0.f);
+					rotate4(_mm_xor_ps(qx, sign), _mm_xor_ps(qy, sign), _mm_xor_ps(qz, sign), qw, tx, ty, tz);
+					loadMatrices(bodies.localInverseInertias + i, m);
+
+					__m128 bx = multiplyAdd(m[0], tx, multiplyAdd(m[3], ty, _mm_mul_ps(m[6], tz)));
+					__m128 by = multiplyAdd(m[1], tx, multiplyAdd(m[4], ty, _mm_mul_ps(m[7], tz)));
+					__m128 bz = multiplyAdd(m[2], tx, multiplyAdd(m[5], ty, _mm_mul_ps(m[8], tz)));
+					rotate4(qx, qy, qz, qw, bx, by, bz);
+
+					wx = multiplyAdd(bx, step, wx);
+					wy = multiplyAdd(by, step, wy);
+					wz = multiplyAdd(bz, step, wz);
+					store4(wx, wy, wz, bodies.angularVelocities + i);
+				}
+			}
+
+			if (Drift)
+			{
+				__m128 px, py, pz;
+				load4(bodies.positions + i, px, py, pz);
+				store4(multiplyAdd(vx, step, px), multiplyAdd(vy, step, py), multiplyAdd(vz, step, pz), bodies.positions + i);
+
+				// Rotation exp(w * dt / 2) applied from the left, q' = d * q.
+				const __m128 half = _mm_mul_ps(step, _mm_set1_ps(0.5f));
+				__m128 dx = _mm_mul_ps(wx, half);
+				__m128 dy = _mm_mul_ps(wy, half);
+				__m128 dz = _mm_mul_ps(wz, half);
+				__m128 dw;
+				exponentialMap(dx, dy, dz, dw);
+
+				__m128 x = _mm_add_ps(multiplyAdd(dw, qx, _mm_mul_ps(qw, dx)), _mm_sub_ps(_mm_mul_ps(dy, qz), _mm_mul_ps(dz, qy)));
+				__m128 y = _mm_add_ps(multiplyAdd(dw, qy, _mm_mul_ps(qw, dy)), _mm_sub_ps(_mm_mul_ps(dz, qx), _mm_mul_ps(dx, qz)));
+				__m128 z = _mm_add_ps(multiplyAdd(dw, qz, _mm_mul_ps(qw, dz)), _mm_sub_ps(_mm_mul_ps(dx, qy), _mm_mul_ps(dy, qx)));
+				__m128 w = _mm_sub_ps(_mm_mul_ps(dw, qw), multiplyAdd(dx, qx, multiplyAdd(dy, qy, _mm_mul_ps(dz, qz))));
+
+				// Renormalization removes the drift of the unit length.
+				const __m128 scale = rsqrtFast4(multiplyAdd(x, x, multiplyAdd(y, y, multiplyAdd(z, z, _mm_mul_ps(w, w)))));
+				x = _mm_mul_ps(x, scale);
+				y = _mm_mul_ps(y, scale);
+				z = _mm_mul_ps(z, scale);
+				w = _mm_mul_ps(w, scale);
+				storeQuaternions(x, y, z, w, bodies.orientations + i);
+
+				if (inertias)
+				{
+					__m128 r[9], m[9], result[9];
+					rotationMatrices(x, y, z, w, r);
+					loadMatrices(bodies.localInverseInertias + i, m);
+					conjugateMatrices(r, m, result);
+					storeMatrices(result, bodies.worldInverseInertias + i);
+				}
+			}
+		}
+#endif
+
+		for (; i < end; i++)
+		{
+			if (Kick)
+				kick(bodies, i, timeStep);
+
+			if (Drift)
+				drift(bodies, i, timeStep);
+		}
+	}
+}
+
+
+void re::integrateN(const RigidBodies& bodies, float timeStep)
+{
+	parallelFor(bodies.count, BODY_BYTES, [&bodies, timeStep](size_t begin, size_t end)
+	{
+		integrate<true, true>(bodies, begin, end, timeStep);
+	});
+}
+
+
+void re::kickN(const RigidBodies& bodies, float timeStep)
+{
+	parallelFor(bodies.count, BODY_BYTES, [&bodies, timeStep](size_t begin, size_t end)
+	{
+		integrate<true, false>(bodies, begin, end, timeStep);
+	});
+}
+
+
+void re::driftN(const RigidBodies& bodies, float timeStep)
+{
+	parallelFor(bodies.count, BODY_BYTES, [&bodies, timeStep](size_t begin, size_t end)
+	{
+		integrate<false, true>(bodies, begin, end, timeStep);
+	});
+}
@@ -0,0 +1,354 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reKdTree.cpp
+// Project:     reMath
+// Description: Implementation of KdTree (k-d tree) class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "reMath/reKdTree.h"
+#include "reMath/reParallel.h"
+#include "reMath/reFrameArena.h"
+#include <algorithm>
+#include <cfloat>
+
+namespace
+{
+	// Ranges up to this size are leaves.
+	const size_t LEAF_SIZE = 8;
+
+	// Traversal stack size: every level pushes at most one far half.
+	const int STACK_SIZE = 64;
+
+	float distanceSquared(const float first[3], const float second[3])
+	{
+		const float x = first[0] - second[0];
+		const float y = first[1] - second[1];
+		const float z = first[2] - second[2];
+		return x * x + y * y + z * z;
+	}
+
+	// Max-heap of candidates kept in two parallel arrays, the furthest candidate is on top.
+	void siftUp(unsigned int* indices, float* distances, size_t position)
+	{
+		while (position > 0)
+		{
+			const size_t parent = (position - 1) / 2;
+
+			if (distances[parent] >= distances[position])
+				break;
+
+			std::swap(distances[parent], distances[position]);
+			std::swap(indices[parent], indices[position]);
+			position = parent;
+		}
+	}
+
+	void siftDown(unsigned int* indices, float* distances, size_t count, size_t position)
+	{
+		for (;;)
+		{
+			const size_t left = position * 2 + 1;
+			const size_t right = left + 1;
+			size_t largest = position;
+
+			if (left < count && distances[left] > distances[largest])
+				largest = left;
+
+			if (right < count && distances[right] > distances[largest])
+				largest = right;
+
+			if (largest == position)
+				break;
+
+			std::swap(distances[largest], distances[position]);
+			std::swap(indices[largest], indices[position]);
+			position = largest;
+		}
+	}
+}
+
+
+void re::KdTree::build(const Vec3d* points, size_t count)
+{
+	entries_.resize(count);
+	axes_.assign(count, 0);
+	Entry* entries = entries_.data();
+
+	parallelFor(count, sizeof(Vec3d) + sizeof(Entry), [=](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			entries[i].d[0] = points[i].x;
+			entries[i].d[1] = points[i].y;
+			entries[i].d[2] = points[i].z;
+			entries[i].index = static_cast<unsigned int>(i);
+		}
+	});
+
+	// Top levels are split one level at a time with the ranges in parallel,
+	// once there are enough ranges for all threads each one builds a subtree.
+	Executor& executor = getExecutor();
+	const size_t parallelRanges = executor.concurrency() * 4;
+	std::vector<Range> ranges(1, Range{ 0, count });
+
+	while (!ranges.empty() && ranges.size() < parallelRanges)
+	{
+		executor.run(ranges.size(), [&](size_t i)
+		{
+			split(ranges[i]);
+		});
+
+		std::vector<Range> children;
+
+		for (const Range& range : ranges)
+		{
+			if (range.end - range.begin <= LEAF_SIZE)
+				continue;
+
+			const size_t middle = range.begin + (range.end - range.begin) / 2;
+			children.push_back(Range{ range.begin, middle });
+			children.push_back(Range{ middle + 1, range.end });
+		}
+
+		ranges.swap(children);
+	}
+
+	executor.run(ranges.size(), [&](size_t i)
+	{
+		buildRange(ranges[i]);
+	});
+}
+
+
+size_t re::KdTree::getPointCount() const
+{
+	return entries_.size();
+}
+
+
+unsigned int re::KdTree::findNearest(const Vec3d& point, float* distanceSquared) const
+{
+	unsigned int nearest = INVALID;
+	float bound = FLT_MAX;
+
+	auto visit = [&](const Entry& entry, float distance)
+	{
+		if (distance < bound)
+		{
+			bound = distance;
+			nearest = entry.index;
+		}
+	};
+
+	search(point.d, bound, visit);
+
+	if (distanceSquared)
+		*distanceSquared = bound;
+
+	return nearest;
+}
+
+
+size_t re::KdTree::findNearest(const Vec3d& point, size_t k, unsigned int* indices, float* distancesSquared) const
+{
+	if (!k)
+		return 0;
+
+	FrameArena& scratch = FrameArena::threadLocal();
+	const auto marker = scratch.mark();
+	float* distances = distancesSquared ? distancesSquared : scratch.allocate<float>(k);
+	size_t count = 0;
+	float bound = FLT_MAX;
+
+	auto visit = [&](const Entry& entry, float distance)
+	{
+		if (count < k)
+		{
+			indices[count] = entry.index;
+			distances[count] = distance;
+			siftUp(indices, distances, count++);
+
+			if (count == k)
+				bound = distances[0];
+		}
+		else if (distance < distances[0])
+		{
+			indices[0] = entry.index;
+			distances[0] = distance;
+			siftDown(indices, distances, k, 0);
+			bound = distances[0];
+		}
+	};
+
+	search(point.d, bound, visit);
+
+	// Heap sort into ascending order.
+	for (size_t end = count; end > 1; end--)
+	{
+		std::swap(distances[0], distances[end - 1]);
+		std::swap(indices[0], indices[end - 1]);
+		siftDown(indices, distances, end - 1, 0);
+	}
+
+	scratch.rewind(marker);
+	return count;
+}
+
+
+void re::KdTree::findInRadius(const Vec3d& point, float radius, std::vector<unsigned int>& result) const
+{
+	float bound = radius * radius;
+
+	auto visit = [&](const Entry& entry, float distance)
+	{
+		if (distance <= bound)
+			result.push_back(entry.index);
+	};
+
+	search(point.d, bound, visit);
+}
+
+
+void re::KdTree::findNearestN(const Vec3d* points, size_t count, unsigned int* indices, float* distancesSquared) const
+{
+	parallelFor(count, sizeof(Vec3d) + sizeof(unsigned int) + sizeof(float), [=](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+			indices[i] = findNearest(points[i], distancesSquared ? distancesSquared + i : nullptr);
+	});
+}
+
+
+void re::KdTree::findNearestN(const Vec3d* points, size_t count, size_t k, unsigned int* indices, float* distancesSquared) const
+{
+	parallelFor(count, sizeof(Vec3d) + k * (sizeof(unsigned int) + sizeof(float)), [=](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			unsigned int* queryIndices = indices + i * k;
+			float* queryDistances = distancesSquared ? distancesSquared + i * k : nullptr;
+
+			for (size_t found = findNearest(points[i], k, queryIndices, queryDistances); found < k; found++)
+			{
+				queryIndices[found] = INVALID;
+
+				if (queryDistances)
+					queryDistances[found] = FLT_MAX;
+			}
+		}
+	});
+}
+
+
+void re::KdTree::split(const Range& range)
+{
+	if (range.end - range.begin <= LEAF_SIZE)
+		return;
+
+	Entry* begin = entries_.data() + range.begin;
+	Entry* end = entries_.data() + range.end;
+	float minValue[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+	float maxValue[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+	for (const Entry* entry = begin; entry != end; entry++)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			minValue[i] = std::min(minValue[i], entry->d[i]);
+			maxValue[i] = std::max(maxValue[i], entry->d[i]);
+		}
+	}
+
+	// Split along the largest extent of the range.
+	int axis = 0;
+
+	for (int i = 1; i < 3; i++)
+	{
+		if (maxValue[i] - minValue[i] > maxValue[axis] - minValue[axis])
+			axis = i;
+	}
+
+	const size_t middle = (range.end - range.begin) / 2;
+	std::nth_element(begin, begin + middle, end, [axis](const Entry& first, const Entry& second)
+	{
+		return first.d[axis] < second.d[axis];
+	});
+
+	axes_[range.begin + middle] = static_cast<unsigned char>(axis);
+}
+
+
+void re::KdTree::buildRange(const Range& range)
+{
+	if (range.end - range.begin <= LEAF_SIZE)
+		return;
+
+	split(range);
+
+	const size_t middle = range.begin + (range.end - range.begin) / 2;
+	buildRange(Range{ range.begin, middle });
+	buildRange(Range{ middle + 1, range.end });
+}
+
+
+template <typename Visitor>
+void re::KdTree::search(const float point[3], float& maxDistanceSquared, Visitor& visitor) const
+{
+	struct Pending
+	{
+		size_t begin;
+		size_t end;
+		float distance;
+	};
+
+	const Entry* entries = entries_.data();
+	const unsigned char* axes = axes_.data();
+	Pending stack[STACK_SIZE];
+	int top = 0;
+	stack[top++] = Pending{ 0, entries_.size(), 0.f };
+
+	while (top > 0)
+	{
+		const Pending pending = stack[--top];
+
+		if (pending.distance > maxDistanceSquared)
+			continue;
+
+		size_t begin = pending.begin;
+		size_t end = pending.end;
+
+		// Descends to the half containing the point, the other half is searched later
+		// if it is closer than the current bound.
+		while (end - begin > LEAF_SIZE)
+		{
+			const size_t middle = begin + (end - begin) / 2;
+			const Entry& entry = entries[middle];
+			const int axis = axes[middle];
+			visitor(entry, distanceSquared(point, entry.d));
+
+			const float difference = point[axis] - entry.d[axis];
+			const float planeDistance = difference * difference;
+
+			if (difference < 0.f)
+			{
+				if (planeDistance <= maxDistanceSquared)
+					stack[top++] = Pending{ middle + 1, end, planeDistance };
+
+				end = middle;
+			}
+			else
+			{
+				if (planeDistance <= maxDistanceSquared)
+					stack[top++] = Pending{ begin, middle, planeDistance };
+
+				begin = middle + 1;
+			}
+		}
+
+		for (size_t i = begin; i < end; i++)
+			visitor(entries[i], distanceSquared(point, entries[i].d));
+	}
+}
@@ -0,0 +1,478 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reLBVH.cpp
+// Project:     reMath
+// Description: Implementation of LBVH (linear bounding volume hierarchy) class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "reMath/reLBVH.h"
+#include "reMath/reMorton.h"
+#include "reMath/reParallel.h"
+#include "reMath/reFrameArena.h"
+#include <algorithm>
+#include <atomic>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+	// Keys are 30-bit codes extended by 32-bit indices, every level of the radix tree has a longer
+	// common prefix, so leaves are at most 64 levels deep. Rotations never increase the height.
+	const int MAX_HEIGHT = 64;
+
+	// Traversal stack size: every level leaves at most one sibling on the stack.
+	const int STACK_SIZE = MAX_HEIGHT + 1;
+
+	// Surface area heuristic costs of a node traversal and a primitive intersection.
+	const float TRAVERSAL_COST = 1.2f;
+	const float INTERSECTION_COST = 1.f;
+
+	int countLeadingZeros(unsigned int value)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanReverse(&index, value);
+		return 31 - static_cast<int>(index);
+#else
+		return __builtin_clz(value);
+#endif
+	}
+
+	// Common prefix length of two sorted keys, equal codes are told apart by their positions.
+	int commonPrefix(const unsigned int* codes, long long count, long long first, long long second)
+	{
+		if (second < 0 || second >= count)
+			return -1;
+
+		const unsigned int difference = codes[first] ^ codes[second];
+
+		if (difference)
+			return countLeadingZeros(difference);
+
+		return 32 + countLeadingZeros(static_cast<unsigned int>(first ^ second));
+	}
+
+	int height(const unsigned char* heights, unsigned int first, unsigned int second)
+	{
+		return 1 + std::max(heights[first], heights[second]);
+	}
+
+	// Swaps a child of the node with a grandchild under the other child, when that reduces the
+	// surface area of the other child without increasing the node height.
+	void rotateNode(re::LBVH::Node* nodes, unsigned char* heights, unsigned int index)
+	{
+		re::LBVH::Node& node = nodes[index];
+		const int nodeHeight = heights[index];
+		float bestArea = 0.f;
+		unsigned int* bestChild = nullptr;
+		unsigned int* bestGrandchild = nullptr;
+		unsigned int bestParent = re::LBVH::INVALID;
+
+		for (int side = 0; side < 2; side++)
+		{
+			unsigned int* child = side ? &node.right : &node.left;
+			const unsigned int otherIndex = side ? node.left : node.right;
+			re::LBVH::Node& other = nodes[otherIndex];
+
+			if (other.right == re::LBVH::INVALID)
+				continue;
+
+			const float otherArea = other.bounds.getSurfaceArea();
+
+			for (int grandSide = 0; grandSide < 2; grandSide++)
+			{
+				unsigned int* grandchild = grandSide ? &other.right : &other.left;
+				const unsigned int kept = grandSide ? other.left : other.right;
+
+				// Height of the other child and the node after the swap.
+				const int rotatedHeight = height(heights, *child, kept);
+
+				if (std::max<int>(rotatedHeight, heights[*grandchild]) + 1 > nodeHeight)
+					continue;
+
+				re::AABB rotated = nodes[*child].bounds;
+				rotated.expand(nodes[kept].bounds);
+				const float area = otherArea - rotated.getSurfaceArea();
+
+				if (area > bestArea)
+				{
+					bestArea = area;
+					bestChild = child;
+					bestGrandchild = grandchild;
+					bestParent = otherIndex;
+				}
+			}
+		}
+
+		if (!bestChild)
+			return;
+
+		std::swap(*bestChild, *bestGrandchild);
+		nodes[*bestChild].parent = index;
+		nodes[*bestGrandchild].parent = bestParent;
+
+		re::LBVH::Node& parent = nodes[bestParent];
+		parent.bounds = nodes[parent.left].bounds;
+		parent.bounds.expand(nodes[parent.right].bounds);
+		heights[bestParent] = static_cast<unsigned char>(height(heights, parent.left, parent.right));
+	}
+
+	re::AABB triangleBounds(const re::Vec3d* vertices, const unsigned int* indices, size_t triangle)
+	{
+		const re::Vec3d& a = vertices[indices[triangle * 3]];
+		const re::Vec3d& b = vertices[indices[triangle * 3 + 1]];
+		const re::Vec3d& c = vertices[indices[triangle * 3 + 2]];
+		re::AABB result(a, a);
+		result.expand(b);
+		result.expand(c);
+		return result;
+	}
+}
+
+
+void re::LBVH::build(const AABB* boxes, size_t count)
+{
+	primitiveCount_ = count;
+	nodes_.resize(count ? 2 * count - 1 : 0);
+
+	if (count)
+		buildTree(boxes);
+
+	buildCost_ = getCost();
+}
+
+
+void re::LBVH::build(const Vec3d* vertices, const unsigned int* indices, size_t triangleCount)
+{
+	FrameArena& scratch = FrameArena::threadLocal();
+	const auto marker = scratch.mark();
+	AABB* boxes = scratch.allocate<AABB>(triangleCount);
+
+	parallelFor(triangleCount, sizeof(AABB) + 3 * sizeof(Vec3d), [=](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+			boxes[i] = triangleBounds(vertices, indices, i);
+	});
+
+	build(boxes, triangleCount);
+	scratch.rewind(marker);
+}
+
+
+void re::LBVH::refit(const AABB* boxes, bool rotate)
+{
+	if (!primitiveCount_)
+		return;
+
+	Node* leaves = nodes_.data() + primitiveCount_ - 1;
+
+	parallelFor(primitiveCount_, sizeof(Node) + sizeof(AABB), [=](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+			leaves[i].bounds = boxes[leaves[i].left];
+	});
+
+	refitNodes(rotate);
+}
+
+
+void re::LBVH::refit(const Vec3d* vertices, const unsigned int* indices, bool rotate)
+{
+	if (!primitiveCount_)
+		return;
+
+	Node* leaves = nodes_.data() + primitiveCount_ - 1;
+
+	parallelFor(primitiveCount_, sizeof(Node) + 3 * sizeof(Vec3d), [=](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+			leaves[i].bounds = triangleBounds(vertices, indices, leaves[i].left);
+	});
+
+	refitNodes(rotate);
+}
+
+
+float re::LBVH::getCost() const
+{
+	if (nodes_.empty())
+		return 0.f;
+
+	const Node* nodes = nodes_.data();
+	const size_t count = nodes_.size();
+
+	Executor& executor = getExecutor();
+	const size_t blockCount = std::max<size_t>(1, std::min(executor.concurrency(), count / PARALLEL_MIN_CHUNK));
+	const size_t blockSize = (count + blockCount - 1) / blockCount;
+	std::vector<double> sums(blockCount, 0.0);
+
+	executor.run(blockCount, [&](size_t block)
+	{
+		double sum = 0.0;
+
+		for (size_t i = block * blockSize, end = std::min(count, i + blockSize); i < end; i++)
+			sum += nodes[i].bounds.getSurfaceArea() * (nodes[i].right == INVALID ? INTERSECTION_COST : TRAVERSAL_COST);
+
+		sums[block] = sum;
+	});
+
+	double sum = 0.0;
+
+	for (const double blockSum : sums)
+		sum += blockSum;
+
+	const float rootArea = nodes[0].bounds.getSurfaceArea();
+	return rootArea > 0.f ? static_cast<float>(sum / rootArea) : 0.f;
+}
+
+
+float re::LBVH::getBuildCost() const
+{
+	return buildCost_;
+}
+
+
+const std::vector<re::LBVH::Node>& re::LBVH::getNodes() const
+{
+	return nodes_;
+}
+
+
+size_t re::LBVH::getPrimitiveCount() const
+{
+	return primitiveCount_;
+}
+
+
+re::AABB re::LBVH::getBounds() const
+{
+	return nodes_.empty() ? AABB() : nodes_[0].bounds;
+}
+
+
+void re::LBVH::queryOverlap(const AABB& box, std::vector<unsigned int>& result) const
+{
+	if (nodes_.empty())
+		return;
+
+	unsigned int stack[STACK_SIZE];
+	int top = 0;
+	stack[top++] = 0;
+
+	while (top > 0)
+	{
+		const Node& node = nodes_[stack[--top]];
+
+		if (!node.bounds.overlaps(box))
+			continue;
+
+		if (node.right == INVALID)
+		{
+			result.push_back(node.left);
+			continue;
+		}
+
+		stack[top++] = node.right;
+		stack[top++] = node.left;
+	}
+}
+
+
+void re::LBVH::queryRay(const Vec3d& origin, const Vec3d& direction, float maxDistance, std::vector<unsigned int>& result) const
+{
+	if (nodes_.empty())
+		return;
+
+	const Vec3d inverseDirection(1.f / direction.x, 1.f / direction.y, 1.f / direction.z);
+
+	unsigned int stack[STACK_SIZE];
+	int top = 0;
+	stack[top++] = 0;
+
+	while (top > 0)
+	{
+		const Node& node = nodes_[stack[--top]];
+		float distance;
+
+		if (!node.bounds.intersectsRay(origin, inverseDirection, maxDistance, distance))
+			continue;
+
+		if (node.right == INVALID)
+		{
+			result.push_back(node.left);
+			continue;
+		}
+
+		stack[top++] = node.right;
+		stack[top++] = node.left;
+	}
+}
+
+
+void re::LBVH::buildTree(const AABB* boxes)
+{
+	const size_t count = primitiveCount_;
+	const size_t leafOffset = count - 1;
+	Node* nodes = nodes_.data();
+
+	FrameArena& scratch = FrameArena::threadLocal();
+	const auto marker = scratch.mark();
+	Vec3d* centroids = scratch.allocate<Vec3d>(count);
+	unsigned int* codes = scratch.allocate<unsigned int>(count);
+	unsigned int* order = scratch.allocate<unsigned int>(count);
+
+	parallelFor(count, sizeof(AABB) + sizeof(Vec3d), [=](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			centroids[i] = (boxes[i].min + boxes[i].max) * 0.5f;
+			order[i] = static_cast<unsigned int>(i);
+		}
+	});
+
+	// Centroid bounds reduced per block, then merged.
+	Executor& executor = getExecutor();
+	const size_t blockCount = std::max<size_t>(1, std::min(executor.concurrency(), count / PARALLEL_MIN_CHUNK));
+	const size_t blockSize = (count + blockCount - 1) / blockCount;
+	AABB* blockBounds = scratch.allocate<AABB>(blockCount);
+
+	executor.run(blockCount, [&](size_t block)
+	{
+		const size_t begin = block * blockSize;
+		const size_t end = std::min(count, begin + blockSize);
+
+		if (begin < end)
+			blockBounds[block] = AABB::fromPoints(centroids + begin, end - begin);
+	});
+
+	AABB centroidBounds;
+
+	for (size_t block = 0; block < blockCount; block++)
+		centroidBounds.expand(blockBounds[block]);
+
+	mortonCodeN(centroids, count, centroidBounds, codes);
+	radixSort(codes, order, count);
+
+	parallelFor(count, sizeof(Node) + sizeof(AABB), [=](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			Node& leaf = nodes[leafOffset + i];
+			leaf.bounds = boxes[order[i]];
+			leaf.left = order[i];
+			leaf.right = INVALID;
+		}
+	});
+
+	nodes[0].parent = INVALID;
+
+	// Each internal node covers the range of keys sharing a prefix and splits it where the next
+	// bit changes. The range is found from the node index alone, so nodes are built independently.
+	parallelFor(leafOffset, sizeof(Node) + 4 * sizeof(unsigned int), [=](size_t begin, size_t end)
+	{
+		const long long keyCount = static_cast<long long>(count);
+
+		for (size_t index = begin; index < end; index++)
+		{
+			const long long i = static_cast<long long>(index);
+			const long long d = commonPrefix(codes, keyCount, i, i + 1) > commonPrefix(codes, keyCount, i, i - 1) ? 1 : -1;
+			const int minPrefix = commonPrefix(codes, keyCount, i, i - d);
+
+			long long maxLength = 2;
+
+			while (commonPrefix(codes, keyCount, i, i + maxLength * d) > minPrefix)
+				maxLength *= 2;
+
+			long long length = 0;
+
+			for (long long step = maxLength / 2; step > 0; step /= 2)
+			{
+				if (commonPrefix(codes, keyCount, i, i + (length + step) * d) > minPrefix)
+					length += step;
+			}
+
+			const long long j = i + length * d;
+			const int nodePrefix = commonPrefix(codes, keyCount, i, j);
+			long long split = 0;
+			long long step = length;
+
+			do
+			{
+				step = (step + 1) / 2;
+
+				if (commonPrefix(codes, keyCount, i, i + (split + step) * d) > nodePrefix)
+					split += step;
+			}
+			while (step > 1);
+
+			const long long gamma = i + split * d + std::min<long long>(d, 0);
+			Node& node = nodes[index];
+			node.left = static_cast<unsigned int>(std::min(i, j) == gamma ? leafOffset + gamma : gamma);
+			node.right = static_cast<unsigned int>(std::max(i, j) == gamma + 1 ? leafOffset + gamma + 1 : gamma + 1);
+			nodes[node.left].parent = static_cast<unsigned int>(index);
+			nodes[node.right].parent = static_cast<unsigned int>(index);
+		}
+	});
+
+	scratch.rewind(marker);
+	refitNodes(false);
+}
+
+
+void re::LBVH::refitNodes(bool rotate)
+{
+	const size_t count = primitiveCount_;
+
+	if (count < 2)
+		return;
+
+	const size_t leafOffset = count - 1;
+	Node* nodes = nodes_.data();
+
+	FrameArena& scratch = FrameArena::threadLocal();
+	const auto marker = scratch.mark();
+	std::atomic<unsigned int>* visits = scratch.allocate<std::atomic<unsigned int>>(leafOffset);
+	unsigned char* heights = scratch.allocate<unsigned char>(nodes_.size());
+
+	parallelFor(nodes_.size(), sizeof(unsigned int) + 1, [=](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			heights[i] = 0;
+
+			if (i < leafOffset)
+				visits[i].store(0, std::memory_order_relaxed);
+		}
+	});
+
+	// Walks up from every leaf, the first visitor of a node stops and the second one merges its
+	// children. Acquire-release ordering makes the subtree written by the first visitor visible,
+	// and the whole subtree is finished, so the second visitor may also rotate inside it.
+	parallelFor(count, 2 * sizeof(Node), [=](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			unsigned int index = nodes[leafOffset + i].parent;
+
+			while (index != INVALID && visits[index].fetch_add(1, std::memory_order_acq_rel) == 1)
+			{
+				Node& node = nodes[index];
+				heights[index] = static_cast<unsigned char>(height(heights, node.left, node.right));
+
+				if (rotate)
+					rotateNode(nodes, heights, index);
+
+				node.bounds = nodes[node.left].bounds;
+				node.bounds.expand(nodes[node.right].bounds);
+				index = node.parent;
+			}
+		}
+	});
+
+	scratch.rewind(marker);
+}
@@ -11,6 +11,12 @@
 #include "reMath/reMathUtil.h"
 #include "reMath/reMath.h"
 #include <cmath>
+#include <cstring>
+#include <cstdint>
+
+#ifdef RE_MATH_SSE
+#include <xmmintrin.h>
+#endif
 
 float re::toRadians(float degrees)
 {
@@ -52,6 +58,27 @@ unsigned char re::getLowNibble(unsigned char byte)
 }
 
 
+float re::rsqrtFast(float value)
+{
+#ifdef RE_MATH_SSE
+	const float estimate = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(value)));
+	return estimate * (1.5f - 0.5f * value * estimate * estimate);
+#else
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	bits = 0x5f375a86u - (bits >> 1);
+
+	float estimate;
+	memcpy(&estimate, &bits, sizeof(estimate));
+
+	for (int i = 0; i < 3; i++)
+		estimate *= 1.5f - 0.5f * value * estimate * estimate;
+
+	return estimate;
+#endif
+}
+
+
 re::Matrix4 re::perspective(float fovy, float aspect, float zNear, float zFar)
 {
 	const float tanHalfFovy = 1.f / tan(toRadians(fovy) / 2.f);
@@ -62,6 +89,7 @@ re::Matrix4 re::perspective(float fovy, float aspect, float zNear, float zFar)
 	matrix[10] = (zFar + zNear) / (zNear - zFar);
 	matrix[11] = -1.f;
 	matrix[14] = (2.f * zFar * zNear) / (zNear - zFar);
+	matrix[15] = 0.f;
 	return matrix;
 }
 
@@ -100,9 +128,9 @@ re::Matrix4 re::lookAt(const Vec3d& eye, const Vec3d& center, const Vec3d& up)
 	matrix2[6] = -forward.y;
 	matrix2[10] = -forward.z;
 
-	// Set eye translation
+	// Set eye translation, rotated into the view space
 	result *= matrix2;
-	result.setTranslation(-eye);
+	result.setTranslation(-side.dot(eye), -upVector.dot(eye), forward.dot(eye));
 	
 	return result;
 }
@@ -14,6 +14,8 @@
 #include <cstring>
 #include <cmath>
 #include "reMath/reMathUtil.h"
+#include "reMath/reDecomposition.h"
+#include <utility>
 
 re::Matrix3::Matrix3()
 {
@@ -142,6 +144,34 @@ re::Vec3d re::Matrix3::getEulers() const
 }
 
 
+void re::Matrix3::transpose()
+{
+	std::swap(data_[1], data_[3]);
+	std::swap(data_[2], data_[6]);
+	std::swap(data_[5], data_[7]);
+}
+
+
+re::Matrix3 re::Matrix3::toTransposed() const
+{
+	Matrix3 result(this);
+	result.transpose();
+	return result;
+}
+
+
+void re::Matrix3::eigenSymmetric(Vec3d & values, Matrix3 & vectors) const
+{
+	eigenSymmetricN(this, 1, &values, &vectors);
+}
+
+
+void re::Matrix3::svd(Matrix3 & u, Vec3d & sigma, Matrix3 & v) const
+{
+	svdN(this, 1, &u, &sigma, &v);
+}
+
+
 void re::Matrix3::rotate(float & x, float & y, float & z) const
 {
 	const float tx = x * data_[0] + y * data_[3] + z * data_[6];	// 0-0, 1-0, 2-0
@@ -209,6 +239,31 @@ re::Matrix3 & re::Matrix3::operator = (const Matrix3 & matrix)
 }
 
 
+re::Matrix3 re::Matrix3::operator * (const Matrix3 & matrix) const
+{
+	Matrix3 result(this);
+	result *= matrix;
+	return result;
+}
+
+
+void re::Matrix3::operator *= (const Matrix3 & matrix)
+{
+	float result[9];
+	const float* m1 = data_;
+	const float* m2 = matrix.data_;
+
+	for (int column = 0; column < 3; column++)
+	{
+		result[column * 3] = m1[0] * m2[column * 3] + m1[3] * m2[column * 3 + 1] + m1[6] * m2[column * 3 + 2];
+		result[column * 3 + 1] = m1[1] * m2[column * 3] + m1[4] * m2[column * 3 + 1] + m1[7] * m2[column * 3 + 2];
+		result[column * 3 + 2] = m1[2] * m2[column * 3] + m1[5] * m2[column * 3 + 1] + m1[8] * m2[column * 3 + 2];
+	}
+
+	memcpy(data_, result, sizeof(float) * 9);
+}
+
+
 re::Matrix3::operator float * ()
 {
 	return data_;
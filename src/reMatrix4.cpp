@@ -169,7 +169,26 @@ void re::Matrix4::setScale(const float scale)
 
 float re::Matrix4::getScale() const
 {
-	return 1 / data_[0];
+	return getScales().x;
+}
+
+
+re::Vec3d re::Matrix4::getScales() const
+{
+	Vec3d result(
+		sqrt(data_[0] * data_[0] + data_[1] * data_[1] + data_[2] * data_[2]),
+		sqrt(data_[4] * data_[4] + data_[5] * data_[5] + data_[6] * data_[6]),
+		sqrt(data_[8] * data_[8] + data_[9] * data_[9] + data_[10] * data_[10]));
+
+	const float determinant =
+		data_[0] * (data_[5] * data_[10] - data_[9] * data_[6]) -
+		data_[4] * (data_[1] * data_[10] - data_[9] * data_[2]) +
+		data_[8] * (data_[1] * data_[6] - data_[5] * data_[2]);
+
+	if (determinant < 0.f)
+		result.x = -result.x;
+
+	return result;
 }
 
 
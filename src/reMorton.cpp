@@ -0,0 +1,224 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reMorton.cpp
+// Project:     reMath
+// Description: Implementation of Morton code (Z-order curve) functions
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "reMath/reMorton.h"
+#include "reMath/reMathUtil.h"
+#include "reMath/reParallel.h"
+#include "reMath/reFrameArena.h"
+
+#ifdef RE_MATH_BMI2
+#include <immintrin.h>
+#endif
+
+namespace
+{
+	const unsigned int MASK_X = 0x09249249;
+	const unsigned long long MASK_X64 = 0x1249249249249249ull;
+
+#ifndef RE_MATH_BMI2
+	// Spreads the lower 10 bits apart leaving two zero bits between them.
+	unsigned int splitBits(unsigned int value)
+	{
+		value &= 0x000003FF;
+		value = (value | (value << 16)) & 0x030000FF;
+		value = (value | (value << 8)) & 0x0300F00F;
+		value = (value | (value << 4)) & 0x030C30C3;
+		value = (value | (value << 2)) & MASK_X;
+		return value;
+	}
+
+	unsigned int compactBits(unsigned int value)
+	{
+		value &= MASK_X;
+		value = (value | (value >> 2)) & 0x030C30C3;
+		value = (value | (value >> 4)) & 0x0300F00F;
+		value = (value | (value >> 8)) & 0x030000FF;
+		value = (value | (value >> 16)) & 0x000003FF;
+		return value;
+	}
+
+	// Spreads the lower 21 bits apart leaving two zero bits between them.
+	unsigned long long splitBits64(unsigned long long value)
+	{
+		value &= 0x1FFFFF;
+		value = (value | (value << 32)) & 0x001F00000000FFFFull;
+		value = (value | (value << 16)) & 0x001F0000FF0000FFull;
+		value = (value | (value << 8)) & 0x100F00F00F00F00Full;
+		value = (value | (value << 4)) & 0x10C30C30C30C30C3ull;
+		value = (value | (value << 2)) & MASK_X64;
+		return value;
+	}
+
+	unsigned int compactBits64(unsigned long long value)
+	{
+		value &= MASK_X64;
+		value = (value | (value >> 2)) & 0x10C30C30C30C30C3ull;
+		value = (value | (value >> 4)) & 0x100F00F00F00F00Full;
+		value = (value | (value >> 8)) & 0x001F0000FF0000FFull;
+		value = (value | (value >> 16)) & 0x001F00000000FFFFull;
+		value = (value | (value >> 32)) & 0x1FFFFF;
+		return static_cast<unsigned int>(value);
+	}
+#endif
+
+	// Scales applying the point to grid cell transformation, zero for flat axes.
+	void gridScale(const re::AABB& bounds, float cells, float scale[3])
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			const float size = bounds.max.d[i] - bounds.min.d[i];
+			scale[i] = size > 0.f ? cells / size : 0.f;
+		}
+	}
+
+	unsigned int quantize(float value, float minValue, float scale, unsigned int maxCell)
+	{
+		const float cell = (value - minValue) * scale;
+
+		if (!(cell > 0.f))
+			return 0;
+
+		return cell < static_cast<float>(maxCell) ? static_cast<unsigned int>(cell) : maxCell;
+	}
+}
+
+
+unsigned int re::mortonEncode(unsigned int x, unsigned int y, unsigned int z)
+{
+#ifdef RE_MATH_BMI2
+	return _pdep_u32(x, MASK_X) | _pdep_u32(y, MASK_X << 1) | _pdep_u32(z, MASK_X << 2);
+#else
+	return splitBits(x) | (splitBits(y) << 1) | (splitBits(z) << 2);
+#endif
+}
+
+
+void re::mortonDecode(unsigned int code, unsigned int& x, unsigned int& y, unsigned int& z)
+{
+#ifdef RE_MATH_BMI2
+	x = _pext_u32(code, MASK_X);
+	y = _pext_u32(code, MASK_X << 1);
+	z = _pext_u32(code, MASK_X << 2);
+#else
+	x = compactBits(code);
+	y = compactBits(code >> 1);
+	z = compactBits(code >> 2);
+#endif
+}
+
+
+unsigned long long re::mortonEncode64(unsigned int x, unsigned int y, unsigned int z)
+{
+#ifdef RE_MATH_BMI2
+	return _pdep_u64(x, MASK_X64) | _pdep_u64(y, MASK_X64 << 1) | _pdep_u64(z, MASK_X64 << 2);
+#else
+	return splitBits64(x) | (splitBits64(y) << 1) | (splitBits64(z) << 2);
+#endif
+}
+
+
+void re::mortonDecode64(unsigned long long code, unsigned int& x, unsigned int& y, unsigned int& z)
+{
+#ifdef RE_MATH_BMI2
+	x = static_cast<unsigned int>(_pext_u64(code, MASK_X64));
+	y = static_cast<unsigned int>(_pext_u64(code, MASK_X64 << 1));
+	z = static_cast<unsigned int>(_pext_u64(code, MASK_X64 << 2));
+#else
+	x = compactBits64(code);
+	y = compactBits64(code >> 1);
+	z = compactBits64(code >> 2);
+#endif
+}
+
+
+unsigned int re::mortonCode(const Vec3d& point, const AABB& bounds)
+{
+	const unsigned int maxCell = (1u << MORTON_BITS) - 1;
+	float scale[3];
+	gridScale(bounds, static_cast<float>(1u << MORTON_BITS), scale);
+
+	return mortonEncode(
+		quantize(point.x, bounds.min.x, scale[0], maxCell),
+		quantize(point.y, bounds.min.y, scale[1], maxCell),
+		quantize(point.z, bounds.min.z, scale[2], maxCell));
+}
+
+
+unsigned long long re::mortonCode64(const Vec3d& point, const AABB& bounds)
+{
+	const unsigned int maxCell = (1u << MORTON_BITS64) - 1;
+	float scale[3];
+	gridScale(bounds, static_cast<float>(1u << MORTON_BITS64), scale);
+
+	return mortonEncode64(
+		quantize(point.x, bounds.min.x, scale[0], maxCell),
+		quantize(point.y, bounds.min.y, scale[1], maxCell),
+		quantize(point.z, bounds.min.z, scale[2], maxCell));
+}
+
+
+void re::mortonCodeN(const Vec3d* points, size_t count, const AABB& bounds, unsigned int* codes)
+{
+	const unsigned int maxCell = (1u << MORTON_BITS) - 1;
+	const Vec3d origin = bounds.min;
+	float scale[3];
+	gridScale(bounds, static_cast<float>(1u << MORTON_BITS), scale);
+
+	parallelFor(count, sizeof(Vec3d) + sizeof(unsigned int), [=](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			codes[i] = mortonEncode(
+				quantize(points[i].x, origin.x, scale[0], maxCell),
+				quantize(points[i].y, origin.y, scale[1], maxCell),
+				quantize(points[i].z, origin.z, scale[2], maxCell));
+		}
+	});
+}
+
+
+void re::mortonSort(Vec3d* points, size_t count, unsigned int* order)
+{
+	if (count < 2)
+	{
+		if (count && order)
+			order[0] = 0;
+
+		return;
+	}
+
+	FrameArena& scratch = FrameArena::threadLocal();
+	const auto marker = scratch.mark();
+
+	unsigned int* codes = scratch.allocate<unsigned int>(count);
+	unsigned int* indices = order ? order : scratch.allocate<unsigned int>(count);
+	Vec3d* sorted = scratch.allocate<Vec3d>(count);
+
+	mortonCodeN(points, count, AABB::fromPoints(points, count), codes);
+
+	for (size_t i = 0; i < count; i++)
+		indices[i] = static_cast<unsigned int>(i);
+
+	radixSort(codes, indices, count);
+
+	parallelFor(count, 2 * sizeof(Vec3d), [=](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+			sorted[i] = points[indices[i]];
+	});
+
+	parallelFor(count, 2 * sizeof(Vec3d), [=](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+			points[i] = sorted[i];
+	});
+
+	scratch.rewind(marker);
+}
@@ -0,0 +1,355 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reOBB.cpp
+// Project:     reMath
+// Description: Implementation of OBB (oriented bounding box) class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "reMath/reOBB.h"
+#include "reMath/reMatrix4.h"
+#include "reMath/reParallel.h"
+#include "reMath/reMathUtil.h"
+#include <cfloat>
+#include <cmath>
+
+#ifdef RE_MATH_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+	// Added to the absolute rotation terms so that near parallel edges don't produce a zero cross
+	// product axis that reports separation by rounding error.
+	const float SAT_EPSILON = 0.000001f;
+
+#ifdef RE_MATH_SSE
+	inline __m128 abs4(__m128 value)
+	{
+		return _mm_andnot_ps(_mm_set1_ps(-0.f), value);
+	}
+
+	// Separating axis test of one box against four, boxes data is stored per component (structure of arrays).
+	// Returns a mask of the separated lanes.
+	int separated4(const float* centerA, const float* axesA, const float* extentsA, const float soa[15][4])
+	{
+		__m128 t[3];
+		__m128 r[3][3];
+		__m128 absR[3][3];
+		__m128 eb[3];
+
+		for (int j = 0; j < 3; j++)
+			eb[j] = _mm_loadu_ps(soa[12 + j]);
+
+		// Center offset and rotation of the second boxes expressed in the first box frame.
+		const __m128 tx = _mm_sub_ps(_mm_loadu_ps(soa[0]), _mm_set1_ps(centerA[0]));
+		const __m128 ty = _mm_sub_ps(_mm_loadu_ps(soa[1]), _mm_set1_ps(centerA[1]));
+		const __m128 tz = _mm_sub_ps(_mm_loadu_ps(soa[2]), _mm_set1_ps(centerA[2]));
+
+		for (int i = 0; i < 3; i++)
+		{
+			const __m128 ax = _mm_set1_ps(axesA[i * 3]);
+			const __m128 ay = _mm_set1_ps(axesA[i * 3 + 1]);
+			const __m128 az = _mm_set1_ps(axesA[i * 3 + 2]);
+			t[i] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, ax), _mm_mul_ps(ty, ay)), _mm_mul_ps(tz, az));
+
+			for (int j = 0; j < 3; j++)
+			{
+				r[i][j] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(soa[3 + j * 3]), ax),
+					_mm_mul_ps(_mm_loadu_ps(soa[4 + j * 3]), ay)), _mm_mul_ps(_mm_loadu_ps(soa[5 + j * 3]), az));
+				absR[i][j] = _mm_add_ps(abs4(r[i][j]), _mm_set1_ps(SAT_EPSILON));
+			}
+		}
+
+		__m128 separated = _mm_setzero_ps();
+
+		// First box face axes.
+		for (int i = 0; i < 3; i++)
+		{
+			const __m128 rb = _mm_add_ps(_mm_add_ps(_mm_mul_ps(eb[0], absR[i][0]), _mm_mul_ps(eb[1], absR[i][1])), _mm_mul_ps(eb[2], absR[i][2]));
+			separated = _mm_or_ps(separated, _mm_cmpgt_ps(abs4(t[i]), _mm_add_ps(_mm_set1_ps(extentsA[i]), rb)));
+		}
+
+		// Second box face axes.
+		for (int j = 0; j < 3; j++)
+		{
+			const __m128 ra = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(extentsA[0]), absR[0][j]),
+				_mm_mul_ps(_mm_set1_ps(extentsA[1]), absR[1][j])), _mm_mul_ps(_mm_set1_ps(extentsA[2]), absR[2][j]));
+			const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(t[0], r[0][j]), _mm_mul_ps(t[1], r[1][j])), _mm_mul_ps(t[2], r[2][j]));
+			separated = _mm_or_ps(separated, _mm_cmpgt_ps(abs4(distance), _mm_add_ps(ra, eb[j])));
+		}
+
+		if (_mm_movemask_ps(separated) == 0xF)
+			return 0xF;
+
+		// Edge cross product axes.
+		for (int i = 0; i < 3; i++)
+		{
+			const int i1 = (i + 1) % 3;
+			const int i2 = (i + 2) % 3;
+
+			for (int j = 0; j < 3; j++)
+			{
+				const int j1 = (j + 1) % 3;
+				const int j2 = (j + 2) % 3;
+				const __m128 ra = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(extentsA[i1]), absR[i2][j]), _mm_mul_ps(_mm_set1_ps(extentsA[i2]), absR[i1][j]));
+				const __m128 rb = _mm_add_ps(_mm_mul_ps(eb[j1], absR[i][j2]), _mm_mul_ps(eb[j2], absR[i][j1]));
+				const __m128 distance = _mm_sub_ps(_mm_mul_ps(t[i2], r[i1][j]), _mm_mul_ps(t[i1], r[i2][j]));
+				separated = _mm_or_ps(separated, _mm_cmpgt_ps(abs4(distance), _mm_add_ps(ra, rb)));
+			}
+		}
+
+		return _mm_movemask_ps(separated);
+	}
+#endif
+}
+
+
+re::OBB::OBB() :
+	center(0.f, 0.f, 0.f),
+	extents(0.f, 0.f, 0.f)
+{
+}
+
+
+re::OBB::OBB(const Vec3d& centerValue, const Matrix3& rotationValue, const Vec3d& extentsValue) :
+	center(centerValue),
+	rotation(rotationValue),
+	extents(extentsValue)
+{
+}
+
+
+re::OBB re::OBB::fromPoints(const Vec3d* points, size_t count)
+{
+	OBB result;
+
+	if (!points || !count)
+		return result;
+
+	Vec3d mean(0.f, 0.f, 0.f);
+
+	for (size_t i = 0; i < count; i++)
+		mean += points[i];
+
+	mean /= static_cast<float>(count);
+
+	float covariance[3][3] = {};
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const Vec3d d = points[i] - mean;
+
+		for (int j = 0; j < 3; j++)
+			for (int k = j; k < 3; k++)
+				covariance[j][k] += d.d[j] * d.d[k];
+	}
+
+	for (int j = 0; j < 3; j++)
+		for (int k = j; k < 3; k++)
+			covariance[k][j] = covariance[j][k] /= static_cast<float>(count);
+
+	Matrix3 matrix;
+
+	for (int j = 0; j < 3; j++)
+		for (int k = 0; k < 3; k++)
+			matrix[k * 3 + j] = covariance[j][k];
+
+	// Eigenvectors come as columns of a rotation, which is a right-handed basis.
+	Vec3d values;
+	Matrix3 vectors;
+	matrix.eigenSymmetric(values, vectors);
+
+	Vec3d axes[3];
+
+	for (int i = 0; i < 3; i++)
+		axes[i].set(vectors[i * 3], vectors[i * 3 + 1], vectors[i * 3 + 2]);
+
+	Vec3d minimum(FLT_MAX, FLT_MAX, FLT_MAX);
+	Vec3d maximum(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const Vec3d d = points[i] - mean;
+
+		for (int j = 0; j < 3; j++)
+		{
+			const float projection = d.dot(axes[j]);
+			minimum.d[j] = projection < minimum.d[j] ? projection : minimum.d[j];
+			maximum.d[j] = projection > maximum.d[j] ? projection : maximum.d[j];
+		}
+	}
+
+	result.center = mean;
+
+	for (int i = 0; i < 3; i++)
+	{
+		result.center += axes[i] * ((minimum.d[i] + maximum.d[i]) / 2.f);
+		result.extents.d[i] = (maximum.d[i] - minimum.d[i]) / 2.f;
+		result.rotation[i * 3] = axes[i].x;
+		result.rotation[i * 3 + 1] = axes[i].y;
+		result.rotation[i * 3 + 2] = axes[i].z;
+	}
+
+	return result;
+}
+
+
+re::Vec3d re::OBB::getAxis(int index) const
+{
+	return Vec3d(rotation[index * 3], rotation[index * 3 + 1], rotation[index * 3 + 2]);
+}
+
+
+void re::OBB::transform(const Matrix4& matrix)
+{
+	center *= matrix;
+
+	for (int i = 0; i < 3; i++)
+	{
+		const float x = rotation[i * 3];
+		const float y = rotation[i * 3 + 1];
+		const float z = rotation[i * 3 + 2];
+		Vec3d axis(x * matrix[0] + y * matrix[4] + z * matrix[8],
+			x * matrix[1] + y * matrix[5] + z * matrix[9],
+			x * matrix[2] + y * matrix[6] + z * matrix[10]);
+
+		const float scale = axis.length();
+
+		if (scale > 0.f)
+		{
+			axis /= scale;
+			rotation[i * 3] = axis.x;
+			rotation[i * 3 + 1] = axis.y;
+			rotation[i * 3 + 2] = axis.z;
+		}
+
+		extents.d[i] *= scale;
+	}
+}
+
+
+bool re::OBB::contains(const Vec3d& point) const
+{
+	const Vec3d d = point - center;
+
+	for (int i = 0; i < 3; i++)
+	{
+		if (fabs(d.dot(getAxis(i))) > extents.d[i])
+			return false;
+	}
+
+	return true;
+}
+
+
+bool re::OBB::overlaps(const OBB& box) const
+{
+	float r[3][3];
+	float absR[3][3];
+	float t[3];
+	const float* ea = extents.d;
+	const float* eb = box.extents.d;
+	const Vec3d offset = box.center - center;
+
+	// Rotation and center offset of the second box expressed in this box frame.
+	for (int i = 0; i < 3; i++)
+	{
+		const Vec3d axis = getAxis(i);
+		t[i] = offset.dot(axis);
+
+		for (int j = 0; j < 3; j++)
+		{
+			r[i][j] = axis.x * box.rotation[j * 3] + axis.y * box.rotation[j * 3 + 1] + axis.z * box.rotation[j * 3 + 2];
+			absR[i][j] = fabs(r[i][j]) + SAT_EPSILON;
+		}
+	}
+
+	// This box face axes.
+	for (int i = 0; i < 3; i++)
+	{
+		if (fabs(t[i]) > ea[i] + eb[0] * absR[i][0] + eb[1] * absR[i][1] + eb[2] * absR[i][2])
+			return false;
+	}
+
+	// Second box face axes.
+	for (int j = 0; j < 3; j++)
+	{
+		const float distance = t[0] * r[0][j] + t[1] * r[1][j] + t[2] * r[2][j];
+
+		if (fabs(distance) > ea[0] * absR[0][j] + ea[1] * absR[1][j] + ea[2] * absR[2][j] + eb[j])
+			return false;
+	}
+
+	// Edge cross product axes.
+	for (int i = 0; i < 3; i++)
+	{
+		const int i1 = (i + 1) % 3;
+		const int i2 = (i + 2) % 3;
+
+		for (int j = 0; j < 3; j++)
+		{
+			const int j1 = (j + 1) % 3;
+			const int j2 = (j + 2) % 3;
+			const float ra = ea[i1] * absR[i2][j] + ea[i2] * absR[i1][j];
+			const float rb = eb[j1] * absR[i][j2] + eb[j2] * absR[i][j1];
+
+			if (fabs(t[i2] * r[i1][j] - t[i1] * r[i2][j]) > ra + rb)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+
+void re::OBB::overlapN(const OBB& box, const OBB* boxes, size_t count, bool* results)
+{
+	const OBB* first = &box;
+
+	parallelFor(count, sizeof(OBB) + sizeof(bool), [=](size_t begin, size_t end)
+	{
+		size_t i = begin;
+
+#ifdef RE_MATH_SSE
+		float centerA[3];
+		float axesA[9];
+
+		for (int j = 0; j < 3; j++)
+			centerA[j] = first->center.d[j];
+
+		for (int j = 0; j < 9; j++)
+			axesA[j] = first->rotation[j];
+
+		for (; i + 4 <= end; i += 4)
+		{
+			// Center, axes and extents of four boxes, one component per row.
+			float soa[15][4];
+
+			for (int lane = 0; lane < 4; lane++)
+			{
+				const OBB& other = boxes[i + lane];
+
+				for (int j = 0; j < 3; j++)
+				{
+					soa[j][lane] = other.center.d[j];
+					soa[12 + j][lane] = other.extents.d[j];
+				}
+
+				for (int j = 0; j < 9; j++)
+					soa[3 + j][lane] = other.rotation[j];
+			}
+
+			const int separated = separated4(centerA, axesA, first->extents.d, soa);
+
+			for (int lane = 0; lane < 4; lane++)
+				results[i + lane] = (separated & (1 << lane)) == 0;
+		}
+#endif
+
+		for (; i < end; i++)
+			results[i] = first->overlaps(boxes[i]);
+	});
+}
@@ -0,0 +1,586 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reOcclusionBuffer.cpp
+// Project:     reMath
+// Description: Implementation of OcclusionBuffer class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "reMath/reOcclusionBuffer.h"
+#include "reMath/reVec3d.h"
+#include "reMath/reAABB.h"
+#include "reMath/reCamera.h"
+#include "reMath/reParallel.h"
+#include "reMath/reMathUtil.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#ifdef RE_MATH_SSE
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	// Frustum outcode bits in the clipping order, the near plane goes first so that the side
+	// planes are clipped with positive w only.
+	const unsigned int CLIP_NEAR = 1;
+	const unsigned int CLIP_LEFT = 2;
+	const unsigned int CLIP_RIGHT = 4;
+	const unsigned int CLIP_BOTTOM = 8;
+	const unsigned int CLIP_TOP = 16;
+	const unsigned int CLIP_PLANE_COUNT = 5;
+
+	// A triangle clipped by five planes gains at most one vertex per plane.
+	const size_t MAX_CLIP_VERTICES = 8;
+
+	// Triangles set up by one task.
+	const size_t SETUP_CHUNK = 1024;
+
+	// Bytes of a vertex read and written by the transform, for the parallel chunk size.
+	const size_t VERTEX_BYTES = sizeof(re::Vec3d) + sizeof(float) * 3 + sizeof(unsigned char);
+
+	struct ClipVertex
+	{
+		float x;
+		float y;
+		float w;
+	};
+
+	unsigned int getOutcode(float x, float y, float w, float zNear)
+	{
+		return (w < zNear ? CLIP_NEAR : 0) | (x < -w ? CLIP_LEFT : 0) | (x > w ? CLIP_RIGHT : 0) |
+			(y < -w ? CLIP_BOTTOM : 0) | (y > w ? CLIP_TOP : 0);
+	}
+
+	// Transforms vertices to clip space, z is not needed as depth comes from w.
+	void transformVertices(const float* m, float zNear, const re::Vec3d* vertices, float* x, float* y, float* w, unsigned char* codes, size_t count)
+	{
+		size_t i = 0;
+
+#ifdef RE_MATH_SSE
+		const __m128 m0 = _mm_set1_ps(m[0]), m4 = _mm_set1_ps(m[4]), m8 = _mm_set1_ps(m[8]), m12 = _mm_set1_ps(m[12]);
+		const __m128 m1 = _mm_set1_ps(m[1]), m5 = _mm_set1_ps(m[5]), m9 = _mm_set1_ps(m[9]), m13 = _mm_set1_ps(m[13]);
+		const __m128 m3 = _mm_set1_ps(m[3]), m7 = _mm_set1_ps(m[7]), m11 = _mm_set1_ps(m[11]), m15 = _mm_set1_ps(m[15]);
+		const __m128 nearPlane = _mm_set1_ps(zNear);
+		const __m128 zero = _mm_setzero_ps();
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const re::Vec3d* v = vertices + i;
+			const __m128 vx = _mm_setr_ps(v[0].x, v[1].x, v[2].x, v[3].x);
+			const __m128 vy = _mm_setr_ps(v[0].y, v[1].y, v[2].y, v[3].y);
+			const __m128 vz = _mm_setr_ps(v[0].z, v[1].z, v[2].z, v[3].z);
+
+			const __m128 cx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, m0), _mm_mul_ps(vy, m4)), _mm_add_ps(_mm_mul_ps(vz, m8), m12));
+			const __m128 cy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, m1), _mm_mul_ps(vy, m5)), _mm_add_ps(_mm_mul_ps(vz, m9), m13));
+			const __m128 cw = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, m3), _mm_mul_ps(vy, m7)), _mm_add_ps(_mm_mul_ps(vz, m11), m15));
+			_mm_storeu_ps(x + i, cx);
+			_mm_storeu_ps(y + i, cy);
+			_mm_storeu_ps(w + i, cw);
+
+			const __m128 negative = _mm_sub_ps(zero, cw);
+			__m128i code = _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(cw, nearPlane)), _mm_set1_epi32(CLIP_NEAR));
+			code = _mm_or_si128(code, _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(cx, negative)), _mm_set1_epi32(CLIP_LEFT)));
+			code = _mm_or_si128(code, _mm_and_si128(_mm_castps_si128(_mm_cmpgt_ps(cx, cw)), _mm_set1_epi32(CLIP_RIGHT)));
+			code = _mm_or_si128(code, _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(cy, negative)), _mm_set1_epi32(CLIP_BOTTOM)));
+			code = _mm_or_si128(code, _mm_and_si128(_mm_castps_si128(_mm_cmpgt_ps(cy, cw)), _mm_set1_epi32(CLIP_TOP)));
+
+			// Codes fit in the low byte of every lane.
+			code = _mm_packs_epi32(code, code);
+			code = _mm_packus_epi16(code, code);
+			const int packed = _mm_cvtsi128_si32(code);
+			codes[i] = static_cast<unsigned char>(packed);
+			codes[i + 1] = static_cast<unsigned char>(packed >> 8);
+			codes[i + 2] = static_cast<unsigned char>(packed >> 16);
+			codes[i + 3] = static_cast<unsigned char>(packed >> 24);
+		}
+#endif
+
+		for (; i < count; i++)
+		{
+			const re::Vec3d& v = vertices[i];
+			x[i] = v.x * m[0] + v.y * m[4] + v.z * m[8] + m[12];
+			y[i] = v.x * m[1] + v.y * m[5] + v.z * m[9] + m[13];
+			w[i] = v.x * m[3] + v.y * m[7] + v.z * m[11] + m[15];
+			codes[i] = static_cast<unsigned char>(getOutcode(x[i], y[i], w[i], zNear));
+		}
+	}
+
+	float getPlaneDistance(const ClipVertex& vertex, unsigned int plane, float zNear)
+	{
+		switch (plane)
+		{
+		case 0: return vertex.w - zNear;
+		case 1: return vertex.w + vertex.x;
+		case 2: return vertex.w - vertex.x;
+		case 3: return vertex.w + vertex.y;
+		default: return vertex.w - vertex.y;
+		}
+	}
+
+	// Sutherland-Hodgman clipping of a convex polygon in homogeneous space by the planes in the mask.
+	size_t clipPolygon(ClipVertex* polygon, size_t count, unsigned int planes, float zNear)
+	{
+		for (unsigned int plane = 0; plane < CLIP_PLANE_COUNT && count >= 3; plane++)
+		{
+			if (!(planes & (1 << plane)))
+				continue;
+
+			ClipVertex clipped[MAX_CLIP_VERTICES];
+			size_t clippedCount = 0;
+
+			for (size_t i = 0; i < count; i++)
+			{
+				const ClipVertex& a = polygon[i];
+				const ClipVertex& b = polygon[(i + 1) % count];
+				const float da = getPlaneDistance(a, plane, zNear);
+				const float db = getPlaneDistance(b, plane, zNear);
+
+				if (da >= 0.f)
+					clipped[clippedCount++] = a;
+
+				if ((da >= 0.f) != (db >= 0.f))
+				{
+					const float t = da / (da - db);
+					clipped[clippedCount++] = { a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.w + (b.w - a.w) * t };
+				}
+			}
+
+			std::copy(clipped, clipped + clippedCount, polygon);
+			count = clippedCount;
+		}
+
+		return count >= 3 ? count : 0;
+	}
+}
+
+
+re::OcclusionBuffer::OcclusionBuffer(size_t width, size_t height) :
+	width_((width + TILE_SIZE - 1) / TILE_SIZE * TILE_SIZE),
+	height_((height + TILE_SIZE - 1) / TILE_SIZE * TILE_SIZE),
+	binColumns_((width_ + BIN_SIZE - 1) / BIN_SIZE),
+	binRows_((height_ + BIN_SIZE - 1) / BIN_SIZE),
+	depths_(width_ * height_, 0.f),
+	tileDepths_(width_ * height_ / (TILE_SIZE * TILE_SIZE), 0.f)
+{
+}
+
+
+size_t re::OcclusionBuffer::getWidth() const
+{
+	return width_;
+}
+
+
+size_t re::OcclusionBuffer::getHeight() const
+{
+	return height_;
+}
+
+
+void re::OcclusionBuffer::begin(const Matrix4& viewProjection, float zNear)
+{
+	viewProjection_ = viewProjection;
+	near_ = zNear;
+	clipX_.clear();
+	clipY_.clear();
+	clipW_.clear();
+	codes_.clear();
+	indices_.clear();
+	occluders_.clear();
+}
+
+
+void re::OcclusionBuffer::begin(const Camera& camera)
+{
+	begin(camera.getViewProjectionMatrix(), camera.getNear());
+}
+
+
+void re::OcclusionBuffer::addOccluder(const Vec3d* vertices, size_t vertexCount, const unsigned int* indices, size_t triangleCount, bool doubleSided)
+{
+	addOccluder(vertices, vertexCount, indices, triangleCount, static_cast<const float*>(viewProjection_), doubleSided);
+}
+
+
+void re::OcclusionBuffer::addOccluder(const Vec3d* vertices, size_t vertexCount, const unsigned int* indices, size_t triangleCount, const Matrix4& world, bool doubleSided)
+{
+	const Matrix4 matrix = viewProjection_ * world;
+	addOccluder(vertices, vertexCount, indices, triangleCount, static_cast<const float*>(matrix), doubleSided);
+}
+
+
+void re::OcclusionBuffer::addOccluder(const Vec3d* vertices, size_t vertexCount, const unsigned int* indices, size_t triangleCount, const float* matrix, bool doubleSided)
+{
+	if (!vertexCount || !triangleCount)
+		return;
+
+	const size_t base = clipX_.size();
+	clipX_.resize(base + vertexCount);
+	clipY_.resize(base + vertexCount);
+	clipW_.resize(base + vertexCount);
+	codes_.resize(base + vertexCount);
+
+	float* x = clipX_.data() + base;
+	float* y = clipY_.data() + base;
+	float* w = clipW_.data() + base;
+	unsigned char* codes = codes_.data() + base;
+	const float zNear = near_;
+
+	parallelFor(vertexCount, VERTEX_BYTES, [=](size_t begin, size_t end)
+	{
+		transformVertices(matrix, zNear, vertices + begin, x + begin, y + begin, w + begin, codes + begin, end - begin);
+	});
+
+	occluders_.push_back({ indices_.size() / 3, triangleCount, doubleSided });
+	indices_.reserve(indices_.size() + triangleCount * 3);
+
+	for (size_t i = 0; i < triangleCount * 3; i++)
+		indices_.push_back(static_cast<unsigned int>(base + indices[i]));
+}
+
+
+void re::OcclusionBuffer::end()
+{
+	// Split the occluders into setup jobs, reusing the lists of the previous frames.
+	jobCount_ = 0;
+
+	for (const Occluder& occluder : occluders_)
+		jobCount_ += (occluder.triangleCount + SETUP_CHUNK - 1) / SETUP_CHUNK;
+
+	if (jobs_.size() < jobCount_)
+		jobs_.resize(jobCount_);
+
+	size_t job = 0;
+
+	for (size_t i = 0; i < occluders_.size(); i++)
+	{
+		for (size_t first = 0; first < occluders_[i].triangleCount; first += SETUP_CHUNK, job++)
+		{
+			SetupJob& setup = jobs_[job];
+			setup.occluder = i;
+			setup.first = first;
+			setup.count = std::min(SETUP_CHUNK, occluders_[i].triangleCount - first);
+			setup.triangles.clear();
+			setup.bins.resize(binColumns_ * binRows_);
+
+			for (std::vector<unsigned int>& bin : setup.bins)
+				bin.clear();
+		}
+	}
+
+	Executor& executor = getExecutor();
+
+	if (jobCount_)
+		executor.run(jobCount_, [this](size_t index) { setupTriangles(jobs_[index]); });
+
+	executor.run(binColumns_ * binRows_, [this](size_t index) { rasterizeBin(index); });
+}
+
+
+float re::OcclusionBuffer::getDepth(size_t x, size_t y) const
+{
+	return depths_[y * width_ + x];
+}
+
+
+bool re::OcclusionBuffer::isVisible(const AABB& box) const
+{
+	const float* m = static_cast<const float*>(viewProjection_);
+	const float halfWidth = 0.5f * width_;
+	const float halfHeight = 0.5f * height_;
+
+	// Screen rectangle of the projected corners and the reciprocal distance of the nearest one,
+	// w is linear so the nearest box point is a corner.
+	float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+	float nearest = 0.f;
+	int behind = 0;
+
+	for (int corner = 0; corner < 8; corner++)
+	{
+		const float x = corner & 1 ? box.max.x : box.min.x;
+		const float y = corner & 2 ? box.max.y : box.min.y;
+		const float z = corner & 4 ? box.max.z : box.min.z;
+		const float w = x * m[3] + y * m[7] + z * m[11] + m[15];
+
+		if (w < near_)
+		{
+			behind++;
+			continue;
+		}
+
+		const float inverse = 1.f / w;
+		const float sx = ((x * m[0] + y * m[4] + z * m[8] + m[12]) * inverse + 1.f) * halfWidth;
+		const float sy = ((x * m[1] + y * m[5] + z * m[9] + m[13]) * inverse + 1.f) * halfHeight;
+		minX = std::min(minX, sx);
+		minY = std::min(minY, sy);
+		maxX = std::max(maxX, sx);
+		maxY = std::max(maxY, sy);
+		nearest = std::max(nearest, inverse);
+	}
+
+	if (behind == 8)
+		return false;
+
+	if (behind)
+		return true;
+
+	if (maxX < 0.f || maxY < 0.f || minX >= width_ || minY >= height_)
+		return false;
+
+	// Every pixel the rectangle touches.
+	const size_t pixelMinX = static_cast<size_t>(std::max(minX, 0.f));
+	const size_t pixelMinY = static_cast<size_t>(std::max(minY, 0.f));
+	const size_t pixelMaxX = std::min(static_cast<size_t>(maxX), width_ - 1);
+	const size_t pixelMaxY = std::min(static_cast<size_t>(maxY), height_ - 1);
+	const size_t tileColumns = width_ / TILE_SIZE;
+
+	for (size_t tileY = pixelMinY / TILE_SIZE; tileY <= pixelMaxY / TILE_SIZE; tileY++)
+	{
+		for (size_t tileX = pixelMinX / TILE_SIZE; tileX <= pixelMaxX / TILE_SIZE; tileX++)
+		{
+			// The whole tile is closer than the box.
+			if (tileDepths_[tileY * tileColumns + tileX] > nearest)
+				continue;
+
+			if (isTileVisible(tileX, tileY, pixelMinX, pixelMinY, pixelMaxX, pixelMaxY, nearest))
+				return true;
+		}
+	}
+
+	return false;
+}
+
+
+void re::OcclusionBuffer::isVisibleN(const AABB* boxes, bool* visible, size_t count) const
+{
+	parallelFor(count, sizeof(AABB), [=](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+			visible[i] = isVisible(boxes[i]);
+	});
+}
+
+
+void re::OcclusionBuffer::addTriangle(SetupJob& job, const float* a, const float* b, const float* c, bool doubleSided) const
+{
+	float area = (b[0] - a[0]) * (c[1] - a[1]) - (c[0] - a[0]) * (b[1] - a[1]);
+
+	if (area < 0.f)
+	{
+		if (!doubleSided)
+			return;
+
+		std::swap(b, c);
+		area = -area;
+	}
+
+	// Degenerate or NaN.
+	if (!(area > 0.f))
+		return;
+
+	// Pixels with the centers inside the bounds.
+	Triangle triangle;
+	triangle.minX = std::max(static_cast<int>(ceilf(std::min(std::min(a[0], b[0]), c[0]) - 0.5f)), 0);
+	triangle.minY = std::max(static_cast<int>(ceilf(std::min(std::min(a[1], b[1]), c[1]) - 0.5f)), 0);
+	triangle.maxX = std::min(static_cast<int>(floorf(std::max(std::max(a[0], b[0]), c[0]) - 0.5f)), static_cast<int>(width_) - 1);
+	triangle.maxY = std::min(static_cast<int>(floorf(std::max(std::max(a[1], b[1]), c[1]) - 0.5f)), static_cast<int>(height_) - 1);
+
+	if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+		return;
+
+	// Counter-clockwise edge functions, non-negative inside.
+	const float* vertices[] = { a, b, c };
+
+	for (int i = 0; i < 3; i++)
+	{
+		const float* from = vertices[i];
+		const float* to = vertices[(i + 1) % 3];
+		const float ea = from[1] - to[1];
+		const float eb = to[0] - from[0];
+		triangle.edges[i][0] = ea;
+		triangle.edges[i][1] = eb;
+		triangle.edges[i][2] = from[0] * to[1] - from[1] * to[0] + 0.5f * (ea + eb);
+	}
+
+	const float inverseArea = 1.f / area;
+	const float dzdx = ((b[2] - a[2]) * (c[1] - a[1]) - (c[2] - a[2]) * (b[1] - a[1])) * inverseArea;
+	const float dzdy = ((c[2] - a[2]) * (b[0] - a[0]) - (b[2] - a[2]) * (c[0] - a[0])) * inverseArea;
+	triangle.depth[0] = dzdx;
+	triangle.depth[1] = dzdy;
+	triangle.depth[2] = a[2] - dzdx * a[0] - dzdy * a[1] + 0.5f * (dzdx + dzdy);
+
+	const unsigned int index = static_cast<unsigned int>(job.triangles.size());
+	job.triangles.push_back(triangle);
+
+	for (size_t binY = triangle.minY / BIN_SIZE; binY <= triangle.maxY / BIN_SIZE; binY++)
+		for (size_t binX = triangle.minX / BIN_SIZE; binX <= triangle.maxX / BIN_SIZE; binX++)
+			job.bins[binY * binColumns_ + binX].push_back(index);
+}
+
+
+void re::OcclusionBuffer::setupTriangles(SetupJob& job) const
+{
+	const Occluder& occluder = occluders_[job.occluder];
+	const unsigned int* indices = indices_.data() + (occluder.firstTriangle + job.first) * 3;
+	const float halfWidth = 0.5f * width_;
+	const float halfHeight = 0.5f * height_;
+
+	for (size_t i = 0; i < job.count; i++, indices += 3)
+	{
+		const unsigned int c0 = codes_[indices[0]];
+		const unsigned int c1 = codes_[indices[1]];
+		const unsigned int c2 = codes_[indices[2]];
+
+		// All vertices outside the same plane.
+		if (c0 & c1 & c2)
+			continue;
+
+		ClipVertex polygon[MAX_CLIP_VERTICES];
+		size_t count = 3;
+
+		for (int k = 0; k < 3; k++)
+			polygon[k] = { clipX_[indices[k]], clipY_[indices[k]], clipW_[indices[k]] };
+
+		if (c0 | c1 | c2)
+			count = clipPolygon(polygon, count, c0 | c1 | c2, near_);
+
+		// Screen position and depth, the polygon is a triangle fan.
+		float screen[MAX_CLIP_VERTICES][3];
+
+		for (size_t k = 0; k < count; k++)
+		{
+			const float inverse = 1.f / polygon[k].w;
+			screen[k][0] = (polygon[k].x * inverse + 1.f) * halfWidth;
+			screen[k][1] = (polygon[k].y * inverse + 1.f) * halfHeight;
+			screen[k][2] = inverse;
+		}
+
+		for (size_t k = 2; k < count; k++)
+			addTriangle(job, screen[0], screen[k - 1], screen[k], occluder.doubleSided);
+	}
+}
+
+
+void re::OcclusionBuffer::rasterizeBin(size_t bin)
+{
+	const size_t x0 = bin % binColumns_ * BIN_SIZE;
+	const size_t y0 = bin / binColumns_ * BIN_SIZE;
+	const int x1 = static_cast<int>(std::min(x0 + BIN_SIZE, width_)) - 1;
+	const int y1 = static_cast<int>(std::min(y0 + BIN_SIZE, height_)) - 1;
+
+	for (int y = static_cast<int>(y0); y <= y1; y++)
+		std::fill(depths_.begin() + y * width_ + x0, depths_.begin() + y * width_ + x1 + 1, 0.f);
+
+	for (size_t job = 0; job < jobCount_; job++)
+	{
+		const SetupJob& setup = jobs_[job];
+
+		for (unsigned int index : setup.bins[bin])
+		{
+			const Triangle& t = setup.triangles[index];
+			const int rowBegin = std::max(t.minY, static_cast<int>(y0));
+			const int rowEnd = std::min(t.maxY, y1);
+			const float columnBegin = static_cast<float>(std::max(t.minX, static_cast<int>(x0)));
+			const float columnEnd = static_cast<float>(std::min(t.maxX, x1));
+
+			// Each edge bounds the covered span of a row from the left (positive x slope) or the right.
+			float inverse[3];
+
+			for (int k = 0; k < 3; k++)
+				inverse[k] = t.edges[k][0] != 0.f ? -1.f / t.edges[k][0] : 0.f;
+
+			for (int y = rowBegin; y <= rowEnd; y++)
+			{
+				float left = columnBegin;
+				float right = columnEnd;
+				bool empty = false;
+
+				for (int k = 0; k < 3; k++)
+				{
+					const float e = t.edges[k][1] * y + t.edges[k][2];
+
+					if (t.edges[k][0] > 0.f)
+						left = std::max(left, e * inverse[k]);
+					else if (t.edges[k][0] < 0.f)
+						right = std::min(right, e * inverse[k]);
+					else
+						empty = empty || e < 0.f;
+				}
+
+				if (empty || left > right)
+					continue;
+
+				// Covered pixel columns (the bounds are not negative, truncation rounds down), blocks
+				// of four start aligned as bins and rows are multiples of four pixels.
+				int first = static_cast<int>(left);
+				first += static_cast<float>(first) < left ? 1 : 0;
+				const int last = static_cast<int>(right);
+				float* row = depths_.data() + y * width_;
+				const float z = t.depth[1] * y + t.depth[2];
+				int x = first & ~3;
+
+#ifdef RE_MATH_SSE
+				const __m128 lanes = _mm_setr_ps(0.f, 1.f, 2.f, 3.f);
+				const __m128 spanBegin = _mm_set1_ps(static_cast<float>(first));
+				const __m128 spanEnd = _mm_set1_ps(static_cast<float>(last));
+				const __m128 slope = _mm_set1_ps(t.depth[0]);
+				const __m128 offset = _mm_set1_ps(z);
+
+				for (; x <= last; x += 4)
+				{
+					const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), lanes);
+					const __m128 inside = _mm_and_ps(_mm_cmpge_ps(px, spanBegin), _mm_cmple_ps(px, spanEnd));
+					const __m128 depth = _mm_add_ps(_mm_mul_ps(slope, px), offset);
+					const __m128 current = _mm_loadu_ps(row + x);
+					_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, _mm_max_ps(current, depth)), _mm_andnot_ps(inside, current)));
+				}
+#endif
+
+				for (x = std::max(x, first); x <= last; x++)
+					row[x] = std::max(row[x], t.depth[0] * x + z);
+			}
+		}
+	}
+
+	// Farthest depth of the bin tiles.
+	const size_t tileColumns = width_ / TILE_SIZE;
+
+	for (size_t tileY = y0 / TILE_SIZE; tileY * TILE_SIZE <= static_cast<size_t>(y1); tileY++)
+	{
+		for (size_t tileX = x0 / TILE_SIZE; tileX * TILE_SIZE <= static_cast<size_t>(x1); tileX++)
+		{
+			const float* pixels = depths_.data() + tileY * TILE_SIZE * width_ + tileX * TILE_SIZE;
+			float farthest = FLT_MAX;
+
+			for (size_t y = 0; y < TILE_SIZE; y++, pixels += width_)
+				for (size_t x = 0; x < TILE_SIZE; x++)
+					farthest = std::min(farthest, pixels[x]);
+
+			tileDepths_[tileY * tileColumns + tileX] = farthest;
+		}
+	}
+}
+
+
+bool re::OcclusionBuffer::isTileVisible(size_t tileX, size_t tileY, size_t minX, size_t minY, size_t maxX, size_t maxY, float nearest) const
+{
+	const size_t columnBegin = std::max(minX, tileX * TILE_SIZE);
+	const size_t columnEnd = std::min(maxX, tileX * TILE_SIZE + TILE_SIZE - 1);
+	const size_t rowBegin = std::max(minY, tileY * TILE_SIZE);
+	const size_t rowEnd = std::min(maxY, tileY * TILE_SIZE + TILE_SIZE - 1);
+
+	for (size_t y = rowBegin; y <= rowEnd; y++)
+	{
+		const float* row = depths_.data() + y * width_;
+
+		for (size_t x = columnBegin; x <= columnEnd; x++)
+			if (row[x] <= nearest)
+				return true;
+	}
+
+	return false;
+}
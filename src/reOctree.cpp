@@ -0,0 +1,472 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reOctree.cpp
+// Project:     reMath
+// Description: Implementation of Octree (loose octree) class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "reMath/reOctree.h"
+#include "reMath/reCamera.h"
+#include "reMath/reMorton.h"
+#include <cmath>
+
+namespace
+{
+	const unsigned int ROOT = 0;
+	const unsigned int ROOT_KEY = 1;
+
+	// Traversal stack size: every level pushes at most eight children.
+	const int STACK_SIZE = 8 * (re::Octree::MAX_DEPTH + 1);
+
+	int keyDepth(unsigned int key)
+	{
+		int depth = 0;
+
+		while (depth < re::Octree::MAX_DEPTH && (key >> (3 * (depth + 1))))
+			depth++;
+
+		return depth;
+	}
+
+	bool sphereOverlapsBox(const re::Vec3d& center, float radius, const re::AABB& box)
+	{
+		float distance = 0.f;
+
+		for (int i = 0; i < 3; i++)
+		{
+			const float value = center.d[i];
+
+			if (value < box.min.d[i])
+				distance += (box.min.d[i] - value) * (box.min.d[i] - value);
+			else if (value > box.max.d[i])
+				distance += (value - box.max.d[i]) * (value - box.max.d[i]);
+		}
+
+		return distance <= radius * radius;
+	}
+
+	bool rayHitsSphere(const re::Vec3d& origin, const re::Vec3d& direction, float maxDistance, const re::Vec3d& center, float radius)
+	{
+		const re::Vec3d offset = origin - center;
+		const float b = offset.dot(direction);
+		const float c = offset.lengthSquared() - radius * radius;
+
+		// Origin outside of the sphere and pointing away.
+		if (c > 0.f && b > 0.f)
+			return false;
+
+		const float discriminant = b * b - c;
+
+		if (discriminant < 0.f)
+			return false;
+
+		return -b - sqrt(discriminant) <= maxDistance;
+	}
+}
+
+
+re::Octree::Octree(const AABB& bounds, int maxDepth) :
+	origin_(bounds.min),
+	maxDepth_(maxDepth < 0 ? 0 : maxDepth > MAX_DEPTH ? MAX_DEPTH : maxDepth)
+{
+	const Vec3d size = bounds.max - bounds.min;
+	size_ = size.x > size.y ? size.x : size.y;
+	size_ = size.z > size_ ? size.z : size_;
+
+	Node root;
+	root.key = ROOT_KEY;
+	root.parent = INVALID;
+	root.firstObject = INVALID;
+	root.objectCount = 0;
+
+	for (auto& child : root.children)
+		child = INVALID;
+
+	nodes_.push_back(root);
+	nodeCount_ = 1;
+}
+
+
+unsigned int re::Octree::insert(const Vec3d& position, float radius)
+{
+	unsigned int id;
+
+	if (freeObjects_ != INVALID)
+	{
+		id = freeObjects_;
+		freeObjects_ = objects_[id].next;
+	}
+	else
+	{
+		id = static_cast<unsigned int>(objects_.size());
+		objects_.push_back(Object());
+	}
+
+	objects_[id].position = position;
+	objects_[id].radius = radius;
+	link(id, acquireNode(locate(position, radius)));
+	objectCount_++;
+	return id;
+}
+
+
+void re::Octree::remove(unsigned int id)
+{
+	unlink(id);
+	objects_[id].node = INVALID;
+	objects_[id].next = freeObjects_;
+	freeObjects_ = id;
+	objectCount_--;
+}
+
+
+void re::Octree::move(unsigned int id, const Vec3d& position, float radius)
+{
+	Object& object = objects_[id];
+	object.position = position;
+	object.radius = radius;
+
+	const unsigned int key = locate(position, radius);
+
+	if (nodes_[object.node].key == key)
+		return;
+
+	unlink(id);
+	link(id, acquireNode(key));
+}
+
+
+const re::Vec3d& re::Octree::getPosition(unsigned int id) const
+{
+	return objects_[id].position;
+}
+
+
+float re::Octree::getRadius(unsigned int id) const
+{
+	return objects_[id].radius;
+}
+
+
+size_t re::Octree::getObjectCount() const
+{
+	return objectCount_;
+}
+
+
+size_t re::Octree::getNodeCount() const
+{
+	return nodeCount_;
+}
+
+
+void re::Octree::querySphere(const Vec3d& center, float radius, std::vector<unsigned int>& result) const
+{
+	unsigned int stack[STACK_SIZE];
+	int top = 0;
+	stack[top++] = ROOT;
+
+	while (top > 0)
+	{
+		const Node& node = nodes_[stack[--top]];
+
+		// Root also holds the objects outside of the world bounds, it is never culled.
+		if (node.key != ROOT_KEY && !sphereOverlapsBox(center, radius, getLooseBounds(node.key)))
+			continue;
+
+		for (unsigned int id = node.firstObject; id != INVALID; id = objects_[id].next)
+		{
+			const Object& object = objects_[id];
+			const float distance = radius + object.radius;
+
+			if (object.position.distanceSquaredTo(center) <= distance * distance)
+				result.push_back(id);
+		}
+
+		for (const unsigned int child : node.children)
+		{
+			if (child != INVALID)
+				stack[top++] = child;
+		}
+	}
+}
+
+
+void re::Octree::queryFrustum(const Camera& camera, std::vector<unsigned int>& result) const
+{
+	const float* planes[Camera::PLANE_COUNT];
+
+	for (int i = 0; i < Camera::PLANE_COUNT; i++)
+		planes[i] = camera.getFrustumPlane(static_cast<Camera::FrustumPlane>(i));
+
+	unsigned int stack[STACK_SIZE];
+	int top = 0;
+	stack[top++] = ROOT;
+
+	while (top > 0)
+	{
+		const unsigned int index = stack[--top];
+		const Node& node = nodes_[index];
+
+		if (node.key != ROOT_KEY)
+		{
+			const AABB bounds = getLooseBounds(node.key);
+			bool outside = false;
+			bool inside = true;
+
+			for (const float* plane : planes)
+			{
+				// Box corners furthest along and against the plane normal.
+				float furthest = plane[3];
+				float nearest = plane[3];
+
+				for (int i = 0; i < 3; i++)
+				{
+					furthest += plane[i] * (plane[i] >= 0.f ? bounds.max.d[i] : bounds.min.d[i]);
+					nearest += plane[i] * (plane[i] >= 0.f ? bounds.min.d[i] : bounds.max.d[i]);
+				}
+
+				if (furthest < 0.f)
+				{
+					outside = true;
+					break;
+				}
+
+				inside = inside && nearest >= 0.f;
+			}
+
+			if (outside)
+				continue;
+
+			if (inside)
+			{
+				collect(index, result);
+				continue;
+			}
+		}
+
+		for (unsigned int id = node.firstObject; id != INVALID; id = objects_[id].next)
+		{
+			const Object& object = objects_[id];
+			bool visible = true;
+
+			for (const float* plane : planes)
+			{
+				if (plane[0] * object.position.x + plane[1] * object.position.y + plane[2] * object.position.z + plane[3] < -object.radius)
+				{
+					visible = false;
+					break;
+				}
+			}
+
+			if (visible)
+				result.push_back(id);
+		}
+
+		for (const unsigned int child : node.children)
+		{
+			if (child != INVALID)
+				stack[top++] = child;
+		}
+	}
+}
+
+
+void re::Octree::queryRay(const Vec3d& origin, const Vec3d& direction, float maxDistance, std::vector<unsigned int>& result) const
+{
+	const Vec3d inverseDirection(1.f / direction.x, 1.f / direction.y, 1.f / direction.z);
+
+	unsigned int stack[STACK_SIZE];
+	int top = 0;
+	stack[top++] = ROOT;
+
+	while (top > 0)
+	{
+		const Node& node = nodes_[stack[--top]];
+		float distance;
+
+		if (node.key != ROOT_KEY && !getLooseBounds(node.key).intersectsRay(origin, inverseDirection, maxDistance, distance))
+			continue;
+
+		for (unsigned int id = node.firstObject; id != INVALID; id = objects_[id].next)
+		{
+			if (rayHitsSphere(origin, direction, maxDistance, objects_[id].position, objects_[id].radius))
+				result.push_back(id);
+		}
+
+		for (const unsigned int child : node.children)
+		{
+			if (child != INVALID)
+				stack[top++] = child;
+		}
+	}
+}
+
+
+unsigned int re::Octree::locate(const Vec3d& position, float radius) const
+{
+	const Vec3d relative = (position - origin_) * (1.f / size_);
+
+	for (int i = 0; i < 3; i++)
+	{
+		if (!(relative.d[i] >= 0.f && relative.d[i] <= 1.f))
+			return ROOT_KEY;
+	}
+
+	// Deepest level where the radius fits half a cell, so that the loose bounds enclose the object.
+	int depth = 0;
+	float cellSize = size_;
+
+	while (depth < maxDepth_ && radius <= cellSize / 4.f)
+	{
+		cellSize /= 2.f;
+		depth++;
+	}
+
+	const unsigned int cells = 1u << depth;
+	unsigned int cell[3];
+
+	for (int i = 0; i < 3; i++)
+	{
+		cell[i] = static_cast<unsigned int>(relative.d[i] * cells);
+		cell[i] = cell[i] < cells ? cell[i] : cells - 1;
+	}
+
+	return (1u << (3 * depth)) | mortonEncode(cell[0], cell[1], cell[2]);
+}
+
+
+unsigned int re::Octree::acquireNode(unsigned int key)
+{
+	if (key == ROOT_KEY)
+		return ROOT;
+
+	const unsigned int parent = acquireNode(key >> 3);
+	const unsigned int slot = key & 7;
+
+	if (nodes_[parent].children[slot] != INVALID)
+		return nodes_[parent].children[slot];
+
+	unsigned int index;
+
+	if (freeNodes_ != INVALID)
+	{
+		index = freeNodes_;
+		freeNodes_ = nodes_[index].parent;
+	}
+	else
+	{
+		index = static_cast<unsigned int>(nodes_.size());
+		nodes_.push_back(Node());
+	}
+
+	Node& node = nodes_[index];
+	node.key = key;
+	node.parent = parent;
+	node.firstObject = INVALID;
+	node.objectCount = 0;
+
+	for (auto& child : node.children)
+		child = INVALID;
+
+	nodes_[parent].children[slot] = index;
+	nodeCount_++;
+	return index;
+}
+
+
+void re::Octree::link(unsigned int id, unsigned int node)
+{
+	Object& object = objects_[id];
+	object.node = node;
+	object.previous = INVALID;
+	object.next = nodes_[node].firstObject;
+
+	if (object.next != INVALID)
+		objects_[object.next].previous = id;
+
+	nodes_[node].firstObject = id;
+	nodes_[node].objectCount++;
+}
+
+
+void re::Octree::unlink(unsigned int id)
+{
+	const Object& object = objects_[id];
+	unsigned int index = object.node;
+
+	if (object.previous != INVALID)
+		objects_[object.previous].next = object.next;
+	else
+		nodes_[index].firstObject = object.next;
+
+	if (object.next != INVALID)
+		objects_[object.next].previous = object.previous;
+
+	nodes_[index].objectCount--;
+
+	// Release the empty leaf nodes up the branch.
+	while (index != ROOT)
+	{
+		Node& node = nodes_[index];
+
+		if (node.objectCount)
+			return;
+
+		for (const unsigned int child : node.children)
+		{
+			if (child != INVALID)
+				return;
+		}
+
+		const unsigned int parent = node.parent;
+		nodes_[parent].children[node.key & 7] = INVALID;
+		node.parent = freeNodes_;
+		freeNodes_ = index;
+		nodeCount_--;
+		index = parent;
+	}
+}
+
+
+re::AABB re::Octree::getLooseBounds(unsigned int key) const
+{
+	const int depth = keyDepth(key);
+	const float cellSize = size_ / static_cast<float>(1u << depth);
+	Vec3d cell(0.f, 0.f, 0.f);
+
+	for (int bit = 0; bit < depth; bit++)
+	{
+		cell.x += static_cast<float>(((key >> (bit * 3)) & 1) << bit);
+		cell.y += static_cast<float>(((key >> (bit * 3 + 1)) & 1) << bit);
+		cell.z += static_cast<float>(((key >> (bit * 3 + 2)) & 1) << bit);
+	}
+
+	const Vec3d min = origin_ + cell * cellSize - Vec3d(cellSize / 2.f);
+	return AABB(min, min + Vec3d(cellSize * 2.f));
+}
+
+
+void re::Octree::collect(unsigned int node, std::vector<unsigned int>& result) const
+{
+	unsigned int stack[STACK_SIZE];
+	int top = 0;
+	stack[top++] = node;
+
+	while (top > 0)
+	{
+		const Node& current = nodes_[stack[--top]];
+
+		for (unsigned int id = current.firstObject; id != INVALID; id = objects_[id].next)
+			result.push_back(id);
+
+		for (const unsigned int child : current.children)
+		{
+			if (child != INVALID)
+				stack[top++] = child;
+		}
+	}
+}
@@ -0,0 +1,311 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reParallel.cpp
+// Project:     reMath
+// Description: Implementation of task executors and parallel loop helpers
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "reMath/reParallel.h"
+#include "reMath/reFrameArena.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	re::SerialExecutor serialExecutor;
+	std::atomic<re::Executor*> currentExecutor(&serialExecutor);
+
+	// Set for the pool worker threads to run nested loops serially.
+	thread_local bool insidePool = false;
+
+	const size_t RADIX_BITS = 8;
+	const size_t RADIX_SIZE = 1 << RADIX_BITS;
+
+	template <typename Key>
+	void radixSortImpl(Key* keys, unsigned int* values, size_t count)
+	{
+		if (count < 2)
+			return;
+
+		re::FrameArena& scratch = re::FrameArena::threadLocal();
+		const auto marker = scratch.mark();
+
+		re::Executor& executor = re::getExecutor();
+		const size_t concurrency = executor.concurrency();
+		const size_t blockCount = concurrency < 2 ? 1 : std::max<size_t>(1, std::min(concurrency, count / re::PARALLEL_MIN_CHUNK));
+		const size_t blockSize = (count + blockCount - 1) / blockCount;
+
+		Key* sourceKeys = keys;
+		Key* targetKeys = scratch.allocate<Key>(count);
+		unsigned int* sourceValues = values;
+		unsigned int* targetValues = values ? scratch.allocate<unsigned int>(count) : nullptr;
+		size_t* histograms = scratch.allocate<size_t>(blockCount * RADIX_SIZE);
+
+		for (size_t shift = 0; shift < sizeof(Key) * 8; shift += RADIX_BITS)
+		{
+			executor.run(blockCount, [&](size_t block)
+			{
+				size_t* histogram = histograms + block * RADIX_SIZE;
+				std::fill(histogram, histogram + RADIX_SIZE, 0);
+
+				for (size_t i = block * blockSize, end = std::min(count, i + blockSize); i < end; i++)
+					histogram[(sourceKeys[i] >> shift) & (RADIX_SIZE - 1)]++;
+			});
+
+			bool skip = false;
+
+			for (size_t digit = 0; digit < RADIX_SIZE && !skip; digit++)
+			{
+				size_t total = 0;
+
+				for (size_t block = 0; block < blockCount; block++)
+					total += histograms[block * RADIX_SIZE + digit];
+
+				skip = total == count;
+			}
+
+			if (skip)
+				continue;
+
+			// Every block scatters its digits after the same digits of the preceding blocks.
+			size_t offset = 0;
+
+			for (size_t digit = 0; digit < RADIX_SIZE; digit++)
+			{
+				for (size_t block = 0; block < blockCount; block++)
+				{
+					const size_t digitCount = histograms[block * RADIX_SIZE + digit];
+					histograms[block * RADIX_SIZE + digit] = offset;
+					offset += digitCount;
+				}
+			}
+
+			executor.run(blockCount, [&](size_t block)
+			{
+				size_t* histogram = histograms + block * RADIX_SIZE;
+
+				for (size_t i = block * blockSize, end = std::min(count, i + blockSize); i < end; i++)
+				{
+					const size_t target = histogram[(sourceKeys[i] >> shift) & (RADIX_SIZE - 1)]++;
+					targetKeys[target] = sourceKeys[i];
+
+					if (values)
+						targetValues[target] = sourceValues[i];
+				}
+			});
+
+			std::swap(sourceKeys, targetKeys);
+			std::swap(sourceValues, targetValues);
+		}
+
+		if (sourceKeys != keys)
+		{
+			memcpy(keys, sourceKeys, sizeof(Key) * count);
+
+			if (values)
+				memcpy(values, sourceValues, sizeof(unsigned int) * count);
+		}
+
+		scratch.rewind(marker);
+	}
+}
+
+
+size_t re::SerialExecutor::concurrency() const
+{
+	return 1;
+}
+
+
+void re::SerialExecutor::run(size_t taskCount, const std::function<void(size_t)>& task)
+{
+	for (size_t i = 0; i < taskCount; i++)
+		task(i);
+}
+
+
+re::ThreadPool::ThreadPool(size_t threadCount) : nextTask_(0), finishedTasks_(0)
+{
+	if (!threadCount)
+		threadCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+	for (size_t i = 1; i < threadCount; i++)
+		workers_.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+
+re::ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+	}
+
+	wake_.notify_all();
+
+	for (auto& worker : workers_)
+		worker.join();
+}
+
+
+size_t re::ThreadPool::concurrency() const
+{
+	return workers_.size() + 1;
+}
+
+
+void re::ThreadPool::run(size_t taskCount, const std::function<void(size_t)>& task)
+{
+	if (!taskCount)
+		return;
+
+	// Nested or single-task runs don't need the workers.
+	if (insidePool || taskCount == 1 || workers_.empty())
+	{
+		for (size_t i = 0; i < taskCount; i++)
+			task(i);
+
+		return;
+	}
+
+	std::lock_guard<std::mutex> runLock(runMutex_);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		task_ = &task;
+		taskCount_ = taskCount;
+		nextTask_ = 0;
+		finishedTasks_ = 0;
+		generation_++;
+	}
+
+	wake_.notify_all();
+
+	insidePool = true;
+	execute(task, taskCount);
+	insidePool = false;
+
+	// Workers which joined the job must leave it before the task goes out of scope.
+	std::unique_lock<std::mutex> lock(mutex_);
+	done_.wait(lock, [this] { return finishedTasks_ == taskCount_ && !activeWorkers_; });
+	task_ = nullptr;
+}
+
+
+void re::ThreadPool::workerLoop()
+{
+	insidePool = true;
+	size_t generation = 0;
+
+	while (true)
+	{
+		const std::function<void(size_t)>* task;
+		size_t taskCount;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			wake_.wait(lock, [&] { return stop_ || (task_ && generation != generation_); });
+
+			if (stop_)
+				return;
+
+			generation = generation_;
+			task = task_;
+			taskCount = taskCount_;
+			activeWorkers_++;
+		}
+
+		execute(*task, taskCount);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			activeWorkers_--;
+		}
+
+		done_.notify_all();
+	}
+}
+
+
+void re::ThreadPool::execute(const std::function<void(size_t)>& task, size_t taskCount)
+{
+	size_t finished = 0;
+
+	for (size_t i = nextTask_++; i < taskCount; i = nextTask_++)
+	{
+		task(i);
+		finished++;
+	}
+
+	finishedTasks_ += finished;
+}
+
+
+void re::setExecutor(Executor* executor)
+{
+	currentExecutor = executor ? executor : &serialExecutor;
+}
+
+
+re::Executor& re::getExecutor()
+{
+	return *currentExecutor;
+}
+
+
+size_t re::chunkSize(size_t count, size_t bytesPerElement, size_t concurrency)
+{
+	// Half of the cache slice is left for the data the kernel reads besides the stream itself.
+	const size_t cacheChunk = std::max<size_t>(PARALLEL_CACHE_SIZE / 2 / std::max<size_t>(bytesPerElement, 1), 1);
+
+	// Several chunks per thread let fast threads pick up the work of slow ones.
+	const size_t balancedChunk = (count + concurrency * 4 - 1) / (concurrency * 4);
+
+	return std::max(std::min(cacheChunk, balancedChunk), std::min(PARALLEL_MIN_CHUNK, count));
+}
+
+
+void re::parallelFor(size_t count, size_t bytesPerElement, const std::function<void(size_t, size_t)>& body)
+{
+	if (!count)
+		return;
+
+	Executor& executor = getExecutor();
+	const size_t concurrency = executor.concurrency();
+
+	if (concurrency < 2 || count <= PARALLEL_MIN_CHUNK)
+	{
+		body(0, count);
+		return;
+	}
+
+	const size_t chunk = chunkSize(count, bytesPerElement, concurrency);
+	const size_t chunkCount = (count + chunk - 1) / chunk;
+
+	if (chunkCount < 2)
+	{
+		body(0, count);
+		return;
+	}
+
+	executor.run(chunkCount, [&](size_t index)
+	{
+		const size_t begin = index * chunk;
+		body(begin, std::min(begin + chunk, count));
+	});
+}
+
+
+void re::radixSort(unsigned int* keys, unsigned int* values, size_t count)
+{
+	radixSortImpl(keys, values, count);
+}
+
+
+void re::radixSort(unsigned long long* keys, unsigned int* values, size_t count)
+{
+	radixSortImpl(keys, values, count);
+}
@@ -0,0 +1,479 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reParticleBuffer.cpp
+// Project:     reMath
+// Description: Implementation of ParticleBuffer class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "reMath/reParticleBuffer.h"
+#include "reMath/reParallel.h"
+#include "reMath/reFrameArena.h"
+#include "reMath/reMathUtil.h"
+#include "reSimd.h"
+#include <cmath>
+
+#ifdef RE_MATH_SSE
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	using namespace re::simd;
+
+	// Bytes of a particle read and written by the update kernels.
+	const size_t PARTICLE_BYTES = sizeof(float) * 7;
+
+	// Noise potential waves, three per potential component: unit direction and phase.
+	const int WAVE_COUNT = 3;
+	const float WAVES[3][WAVE_COUNT][4] = {
+		{ { 0.1127f, -0.8615f, 0.4951f, 1.8991f }, { 0.0236f, 0.7122f, -0.7016f, 1.3641f }, { -0.6736f, -0.5205f, -0.5248f, 5.2881f } },
+		{ { 0.1663f, -0.5073f, -0.8456f, 4.1016f }, { -0.7009f, -0.2123f, 0.6810f, 4.9167f }, { -0.6656f, -0.3994f, -0.6305f, 1.8308f } },
+		{ { -0.8974f, -0.4322f, 0.0889f, 2.0060f }, { -0.1745f, 0.6864f, 0.7059f, 2.6534f }, { 0.8394f, -0.4320f, -0.3298f, 1.6258f } } };
+
+	// Smallest squared distance to a sphere center with a defined push out direction.
+	const float SPHERE_EPSILON = 1e-12f;
+
+	inline float cosine(float value)
+	{
+		return cosf(value);
+	}
+
+	template <typename Real>
+	inline Real load(const float* data);
+
+	template <>
+	inline float load<float>(const float* data)
+	{
+		return *data;
+	}
+
+	inline void store(float* data, float value)
+	{
+		*data = value;
+	}
+
+#ifdef RE_MATH_SSE
+	// Cosine reduced to a quarter period and evaluated by its series, max error is 5e-7.
+	inline Float4 cosine(Float4 value)
+	{
+		const __m128 turns = _mm_mul_ps(value.v, _mm_set1_ps(0.15915494f));
+		const __m128 fraction = _mm_andnot_ps(_mm_set1_ps(-0.f), _mm_sub_ps(turns, _mm_cvtepi32_ps(_mm_cvtps_epi32(turns))));
+		const __m128 flip = _mm_cmpgt_ps(fraction, _mm_set1_ps(0.25f));
+		const Float4 angle = _mm_mul_ps(select(Mask4{ flip }, _mm_sub_ps(_mm_set1_ps(0.5f), fraction), fraction).v, _mm_set1_ps(6.2831853f));
+		const Float4 squared = angle * angle;
+
+		Float4 result = squared * Float4(-1.f / 3628800.f) + Float4(1.f / 40320.f);
+		result = squared * result + Float4(-1.f / 720.f);
+		result = squared * result + Float4(1.f / 24.f);
+		result = squared * result + Float4(-0.5f);
+		result = squared * result + Float4(1.f);
+		return _mm_xor_ps(result.v, _mm_and_ps(flip, _mm_set1_ps(-0.f)));
+	}
+
+	template <>
+	inline Float4 load<Float4>(const float* data)
+	{
+		return _mm_loadu_ps(data);
+	}
+
+	inline void store(float* data, Float4 value)
+	{
+		_mm_storeu_ps(data, value.v);
+	}
+#endif
+
+	struct Particles
+	{
+		float* x;
+		float* y;
+		float* z;
+		float* vx;
+		float* vy;
+		float* vz;
+		float* age;
+	};
+
+	Particles getParticles(std::vector<float>* streams)
+	{
+		return { streams[re::ParticleBuffer::STREAM_POSITION_X].data(), streams[re::ParticleBuffer::STREAM_POSITION_Y].data(),
+			streams[re::ParticleBuffer::STREAM_POSITION_Z].data(), streams[re::ParticleBuffer::STREAM_VELOCITY_X].data(),
+			streams[re::ParticleBuffer::STREAM_VELOCITY_Y].data(), streams[re::ParticleBuffer::STREAM_VELOCITY_Z].data(),
+			streams[re::ParticleBuffer::STREAM_AGE].data() };
+	}
+
+	// Removes the velocity component into a surface where the mask is set, keeping the restitution part of it.
+	template <typename Real, typename Mask>
+	inline void reflect(Mask contact, Real nx, Real ny, Real nz, Real& vx, Real& vy, Real& vz, float restitution, float friction)
+	{
+		const Real normal = nx * vx + ny * vy + nz * vz;
+		const Mask hit = both(contact, less(normal, Real(0.f)));
+		const Real keep(1.f - friction);
+		const Real scale = normal * Real(1.f - friction + restitution);
+		vx = select(hit, vx * keep - nx * scale, vx);
+		vy = select(hit, vy * keep - ny * scale, vy);
+		vz = select(hit, vz * keep - nz * scale, vz);
+	}
+
+	struct Accelerate
+	{
+		float x, y, z;
+
+		template <typename Real, typename Mask>
+		void apply(const Particles& p, size_t i) const
+		{
+			store(p.vx + i, load<Real>(p.vx + i) + Real(x));
+			store(p.vy + i, load<Real>(p.vy + i) + Real(y));
+			store(p.vz + i, load<Real>(p.vz + i) + Real(z));
+		}
+	};
+
+	struct Damp
+	{
+		float factor;
+
+		template <typename Real, typename Mask>
+		void apply(const Particles& p, size_t i) const
+		{
+			store(p.vx + i, load<Real>(p.vx + i) * Real(factor));
+			store(p.vy + i, load<Real>(p.vy + i) * Real(factor));
+			store(p.vz + i, load<Real>(p.vz + i) * Real(factor));
+		}
+	};
+
+	// Velocity change by the curl of the potential, a sum of sin(f * d.p + t + phase) / f per component.
+	struct CurlNoise
+	{
+		float scale, frequency, time;
+
+		template <typename Real, typename Mask>
+		void apply(const Particles& p, size_t i) const
+		{
+			const Real x = load<Real>(p.x + i) * Real(frequency);
+			const Real y = load<Real>(p.y + i) * Real(frequency);
+			const Real z = load<Real>(p.z + i) * Real(frequency);
+			Real gradients[3][3];
+
+			for (int component = 0; component < 3; component++)
+			{
+				gradients[component][0] = Real(0.f);
+				gradients[component][1] = Real(0.f);
+				gradients[component][2] = Real(0.f);
+
+				for (int k = 0; k < WAVE_COUNT; k++)
+				{
+					const float* wave = WAVES[component][k];
+					const Real slope = cosine(x * Real(wave[0]) + y * Real(wave[1]) + z * Real(wave[2]) + Real(time + wave[3]));
+					gradients[component][0] += slope * Real(wave[0]);
+					gradients[component][1] += slope * Real(wave[1]);
+					gradients[component][2] += slope * Real(wave[2]);
+				}
+			}
+
+			store(p.vx + i, load<Real>(p.vx + i) + Real(scale) * (gradients[2][1] - gradients[1][2]));
+			store(p.vy + i, load<Real>(p.vy + i) + Real(scale) * (gradients[0][2] - gradients[2][0]));
+			store(p.vz + i, load<Real>(p.vz + i) + Real(scale) * (gradients[1][0] - gradients[0][1]));
+		}
+	};
+
+	struct Move
+	{
+		float step;
+
+		template <typename Real, typename Mask>
+		void apply(const Particles& p, size_t i) const
+		{
+			store(p.x + i, load<Real>(p.x + i) + load<Real>(p.vx + i) * Real(step));
+			store(p.y + i, load<Real>(p.y + i) + load<Real>(p.vy + i) * Real(step));
+			store(p.z + i, load<Real>(p.z + i) + load<Real>(p.vz + i) * Real(step));
+			store(p.age + i, load<Real>(p.age + i) + Real(step));
+		}
+	};
+
+	struct PlaneCollider
+	{
+		const float* plane;
+		float restitution, friction;
+
+		template <typename Real, typename Mask>
+		void apply(const Particles& p, size_t i) const
+		{
+			const Real nx(plane[0]), ny(plane[1]), nz(plane[2]);
+			Real x = load<Real>(p.x + i), y = load<Real>(p.y + i), z = load<Real>(p.z + i);
+			Real vx = load<Real>(p.vx + i), vy = load<Real>(p.vy + i), vz = load<Real>(p.vz + i);
+
+			const Real distance = nx * x + ny * y + nz * z + Real(plane[3]);
+			const Mask behind = less(distance, Real(0.f));
+			const Real depth = select(behind, distance, Real(0.f));
+			store(p.x + i, x - nx * depth);
+			store(p.y + i, y - ny * depth);
+			store(p.z + i, z - nz * depth);
+
+			reflect(behind, nx, ny, nz, vx, vy, vz, restitution, friction);
+			store(p.vx + i, vx);
+			store(p.vy + i, vy);
+			store(p.vz + i, vz);
+		}
+	};
+
+	struct SphereCollider
+	{
+		float x, y, z, radius, restitution, friction;
+
+		template <typename Real, typename Mask>
+		void apply(const Particles& p, size_t i) const
+		{
+			const Real ox = load<Real>(p.x + i) - Real(x);
+			const Real oy = load<Real>(p.y + i) - Real(y);
+			const Real oz = load<Real>(p.z + i) - Real(z);
+			Real vx = load<Real>(p.vx + i), vy = load<Real>(p.vy + i), vz = load<Real>(p.vz + i);
+
+			const Real squared = ox * ox + oy * oy + oz * oz;
+			const Mask inside = less(squared, Real(radius * radius));
+			const Real inverse = rsqrt(maximum(squared, Real(SPHERE_EPSILON)));
+			const Real nx = ox * inverse, ny = oy * inverse, nz = oz * inverse;
+			store(p.x + i, select(inside, Real(x) + nx * Real(radius), ox + Real(x)));
+			store(p.y + i, select(inside, Real(y) + ny * Real(radius), oy + Real(y)));
+			store(p.z + i, select(inside, Real(z) + nz * Real(radius), oz + Real(z)));
+
+			reflect(inside, nx, ny, nz, vx, vy, vz, restitution, friction);
+			store(p.vx + i, vx);
+			store(p.vy + i, vy);
+			store(p.vz + i, vz);
+		}
+	};
+
+	template <typename Stage>
+	void run(const Particles& particles, size_t begin, size_t end, const Stage& stage)
+	{
+		size_t i = begin;
+
+#ifdef RE_MATH_SSE
+		for (; i + 4 <= end; i += 4)
+			stage.template apply<Float4, Mask4>(particles, i);
+#endif
+
+		for (; i < end; i++)
+			stage.template apply<float, bool>(particles, i);
+	}
+
+	template <typename Stage>
+	void runParallel(const Particles& particles, size_t count, const Stage& stage)
+	{
+		re::parallelFor(count, PARTICLE_BYTES, [&](size_t begin, size_t end)
+		{
+			run(particles, begin, end, stage);
+		});
+	}
+
+	// Moves the elements with a set flag to the front, in order and without branches.
+	template <typename T>
+	void compactStream(T* data, const unsigned char* alive, size_t count)
+	{
+		size_t target = 0;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			data[target] = data[i];
+			target += alive[i];
+		}
+	}
+
+	CurlNoise makeNoise(float strength, float frequency, float time, float timeStep)
+	{
+		// Gradient of every wave is a unit vector, the sum is scaled to about the strength.
+		return { strength * timeStep / WAVE_COUNT, frequency, time };
+	}
+}
+
+
+re::ParticleBuffer::ParticleBuffer(size_t capacity) :
+	colors_(capacity)
+{
+	for (auto& stream : streams_)
+		stream.resize(capacity);
+}
+
+
+size_t re::ParticleBuffer::getCount() const
+{
+	return count_;
+}
+
+
+size_t re::ParticleBuffer::getCapacity() const
+{
+	return colors_.size();
+}
+
+
+bool re::ParticleBuffer::emit(const Vec3d& position, const Vec3d& velocity, unsigned int color, float lifetime)
+{
+	if (count_ == colors_.size())
+		return false;
+
+	streams_[STREAM_POSITION_X][count_] = position.x;
+	streams_[STREAM_POSITION_Y][count_] = position.y;
+	streams_[STREAM_POSITION_Z][count_] = position.z;
+	streams_[STREAM_VELOCITY_X][count_] = velocity.x;
+	streams_[STREAM_VELOCITY_Y][count_] = velocity.y;
+	streams_[STREAM_VELOCITY_Z][count_] = velocity.z;
+	streams_[STREAM_AGE][count_] = 0.f;
+	streams_[STREAM_LIFETIME][count_] = lifetime;
+	colors_[count_] = color;
+	count_++;
+	return true;
+}
+
+
+void re::ParticleBuffer::clear()
+{
+	count_ = 0;
+}
+
+
+re::Vec3d re::ParticleBuffer::getPosition(size_t index) const
+{
+	return Vec3d(streams_[STREAM_POSITION_X][index], streams_[STREAM_POSITION_Y][index], streams_[STREAM_POSITION_Z][index]);
+}
+
+
+re::Vec3d re::ParticleBuffer::getVelocity(size_t index) const
+{
+	return Vec3d(streams_[STREAM_VELOCITY_X][index], streams_[STREAM_VELOCITY_Y][index], streams_[STREAM_VELOCITY_Z][index]);
+}
+
+
+unsigned int re::ParticleBuffer::getColor(size_t index) const
+{
+	return colors_[index];
+}
+
+
+float re::ParticleBuffer::getAge(size_t index) const
+{
+	return streams_[STREAM_AGE][index];
+}
+
+
+const float* re::ParticleBuffer::getStream(Stream stream) const
+{
+	return streams_[stream].data();
+}
+
+
+const unsigned int* re::ParticleBuffer::getColors() const
+{
+	return colors_.data();
+}
+
+
+void re::ParticleBuffer::applyGravity(const Vec3d& acceleration, float timeStep)
+{
+	const Particles particles = getParticles(streams_);
+	runParallel(particles, count_, Accelerate{ acceleration.x * timeStep, acceleration.y * timeStep, acceleration.z * timeStep });
+}
+
+
+void re::ParticleBuffer::applyDrag(float drag, float timeStep)
+{
+	const Particles particles = getParticles(streams_);
+	runParallel(particles, count_, Damp{ expf(-drag * timeStep) });
+}
+
+
+void re::ParticleBuffer::applyCurlNoise(float strength, float frequency, float time, float timeStep)
+{
+	const Particles particles = getParticles(streams_);
+	runParallel(particles, count_, makeNoise(strength, frequency, time, timeStep));
+}
+
+
+void re::ParticleBuffer::integrate(float timeStep)
+{
+	const Particles particles = getParticles(streams_);
+	runParallel(particles, count_, Move{ timeStep });
+}
+
+
+void re::ParticleBuffer::collidePlane(const float* plane, float restitution, float friction)
+{
+	const Particles particles = getParticles(streams_);
+	runParallel(particles, count_, PlaneCollider{ plane, restitution, friction });
+}
+
+
+void re::ParticleBuffer::collideSphere(const Vec3d& center, float radius, float restitution, float friction)
+{
+	const Particles particles = getParticles(streams_);
+	runParallel(particles, count_, SphereCollider{ center.x, center.y, center.z, radius, restitution, friction });
+}
+
+
+void re::ParticleBuffer::update(const ParticleForces& forces, float timeStep)
+{
+	const Particles particles = getParticles(streams_);
+	const Accelerate gravity = { forces.gravity.x * timeStep, forces.gravity.y * timeStep, forces.gravity.z * timeStep };
+	const CurlNoise noise = makeNoise(forces.noiseStrength, forces.noiseFrequency, forces.noiseTime, timeStep);
+	const Damp drag = { expf(-forces.drag * timeStep) };
+	const Move move = { timeStep };
+
+	parallelFor(count_, PARTICLE_BYTES, [&](size_t begin, size_t end)
+	{
+		run(particles, begin, end, gravity);
+
+		if (forces.noiseStrength != 0.f)
+			run(particles, begin, end, noise);
+
+		if (forces.drag != 0.f)
+			run(particles, begin, end, drag);
+
+		run(particles, begin, end, move);
+
+		for (size_t i = 0; i < forces.planeCount; i++)
+			run(particles, begin, end, PlaneCollider{ forces.planes + i * 4, forces.restitution, forces.friction });
+
+		for (size_t i = 0; i < forces.sphereCount; i++)
+		{
+			const Vec3d& center = forces.sphereCenters[i];
+			run(particles, begin, end, SphereCollider{ center.x, center.y, center.z, forces.sphereRadii[i], forces.restitution, forces.friction });
+		}
+	});
+}
+
+
+size_t re::ParticleBuffer::compact()
+{
+	FrameArena& scratch = FrameArena::threadLocal();
+	const auto marker = scratch.mark();
+	unsigned char* alive = scratch.allocate<unsigned char>(count_);
+	const float* ages = streams_[STREAM_AGE].data();
+	const float* lifetimes = streams_[STREAM_LIFETIME].data();
+	size_t aliveCount = 0;
+
+	for (size_t i = 0; i < count_; i++)
+	{
+		alive[i] = ages[i] < lifetimes[i];
+		aliveCount += alive[i];
+	}
+
+	// Every array is compacted by its own task with the same flags.
+	if (aliveCount < count_)
+	{
+		getExecutor().run(STREAM_COUNT + 1, [&](size_t stream)
+		{
+			if (stream == STREAM_COUNT)
+				compactStream(colors_.data(), alive, count_);
+			else
+				compactStream(streams_[stream].data(), alive, count_);
+		});
+	}
+
+	scratch.rewind(marker);
+
+	const size_t removed = count_ - aliveCount;
+	count_ = aliveCount;
+	return removed;
+}
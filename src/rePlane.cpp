@@ -0,0 +1,273 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        rePlane.cpp
+// Project:     reMath
+// Description: Implementation of Plane class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "reMath/rePlane.h"
+#include "reMath/reSphere.h"
+#include "reMath/reMatrix3.h"
+#include "reMath/reMatrix4.h"
+#include "reMath/reParallel.h"
+#include "reMath/reMathUtil.h"
+#include <atomic>
+#include <cmath>
+
+#ifdef RE_MATH_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+	// Inverse transpose of an affine matrix scaled by |det|: the cofactor matrix columns times
+	// the determinant sign. The scale does not change a plane, which is normalized afterwards.
+	struct PlaneTransform
+	{
+		re::Vec3d columns[3];
+		re::Vec3d translation;
+		float scale;
+	};
+
+	PlaneTransform getPlaneTransform(const re::Matrix4& matrix)
+	{
+		const float* m = static_cast<const float*>(matrix);
+		const re::Vec3d c0(m[0], m[1], m[2]);
+		const re::Vec3d c1(m[4], m[5], m[6]);
+		const re::Vec3d c2(m[8], m[9], m[10]);
+
+		PlaneTransform result;
+		result.columns[0] = c1.cross(c2);
+		result.columns[1] = c2.cross(c0);
+		result.columns[2] = c0.cross(c1);
+		result.translation.set(m[12], m[13], m[14]);
+
+		const float determinant = c0.dot(result.columns[0]);
+		result.scale = fabsf(determinant);
+
+		if (determinant < 0.f)
+			for (re::Vec3d& column : result.columns)
+				column.negate();
+
+		return result;
+	}
+
+	void transformPlane(const PlaneTransform& transform, re::Plane& plane)
+	{
+		const re::Vec3d normal(transform.columns[0] * plane.normal.x + transform.columns[1] * plane.normal.y + transform.columns[2] * plane.normal.z);
+		plane.d = plane.d * transform.scale - normal.dot(transform.translation);
+		plane.normal = normal;
+		plane.normalize();
+	}
+}
+
+
+re::Plane::Plane() :
+	normal(0.f, 1.f, 0.f),
+	d(0.f)
+{
+}
+
+
+re::Plane::Plane(const Vec3d& normalValue, float dValue) :
+	normal(normalValue),
+	d(dValue)
+{
+}
+
+
+re::Plane::Plane(const Vec3d& normalValue, const Vec3d& point) :
+	normal(normalValue),
+	d(-normalValue.dot(point))
+{
+}
+
+
+re::Plane::Plane(const float* coefficients) :
+	normal(coefficients),
+	d(coefficients[3])
+{
+}
+
+
+re::Plane re::Plane::fromPoints(const Vec3d& a, const Vec3d& b, const Vec3d& c)
+{
+	Plane result((b - a).cross(c - a), a);
+	result.normalize();
+	return result;
+}
+
+
+re::Plane re::Plane::fromPoints(const Vec3d* points, size_t count)
+{
+	if (!points || !count)
+		return Plane();
+
+	Vec3d mean(0.f, 0.f, 0.f);
+
+	for (size_t i = 0; i < count; i++)
+		mean += points[i];
+
+	mean /= static_cast<float>(count);
+
+	Matrix3 covariance;
+
+	for (int j = 0; j < 9; j++)
+		covariance[j] = 0.f;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const Vec3d offset = points[i] - mean;
+
+		for (int j = 0; j < 3; j++)
+			for (int k = 0; k < 3; k++)
+				covariance[k * 3 + j] += offset.d[j] * offset.d[k];
+	}
+
+	// Eigenvalues are in descending order, the normal is the last eigenvector.
+	Vec3d values;
+	Matrix3 vectors;
+	covariance.eigenSymmetric(values, vectors);
+
+	return Plane(Vec3d(vectors[6], vectors[7], vectors[8]), mean);
+}
+
+
+void re::Plane::normalize()
+{
+	const float length = normal.length();
+
+	if (length > 0.f)
+	{
+		normal /= length;
+		d /= length;
+	}
+}
+
+
+float re::Plane::distance(const Vec3d& point) const
+{
+	return normal.dot(point) + d;
+}
+
+
+re::Vec3d re::Plane::project(const Vec3d& point) const
+{
+	return point - normal * distance(point);
+}
+
+
+re::Plane::Side re::Plane::classify(const Vec3d& point, float epsilon) const
+{
+	const float value = distance(point);
+	return value > epsilon ? SIDE_FRONT : value < -epsilon ? SIDE_BACK : SIDE_ON;
+}
+
+
+re::Plane::Side re::Plane::classify(const Sphere& sphere) const
+{
+	if (sphere.isEmpty())
+		return classify(sphere.center);
+
+	const float value = distance(sphere.center);
+	return value > sphere.radius ? SIDE_FRONT : value < -sphere.radius ? SIDE_BACK : SIDE_SPANNING;
+}
+
+
+bool re::Plane::intersectsRay(const Vec3d& origin, const Vec3d& direction, float& distance) const
+{
+	const float denominator = normal.dot(direction);
+
+	if (denominator == 0.f)
+		return false;
+
+	distance = -this->distance(origin) / denominator;
+	return distance >= 0.f;
+}
+
+
+void re::Plane::transform(const Matrix4& matrix)
+{
+	transformPlane(getPlaneTransform(matrix), *this);
+}
+
+
+void re::Plane::transformN(const Matrix4& matrix, Plane* planes, size_t count)
+{
+	const PlaneTransform transform = getPlaneTransform(matrix);
+
+	for (size_t i = 0; i < count; i++)
+		transformPlane(transform, planes[i]);
+}
+
+
+void re::Plane::distanceN(const Plane& plane, const Vec3d* points, size_t count, float* distances)
+{
+	const Plane* source = &plane;
+
+	parallelFor(count, sizeof(Vec3d) + sizeof(float), [=](size_t begin, size_t end)
+	{
+		size_t i = begin;
+
+#ifdef RE_MATH_SSE
+		const __m128 nx = _mm_set1_ps(source->normal.x);
+		const __m128 ny = _mm_set1_ps(source->normal.y);
+		const __m128 nz = _mm_set1_ps(source->normal.z);
+		const __m128 offset = _mm_set1_ps(source->d);
+
+		for (; i + 4 <= end; i += 4)
+		{
+			const Vec3d* p = points + i;
+			const __m128 x = _mm_setr_ps(p[0].x, p[1].x, p[2].x, p[3].x);
+			const __m128 y = _mm_setr_ps(p[0].y, p[1].y, p[2].y, p[3].y);
+			const __m128 z = _mm_setr_ps(p[0].z, p[1].z, p[2].z, p[3].z);
+			_mm_storeu_ps(distances + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, x), _mm_mul_ps(ny, y)), _mm_add_ps(_mm_mul_ps(nz, z), offset)));
+		}
+#endif
+
+		for (; i < end; i++)
+			distances[i] = source->distance(points[i]);
+	});
+}
+
+
+re::Plane::Side re::Plane::classifyN(const Plane& plane, const Vec3d* points, size_t count, float epsilon)
+{
+	const Plane* source = &plane;
+	std::atomic<unsigned int> sides(SIDE_ON);
+
+	parallelFor(count, sizeof(Vec3d), [=, &sides](size_t begin, size_t end)
+	{
+		unsigned int found = SIDE_ON;
+		size_t i = begin;
+
+#ifdef RE_MATH_SSE
+		const __m128 nx = _mm_set1_ps(source->normal.x);
+		const __m128 ny = _mm_set1_ps(source->normal.y);
+		const __m128 nz = _mm_set1_ps(source->normal.z);
+		const __m128 offset = _mm_set1_ps(source->d);
+		const __m128 front = _mm_set1_ps(epsilon);
+		const __m128 back = _mm_set1_ps(-epsilon);
+
+		for (; i + 4 <= end && found != SIDE_SPANNING; i += 4)
+		{
+			const Vec3d* p = points + i;
+			const __m128 x = _mm_setr_ps(p[0].x, p[1].x, p[2].x, p[3].x);
+			const __m128 y = _mm_setr_ps(p[0].y, p[1].y, p[2].y, p[3].y);
+			const __m128 z = _mm_setr_ps(p[0].z, p[1].z, p[2].z, p[3].z);
+			const __m128 value = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, x), _mm_mul_ps(ny, y)), _mm_add_ps(_mm_mul_ps(nz, z), offset));
+			found |= (_mm_movemask_ps(_mm_cmpgt_ps(value, front)) ? SIDE_FRONT : 0) | (_mm_movemask_ps(_mm_cmplt_ps(value, back)) ? SIDE_BACK : 0);
+		}
+#endif
+
+		for (; i < end && found != SIDE_SPANNING; i++)
+			found |= source->classify(points[i], epsilon);
+
+		sides.fetch_or(found, std::memory_order_relaxed);
+	});
+
+	return static_cast<Side>(sides.load());
+}
@@ -10,10 +10,56 @@
 
 #include "reMath/reQuaternion.h"
 #include "reMath/reVec3d.h"
+#include "reMath/reMatrix3.h"
 #include "reMath/reMatrix4.h"
+#include "reMath/reVecExpr.h"
+#include "reMath/reMathUtil.h"
+#include <cfloat>
 #include <cstring>
 #include <cmath>
 
+namespace
+{
+	// Relative tolerance of nearly opposite directions in the shortest arc rotation.
+	const float SHORTEST_ARC_EPSILON = 0.000001f;
+
+	// Shepperd's method: the largest of the four quaternion components is computed from the
+	// diagonal and the others are divided by it, which keeps the precision at any rotation angle.
+	// Column-major matrix elements are m[column * stride + row].
+	re::Quaternion fromRotation(const float* m, int stride)
+	{
+		const float m00 = m[0];
+		const float m11 = m[stride + 1];
+		const float m22 = m[stride * 2 + 2];
+		const float traces[4] = { m00 + m11 + m22, m00 - m11 - m22, m11 - m00 - m22, m22 - m00 - m11 };
+		int largest = 0;
+
+		for (int i = 1; i < 4; i++)
+			largest = traces[i] > traces[largest] ? i : largest;
+
+		const float diagonal = 1.f + traces[largest];
+		const float scale = 0.5f / sqrtf(diagonal);
+		const float a = m[stride + 2] - m[stride * 2 + 1];	// m21 - m12
+		const float b = m[stride * 2] - m[2];				// m02 - m20
+		const float c = m[1] - m[stride];					// m10 - m01
+		const float d = m[stride] + m[1];					// m01 + m10
+		const float e = m[stride * 2] + m[2];				// m02 + m20
+		const float f = m[stride * 2 + 1] + m[stride + 2];	// m12 + m21
+
+		const float candidates[4][4] = {
+			{ a, b, c, diagonal },
+			{ diagonal, d, e, a },
+			{ d, diagonal, f, b },
+			{ e, f, diagonal, c } };
+
+		const float* q = candidates[largest];
+		re::Quaternion result(q[0] * scale, q[1] * scale, q[2] * scale, q[3] * scale);
+		result.normalize();
+		return result;
+	}
+}
+
+
 re::Quaternion::Quaternion()
 {
 	set(0, 0, 0, 1);
@@ -83,7 +129,7 @@ void re::Quaternion::set(const Vec3d& vector)
 }
 
 
-re::Quaternion re::Quaternion::fromEulers(Vec3d& vector)
+re::Quaternion re::Quaternion::fromEulers(const Vec3d& vector)
 {
 	const float sinYaw = sinf(vector.z / 2.f);
 	const float sinPitch = sinf(vector.y / 2.f);
@@ -122,6 +168,68 @@ re::Quaternion re::Quaternion::fromEulerZRotation(float angle)
 }
 
 
+re::Quaternion re::Quaternion::fromMatrix(const Matrix3& matrix)
+{
+	return fromRotation(static_cast<const float*>(matrix), 3);
+}
+
+
+re::Quaternion re::Quaternion::fromMatrix(const Matrix4& matrix)
+{
+	return fromRotation(static_cast<const float*>(matrix), 4);
+}
+
+
+re::Quaternion re::Quaternion::fromAxisAngle(const Vec3d& axis, float angle)
+{
+	const float halfAngle = angle * 0.5f;
+	const float sine = sinf(halfAngle);
+	return Quaternion(axis.x * sine, axis.y * sine, axis.z * sine, cosf(halfAngle));
+}
+
+
+re::Quaternion re::Quaternion::fromTo(const Vec3d& from, const Vec3d& to)
+{
+	// (from x to, |from| |to| + from . to) is the quaternion of twice the angle between the
+	// vectors, adding the lengths product to w halves it.
+	const float lengths = sqrtf(from.lengthSquared() * to.lengthSquared());
+	const float cosine = from.dot(to);
+	Quaternion result;
+
+	if (cosine + lengths > lengths * SHORTEST_ARC_EPSILON)
+	{
+		const Vec3d axis = from.cross(to);
+		result.set(axis.x, axis.y, axis.z, cosine + lengths);
+	}
+	else
+	{
+		// Opposite directions, half turn around any perpendicular axis.
+		const Vec3d axis = fabsf(from.x) > fabsf(from.z) ? Vec3d(-from.y, from.x, 0.f) : Vec3d(0.f, -from.z, from.y);
+		result.set(axis.x, axis.y, axis.z, 0.f);
+	}
+
+	result.normalize();
+	return result;
+}
+
+
+re::Quaternion re::Quaternion::lookRotation(const Vec3d& forward, const Vec3d& up)
+{
+	Vec3d zAxis(-forward);
+	zAxis.normalize();
+	Vec3d xAxis(up.cross(zAxis));
+
+	// Up parallel to forward leaves the roll undefined, the shortest arc is used then.
+	if (xAxis.lengthSquared() <= FLT_EPSILON * up.lengthSquared())
+		return fromTo(Vec3d(0.f, 0.f, -1.f), forward);
+
+	xAxis.normalize();
+	const Vec3d yAxis(zAxis.cross(xAxis));
+	const float matrix[9] = { xAxis.x, xAxis.y, xAxis.z, yAxis.x, yAxis.y, yAxis.z, zAxis.x, zAxis.y, zAxis.z };
+	return fromMatrix(Matrix3(matrix));
+}
+
+
 void re::Quaternion::computeW()
 {
 	if (!x && !y && !z)
@@ -204,6 +312,12 @@ float re::Quaternion::length() const
 }
 
 
+float re::Quaternion::lengthSquared() const
+{
+	return x*x + y*y + z*z + w*w;
+}
+
+
 void re::Quaternion::normalize()
 {
 	const float d = length();
@@ -222,6 +336,26 @@ void re::Quaternion::normalize()
 }
 
 
+void re::Quaternion::normalizeFast()
+{
+	const float squared = lengthSquared();
+
+	// Denormal squared lengths overflow the reciprocal square root, the exact path handles them.
+	if (squared >= FLT_MIN)
+	{
+		const float scale = rsqrtFast(squared);
+		x *= scale;
+		y *= scale;
+		z *= scale;
+		w *= scale;
+	}
+	else
+	{
+		normalize();
+	}
+}
+
+
 void re::Quaternion::negate()
 {
 	x = -x;
@@ -231,6 +365,83 @@ void re::Quaternion::negate()
 }
 
 
+void re::Quaternion::conjugate()
+{
+	x = -x;
+	y = -y;
+	z = -z;
+}
+
+
+void re::Quaternion::inverse()
+{
+	const float d = lengthSquared();
+	conjugate();
+
+	if (d)
+	{
+		x /= d;
+		y /= d;
+		z /= d;
+		w /= d;
+	}
+}
+
+
+re::Quaternion re::Quaternion::toConjugated() const
+{
+	return Quaternion(-x, -y, -z, w);
+}
+
+
+re::Quaternion re::Quaternion::toInversed() const
+{
+	Quaternion result(this);
+	result.inverse();
+	return result;
+}
+
+
+re::Quaternion re::Quaternion::log() const
+{
+	const float vectorLength = sqrtf(x * x + y * y + z * z);
+	const float logLength = logf(length());
+
+	// The angle over the sine approaches 1 for small angles, near -identity the angle approaches
+	// PI instead and stays on the atan2f() path. Exact -identity has no axis, any one will do.
+	if (vectorLength <= 0.f && w < 0.f)
+		return Quaternion(PI, 0.f, 0.f, logLength);
+
+	const float scale = w > 0.f && vectorLength <= FLT_EPSILON ? 1.f / w : atan2f(vectorLength, w) / vectorLength;
+	return Quaternion(x * scale, y * scale, z * scale, logLength);
+}
+
+
+re::Quaternion re::Quaternion::exp() const
+{
+	const float angle = sqrtf(x * x + y * y + z * z);
+	const float magnitude = expf(w);
+	const float scale = angle > FLT_EPSILON ? magnitude * sinf(angle) / angle : magnitude;
+	return Quaternion(x * scale, y * scale, z * scale, magnitude * cosf(angle));
+}
+
+
+void re::Quaternion::swingTwist(const Vec3d& axis, Quaternion& swing, Quaternion& twist) const
+{
+	// Twist keeps the rotation part along the axis.
+	const float projection = x * axis.x + y * axis.y + z * axis.z;
+	twist.set(axis.x * projection, axis.y * projection, axis.z * projection, w);
+
+	// Half turn perpendicular to the axis has no twist.
+	if (twist.lengthSquared() <= FLT_EPSILON * FLT_EPSILON)
+		twist.set(0.f, 0.f, 0.f, 1.f);
+	else
+		twist.normalize();
+
+	swing = *this * twist.toConjugated();
+}
+
+
 re::Quaternion re::Quaternion::slerp(const Quaternion& quaternion, float scale) const
 {
 	Quaternion first(this);
@@ -263,7 +474,8 @@ re::Quaternion re::Quaternion::slerp(const Quaternion& quaternion, float scale)
 
 re::Quaternion re::Quaternion::lerp(const Quaternion& quaternion, float scale) const
 {
-	Quaternion result(Quaternion(this) + ((quaternion - Quaternion(this)) * scale));
+	Quaternion result;
+	expr::assign(result, expr::lerp(expr::ref(*this), expr::ref(quaternion), scale));
 	result.normalize();
 	return result;
 }
@@ -275,6 +487,31 @@ float re::Quaternion::dot(const Quaternion& quaternion) const
 }
 
 
+void re::Quaternion::rotate(float& xValue, float& yValue, float& zValue) const
+{
+	// With t = 2 * (q x v) the rotated vector is v + w * t + q x t, two cross products instead of
+	// two quaternion products.
+	const float tx = 2.f * (y * zValue - z * yValue);
+	const float ty = 2.f * (z * xValue - x * zValue);
+	const float tz = 2.f * (x * yValue - y * xValue);
+	xValue += w * tx + y * tz - z * ty;
+	yValue += w * ty + z * tx - x * tz;
+	zValue += w * tz + x * ty - y * tx;
+}
+
+
+void re::Quaternion::rotate(float* vector) const
+{
+	rotate(vector[0], vector[1], vector[2]);
+}
+
+
+void re::Quaternion::rotate(Vec3d& vector) const
+{
+	rotate(vector.x, vector.y, vector.z);
+}
+
+
 bool re::Quaternion::operator == (const Quaternion& quaternion) const
 {
 	return (x == quaternion.x && y == quaternion.y && z == quaternion.z && w == quaternion.w);
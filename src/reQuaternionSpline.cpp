@@ -0,0 +1,194 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reQuaternionSpline.cpp
+// Project:     reMath
+// Description: Implementation of QuaternionSpline class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "reMath/reQuaternionSpline.h"
+#include "reMath/reParallel.h"
+#include <cmath>
+
+namespace
+{
+	// Below this sine of the angle slerp falls back to lerp.
+	const float SLERP_EPSILON = 0.0001f;
+
+	void computeArc(const re::Quaternion& first, const re::Quaternion& second, float& angle, float& inverseSine)
+	{
+		float cosine = first.dot(second);
+		cosine = cosine > 1.f ? 1.f : cosine < -1.f ? -1.f : cosine;
+		angle = acosf(cosine);
+
+		const float sine = sinf(angle);
+		inverseSine = sine > SLERP_EPSILON ? 1.f / sine : 0.f;
+	}
+
+	// Slerp without the shortest path flip, which would break the continuity of SQUAD.
+	re::Quaternion slerp(const re::Quaternion& first, const re::Quaternion& second, float angle, float inverseSine, float fraction)
+	{
+		re::Quaternion result = inverseSine > 0.f ?
+			first * (sinf((1.f - fraction) * angle) * inverseSine) + second * (sinf(fraction * angle) * inverseSine) :
+			first * (1.f - fraction) + second * fraction;
+
+		result.normalize();
+		return result;
+	}
+
+	// Cumulative basis functions of the uniform cubic B-spline.
+	void cumulativeBasis(float u, float basis[3])
+	{
+		const float u2 = u * u;
+		const float u3 = u2 * u;
+		basis[0] = (5.f + 3.f * u - 3.f * u2 + u3) / 6.f;
+		basis[1] = (1.f + 3.f * u + 3.f * u2 - 2.f * u3) / 6.f;
+		basis[2] = u3 / 6.f;
+	}
+}
+
+
+re::QuaternionSpline::QuaternionSpline(const Quaternion* keys, size_t count, Interpolation interpolation) :
+	interpolation_(interpolation),
+	keys_(keys, keys + count)
+{
+	// Neighbour keys in one hemisphere, so that every segment takes the short way.
+	for (size_t i = 1; i < count; i++)
+	{
+		if (keys_[i].dot(keys_[i - 1]) < 0.f)
+			keys_[i].negate();
+	}
+
+	if (count < 2)
+		return;
+
+	if (interpolation_ == INTERPOLATION_SQUAD)
+	{
+		inner_.resize(count);
+		inner_.front() = keys_.front();
+		inner_.back() = keys_.back();
+
+		for (size_t i = 1; i + 1 < count; i++)
+		{
+			const Quaternion inverse = keys_[i].toConjugated();
+			const Quaternion tangent = ((inverse * keys_[i + 1]).log() + (inverse * keys_[i - 1]).log()) * -0.25f;
+			inner_[i] = keys_[i] * tangent.exp();
+		}
+
+		keyArcs_.resize(count - 1);
+		innerArcs_.resize(count - 1);
+
+		for (size_t i = 0; i + 1 < count; i++)
+		{
+			computeArc(keys_[i], keys_[i + 1], keyArcs_[i].angle, keyArcs_[i].inverseSine);
+			computeArc(inner_[i], inner_[i + 1], innerArcs_[i].angle, innerArcs_[i].inverseSine);
+		}
+	}
+	else
+	{
+		// The first and last deltas rotate a clamped key onto itself.
+		deltas_.resize(count + 1);
+
+		for (size_t i = 0; i <= count; i++)
+		{
+			Delta& delta = deltas_[i];
+			delta.axis[0] = delta.axis[1] = delta.axis[2] = 0.f;
+			delta.angle = 0.f;
+
+			if (i == 0 || i == count)
+				continue;
+
+			const Quaternion logarithm = (keys_[i - 1].toConjugated() * keys_[i]).log();
+			const float halfAngle = sqrtf(logarithm.x * logarithm.x + logarithm.y * logarithm.y + logarithm.z * logarithm.z);
+
+			if (halfAngle > 0.f)
+			{
+				delta.axis[0] = logarithm.x / halfAngle;
+				delta.axis[1] = logarithm.y / halfAngle;
+				delta.axis[2] = logarithm.z / halfAngle;
+				delta.angle = halfAngle * 2.f;
+			}
+		}
+	}
+}
+
+
+size_t re::QuaternionSpline::getKeyCount() const
+{
+	return keys_.size();
+}
+
+
+re::QuaternionSpline::Interpolation re::QuaternionSpline::getInterpolation() const
+{
+	return interpolation_;
+}
+
+
+re::Quaternion re::QuaternionSpline::evaluate(float time) const
+{
+	if (keys_.empty())
+		return Quaternion();
+
+	if (keys_.size() == 1)
+		return keys_.front();
+
+	const float last = static_cast<float>(keys_.size() - 1);
+	time = time < 0.f ? 0.f : time > last ? last : time;
+
+	size_t segment = static_cast<size_t>(time);
+	segment = segment < keys_.size() - 1 ? segment : keys_.size() - 2;
+	const float fraction = time - static_cast<float>(segment);
+
+	return interpolation_ == INTERPOLATION_SQUAD ? evaluateSquad(segment, fraction) : evaluateBSpline(segment, fraction);
+}
+
+
+void re::QuaternionSpline::evaluateN(const float* times, Quaternion* output, size_t count) const
+{
+	parallelFor(count, sizeof(float) + sizeof(Quaternion), [=](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+			output[i] = evaluate(times[i]);
+	});
+}
+
+
+re::Quaternion re::QuaternionSpline::evaluateSquad(size_t segment, float fraction) const
+{
+	const Arc& keyArc = keyArcs_[segment];
+	const Arc& innerArc = innerArcs_[segment];
+	const Quaternion outer = slerp(keys_[segment], keys_[segment + 1], keyArc.angle, keyArc.inverseSine, fraction);
+	const Quaternion inner = slerp(inner_[segment], inner_[segment + 1], innerArc.angle, innerArc.inverseSine, fraction);
+
+	float angle, inverseSine;
+	computeArc(outer, inner, angle, inverseSine);
+	return slerp(outer, inner, angle, inverseSine, 2.f * fraction * (1.f - fraction));
+}
+
+
+re::Quaternion re::QuaternionSpline::evaluateBSpline(size_t segment, float fraction) const
+{
+	// q(u) = key[i - 1] * exp(B1(u) * w[i]) * exp(B2(u) * w[i + 1]) * exp(B3(u) * w[i + 2])
+	float basis[3];
+	cumulativeBasis(fraction, basis);
+
+	Quaternion result = keys_[segment > 0 ? segment - 1 : 0];
+
+	for (int j = 0; j < 3; j++)
+	{
+		const Delta& delta = deltas_[segment + j];
+
+		if (delta.angle == 0.f)
+			continue;
+
+		const float halfAngle = basis[j] * delta.angle * 0.5f;
+		const float sine = sinf(halfAngle);
+		result *= Quaternion(delta.axis[0] * sine, delta.axis[1] * sine, delta.axis[2] * sine, cosf(halfAngle));
+	}
+
+	result.normalize();
+	return result;
+}
@@ -0,0 +1,171 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reSimd.h
+// Project:     reMath
+// Description: Internal lane types and SSE helpers shared by the batch kernels
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __RE_MATH_SIMD__
+#define __RE_MATH_SIMD__
+
+#include "reMath/reMathUtil.h"
+#include "reMath/reVec3d.h"
+#include <cfloat>
+#include <cmath>
+
+#ifdef RE_MATH_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace re
+{
+	namespace simd
+	{
+		// Lane operations of the scalar kernels. Kernels templated on the lane type (float or
+		// Float4) call them unqualified.
+		inline float select(bool mask, float ifTrue, float ifFalse)
+		{
+			return mask ? ifTrue : ifFalse;
+		}
+
+		inline bool less(float first, float second)
+		{
+			return first < second;
+		}
+
+		inline bool both(bool first, bool second)
+		{
+			return first && second;
+		}
+
+		inline float rsqrt(float value)
+		{
+			return 1.f / std::sqrt(value);
+		}
+
+		inline float accurateSqrt(float value)
+		{
+			return std::sqrt(value);
+		}
+
+		inline float absolute(float value)
+		{
+			return std::fabs(value);
+		}
+
+		inline float maximum(float first, float second)
+		{
+			return first > second ? first : second;
+		}
+
+#ifdef RE_MATH_SSE
+		// Four reciprocal square roots refined by one Newton-Raphson step, zero for zero and
+		// denormal input (rsqrtps overflows to infinity there).
+		inline __m128 rsqrtFast4(__m128 value)
+		{
+			const __m128 estimate = _mm_rsqrt_ps(value);
+			const __m128 refined = _mm_mul_ps(estimate, _mm_sub_ps(_mm_set1_ps(1.5f),
+				_mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), value), _mm_mul_ps(estimate, estimate))));
+			return _mm_and_ps(refined, _mm_cmpge_ps(value, _mm_set1_ps(FLT_MIN)));
+		}
+
+		// Rotates four vectors by four quaternions, the same cross product form as Quaternion::rotate().
+		inline void rotate4(__m128 qx, __m128 qy, __m128 qz, __m128 qw, __m128& x, __m128& y, __m128& z)
+		{
+			const __m128 two = _mm_set1_ps(2.f);
+			const __m128 tx = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(qy, z), _mm_mul_ps(qz, y)));
+			const __m128 ty = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(qz, x), _mm_mul_ps(qx, z)));
+			const __m128 tz = _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(qx, y), _mm_mul_ps(qy, x)));
+			x = _mm_add_ps(x, _mm_add_ps(_mm_mul_ps(qw, tx), _mm_sub_ps(_mm_mul_ps(qy, tz), _mm_mul_ps(qz, ty))));
+			y = _mm_add_ps(y, _mm_add_ps(_mm_mul_ps(qw, ty), _mm_sub_ps(_mm_mul_ps(qz, tx), _mm_mul_ps(qx, tz))));
+			z = _mm_add_ps(z, _mm_add_ps(_mm_mul_ps(qw, tz), _mm_sub_ps(_mm_mul_ps(qx, ty), _mm_mul_ps(qy, tx))));
+		}
+
+		// Transposes four vectors into component registers.
+		inline void load4(const Vec3d* v, __m128& x, __m128& y, __m128& z)
+		{
+			x = _mm_setr_ps(v[0].x, v[1].x, v[2].x, v[3].x);
+			y = _mm_setr_ps(v[0].y, v[1].y, v[2].y, v[3].y);
+			z = _mm_setr_ps(v[0].z, v[1].z, v[2].z, v[3].z);
+		}
+
+		inline void store4(__m128 x, __m128 y, __m128 z, Vec3d* v)
+		{
+			float rx[4], ry[4], rz[4];
+			_mm_storeu_ps(rx, x);
+			_mm_storeu_ps(ry, y);
+			_mm_storeu_ps(rz, z);
+
+			for (int j = 0; j < 4; j++)
+				v[j].set(rx[j], ry[j], rz[j]);
+		}
+
+		// Four lanes of the SSE kernels.
+		struct Float4
+		{
+			__m128 v;
+
+			Float4() = default;
+			Float4(__m128 value) : v(value) {}
+			Float4(float value) : v(_mm_set1_ps(value)) {}
+		};
+
+		struct Mask4
+		{
+			__m128 m;
+		};
+
+		inline Float4 operator + (Float4 first, Float4 second) { return _mm_add_ps(first.v, second.v); }
+		inline Float4 operator - (Float4 first, Float4 second) { return _mm_sub_ps(first.v, second.v); }
+		inline Float4 operator * (Float4 first, Float4 second) { return _mm_mul_ps(first.v, second.v); }
+		inline Float4 operator / (Float4 first, Float4 second) { return _mm_div_ps(first.v, second.v); }
+		inline Float4 operator - (Float4 value) { return _mm_xor_ps(value.v, _mm_set1_ps(-0.f)); }
+		inline Float4& operator += (Float4& first, Float4 second) { first.v = _mm_add_ps(first.v, second.v); return first; }
+		inline Float4& operator -= (Float4& first, Float4 second) { first.v = _mm_sub_ps(first.v, second.v); return first; }
+		inline Float4& operator *= (Float4& first, Float4 second) { first.v = _mm_mul_ps(first.v, second.v); return first; }
+
+		inline Float4 select(Mask4 mask, Float4 ifTrue, Float4 ifFalse)
+		{
+			return _mm_or_ps(_mm_and_ps(mask.m, ifTrue.v), _mm_andnot_ps(mask.m, ifFalse.v));
+		}
+
+		inline Mask4 less(Float4 first, Float4 second)
+		{
+			return Mask4{ _mm_cmplt_ps(first.v, second.v) };
+		}
+
+		inline Mask4 both(Mask4 first, Mask4 second)
+		{
+			return Mask4{ _mm_and_ps(first.m, second.m) };
+		}
+
+		inline Float4 rsqrt(Float4 value)
+		{
+			// Estimate refined by a Newton-Raphson step.
+			const __m128 estimate = _mm_rsqrt_ps(value.v);
+			const __m128 half = _mm_mul_ps(_mm_set1_ps(0.5f), value.v);
+			return _mm_mul_ps(estimate, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(half, _mm_mul_ps(estimate, estimate))));
+		}
+
+		inline Float4 accurateSqrt(Float4 value)
+		{
+			return _mm_sqrt_ps(value.v);
+		}
+
+		inline Float4 absolute(Float4 value)
+		{
+			return _mm_andnot_ps(_mm_set1_ps(-0.f), value.v);
+		}
+
+		inline Float4 maximum(Float4 first, Float4 second)
+		{
+			return _mm_max_ps(first.v, second.v);
+		}
+#endif
+	}
+}
+
+#endif // __RE_MATH_SIMD__
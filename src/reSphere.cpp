@@ -0,0 +1,279 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reSphere.cpp
+// Project:     reMath
+// Description: Implementation of Sphere class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "reMath/reSphere.h"
+#include "reMath/reMatrix4.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	// Relative slack of the containment test in Welzl's algorithm, so that the points defining a
+	// sphere are not found outside of it by rounding.
+	const float CONTAINMENT_TOLERANCE = 1e-5f;
+
+	// Squared cross product length (relative to the edge lengths) below which points are collinear.
+	const float DEGENERATE_TOLERANCE = 1e-10f;
+
+	bool isInside(const re::Sphere& sphere, const re::Vec3d& point)
+	{
+		const float radius = sphere.radius * (1.f + CONTAINMENT_TOLERANCE) + CONTAINMENT_TOLERANCE;
+		return sphere.center.distanceSquaredTo(point) <= radius * radius;
+	}
+
+	re::Sphere getSphere(const re::Vec3d& a, const re::Vec3d& b)
+	{
+		const re::Vec3d center((a + b) * 0.5f);
+		return re::Sphere(center, center.distanceTo(a));
+	}
+
+	re::Sphere getSphere(const re::Vec3d& a, const re::Vec3d& b, const re::Vec3d& c)
+	{
+		const re::Vec3d ab(b - a);
+		const re::Vec3d ac(c - a);
+		const re::Vec3d normal(ab.cross(ac));
+		const float denominator = 2.f * normal.lengthSquared();
+
+		// Collinear points, the farthest pair spans the others.
+		if (denominator <= DEGENERATE_TOLERANCE * ab.lengthSquared() * ac.lengthSquared())
+		{
+			const re::Sphere spheres[] = { getSphere(a, b), getSphere(a, c), getSphere(b, c) };
+			return *std::max_element(spheres, spheres + 3, [](const re::Sphere& x, const re::Sphere& y) { return x.radius < y.radius; });
+		}
+
+		// Circumcenter in the plane of the points.
+		const re::Vec3d offset((normal.cross(ab) * ac.lengthSquared() + ac.cross(normal) * ab.lengthSquared()) * (1.f / denominator));
+		return re::Sphere(a + offset, offset.length());
+	}
+
+	re::Sphere getSphere(const re::Vec3d& a, const re::Vec3d& b, const re::Vec3d& c, const re::Vec3d& d)
+	{
+		const re::Vec3d ab(b - a);
+		const re::Vec3d ac(c - a);
+		const re::Vec3d ad(d - a);
+		const float determinant = 2.f * ab.dot(ac.cross(ad));
+		const float scale = ab.length() * ac.length() * ad.length();
+
+		// Coplanar points, the smallest circumscribed sphere of three of them which holds the fourth.
+		if (fabsf(determinant) <= 1e-5f * scale)
+		{
+			const re::Vec3d* points[] = { &a, &b, &c, &d };
+			re::Sphere best;
+
+			for (int skip = 0; skip < 4; skip++)
+			{
+				const re::Vec3d* triangle[3];
+
+				for (int i = 0, j = 0; i < 4; i++)
+					if (i != skip)
+						triangle[j++] = points[i];
+
+				const re::Sphere sphere = getSphere(*triangle[0], *triangle[1], *triangle[2]);
+
+				if (isInside(sphere, *points[skip]) && (best.isEmpty() || sphere.radius < best.radius))
+					best = sphere;
+			}
+
+			return best.isEmpty() ? getSphere(a, b, c) : best;
+		}
+
+		// Circumcenter equidistant from all four points.
+		const re::Vec3d offset((ac.cross(ad) * ab.lengthSquared() + ad.cross(ab) * ac.lengthSquared() + ab.cross(ac) * ad.lengthSquared()) * (1.f / determinant));
+		return re::Sphere(a + offset, offset.length());
+	}
+}
+
+
+re::Sphere::Sphere() :
+	center(0.f, 0.f, 0.f),
+	radius(-1.f)
+{
+}
+
+
+re::Sphere::Sphere(const Vec3d& centerValue, float radiusValue) :
+	center(centerValue),
+	radius(radiusValue)
+{
+}
+
+
+re::Sphere re::Sphere::fromPoints(const Vec3d* points, size_t count)
+{
+	Sphere result;
+
+	if (!points || !count)
+		return result;
+
+	// Points with the minimum and maximum coordinate along every axis.
+	size_t minimum[3] = { 0, 0, 0 };
+	size_t maximum[3] = { 0, 0, 0 };
+
+	for (size_t i = 1; i < count; i++)
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			minimum[axis] = points[i].d[axis] < points[minimum[axis]].d[axis] ? i : minimum[axis];
+			maximum[axis] = points[i].d[axis] > points[maximum[axis]].d[axis] ? i : maximum[axis];
+		}
+	}
+
+	int widest = 0;
+
+	for (int axis = 1; axis < 3; axis++)
+		if (points[minimum[axis]].distanceSquaredTo(points[maximum[axis]]) > points[minimum[widest]].distanceSquaredTo(points[maximum[widest]]))
+			widest = axis;
+
+	result = getSphere(points[minimum[widest]], points[maximum[widest]]);
+
+	for (size_t i = 0; i < count; i++)
+		result.expand(points[i]);
+
+	return result;
+}
+
+
+re::Sphere re::Sphere::fromPointsMinimal(const Vec3d* points, size_t count)
+{
+	Sphere result;
+
+	if (!points || !count)
+		return result;
+
+	// Fixed seed shuffle, so results are reproducible.
+	std::vector<Vec3d> shuffled(points, points + count);
+	unsigned int state = 0x9E3779B9u;
+
+	for (size_t i = count - 1; i > 0; i--)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		std::swap(shuffled[i], shuffled[state % (i + 1)]);
+	}
+
+	// A point outside the sphere of the previous points lies on the boundary of their new sphere,
+	// the inner loops find the sphere with one, two and three such points fixed.
+	result = Sphere(shuffled[0], 0.f);
+
+	for (size_t i = 1; i < count; i++)
+	{
+		if (isInside(result, shuffled[i]))
+			continue;
+
+		result = Sphere(shuffled[i], 0.f);
+
+		for (size_t j = 0; j < i; j++)
+		{
+			if (isInside(result, shuffled[j]))
+				continue;
+
+			result = getSphere(shuffled[i], shuffled[j]);
+
+			for (size_t k = 0; k < j; k++)
+			{
+				if (isInside(result, shuffled[k]))
+					continue;
+
+				result = getSphere(shuffled[i], shuffled[j], shuffled[k]);
+
+				for (size_t l = 0; l < k; l++)
+					if (!isInside(result, shuffled[l]))
+						result = getSphere(shuffled[i], shuffled[j], shuffled[k], shuffled[l]);
+			}
+		}
+	}
+
+	return result;
+}
+
+
+bool re::Sphere::isEmpty() const
+{
+	return radius < 0.f;
+}
+
+
+void re::Sphere::expand(const Vec3d& point)
+{
+	if (isEmpty())
+	{
+		center = point;
+		radius = 0.f;
+		return;
+	}
+
+	const float distanceSquared = center.distanceSquaredTo(point);
+
+	if (distanceSquared <= radius * radius)
+		return;
+
+	// The new sphere touches the point and the far side of the old one.
+	const float distance = sqrtf(distanceSquared);
+	const float newRadius = 0.5f * (radius + distance);
+	center += (point - center) * ((newRadius - radius) / distance);
+	radius = newRadius;
+}
+
+
+void re::Sphere::expand(const Sphere& sphere)
+{
+	if (sphere.isEmpty())
+		return;
+
+	const float distance = center.distanceTo(sphere.center);
+
+	if (isEmpty() || distance + radius <= sphere.radius)
+	{
+		*this = sphere;
+		return;
+	}
+
+	if (distance + sphere.radius <= radius)
+		return;
+
+	const float newRadius = 0.5f * (distance + radius + sphere.radius);
+	center += (sphere.center - center) * ((newRadius - radius) / distance);
+	radius = newRadius;
+}
+
+
+bool re::Sphere::contains(const Vec3d& point) const
+{
+	if (isEmpty())
+		return false;
+
+	return center.distanceSquaredTo(point) <= radius * radius;
+}
+
+
+bool re::Sphere::intersects(const Sphere& sphere) const
+{
+	if (isEmpty() || sphere.isEmpty())
+		return false;
+
+	const float radii = radius + sphere.radius;
+	return center.distanceSquaredTo(sphere.center) <= radii * radii;
+}
+
+
+void re::Sphere::transform(const Matrix4& matrix)
+{
+	const float* m = static_cast<const float*>(matrix);
+	const float x = center.x;
+	const float y = center.y;
+	const float z = center.z;
+	center.set(x * m[0] + y * m[4] + z * m[8] + m[12], x * m[1] + y * m[5] + z * m[9] + m[13], x * m[2] + y * m[6] + z * m[10] + m[14]);
+
+	const float scale = std::max(std::max(m[0] * m[0] + m[1] * m[1] + m[2] * m[2], m[4] * m[4] + m[5] * m[5] + m[6] * m[6]), m[8] * m[8] + m[9] * m[9] + m[10] * m[10]);
+	radius *= sqrtf(scale);
+}
@@ -0,0 +1,367 @@
+//////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// File:        reSweepAndPrune.cpp
+// Project:     reMath
+// Description: Implementation of SweepAndPrune broad phase class
+// Copyright:   Copyright  2004++ REGLabs
+// Author:      Pavel Chikul
+//
+//////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "reMath/reSweepAndPrune.h"
+#include "reMath/reParallel.h"
+#include "reMath/reFrameArena.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	unsigned long long pairKey(unsigned int first, unsigned int second)
+	{
+		return first < second ?
+			(static_cast<unsigned long long>(first) << 32) | second :
+			(static_cast<unsigned long long>(second) << 32) | first;
+	}
+
+	re::SweepAndPrune::Pair makePair(unsigned long long key)
+	{
+		return { static_cast<unsigned int>(key >> 32), static_cast<unsigned int>(key & 0xFFFFFFFF) };
+	}
+
+	// Maps a float to an unsigned integer with the same ordering.
+	unsigned int sortableKey(float value)
+	{
+		unsigned int bits;
+		memcpy(&bits, &value, sizeof(bits));
+		return bits ^ ((bits >> 31) ? 0xFFFFFFFF : 0x80000000);
+	}
+}
+
+
+re::SweepAndPrune::SweepAndPrune(int axisCount) :
+	axisCount_(axisCount == 1 ? 1 : 3)
+{
+}
+
+
+unsigned int re::SweepAndPrune::add(const AABB& box)
+{
+	unsigned int id;
+
+	if (freeIds_.empty())
+	{
+		id = static_cast<unsigned int>(boxes_.size());
+		boxes_.push_back(box);
+		states_.push_back(STATE_ACTIVE);
+	}
+	else
+	{
+		id = freeIds_.back();
+		freeIds_.pop_back();
+		boxes_[id] = box;
+		states_[id] = STATE_ACTIVE;
+	}
+
+	// New endpoints are appended and sorted into place by the next update.
+	for (int axis = 0; axis < axisCount_; axis++)
+	{
+		endpoints_[axis].push_back({ box.min.d[axis], id << 1 });
+		endpoints_[axis].push_back({ box.max.d[axis], (id << 1) | 1 });
+	}
+
+	return id;
+}
+
+
+void re::SweepAndPrune::remove(unsigned int id)
+{
+	if (id < states_.size() && states_[id] == STATE_ACTIVE)
+	{
+		states_[id] = STATE_REMOVED;
+		hasRemovals_ = true;
+	}
+}
+
+
+void re::SweepAndPrune::setBox(unsigned int id, const AABB& box)
+{
+	boxes_[id] = box;
+}
+
+
+const re::AABB& re::SweepAndPrune::getBox(unsigned int id) const
+{
+	return boxes_[id];
+}
+
+
+void re::SweepAndPrune::update()
+{
+	added_.clear();
+	removed_.clear();
+	processRemovals();
+
+	for (int axis = 0; axis < axisCount_; axis++)
+	{
+		auto& endpoints = endpoints_[axis];
+
+		for (auto& endpoint : endpoints)
+		{
+			const AABB& box = boxes_[endpoint.data >> 1];
+			endpoint.value = endpoint.data & 1 ? box.max.d[axis] : box.min.d[axis];
+		}
+
+		// Insertion sort, equal values keep min endpoints before max ones so that touching boxes overlap.
+		for (size_t i = 1; i < endpoints.size(); i++)
+		{
+			const Endpoint endpoint = endpoints[i];
+			size_t j = i;
+
+			for (; j > 0; j--)
+			{
+				const Endpoint& other = endpoints[j - 1];
+
+				if (other.value < endpoint.value || (other.value == endpoint.value && (other.data & 1) <= (endpoint.data & 1)))
+					break;
+
+				const bool isMax = (endpoint.data & 1) != 0;
+				const bool otherMax = (other.data & 1) != 0;
+
+				if (!isMax && otherMax)
+					beginOverlap(endpoint.data >> 1, other.data >> 1);
+				else if (isMax && !otherMax)
+					endOverlap(endpoint.data >> 1, other.data >> 1);
+
+				endpoints[j] = other;
+			}
+
+			endpoints[j] = endpoint;
+		}
+	}
+
+	if (axisCount_ == 1)
+		checkCandidates();
+}
+
+
+void re::SweepAndPrune::rebuild()
+{
+	added_.clear();
+	removed_.clear();
+	processRemovals();
+
+	FrameArena& scratch = FrameArena::threadLocal();
+	const auto marker = scratch.mark();
+
+	for (int axis = 0; axis < axisCount_; axis++)
+	{
+		auto& endpoints = endpoints_[axis];
+		const size_t count = endpoints.size();
+		unsigned int* keys = scratch.allocate<unsigned int>(count);
+		unsigned int* values = scratch.allocate<unsigned int>(count);
+		size_t index = 0;
+
+		// Radix sort is stable, listing the min endpoints first puts them before equal max ones.
+		for (int pass = 0; pass < 2; pass++)
+		{
+			for (const auto& endpoint : endpoints)
+			{
+				if ((endpoint.data & 1) != static_cast<unsigned int>(pass))
+					continue;
+
+				const AABB& box = boxes_[endpoint.data >> 1];
+				keys[index] = sortableKey(pass ? box.max.d[axis] : box.min.d[axis]);
+				values[index++] = endpoint.data;
+			}
+		}
+
+		radixSort(keys, values, count);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const AABB& box = boxes_[values[i] >> 1];
+			endpoints[i].data = values[i];
+			endpoints[i].value = values[i] & 1 ? box.max.d[axis] : box.min.d[axis];
+		}
+	}
+
+	scratch.rewind(marker);
+
+	// Sweep the first axis for the pairs from scratch and report the difference.
+	std::unordered_map<unsigned long long, bool> pairs;
+	std::vector<unsigned int> active;
+
+	for (const auto& endpoint : endpoints_[0])
+	{
+		const unsigned int id = endpoint.data >> 1;
+
+		if (endpoint.data & 1)
+		{
+			auto it = std::find(active.begin(), active.end(), id);
+			*it = active.back();
+			active.pop_back();
+			continue;
+		}
+
+		for (const unsigned int other : active)
+		{
+			const bool overlapping = boxes_[id].overlaps(boxes_[other]);
+
+			if (overlapping || axisCount_ == 1)
+				pairs[pairKey(id, other)] = overlapping;
+		}
+
+		active.push_back(id);
+	}
+
+	for (const auto& pair : pairs_)
+	{
+		if (!pair.second)
+			continue;
+
+		const auto it = pairs.find(pair.first);
+
+		if (it == pairs.end() || !it->second)
+			removed_.push_back(makePair(pair.first));
+	}
+
+	pairCount_ = 0;
+
+	for (const auto& pair : pairs)
+	{
+		if (!pair.second)
+			continue;
+
+		pairCount_++;
+		const auto it = pairs_.find(pair.first);
+
+		if (it == pairs_.end() || !it->second)
+			added_.push_back(makePair(pair.first));
+	}
+
+	pairs_.swap(pairs);
+}
+
+
+const std::vector<re::SweepAndPrune::Pair>& re::SweepAndPrune::getAddedPairs() const
+{
+	return added_;
+}
+
+
+const std::vector<re::SweepAndPrune::Pair>& re::SweepAndPrune::getRemovedPairs() const
+{
+	return removed_;
+}
+
+
+size_t re::SweepAndPrune::getPairCount() const
+{
+	return pairCount_;
+}
+
+
+bool re::SweepAndPrune::isOverlapping(unsigned int first, unsigned int second) const
+{
+	const auto it = pairs_.find(pairKey(first, second));
+	return it != pairs_.end() && it->second;
+}
+
+
+void re::SweepAndPrune::processRemovals()
+{
+	if (!hasRemovals_)
+		return;
+
+	for (auto it = pairs_.begin(); it != pairs_.end();)
+	{
+		const Pair pair = makePair(it->first);
+
+		if (states_[pair.first] != STATE_REMOVED && states_[pair.second] != STATE_REMOVED)
+		{
+			++it;
+			continue;
+		}
+
+		if (it->second)
+		{
+			removed_.push_back(pair);
+			pairCount_--;
+		}
+
+		it = pairs_.erase(it);
+	}
+
+	for (int axis = 0; axis < axisCount_; axis++)
+	{
+		auto& endpoints = endpoints_[axis];
+		endpoints.erase(std::remove_if(endpoints.begin(), endpoints.end(), [this](const Endpoint& endpoint)
+		{
+			return states_[endpoint.data >> 1] == STATE_REMOVED;
+		}), endpoints.end());
+	}
+
+	for (size_t id = 0; id < states_.size(); id++)
+	{
+		if (states_[id] == STATE_REMOVED)
+		{
+			states_[id] = STATE_FREE;
+			freeIds_.push_back(static_cast<unsigned int>(id));
+		}
+	}
+
+	hasRemovals_ = false;
+}
+
+
+void re::SweepAndPrune::beginOverlap(unsigned int first, unsigned int second)
+{
+	const unsigned long long key = pairKey(first, second);
+
+	// With a single axis every overlap on it is a candidate, checked on all axes later.
+	if (axisCount_ == 1)
+	{
+		pairs_.emplace(key, false);
+		return;
+	}
+
+	if (!boxes_[first].overlaps(boxes_[second]) || !pairs_.emplace(key, true).second)
+		return;
+
+	added_.push_back(makePair(key));
+	pairCount_++;
+}
+
+
+void re::SweepAndPrune::endOverlap(unsigned int first, unsigned int second)
+{
+	const auto it = pairs_.find(pairKey(first, second));
+
+	if (it == pairs_.end())
+		return;
+
+	if (it->second)
+	{
+		removed_.push_back(makePair(it->first));
+		pairCount_--;
+	}
+
+	pairs_.erase(it);
+}
+
+
+void re::SweepAndPrune::checkCandidates()
+{
+	for (auto& pair : pairs_)
+	{
+		const Pair ids = makePair(pair.first);
+		const bool overlapping = boxes_[ids.first].overlaps(boxes_[ids.second]);
+
+		if (overlapping == pair.second)
+			continue;
+
+		pair.second = overlapping;
+		(overlapping ? added_ : removed_).push_back(ids);
+		pairCount_ = overlapping ? pairCount_ + 1 : pairCount_ - 1;
+	}
+}
@@ -9,6 +9,8 @@
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "reMath/reVec2d.h"
+#include "reMath/reMathUtil.h"
+#include <cfloat>
 #include <cstring>
 #include <cmath>
 
@@ -81,6 +83,12 @@ float re::Vec2d::length() const
 }
 
 
+float re::Vec2d::lengthSquared() const
+{
+	return x * x + y * y;
+}
+
+
 float re::Vec2d::distanceTo(const Vec2d & vector) const
 {
 	const float dx = x - vector.x;
@@ -89,6 +97,14 @@ float re::Vec2d::distanceTo(const Vec2d & vector) const
 }
 
 
+float re::Vec2d::distanceSquaredTo(const Vec2d & vector) const
+{
+	const float dx = x - vector.x;
+	const float dy = y - vector.y;
+	return dx * dx + dy * dy;
+}
+
+
 bool re::Vec2d::isParallel(const Vec2d& vector) const
 {
 	return ((x / vector.x) == (y / vector.y));
@@ -111,6 +127,24 @@ void re::Vec2d::normalize()
 }
 
 
+void re::Vec2d::normalizeFast()
+{
+	const float squared = lengthSquared();
+
+	// Denormal squared lengths overflow the reciprocal square root, the exact path handles them.
+	if (squared >= FLT_MIN)
+	{
+		const float scale = rsqrtFast(squared);
+		x *= scale;
+		y *= scale;
+	}
+	else
+	{
+		normalize();
+	}
+}
+
+
 void re::Vec2d::negate()
 {
 	x = -x;
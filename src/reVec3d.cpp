@@ -10,6 +10,8 @@
 
 #include "reMath/reVec3d.h"
 #include "reMath/reMatrix4.h"
+#include "reMath/reMathUtil.h"
+#include <cfloat>
 #include <cstring>
 #include <cmath>
 
@@ -83,6 +85,12 @@ float re::Vec3d::length() const
 }
 
 
+float re::Vec3d::lengthSquared() const
+{
+	return x * x + y * y + z * z;
+}
+
+
 float re::Vec3d::distanceTo(const Vec3d & vector) const
 {
 	const float dx = x - vector.x;
@@ -92,6 +100,15 @@ float re::Vec3d::distanceTo(const Vec3d & vector) const
 }
 
 
+float re::Vec3d::distanceSquaredTo(const Vec3d & vector) const
+{
+	const float dx = x - vector.x;
+	const float dy = y - vector.y;
+	const float dz = z - vector.z;
+	return dx * dx + dy * dy + dz * dz;
+}
+
+
 bool re::Vec3d::isParallel(const Vec3d& vector) const
 {
 	// TODO: Not safe, potential division by zero.
@@ -117,6 +134,25 @@ void re::Vec3d::normalize()
 }
 
 
+void re::Vec3d::normalizeFast()
+{
+	const float squared = lengthSquared();
+
+	// Denormal squared lengths overflow the reciprocal square root, the exact path handles them.
+	if (squared >= FLT_MIN)
+	{
+		const float scale = rsqrtFast(squared);
+		x *= scale;
+		y *= scale;
+		z *= scale;
+	}
+	else
+	{
+		normalize();
+	}
+}
+
+
 void re::Vec3d::negate()
 {
 	x = -x;
@@ -0,0 +1,70 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "reMath/reAABB.h"
+#include "reMath/reMatrix4.h"
+#include "reMath/reMathUtil.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace re;
+
+namespace Test
+{
+	TEST_CLASS(AABBUnitTest)
+	{
+	public:
+		TEST_METHOD(BasicAABBTest)
+		{
+			AABB box;
+			Assert::IsTrue(box.isEmpty(), L"Default box is not empty");
+			Assert::AreEqual(0.f, box.getSurfaceArea(), L"Empty box area is not zero");
+
+			const Vec3d points[] = { Vec3d(1.f, -2.f, 3.f), Vec3d(-1.f, 2.f, 0.f), Vec3d(0.f, 0.f, 1.f) };
+			box = AABB::fromPoints(points, 3);
+			Assert::IsFalse(box.isEmpty(), L"Box is empty");
+			Assert::IsTrue(box.min == Vec3d(-1.f, -2.f, 0.f), L"Box min incorrect");
+			Assert::IsTrue(box.max == Vec3d(1.f, 2.f, 3.f), L"Box max incorrect");
+			Assert::IsTrue(box.getCenter() == Vec3d(0.f, 0.f, 1.5f), L"Box center incorrect");
+			Assert::IsTrue(box.getExtents() == Vec3d(1.f, 2.f, 1.5f), L"Box extents incorrect");
+			Assert::AreEqual(2.f * (2.f * 4.f + 4.f * 3.f + 3.f * 2.f), box.getSurfaceArea(), L"Box area incorrect");
+
+			Assert::IsTrue(box.contains(Vec3d(1.f, 2.f, 3.f)), L"Box doesn't contain its corner");
+			Assert::IsFalse(box.contains(Vec3d(1.1f, 0.f, 0.f)), L"Box contains outside point");
+
+			box.expand(AABB(Vec3d(0.f, 0.f, 0.f), Vec3d(5.f, 1.f, 1.f)));
+			Assert::AreEqual(5.f, box.max.x, L"Box expand incorrect");
+
+			Assert::IsTrue(box.overlaps(AABB(Vec3d(5.f, 2.f, 3.f), Vec3d(6.f, 3.f, 4.f))), L"Touching boxes don't overlap");
+			Assert::IsFalse(box.overlaps(AABB(Vec3d(5.1f, 2.f, 3.f), Vec3d(6.f, 3.f, 4.f))), L"Separated boxes overlap");
+		}
+
+		TEST_METHOD(RayAABBTest)
+		{
+			const AABB box(Vec3d(-1.f, -1.f, -1.f), Vec3d(1.f, 1.f, 1.f));
+			float distance = 0.f;
+
+			Assert::IsTrue(box.intersectsRay(Vec3d(-5.f, 0.f, 0.f), Vec3d(1.f, 1.f / 0.f, 1.f / 0.f), 100.f, distance), L"Ray misses the box");
+			Assert::AreEqual(4.f, distance, 0.00001f, L"Ray distance incorrect");
+			Assert::IsFalse(box.intersectsRay(Vec3d(-5.f, 0.f, 0.f), Vec3d(1.f, 1.f / 0.f, 1.f / 0.f), 3.f, distance), L"Ray hits the box beyond max distance");
+			Assert::IsFalse(box.intersectsRay(Vec3d(-5.f, 2.f, 0.f), Vec3d(1.f, 1.f / 0.f, 1.f / 0.f), 100.f, distance), L"Parallel ray hits the box");
+			Assert::IsFalse(box.intersectsRay(Vec3d(-5.f, 0.f, 0.f), Vec3d(-1.f, 1.f / 0.f, 1.f / 0.f), 100.f, distance), L"Ray hits the box behind");
+
+			Assert::IsTrue(box.intersectsRay(Vec3d(0.f, 0.f, 0.f), Vec3d(1.f, 2.f, 3.f), 100.f, distance), L"Ray from inside misses the box");
+			Assert::AreEqual(0.f, distance, L"Ray from inside distance incorrect");
+		}
+
+		TEST_METHOD(TransformAABBTest)
+		{
+			AABB box(Vec3d(-1.f, -2.f, -3.f), Vec3d(1.f, 2.f, 3.f));
+
+			Matrix4 matrix;
+			matrix.setRotation(0.f, 0.f, toRadians(90.f));
+			matrix.setTranslation(10.f, 0.f, 0.f);
+			box.transform(matrix);
+
+			Assert::AreEqual(0.f, box.getCenter().distanceTo(Vec3d(10.f, 0.f, 0.f)), 0.0001f, L"Transformed box center incorrect");
+			Assert::AreEqual(2.f, box.getExtents().x, 0.0001f, L"Transformed box extents incorrect");
+			Assert::AreEqual(1.f, box.getExtents().y, 0.0001f, L"Transformed box extents incorrect");
+			Assert::AreEqual(3.f, box.getExtents().z, 0.0001f, L"Transformed box extents incorrect");
+		}
+	};
+}
@@ -0,0 +1,184 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "reMath/reBatch.h"
+#include "reMath/reParallel.h"
+#include "reMath/reVec3d.h"
+#include "reMath/reMatrix3.h"
+#include "reMath/reMatrix4.h"
+#include "reMath/reQuaternion.h"
+#include <cmath>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace re;
+
+namespace Test
+{
+	TEST_CLASS(BatchUnitTest)
+	{
+	public:
+		TEST_METHOD(TransformBatchTest)
+		{
+			ThreadPool pool(4);
+			setExecutor(&pool);
+
+			Matrix4 matrix;
+			matrix.setRotation(0.3f, 0.5f, 0.7f);
+			matrix.setTranslation(1.f, 2.f, 3.f);
+
+			std::vector<Vec3d> points;
+			for (int i = 0; i < 10000; i++)
+				points.emplace_back(static_cast<float>(i), static_cast<float>(i % 7), static_cast<float>(-i));
+
+			std::vector<Vec3d> transformed(points.size());
+			transformN(matrix, points.data(), transformed.data(), points.size());
+
+			for (size_t i = 0; i < points.size(); i++)
+				Assert::IsTrue(points[i] * matrix == transformed[i], L"Batch transform failed");
+
+			// Normalization.
+			normalizeN(transformed.data(), transformed.size());
+			Assert::AreEqual(1.f, transformed[42].length(), 0.000001f, L"Batch normalize failed");
+
+			setExecutor(nullptr);
+		}
+
+		TEST_METHOD(NormalizeFastBatchTest)
+		{
+			std::vector<Vec3d> vectors;
+			for (int i = 0; i < 11; i++)
+				vectors.emplace_back(static_cast<float>(i), static_cast<float>(2 * i + 1), static_cast<float>(i % 3));
+
+			vectors[5].set(0.f);
+			vectors[2].set(0.f, 1e-20f, 0.f);
+			Vec3d tiny(vectors[2]);
+			tiny.normalize();
+			normalizeFastN(vectors.data(), vectors.size());
+
+			for (size_t i = 0; i < vectors.size(); i++)
+				if (i != 2)
+					Assert::AreEqual(i == 5 ? 0.f : 1.f, vectors[i].length(), 0.0000005f, L"Batch fast normalize failed");
+
+			Assert::IsTrue(tiny == vectors[2], L"Batch fast tiny vector normalize failed");
+
+			std::vector<Quaternion> quaternions;
+			for (int i = 0; i < 6; i++)
+				quaternions.emplace_back(static_cast<float>(i), 2.f, -1.f, static_cast<float>(i % 2));
+
+			quaternions[4].set(0.f, 0.f, 0.f, 0.f);
+			quaternions[1].set(0.f, 0.f, 1e-20f, 0.f);
+			normalizeFastN(quaternions.data(), quaternions.size());
+
+			for (size_t i = 0; i < quaternions.size(); i++)
+				Assert::AreEqual(1.f, quaternions[i].length(), i == 1 ? 0.0001f : 0.0000005f, L"Batch fast quaternion normalize failed");
+
+			Assert::IsTrue(Quaternion() == quaternions[4], L"Batch fast zero quaternion normalize failed");
+		}
+
+		TEST_METHOD(SlerpBatchTest)
+		{
+			const Quaternion from[] = { Quaternion(), Quaternion::fromEulerXRotation(1.f) };
+			const Quaternion to[] = { Quaternion::fromEulerYRotation(1.f), Quaternion::fromEulerZRotation(1.f) };
+			Quaternion result[2];
+			slerpN(from, to, 0.3f, result, 2);
+
+			for (int i = 0; i < 2; i++)
+				Assert::IsTrue(from[i].slerp(to[i], 0.3f) == result[i], L"Batch slerp failed");
+		}
+
+		TEST_METHOD(NormalsBatchTest)
+		{
+			// Two triangles of a quad lying on the XY plane.
+			const Vec3d vertices[] = { Vec3d(0.f, 0.f, 0.f), Vec3d(1.f, 0.f, 0.f), Vec3d(1.f, 1.f, 0.f), Vec3d(0.f, 1.f, 0.f) };
+			const unsigned int indices[] = { 0, 1, 2, 0, 2, 3 };
+			Vec3d normals[4];
+			computeNormals(vertices, 4, indices, 2, normals);
+
+			for (const auto& normal : normals)
+				Assert::IsTrue(Vec3d(0.f, 0.f, 1.f) == normal, L"Normals calculation failed");
+		}
+
+		TEST_METHOD(ToQuaternionBatchTest)
+		{
+			// Odd count covers the SSE groups and the scalar tail.
+			std::vector<Matrix4> matrices;
+			std::vector<Matrix3> rotations;
+
+			for (int i = 0; i < 103; i++)
+			{
+				Quaternion rotation(sinf(i * 0.7f), cosf(i * 1.3f), sinf(i * 2.1f), cosf(i * 0.4f));
+				rotation.normalize();
+				matrices.push_back(rotation.getMatrix());
+				rotations.push_back(Matrix3(matrices.back()));
+			}
+
+			std::vector<Quaternion> fromMatrix4(matrices.size());
+			std::vector<Quaternion> fromMatrix3(matrices.size());
+			toQuaternionN(matrices.data(), fromMatrix4.data(), matrices.size());
+			toQuaternionN(rotations.data(), fromMatrix3.data(), rotations.size());
+
+			for (size_t i = 0; i < matrices.size(); i++)
+			{
+				const Quaternion expected = Quaternion::fromMatrix(matrices[i]);
+				Assert::AreEqual(1.f, expected.dot(fromMatrix4[i]), 0.000001f, L"Batch Matrix4 to quaternion failed");
+				Assert::AreEqual(1.f, expected.dot(fromMatrix3[i]), 0.000001f, L"Batch Matrix3 to quaternion failed");
+			}
+		}
+
+		TEST_METHOD(RotateBatchTest)
+		{
+			std::vector<Quaternion> rotations;
+			std::vector<Vec3d> vectors;
+
+			for (int i = 0; i < 103; i++)
+			{
+				Quaternion rotation(sinf(i * 0.7f), cosf(i * 1.3f), sinf(i * 2.1f), cosf(i * 0.4f));
+				rotation.normalize();
+				rotations.push_back(rotation);
+				vectors.push_back(Vec3d(cosf(i * 0.3f), i * 0.1f, -1.f));
+			}
+
+			std::vector<Vec3d> single(vectors);
+			rotateN(rotations[5], single.data(), single.size());
+
+			std::vector<Vec3d> each(vectors);
+			rotateN(rotations.data(), each.data(), each.size());
+
+			for (size_t i = 0; i < vectors.size(); i++)
+			{
+				Vec3d expected(vectors[i]);
+				rotations[5].rotate(expected);
+				Assert::IsTrue(expected.distanceTo(single[i]) < 0.00001f, L"Batch rotation by one quaternion failed");
+
+				expected = vectors[i];
+				rotations[i].rotate(expected);
+				Assert::IsTrue(expected.distanceTo(each[i]) < 0.00001f, L"Batch rotation by quaternion array failed");
+			}
+		}
+
+		TEST_METHOD(FromToBatchTest)
+		{
+			std::vector<Vec3d> from;
+			std::vector<Vec3d> to;
+			std::vector<float> angles;
+
+			for (int i = 0; i < 103; i++)
+			{
+				from.push_back(Vec3d(sinf(i * 0.7f), cosf(i * 1.3f), sinf(i * 2.1f)));
+				to.push_back(i % 5 ? Vec3d(cosf(i * 0.4f), sinf(i * 0.9f), 0.5f) : from.back() * -2.f);
+				angles.push_back(i * 0.1f);
+			}
+
+			std::vector<Quaternion> arcs(from.size());
+			std::vector<Quaternion> rotations(from.size());
+			fromToN(from.data(), to.data(), arcs.data(), from.size());
+			fromAxisAngleN(from.data(), angles.data(), rotations.data(), from.size());
+
+			for (size_t i = 0; i < from.size(); i++)
+			{
+				Assert::AreEqual(1.f, Quaternion::fromTo(from[i], to[i]).dot(arcs[i]), 0.000001f, L"Batch shortest arc failed");
+				Assert::IsTrue(Quaternion::fromAxisAngle(from[i], angles[i]) == rotations[i], L"Batch axis angle failed");
+			}
+		}
+	};
+}
@@ -0,0 +1,81 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "reMath/reCamera.h"
+#include "reMath/reMathUtil.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace re;
+
+namespace Test
+{
+	TEST_CLASS(CameraUnitTest)
+	{
+	public:
+		TEST_METHOD(BasicCameraTest)
+		{
+			Camera camera;
+			camera.lookAt(Vec3d(1.f, 2.f, 6.f), Vec3d(0.f, 0.f, 0.f), Vec3d(0.f, 1.f, 0.f));
+			camera.setPerspective(45.f, 4.f / 3.f, 0.3f, 100.f);
+
+			// Cached matrices match the utility functions.
+			Assert::IsTrue(lookAt(Vec3d(1.f, 2.f, 6.f), Vec3d(0.f, 0.f, 0.f), Vec3d(0.f, 1.f, 0.f)) == camera.getViewMatrix(), L"View matrix incorrect");
+			Assert::IsTrue(perspective(45.f, 4.f / 3.f, 0.3f, 100.f) == camera.getProjectionMatrix(), L"Projection matrix incorrect");
+
+			// Eye goes to the view space origin and back.
+			Vec3d eye(camera.getEye() * camera.getViewMatrix());
+			Assert::AreEqual(0.f, eye.length(), 0.00001f, L"View matrix doesn't move eye to origin");
+			eye *= camera.getInverseViewMatrix();
+			Assert::AreEqual(0.f, eye.distanceTo(camera.getEye()), 0.00001f, L"Inverse view matrix incorrect");
+
+			// Target projects to the screen center.
+			const Matrix4& viewProjection = camera.getViewProjectionMatrix();
+			const float w = viewProjection[3] * 0.f + viewProjection[7] * 0.f + viewProjection[11] * 0.f + viewProjection[15];
+			Assert::AreEqual(0.f, viewProjection[12] / w, 0.00001f, L"View projection matrix incorrect");
+			Assert::AreEqual(0.f, viewProjection[13] / w, 0.00001f, L"View projection matrix incorrect");
+
+			// Visibility.
+			Assert::IsTrue(camera.isSphereVisible(Vec3d(0.f, 0.f, 0.f), 1.f), L"Target is not visible");
+			Assert::IsFalse(camera.isSphereVisible(Vec3d(2.f, 4.f, 12.f), 1.f), L"Point behind camera is visible");
+			Assert::IsFalse(camera.isSphereVisible(Vec3d(-100.f, -200.f, -600.f), 1.f), L"Point beyond far plane is visible");
+		}
+
+		TEST_METHOD(InverseCameraTest)
+		{
+			Camera camera;
+			camera.lookAt(Vec3d(3.f, -2.f, 5.f), Vec3d(1.f, 1.f, 0.f), Vec3d(0.f, 1.f, 0.f));
+
+			for (int mode = 0; mode < 4; mode++)
+			{
+				camera.setDepthMode(mode & 1 ? Camera::DEPTH_REVERSED : Camera::DEPTH_STANDARD);
+				camera.setPerspective(60.f, 1.5f, 0.5f, mode & 2 ? 0.f : 50.f);
+
+				// Inverse view projection times view projection is identity.
+				const Matrix4& forward = camera.getViewProjectionMatrix();
+				const Matrix4& inverse = camera.getInverseViewProjectionMatrix();
+
+				for (int column = 0; column < 4; column++)
+					for (int row = 0; row < 4; row++)
+					{
+						float value = 0.f;
+						for (int k = 0; k < 4; k++)
+							value += inverse[k * 4 + row] * forward[column * 4 + k];
+
+						Assert::AreEqual(row == column ? 1.f : 0.f, value, 0.0001f, L"Inverse view projection incorrect");
+					}
+
+				// Reversed depth maps near plane to 1.
+				if (mode == 1)
+				{
+					const Matrix4& p = camera.getProjectionMatrix();
+					Assert::AreEqual(1.f, (p[10] * -0.5f + p[14]) / 0.5f, 0.00001f, L"Reversed depth near plane incorrect");
+					Assert::AreEqual(0.f, (p[10] * -50.f + p[14]) / 50.f, 0.00001f, L"Reversed depth far plane incorrect");
+				}
+
+				Assert::IsTrue(camera.isSphereVisible(Vec3d(1.f, 1.f, 0.f), 0.1f), L"Target is not visible");
+			}
+
+			// Infinite far plane accepts distant points.
+			Assert::IsTrue(camera.isSphereVisible(Vec3d(1.f, 1.f, 0.f) + (Vec3d(1.f, 1.f, 0.f) - camera.getEye()) * 10000.f, 0.1f), L"Distant point is not visible");
+		}
+	};
+}
@@ -0,0 +1,150 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "reMath/reConvex.h"
+#include "reMath/reMathUtil.h"
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace re;
+
+namespace Test
+{
+	TEST_CLASS(ConvexUnitTest)
+	{
+	public:
+		TEST_METHOD(ConvexDistanceTest)
+		{
+			const ConvexSphere sphereA(Vec3d(0.f, 0.f, 0.f), 1.f);
+			const ConvexSphere sphereB(Vec3d(5.f, 0.f, 0.f), 1.5f);
+			DistanceResult result = gjkDistance(sphereA, sphereB);
+			Assert::IsFalse(result.intersecting, L"Separated spheres intersect");
+			Assert::AreEqual(2.5f, result.distance, 0.0001f, L"Spheres distance incorrect");
+			Assert::AreEqual(0.f, result.pointA.distanceTo(Vec3d(1.f, 0.f, 0.f)), 0.0001f, L"Sphere closest point incorrect");
+			Assert::AreEqual(0.f, result.pointB.distanceTo(Vec3d(3.5f, 0.f, 0.f)), 0.0001f, L"Sphere closest point incorrect");
+
+			const ConvexBox boxA(OBB(Vec3d(0.f, 0.f, 0.f), Matrix3(), Vec3d(1.f, 1.f, 1.f)));
+			const ConvexBox boxB(OBB(Vec3d(4.f, 0.5f, 0.f), Matrix3(), Vec3d(1.f, 1.f, 1.f)));
+			result = gjkDistance(boxA, boxB);
+			Assert::AreEqual(2.f, result.distance, 0.0001f, L"Boxes distance incorrect");
+			Assert::AreEqual(1.f, result.pointA.x, 0.0001f, L"Box closest point incorrect");
+			Assert::AreEqual(3.f, result.pointB.x, 0.0001f, L"Box closest point incorrect");
+
+			const ConvexCapsule capsule(Vec3d(0.f, -2.f, 0.f), Vec3d(0.f, 2.f, 0.f), 0.5f);
+			const ConvexSphere sphereC(Vec3d(3.f, 1.f, 0.f), 1.f);
+			result = gjkDistance(capsule, sphereC);
+			Assert::AreEqual(1.5f, result.distance, 0.0001f, L"Capsule distance incorrect");
+			Assert::AreEqual(0.f, result.pointA.distanceTo(Vec3d(0.5f, 1.f, 0.f)), 0.0001f, L"Capsule closest point incorrect");
+
+			// Tetrahedron hull against the box edge.
+			const Vec3d points[] = { Vec3d(3.f, 3.f, 0.f), Vec3d(5.f, 3.f, 0.f), Vec3d(3.f, 5.f, 0.f), Vec3d(3.f, 3.f, 2.f) };
+			const ConvexHull hull(points, 4);
+			result = gjkDistance(boxA, hull);
+			Assert::AreEqual(2.828427f, result.distance, 0.0001f, L"Hull distance incorrect");
+
+			Assert::IsFalse(gjkIntersect(boxA, hull), L"Separated shapes intersect");
+			Assert::IsTrue(gjkIntersect(boxA, ConvexSphere(Vec3d(2.f, 2.f, 0.f), 1.5f)), L"Intersecting shapes don't intersect");
+			Assert::IsTrue(gjkDistance(boxA, ConvexSphere(Vec3d(0.5f, 0.f, 0.f), 0.1f)).intersecting, L"Contained shape doesn't intersect");
+		}
+
+		TEST_METHOD(ConvexPenetrationTest)
+		{
+			const ConvexSphere sphereA(Vec3d(0.f, 0.f, 0.f), 1.f);
+			PenetrationResult result = epaPenetration(sphereA, ConvexSphere(Vec3d(1.5f, 0.f, 0.f), 1.f));
+			Assert::IsTrue(result.intersecting, L"Spheres don't intersect");
+			Assert::AreEqual(0.5f, result.depth, 0.0001f, L"Spheres depth incorrect");
+			Assert::AreEqual(1.f, result.normal.x, 0.0001f, L"Spheres normal incorrect");
+			Assert::AreEqual(1.f, result.pointA.x, 0.0001f, L"Sphere deepest point incorrect");
+			Assert::AreEqual(0.5f, result.pointB.x, 0.0001f, L"Sphere deepest point incorrect");
+
+			Assert::IsFalse(epaPenetration(sphereA, ConvexSphere(Vec3d(2.5f, 0.f, 0.f), 1.f)).intersecting, L"Separated spheres intersect");
+
+			// Coincident cores, depth is the sum of the radii.
+			result = epaPenetration(sphereA, ConvexSphere(Vec3d(0.f, 0.f, 0.f), 1.f));
+			Assert::AreEqual(2.f, result.depth, 0.0001f, L"Concentric spheres depth incorrect");
+
+			const ConvexBox boxA(OBB(Vec3d(0.f, 0.f, 0.f), Matrix3(), Vec3d(1.f, 1.f, 1.f)));
+			result = epaPenetration(boxA, ConvexBox(OBB(Vec3d(1.8f, 0.3f, 0.f), Matrix3(), Vec3d(1.f, 1.f, 1.f))));
+			Assert::IsTrue(result.intersecting, L"Boxes don't intersect");
+			Assert::AreEqual(0.2f, result.depth, 0.0001f, L"Boxes depth incorrect");
+			Assert::AreEqual(1.f, result.normal.x, 0.0001f, L"Boxes normal incorrect");
+
+			result = epaPenetration(boxA, ConvexCapsule(Vec3d(0.f, 0.9f, -3.f), Vec3d(0.f, 0.9f, 3.f), 0.5f));
+			Assert::AreEqual(0.6f, result.depth, 0.0001f, L"Box and capsule depth incorrect");
+			Assert::AreEqual(1.f, result.normal.y, 0.0001f, L"Box and capsule normal incorrect");
+		}
+
+		TEST_METHOD(ConvexRandomBoxesTest)
+		{
+			srand(11);
+			auto random = [](float range) { return (static_cast<float>(rand()) / RAND_MAX * 2.f - 1.f) * range; };
+
+			const ConvexBox boxA(OBB(Vec3d(0.f, 0.f, 0.f), Matrix3(), Vec3d(1.f, 1.5f, 0.5f)));
+			int intersecting = 0;
+
+			for (int i = 0; i < 200; i++)
+			{
+				Matrix3 rotation;
+				rotation.setRotation(random(3.f), random(3.f), random(3.f));
+				ConvexBox boxB(OBB(Vec3d(random(3.f), random(3.f), random(3.f)), rotation, Vec3d(0.5f + fabs(random(1.f)), 0.5f, 0.8f)));
+
+				// Skip the nearly touching pairs where the tolerances of the two tests differ.
+				const DistanceResult distance = gjkDistance(boxA, boxB);
+				const PenetrationResult penetration = epaPenetration(boxA, boxB);
+
+				if (!distance.intersecting && distance.distance < 0.001f)
+					continue;
+
+				if (penetration.intersecting && penetration.depth < 0.001f)
+					continue;
+
+				Assert::AreEqual(boxA.box.overlaps(boxB.box), distance.intersecting, L"GJK differs from the SAT test");
+				Assert::AreEqual(distance.intersecting, penetration.intersecting, L"EPA differs from GJK");
+				Assert::AreEqual(distance.intersecting, gjkIntersect(boxA, boxB), L"Boolean GJK differs from the distance query");
+
+				if (!distance.intersecting)
+				{
+					Assert::AreEqual(distance.distance, distance.pointA.distanceTo(distance.pointB), 0.001f, L"Closest points don't match the distance");
+					continue;
+				}
+
+				// Moving by the penetration vector just separates the boxes.
+				intersecting++;
+				boxB.box.center += penetration.normal * (penetration.depth + 0.002f);
+				Assert::IsFalse(boxA.box.overlaps(boxB.box), L"Penetration vector doesn't separate the boxes");
+				boxB.box.center -= penetration.normal * 0.004f;
+				Assert::IsTrue(boxA.box.overlaps(boxB.box), L"Penetration depth is too large");
+			}
+
+			Assert::IsTrue(intersecting > 0, L"Test data doesn't have intersecting boxes");
+		}
+
+		TEST_METHOD(ConvexWarmStartTest)
+		{
+			const ConvexBox boxA(OBB(Vec3d(0.f, 0.f, 0.f), Matrix3(), Vec3d(1.f, 1.f, 1.f)));
+			Matrix3 rotation;
+			rotation.setRotation(0.4f, 0.7f, 0.2f);
+			ConvexBox boxB(OBB(Vec3d(3.f, 1.f, 0.5f), rotation, Vec3d(1.f, 0.5f, 0.5f)));
+
+			Simplex simplex;
+			const DistanceResult cold = gjkDistance(boxA, boxB, &simplex);
+
+			boxB.box.center += Vec3d(0.01f, 0.f, 0.f);
+			const DistanceResult warm = gjkDistance(boxA, boxB, &simplex);
+			const DistanceResult reference = gjkDistance(boxA, boxB);
+
+			Assert::AreEqual(reference.distance, warm.distance, 0.0001f, L"Warm-started distance incorrect");
+			Assert::IsTrue(warm.iterations < cold.iterations, L"Warm start doesn't reduce iterations");
+
+			// Batch query matches the single one.
+			std::vector<const ConvexShape*> a(9, &boxA);
+			std::vector<const ConvexShape*> b(9, &boxB);
+			std::vector<DistanceResult> results(9);
+			gjkDistanceN(a.data(), b.data(), nullptr, results.data(), results.size());
+
+			for (const auto& result : results)
+				Assert::AreEqual(reference.distance, result.distance, 0.00001f, L"Batch distance incorrect");
+		}
+	};
+}
@@ -0,0 +1,171 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "reMath/reCubicSpline3.h"
+#include "reMath/reParallel.h"
+#include <cmath>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace re;
+
+namespace Test
+{
+	namespace
+	{
+		float distanceToPolyline(const Vec3d& point, const std::vector<Vec3d>& polyline)
+		{
+			float best = point.distanceTo(polyline.front());
+
+			for (size_t i = 1; i < polyline.size(); i++)
+			{
+				const Vec3d line = polyline[i] - polyline[i - 1];
+				float t = (point - polyline[i - 1]).dot(line) / line.lengthSquared();
+				t = t < 0.f ? 0.f : t > 1.f ? 1.f : t;
+				const float distance = point.distanceTo(polyline[i - 1] + line * t);
+				best = distance < best ? distance : best;
+			}
+
+			return best;
+		}
+	}
+
+	TEST_CLASS(CubicSpline3UnitTest)
+	{
+	public:
+		TEST_METHOD(BasisCubicSpline3Test)
+		{
+			const Vec3d bezier[] = { Vec3d(0.f, 0.f, 0.f), Vec3d(1.f, 2.f, 0.f), Vec3d(3.f, 2.f, 1.f), Vec3d(4.f, 0.f, 1.f),
+				Vec3d(5.f, -2.f, 1.f), Vec3d(6.f, 0.f, 3.f), Vec3d(7.f, 1.f, 2.f) };
+			const CubicSpline3 bezierSpline(bezier, 7, CubicSpline3::BASIS_BEZIER);
+			Assert::AreEqual(size_t(2), bezierSpline.getSegmentCount(), L"Wrong Bezier segment count");
+			Assert::IsTrue(bezierSpline.evaluate(0.f).distanceTo(bezier[0]) < 0.00001f, L"Bezier start failed");
+			Assert::IsTrue(bezierSpline.evaluate(1.f).distanceTo(bezier[3]) < 0.00001f, L"Bezier joint failed");
+			Assert::IsTrue(bezierSpline.evaluate(2.f).distanceTo(bezier[6]) < 0.00001f, L"Bezier end failed");
+			Assert::IsTrue(bezierSpline.evaluate(0.5f).distanceTo((bezier[0] + bezier[1] * 3.f + bezier[2] * 3.f + bezier[3]) * 0.125f) < 0.00001f, L"Bezier middle failed");
+			Assert::IsTrue(bezierSpline.evaluateTangent(0.f).distanceTo((bezier[1] - bezier[0]) * 3.f) < 0.00001f, L"Bezier tangent failed");
+
+			// Catmull-Rom passes through the points with matching tangents at the joints, even with coincident points.
+			const Vec3d points[] = { Vec3d(0.f, 0.f, 0.f), Vec3d(1.f, 0.f, 0.f), Vec3d(1.1f, 3.f, 0.f), Vec3d(1.1f, 3.f, 0.f),
+				Vec3d(4.f, 3.f, -1.f), Vec3d(8.f, 0.f, 2.f) };
+			const CubicSpline3 catmullRom(points, 6, CubicSpline3::BASIS_CATMULL_ROM);
+			Assert::AreEqual(size_t(5), catmullRom.getSegmentCount(), L"Wrong Catmull-Rom segment count");
+
+			for (int i = 0; i < 6; i++)
+			{
+				const Vec3d position = catmullRom.evaluate(static_cast<float>(i));
+				Assert::IsTrue(position.distanceTo(points[i]) < 0.00001f, L"Catmull-Rom misses a point");
+				Assert::IsTrue(position.x == position.x, L"Catmull-Rom produced NaN");
+			}
+
+			for (int i = 1; i < 5; i++)
+			{
+				if (i == 3)
+					continue;
+
+				Vec3d left = catmullRom.evaluate(static_cast<float>(i)) - catmullRom.evaluate(i - 0.001f);
+				Vec3d right = catmullRom.evaluate(i + 0.001f) - catmullRom.evaluate(static_cast<float>(i));
+				left.normalize();
+				right.normalize();
+				Assert::IsTrue(left.distanceTo(right) < 0.01f, L"Catmull-Rom tangent direction jumps");
+			}
+
+			// Hermite interpolates positions and tangents.
+			const Vec3d hermite[] = { Vec3d(0.f, 0.f, 0.f), Vec3d(1.f, 1.f, 0.f), Vec3d(2.f, 0.f, 0.f), Vec3d(0.f, -3.f, 1.f) };
+			const CubicSpline3 hermiteSpline(hermite, 4, CubicSpline3::BASIS_HERMITE);
+			Assert::IsTrue(hermiteSpline.evaluate(1.f).distanceTo(hermite[2]) < 0.00001f, L"Hermite end failed");
+			Assert::IsTrue(hermiteSpline.evaluateTangent(0.f).distanceTo(hermite[1]) < 0.00001f, L"Hermite start tangent failed");
+			Assert::IsTrue(hermiteSpline.evaluateTangent(1.f).distanceTo(hermite[3]) < 0.00001f, L"Hermite end tangent failed");
+
+			// Degenerate curves.
+			const CubicSpline3 empty(nullptr, 0, CubicSpline3::BASIS_CATMULL_ROM);
+			Assert::IsTrue(Vec3d(0.f) == empty.evaluate(1.f), L"Empty curve failed");
+			Assert::AreEqual(0.f, empty.getLength(), L"Empty curve length failed");
+			const CubicSpline3 single(points + 2, 1, CubicSpline3::BASIS_CATMULL_ROM);
+			Assert::IsTrue(points[2] == single.evaluate(0.7f), L"Single point curve failed");
+			Assert::AreEqual(0.f, single.getParameter(1.f), L"Single point curve parameter failed");
+		}
+
+		TEST_METHOD(BatchCubicSpline3Test)
+		{
+			ThreadPool pool(4);
+			setExecutor(&pool);
+
+			std::vector<Vec3d> points;
+
+			for (int i = 0; i < 50; i++)
+				points.push_back(Vec3d(i * 2.f, sinf(i * 0.7f) * 5.f, cosf(i * 0.3f) * 3.f));
+
+			const CubicSpline3 spline(points.data(), points.size(), CubicSpline3::BASIS_CATMULL_ROM);
+			std::vector<float> times;
+
+			for (int i = 0; i < 20003; i++)
+				times.push_back(i * 0.0025f - 0.5f);
+
+			std::vector<Vec3d> batch(times.size());
+			spline.evaluateN(times.data(), batch.data(), times.size());
+
+			std::vector<float> distances;
+
+			for (int i = 0; i < 1001; i++)
+				distances.push_back(spline.getLength() * i / 1000.f);
+
+			std::vector<Vec3d> uniform(distances.size());
+			spline.evaluateAtDistanceN(distances.data(), uniform.data(), distances.size());
+			setExecutor(nullptr);
+
+			for (size_t i = 0; i < times.size(); i++)
+				Assert::IsTrue(batch[i].distanceTo(spline.evaluate(times[i])) < 0.00001f, L"Batch evaluation differs");
+
+			// Constant speed traversal takes equal steps.
+			const float step = spline.getLength() / 1000.f;
+			Assert::IsTrue(uniform.front().distanceTo(points.front()) < 0.00001f, L"Traversal start failed");
+			Assert::IsTrue(uniform.back().distanceTo(points.back()) < 0.0001f, L"Traversal end failed");
+
+			for (size_t i = 1; i < uniform.size(); i++)
+				Assert::AreEqual(step, uniform[i].distanceTo(uniform[i - 1]), step * 0.02f, L"Traversal speed is not constant");
+		}
+
+		TEST_METHOD(ArcLengthCubicSpline3Test)
+		{
+			// Straight line with uneven speed.
+			const Vec3d line[] = { Vec3d(0.f, 0.f, 0.f), Vec3d(0.2f, 0.f, 0.f), Vec3d(0.4f, 0.f, 0.f), Vec3d(6.f, 0.f, 0.f) };
+			const CubicSpline3 lineSpline(line, 4, CubicSpline3::BASIS_BEZIER);
+			Assert::AreEqual(6.f, lineSpline.getLength(), 0.0001f, L"Line length failed");
+
+			for (float distance = 0.f; distance <= 6.f; distance += 0.25f)
+				Assert::AreEqual(distance, lineSpline.evaluate(lineSpline.getParameter(distance)).x, 0.005f, L"Line distance lookup failed");
+
+			std::vector<Vec3d> polyline;
+			lineSpline.flatten(0.001f, polyline);
+			Assert::AreEqual(size_t(2), polyline.size(), L"Straight line was subdivided");
+
+			// Circle through 16 points.
+			std::vector<Vec3d> circle;
+
+			for (int i = 0; i <= 16; i++)
+				circle.push_back(Vec3d(cosf(i * 0.39269908f) * 10.f, 0.f, sinf(i * 0.39269908f) * 10.f));
+
+			const CubicSpline3 circleSpline(circle.data(), circle.size(), CubicSpline3::BASIS_CATMULL_ROM);
+			Assert::AreEqual(62.831853f, circleSpline.getLength(), 0.1f, L"Circle length failed");
+
+			const CubicSpline3 coarse(circle.data(), circle.size(), CubicSpline3::BASIS_CATMULL_ROM, 0);
+			Assert::AreEqual(0.f, coarse.getLength(), L"Arc length table was not skipped");
+
+			// Polyline stays within the tolerance and gets finer with a smaller tolerance.
+			for (const float tolerance : { 0.1f, 0.01f })
+			{
+				polyline.clear();
+				circleSpline.flatten(tolerance, polyline);
+				Assert::IsTrue(polyline.front() == circleSpline.evaluate(0.f), L"Polyline start failed");
+				Assert::IsTrue(polyline.back().distanceTo(circle.back()) < 0.0001f, L"Polyline end failed");
+
+				for (float time = 0.f; time <= 16.f; time += 0.01f)
+					Assert::IsTrue(distanceToPolyline(circleSpline.evaluate(time), polyline) <= tolerance, L"Polyline too far from the curve");
+			}
+
+			std::vector<Vec3d> rough;
+			circleSpline.flatten(0.1f, rough);
+			Assert::IsTrue(polyline.size() > rough.size(), L"Tolerance didn't refine the polyline");
+		}
+	};
+}
@@ -0,0 +1,278 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "reMath/reDecomposition.h"
+#include "reMath/reMatrix3.h"
+#include "reMath/reMatrix4.h"
+#include "reMath/reQuaternion.h"
+#include "reMath/reParallel.h"
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace re;
+
+namespace Test
+{
+	namespace
+	{
+		Matrix3 randomMatrix()
+		{
+			Matrix3 result;
+
+			for (int i = 0; i < 9; i++)
+				result[i] = static_cast<float>(rand()) / RAND_MAX * 4.f - 2.f;
+
+			return result;
+		}
+
+		float maxDifference(const Matrix3& first, const Matrix3& second)
+		{
+			float result = 0.f;
+
+			for (int i = 0; i < 9; i++)
+				result = fmaxf(result, fabsf(first[i] - second[i]));
+
+			return result;
+		}
+
+		float determinant(const Matrix3& m)
+		{
+			return m[0] * (m[4] * m[8] - m[7] * m[5]) - m[3] * (m[1] * m[8] - m[7] * m[2]) + m[6] * (m[1] * m[5] - m[4] * m[2]);
+		}
+
+		Matrix3 diagonal(const Vec3d& values)
+		{
+			const float data[9] = { values.x, 0.f, 0.f, 0.f, values.y, 0.f, 0.f, 0.f, values.z };
+			Matrix3 result(data);
+
+			return result;
+		}
+
+		bool isRotation(const Matrix3& matrix)
+		{
+			Matrix3 identity;
+			return maxDifference(matrix.toTransposed() * matrix, identity) < 1e-4f && fabsf(determinant(matrix) - 1.f) < 1e-4f;
+		}
+
+		void checkSvd(const Matrix3& matrix)
+		{
+			Matrix3 u, v;
+			Vec3d sigma;
+			matrix.svd(u, sigma, v);
+
+			Assert::IsTrue(isRotation(u), L"U is not a rotation");
+			Assert::IsTrue(isRotation(v), L"V is not a rotation");
+			Assert::IsTrue(fabsf(sigma.x) >= fabsf(sigma.y) && fabsf(sigma.y) >= fabsf(sigma.z), L"Singular values are not sorted");
+			Assert::IsTrue(maxDifference(u * diagonal(sigma) * v.toTransposed(), matrix) < 1e-4f, L"Wrong reconstruction");
+		}
+
+		Quaternion randomRotation()
+		{
+			Quaternion result(static_cast<float>(rand()) / RAND_MAX - 0.5f, static_cast<float>(rand()) / RAND_MAX - 0.5f,
+				static_cast<float>(rand()) / RAND_MAX - 0.5f, static_cast<float>(rand()) / RAND_MAX - 0.5f);
+			result.normalize();
+			return result;
+		}
+
+		Matrix4 compose(const Vec3d& translation, const Quaternion& rotation, const Vec3d& scale)
+		{
+			Matrix4 result = rotation.getMatrix();
+
+			for (int column = 0; column < 3; column++)
+				for (int row = 0; row < 3; row++)
+					result[column * 4 + row] *= scale.d[column];
+
+			result.setTranslation(translation);
+			return result;
+		}
+	}
+
+	TEST_CLASS(DecompositionUnitTest)
+	{
+	public:
+		TEST_METHOD(MatrixProductTest)
+		{
+			Matrix3 first, second;
+			first.setRotation(0.3f, -0.2f, 0.5f);
+			second.setRotation(-0.4f, 0.1f, 0.7f);
+
+			Vec3d direct(1.f, 2.f, 3.f);
+			second.rotate(direct);
+			first.rotate(direct);
+
+			Vec3d combined(1.f, 2.f, 3.f);
+			(first * second).rotate(combined);
+			Assert::IsTrue(direct.distanceTo(combined) < 1e-5f, L"Wrong matrix product");
+
+			Vec3d inverse(combined);
+			(first * second).toTransposed().rotate(inverse);
+			Assert::IsTrue(inverse.distanceTo(Vec3d(1.f, 2.f, 3.f)) < 1e-5f, L"Wrong transposed matrix");
+		}
+
+		TEST_METHOD(EigenSymmetricTest)
+		{
+			srand(7);
+
+			for (int test = 0; test < 100; test++)
+			{
+				Matrix3 matrix = randomMatrix();
+
+				for (int row = 0; row < 3; row++)
+					for (int column = 0; column < row; column++)
+						matrix[column * 3 + row] = matrix[row * 3 + column];
+				Vec3d values;
+				Matrix3 vectors;
+				matrix.eigenSymmetric(values, vectors);
+
+				Assert::IsTrue(isRotation(vectors), L"Eigenvectors are not a rotation");
+				Assert::IsTrue(values.x >= values.y && values.y >= values.z, L"Eigenvalues are not sorted");
+				Assert::IsTrue(maxDifference(vectors * diagonal(values) * vectors.toTransposed(), matrix) < 1e-4f, L"Wrong reconstruction");
+			}
+
+			// Repeated eigenvalues.
+			Matrix3 identity;
+			Vec3d values;
+			Matrix3 vectors;
+			identity.eigenSymmetric(values, vectors);
+			Assert::IsTrue(values.distanceTo(Vec3d(1.f, 1.f, 1.f)) < 1e-5f, L"Wrong identity eigenvalues");
+		}
+
+		TEST_METHOD(SvdTest)
+		{
+			srand(11);
+
+			for (int test = 0; test < 200; test++)
+				checkSvd(randomMatrix());
+
+			// Rank deficient, zero and reflection matrices.
+			Matrix3 matrix = randomMatrix();
+
+			for (int i = 0; i < 3; i++)
+				matrix[6 + i] = matrix[i] * 2.f - matrix[3 + i];
+
+			checkSvd(matrix);
+
+			const float zero[9] = {};
+			checkSvd(Matrix3(zero));
+
+			Matrix3 reflection;
+			reflection.setRotation(0.4f, 0.2f, -0.6f);
+
+			for (int i = 0; i < 3; i++)
+				reflection[i] = -reflection[i];
+
+			Matrix3 u, v;
+			Vec3d sigma;
+			reflection.svd(u, sigma, v);
+			checkSvd(reflection);
+			Assert::IsTrue(fabsf(sigma.x - 1.f) < 1e-4f && fabsf(sigma.y - 1.f) < 1e-4f && fabsf(sigma.z + 1.f) < 1e-4f, L"Wrong reflection singular values");
+
+			// Tiny and huge matrices keep their relative precision, on the single and batch paths.
+			for (const float scale : { 1e-8f, 1e-15f, 1e15f })
+			{
+				const Matrix3 scaled(diagonal(Vec3d(1.f, 2.f, 3.f) * scale));
+				scaled.svd(u, sigma, v);
+				Assert::IsTrue(sigma.distanceTo(Vec3d(3.f, 2.f, 1.f) * scale) < 1e-5f * scale, L"Wrong tiny or huge singular values");
+				Assert::IsTrue(isRotation(u) && isRotation(v), L"Tiny or huge matrix rotations incorrect");
+
+				Matrix3 matrices[4], batchU[4], batchV[4];
+				Vec3d batchSigma[4];
+
+				for (Matrix3& matrix : matrices)
+					matrix = scaled;
+
+				svdN(matrices, 4, batchU, batchSigma, batchV);
+				Assert::IsTrue(batchSigma[3].distanceTo(Vec3d(3.f, 2.f, 1.f) * scale) < 1e-5f * scale, L"Wrong tiny or huge batch singular values");
+			}
+		}
+
+		TEST_METHOD(SvdBatchTest)
+		{
+			ThreadPool pool(4);
+			setExecutor(&pool);
+			srand(13);
+
+			// Odd count runs both the four wide and the scalar paths.
+			const size_t count = 4099;
+			std::vector<Matrix3> matrices;
+
+			for (size_t i = 0; i < count; i++)
+				matrices.push_back(randomMatrix());
+
+			std::vector<Matrix3> u(count), v(count), vectors(count);
+			std::vector<Vec3d> sigma(count), values(count);
+			svdN(matrices.data(), count, u.data(), sigma.data(), v.data());
+			eigenSymmetricN(matrices.data(), count, values.data(), vectors.data());
+
+			for (size_t i = 0; i < count; i++)
+			{
+				Assert::IsTrue(maxDifference(u[i] * diagonal(sigma[i]) * v[i].toTransposed(), matrices[i]) < 1e-4f, L"Wrong batch reconstruction");
+
+				Matrix3 singleU, singleV;
+				Vec3d singleSigma;
+				matrices[i].svd(singleU, singleSigma, singleV);
+				Assert::IsTrue(singleSigma.distanceTo(sigma[i]) < 1e-4f, L"Batch and single results differ");
+
+				Vec3d singleValues;
+				Matrix3 singleVectors;
+				matrices[i].eigenSymmetric(singleValues, singleVectors);
+				Assert::IsTrue(singleValues.distanceTo(values[i]) < 1e-4f, L"Batch and single eigenvalues differ");
+			}
+
+			setExecutor(nullptr);
+		}
+
+		TEST_METHOD(DecomposeTest)
+		{
+			srand(17);
+
+			for (int test = 0; test < 200; test++)
+			{
+				const Quaternion rotation = randomRotation();
+				const Vec3d scale(test % 2 ? -1.5f : 0.5f, 2.f + test * 0.01f, 0.25f);
+				const Vec3d translation(test * 0.1f, -3.f, 7.f);
+				const Matrix4 matrix = compose(translation, rotation, scale);
+
+				const TransformComponents components = decompose(matrix);
+				Assert::IsFalse(components.sheared, L"Orthogonal matrix reported as sheared");
+				Assert::IsTrue(components.translation.distanceTo(translation) < 1e-5f, L"Wrong translation");
+				Assert::IsTrue(components.scale.distanceTo(scale) < 1e-4f, L"Wrong scale");
+				Assert::IsTrue(matrix.getScales().distanceTo(scale) < 1e-4f, L"Wrong matrix scales");
+				Assert::AreEqual(scale.x, matrix.getScale(), 1e-4f, L"Wrong matrix scale");
+				Assert::IsTrue(fabsf(fabsf(components.rotation.dot(rotation)) - 1.f) < 1e-5f, L"Wrong rotation");
+			}
+
+			// Sheared matrix is flagged and its polar decomposition still reconstructs it.
+			Matrix4 sheared = compose(Vec3d(1.f, 2.f, 3.f), randomRotation(), Vec3d(1.f, 2.f, 3.f));
+			sheared[4] += 0.5f;
+
+			const TransformComponents components = decompose(sheared);
+			Assert::IsTrue(components.sheared, L"Sheared matrix not detected");
+
+			Matrix3 rotation, stretch;
+			const Matrix3 linear(sheared);
+			polarDecomposition(linear, rotation, stretch);
+			Assert::IsTrue(isRotation(rotation), L"Polar rotation is not a rotation");
+			Assert::IsTrue(maxDifference(stretch, stretch.toTransposed()) < 1e-5f, L"Stretch is not symmetric");
+			Assert::IsTrue(maxDifference(rotation * stretch, linear) < 1e-4f, L"Wrong polar reconstruction");
+
+			// Batch results match the single ones.
+			std::vector<Matrix4> matrices;
+
+			for (int i = 0; i < 1000; i++)
+				matrices.push_back(compose(Vec3d(0.f, static_cast<float>(i), 0.f), randomRotation(), Vec3d(1.f, 2.f, i % 3 ? 1.f : -1.f)));
+
+			matrices.push_back(sheared);
+			std::vector<TransformComponents> batch(matrices.size());
+			decomposeN(matrices.data(), matrices.size(), batch.data());
+
+			for (size_t i = 0; i < matrices.size(); i++)
+			{
+				const TransformComponents single = decompose(matrices[i]);
+				Assert::IsTrue(batch[i].scale.distanceTo(single.scale) < 1e-6f, L"Batch and single scales differ");
+				Assert::IsTrue(fabsf(batch[i].rotation.dot(single.rotation) - 1.f) < 1e-6f, L"Batch and single rotations differ");
+			}
+		}
+	};
+}
@@ -0,0 +1,64 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "reMath/reFrameArena.h"
+#include "reMath/reBatch.h"
+#include "reMath/reVec3d.h"
+#include "reMath/reMatrix4.h"
+#include <cstdint>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace re;
+
+namespace Test
+{
+	TEST_CLASS(FrameArenaUnitTest)
+	{
+	public:
+		TEST_METHOD(BasicFrameArenaTest)
+		{
+			FrameArena arena(1024);
+			Assert::AreEqual(static_cast<size_t>(1024), arena.capacity(), L"Initial capacity incorrect");
+
+			// Alignment.
+			arena.allocate(3, 1);
+			void* aligned = arena.allocate(16, 64);
+			Assert::AreEqual(static_cast<uintptr_t>(0), reinterpret_cast<uintptr_t>(aligned) % 64, L"Allocation alignment failed");
+
+			// Objects are default-constructed.
+			Vec3d* vectors = arena.allocate<Vec3d>(4);
+			Assert::IsTrue(Vec3d() == vectors[3], L"Object construction failed");
+
+			// Mark and rewind.
+			const auto marker = arena.mark();
+			const size_t used = arena.used();
+			arena.allocate(100);
+			arena.rewind(marker);
+			Assert::AreEqual(used, arena.used(), L"Rewind failed");
+
+			// Overflow blocks are merged on reset, the next frame doesn't grow.
+			arena.allocate(4000);
+			const size_t capacity = arena.capacity();
+			Assert::IsTrue(capacity > 1024, L"Arena didn't grow");
+			arena.reset();
+			Assert::AreEqual(static_cast<size_t>(0), arena.used(), L"Reset failed");
+			Assert::AreEqual(capacity, arena.capacity(), L"Overflow blocks merge failed");
+			arena.allocate(3, 1);
+			arena.allocate(16, 64);
+			arena.allocate<Vec3d>(4);
+			arena.allocate(4000);
+			Assert::AreEqual(capacity, arena.capacity(), L"Steady state frame allocated memory");
+		}
+
+		TEST_METHOD(BatchFrameArenaTest)
+		{
+			FrameArena arena;
+			Matrix4 matrix;
+			matrix.setTranslation(1.f, 2.f, 3.f);
+
+			const Vec3d points[] = { Vec3d(1.f, 1.f, 1.f), Vec3d(-1.f, 0.f, 2.f) };
+			const Vec3d* result = transformN(matrix, points, 2, arena);
+			Assert::IsTrue(Vec3d(2.f, 3.f, 4.f) == result[0], L"Arena batch transform failed");
+			Assert::IsTrue(Vec3d(0.f, 2.f, 5.f) == result[1], L"Arena batch transform failed");
+		}
+	};
+}
@@ -0,0 +1,92 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "reMath/reICP.h"
+#include "reMath/reKdTree.h"
+#include "reMath/reParallel.h"
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace re;
+
+namespace Test
+{
+	TEST_CLASS(ICPUnitTest)
+	{
+	public:
+		TEST_METHOD(RegisterICPTest)
+		{
+			ThreadPool pool(4);
+			setExecutor(&pool);
+
+			// Target is a wavy height field with analytic normals.
+			std::vector<Vec3d> target;
+			std::vector<Vec3d> normals;
+
+			for (int y = 0; y < 80; y++)
+			{
+				for (int x = 0; x < 80; x++)
+				{
+					const float u = x * 0.25f;
+					const float v = y * 0.25f;
+					target.push_back(Vec3d(u, v, sinf(u) * cosf(v * 0.7f)));
+
+					Vec3d normal(-cosf(u) * cosf(v * 0.7f), 0.7f * sinf(u) * sinf(v * 0.7f), 1.f);
+					normal.normalize();
+					normals.push_back(normal);
+				}
+			}
+
+			// Source is the middle of the target moved away, with a few outliers.
+			Matrix4 expected;
+			expected.setRotation(0.03f, -0.02f, 0.05f);
+			expected.setTranslation(0.08f, -0.06f, 0.05f);
+
+			std::vector<Vec3d> source;
+			std::vector<Vec3d> original;
+			srand(19);
+
+			for (int y = 15; y < 65; y++)
+			{
+				for (int x = 15; x < 65; x++)
+				{
+					original.push_back(target[y * 80 + x]);
+					Vec3d point = target[y * 80 + x] - expected.getTranslation();
+					expected.inverseRotate(point);
+					source.push_back(point);
+				}
+			}
+
+			for (int i = 0; i < 50; i++)
+				source.push_back(Vec3d(static_cast<float>(rand() % 20), static_cast<float>(rand() % 20), 5.f + static_cast<float>(rand() % 5)));
+
+			KdTree tree;
+			tree.build(target.data(), target.size());
+
+			RegistrationSettings settings;
+			const RegistrationResult pointResult = icp(source.data(), source.size(), target.data(), tree, Matrix4(), settings);
+
+			settings.targetNormals = normals.data();
+			const RegistrationResult planeResult = icp(source.data(), source.size(), target.data(), target.size(), Matrix4(), settings);
+
+			setExecutor(nullptr);
+
+			for (const RegistrationResult* result : { &pointResult, &planeResult })
+			{
+				Assert::IsTrue(result->converged, L"Registration didn't converge");
+				Assert::IsTrue(result->error < 1e-3f, L"Registration error too large");
+				Assert::IsTrue(result->inlierCount > original.size() * 9 / 10 && result->inlierCount <= original.size(), L"Outliers not rejected");
+
+				for (size_t i = 0; i < original.size(); i++)
+					Assert::IsTrue((source[i] * result->transform).distanceTo(original[i]) < 2e-3f, L"Registered point misplaced");
+			}
+
+			Assert::IsTrue(planeResult.iterations <= pointResult.iterations, L"Point-to-plane needed more iterations");
+
+			// Starting from the answer converges immediately.
+			const RegistrationResult exact = icp(original.data(), original.size(), target.data(), tree);
+			Assert::IsTrue(exact.converged && exact.iterations <= 2 && exact.error < 1e-5f, L"Aligned clouds not recognized");
+		}
+	};
+}
@@ -0,0 +1,163 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "reMath/reIntegrator.h"
+#include "reMath/reQuaternion.h"
+#include "reMath/reMatrix3.h"
+#include "reMath/reMatrix4.h"
+#include "reMath/reParallel.h"
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace re;
+
+namespace Test
+{
+	namespace
+	{
+		float random(float range)
+		{
+			return (static_cast<float>(rand()) / RAND_MAX * 2.f - 1.f) * range;
+		}
+
+		Vec3d randomVector(float range)
+		{
+			return Vec3d(random(range), random(range), random(range));
+		}
+
+		float maxDifference(const Matrix3& first, const Matrix3& second)
+		{
+			const float* a = static_cast<const float*>(first);
+			const float* b = static_cast<const float*>(second);
+			float result = 0.f;
+
+			for (int i = 0; i < 9; i++)
+				result = fabsf(a[i] - b[i]) > result ? fabsf(a[i] - b[i]) : result;
+
+			return result;
+		}
+	}
+
+	TEST_CLASS(IntegratorUnitTest)
+	{
+	public:
+		TEST_METHOD(IntegrateIntegratorTest)
+		{
+			// Odd count covers the scalar tail, a few fast spinning bodies the large angle path.
+			const size_t count = 103;
+			std::vector<Vec3d> positions, linear, angular, forces, torques;
+			std::vector<Quaternion> orientations;
+			std::vector<float> inverseMasses;
+			std::vector<Matrix3> localInertias(count), worldInertias(count);
+			srand(47);
+
+			for (size_t i = 0; i < count; i++)
+			{
+				positions.push_back(randomVector(100.f));
+				linear.push_back(randomVector(10.f));
+				angular.push_back(randomVector(i % 10 ? 3.f : 200.f));
+				forces.push_back(randomVector(50.f));
+				torques.push_back(randomVector(5.f));
+				inverseMasses.push_back(i % 7 ? 0.5f + random(0.4f) : 0.f);
+
+				Quaternion orientation(random(1.f), random(1.f), random(1.f), random(1.f));
+				orientation.normalize();
+				orientations.push_back(orientation);
+
+				// Symmetric positive definite inverse inertia.
+				Matrix3 rotation;
+				rotation.setRotation(randomVector(3.f));
+				float diagonal[9] = { 1.f + random(0.5f), 0.f, 0.f, 0.f, 2.f + random(0.5f), 0.f, 0.f, 0.f, 0.5f + random(0.2f) };
+				localInertias[i] = rotation * Matrix3(diagonal) * rotation.toTransposed();
+			}
+
+			RigidBodies bodies;
+			bodies.positions = positions.data();
+			bodies.orientations = orientations.data();
+			bodies.linearVelocities = linear.data();
+			bodies.angularVelocities = angular.data();
+			bodies.forces = forces.data();
+			bodies.torques = torques.data();
+			bodies.inverseMasses = inverseMasses.data();
+			bodies.localInverseInertias = localInertias.data();
+			bodies.worldInverseInertias = worldInertias.data();
+			bodies.gravity.set(0.f, -9.81f, 0.f);
+			bodies.count = count;
+
+			const std::vector<Vec3d> startPositions(positions), startLinear(linear), startAngular(angular);
+			const std::vector<Quaternion> startOrientations(orientations);
+			const float step = 1.f / 60.f;
+
+			ThreadPool pool(4);
+			setExecutor(&pool);
+			integrateN(bodies, step);
+			setExecutor(nullptr);
+
+			for (size_t i = 0; i < count; i++)
+			{
+				// Semi-implicit Euler, velocities first.
+				Vec3d expectedLinear(startLinear[i]);
+
+				if (inverseMasses[i] > 0.f)
+					expectedLinear += (bodies.gravity + forces[i] * inverseMasses[i]) * step;
+
+				const Matrix3 rotation(startOrientations[i].getMatrix());
+				Vec3d angularAcceleration(torques[i]);
+				(rotation * localInertias[i] * rotation.toTransposed()).rotate(angularAcceleration);
+				const Vec3d expectedAngular = startAngular[i] + angularAcceleration * step;
+
+				Assert::IsTrue(linear[i].distanceTo(expectedLinear) < 0.00001f, L"Linear velocity integration failed");
+				Assert::IsTrue(angular[i].distanceTo(expectedAngular) < 0.0001f, L"Angular velocity integration failed");
+				Assert::IsTrue(positions[i].distanceTo(startPositions[i] + expectedLinear * step) < 0.0001f, L"Position integration failed");
+
+				Vec3d axis(expectedAngular);
+				axis.normalize();
+				const Quaternion expected = Quaternion::fromAxisAngle(axis, expectedAngular.length() * step) * startOrientations[i];
+				Assert::AreEqual(1.f, orientations[i].length(), 0.000001f, L"Orientation is not normalized");
+				Assert::AreEqual(1.f, fabsf(orientations[i].dot(expected)), 0.000001f, L"Orientation integration failed");
+
+				const Matrix3 newRotation(orientations[i].getMatrix());
+				Assert::IsTrue(maxDifference(worldInertias[i], newRotation * localInertias[i] * newRotation.toTransposed()) < 0.00001f, L"World inertia update failed");
+			}
+		}
+
+		TEST_METHOD(LeapfrogIntegratorTest)
+		{
+			// Kick-drift-kick follows a constant acceleration exactly.
+			std::vector<Vec3d> positions(9, Vec3d(1.f, 2.f, 3.f));
+			std::vector<Vec3d> linear(9, Vec3d(4.f, 5.f, 0.f));
+			std::vector<Vec3d> angular(9, Vec3d(0.f, 0.f, 1.5f));
+			std::vector<Quaternion> orientations(9);
+
+			RigidBodies bodies;
+			bodies.positions = positions.data();
+			bodies.orientations = orientations.data();
+			bodies.linearVelocities = linear.data();
+			bodies.angularVelocities = angular.data();
+			bodies.gravity.set(0.f, -9.81f, 0.f);
+			bodies.count = positions.size();
+
+			const float step = 0.01f;
+
+			for (int i = 0; i < 200; i++)
+			{
+				kickN(bodies, step * 0.5f);
+				driftN(bodies, step);
+				kickN(bodies, step * 0.5f);
+			}
+
+			const Vec3d expected(1.f + 4.f * 2.f, 2.f + 5.f * 2.f - 0.5f * 9.81f * 4.f, 3.f);
+			const Quaternion rotation = Quaternion::fromEulerZRotation(3.f);
+
+			for (size_t i = 0; i < positions.size(); i++)
+			{
+				Assert::IsTrue(positions[i].distanceTo(expected) < 0.001f, L"Leapfrog trajectory failed");
+				Assert::IsTrue(linear[i].distanceTo(Vec3d(4.f, 5.f - 9.81f * 2.f, 0.f)) < 0.0001f, L"Leapfrog velocity failed");
+
+				// Constant angular velocity is integrated exactly by the exponential map.
+				Assert::AreEqual(1.f, fabsf(orientations[i].dot(rotation)), 0.000001f, L"Free rotation failed");
+			}
+		}
+	};
+}
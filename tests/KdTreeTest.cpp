@@ -0,0 +1,105 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "reMath/reKdTree.h"
+#include "reMath/reParallel.h"
+#include <algorithm>
+#include <cfloat>
+#include <cstdlib>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace re;
+
+namespace Test
+{
+	TEST_CLASS(KdTreeUnitTest)
+	{
+	public:
+		TEST_METHOD(QueryKdTreeTest)
+		{
+			ThreadPool pool(4);
+			setExecutor(&pool);
+
+			srand(17);
+			auto random = [](float range) { return static_cast<float>(rand()) / RAND_MAX * range; };
+			std::vector<Vec3d> points(20000);
+
+			// Clustered points with duplicates.
+			for (size_t i = 0; i < points.size(); i++)
+				points[i] = i % 10 == 9 ? points[i - 1] : Vec3d(random(100.f), random(10.f), static_cast<float>(rand() % 5));
+
+			KdTree tree;
+			tree.build(points.data(), points.size());
+			Assert::AreEqual(points.size(), tree.getPointCount(), L"Point count incorrect");
+
+			std::vector<Vec3d> queries(100);
+
+			for (auto& query : queries)
+				query.set(random(120.f) - 10.f, random(12.f) - 1.f, random(6.f) - 0.5f);
+
+			const size_t k = 7;
+			std::vector<unsigned int> nearest(queries.size());
+			std::vector<float> nearestDistances(queries.size());
+			std::vector<unsigned int> neighbours(queries.size() * k);
+			std::vector<float> neighbourDistances(queries.size() * k);
+			tree.findNearestN(queries.data(), queries.size(), nearest.data(), nearestDistances.data());
+			tree.findNearestN(queries.data(), queries.size(), k, neighbours.data(), neighbourDistances.data());
+
+			for (size_t q = 0; q < queries.size(); q++)
+			{
+				std::vector<float> distances(points.size());
+
+				for (size_t i = 0; i < points.size(); i++)
+					distances[i] = points[i].distanceSquaredTo(queries[q]);
+
+				std::vector<float> sorted(distances);
+				std::sort(sorted.begin(), sorted.end());
+
+				Assert::AreEqual(sorted[0], nearestDistances[q], L"Nearest distance incorrect");
+				Assert::AreEqual(sorted[0], distances[nearest[q]], L"Nearest point incorrect");
+
+				for (size_t i = 0; i < k; i++)
+				{
+					Assert::AreEqual(sorted[i], neighbourDistances[q * k + i], L"k-NN distances incorrect");
+					Assert::AreEqual(sorted[i], distances[neighbours[q * k + i]], L"k-NN points incorrect");
+				}
+
+				std::vector<unsigned int> inRadius;
+				std::vector<unsigned int> expected;
+				tree.findInRadius(queries[q], 3.f, inRadius);
+				std::sort(inRadius.begin(), inRadius.end());
+
+				for (size_t i = 0; i < points.size(); i++)
+				{
+					if (distances[i] <= 9.f)
+						expected.push_back(static_cast<unsigned int>(i));
+				}
+
+				Assert::IsTrue(expected == inRadius, L"Radius search differs from brute force");
+			}
+
+			setExecutor(nullptr);
+		}
+
+		TEST_METHOD(SmallKdTreeTest)
+		{
+			KdTree tree;
+			Assert::AreEqual(KdTree::INVALID, tree.findNearest(Vec3d(0.f, 0.f, 0.f)), L"Empty tree found a point");
+
+			const Vec3d points[] = { Vec3d(0.f, 0.f, 0.f), Vec3d(1.f, 0.f, 0.f), Vec3d(0.f, 3.f, 0.f) };
+			tree.build(points, 3);
+
+			float distance;
+			Assert::AreEqual(1u, tree.findNearest(Vec3d(2.f, 0.f, 0.f), &distance), L"Nearest point incorrect");
+			Assert::AreEqual(1.f, distance, L"Nearest distance incorrect");
+
+			// Asking for more points than the tree has.
+			unsigned int indices[4];
+			float distances[4];
+			tree.findNearestN(points + 2, 1, 4, indices, distances);
+			Assert::IsTrue(indices[0] == 2 && indices[1] == 0 && indices[2] == 1, L"k-NN order incorrect");
+			Assert::IsTrue(indices[3] == KdTree::INVALID && distances[3] == FLT_MAX, L"Missing k-NN entries not marked");
+			Assert::AreEqual(static_cast<size_t>(3), tree.findNearest(points[0], 4, indices), L"k-NN count incorrect");
+		}
+	};
+}
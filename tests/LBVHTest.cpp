@@ -0,0 +1,255 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "reMath/reLBVH.h"
+#include "reMath/reParallel.h"
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace re;
+
+namespace Test
+{
+	TEST_CLASS(LBVHUnitTest)
+	{
+	public:
+		static bool encloses(const AABB& outer, const AABB& inner)
+		{
+			return outer.contains(inner.min) && outer.contains(inner.max);
+		}
+
+		// Checks parent links and bounds, and that every primitive is in exactly one leaf.
+		static void validate(const LBVH& tree)
+		{
+			const auto& nodes = tree.getNodes();
+			std::vector<int> leaves(tree.getPrimitiveCount(), 0);
+			Assert::AreEqual(LBVH::INVALID, nodes[0].parent, L"Root has a parent");
+
+			for (size_t i = 0; i < nodes.size(); i++)
+			{
+				const LBVH::Node& node = nodes[i];
+
+				if (node.right == LBVH::INVALID)
+				{
+					leaves[node.left]++;
+					continue;
+				}
+
+				Assert::AreEqual(static_cast<unsigned int>(i), nodes[node.left].parent, L"Parent link incorrect");
+				Assert::AreEqual(static_cast<unsigned int>(i), nodes[node.right].parent, L"Parent link incorrect");
+				Assert::IsTrue(encloses(node.bounds, nodes[node.left].bounds) && encloses(node.bounds, nodes[node.right].bounds), L"Node doesn't enclose its children");
+			}
+
+			for (const int count : leaves)
+				Assert::AreEqual(1, count, L"Primitive is not in exactly one leaf");
+		}
+
+		TEST_METHOD(BuildLBVHTest)
+		{
+			ThreadPool pool(4);
+			setExecutor(&pool);
+
+			srand(11);
+			auto random = [](float range) { return static_cast<float>(rand()) / RAND_MAX * range; };
+			std::vector<AABB> boxes(20000);
+
+			for (auto& box : boxes)
+			{
+				const Vec3d center(random(100.f), random(100.f), random(20.f));
+				const Vec3d size(random(1.f), random(1.f), random(1.f));
+				box = AABB(center - size, center + size);
+			}
+
+			LBVH tree;
+			tree.build(boxes.data(), boxes.size());
+			Assert::AreEqual(2 * boxes.size() - 1, tree.getNodes().size(), L"Node count incorrect");
+			validate(tree);
+
+			for (int query = 0; query < 20; query++)
+			{
+				const Vec3d center(random(100.f), random(100.f), random(20.f));
+				const AABB box(center - Vec3d(3.f, 3.f, 3.f), center + Vec3d(3.f, 3.f, 3.f));
+				const Vec3d origin(-10.f, random(100.f), random(20.f));
+				Vec3d direction(1.f, random(0.2f) - 0.1f, random(0.2f) - 0.1f);
+				direction.normalize();
+				const Vec3d inverseDirection(1.f / direction.x, 1.f / direction.y, 1.f / direction.z);
+
+				std::vector<unsigned int> overlap;
+				std::vector<unsigned int> ray;
+				tree.queryOverlap(box, overlap);
+				tree.queryRay(origin, direction, 80.f, ray);
+				std::sort(overlap.begin(), overlap.end());
+				std::sort(ray.begin(), ray.end());
+
+				std::vector<unsigned int> expectedOverlap;
+				std::vector<unsigned int> expectedRay;
+
+				for (size_t i = 0; i < boxes.size(); i++)
+				{
+					float distance;
+
+					if (boxes[i].overlaps(box))
+						expectedOverlap.push_back(static_cast<unsigned int>(i));
+
+					if (boxes[i].intersectsRay(origin, inverseDirection, 80.f, distance))
+						expectedRay.push_back(static_cast<unsigned int>(i));
+				}
+
+				Assert::IsTrue(expectedOverlap == overlap, L"Overlap query differs from brute force");
+				Assert::IsTrue(expectedRay == ray, L"Ray query differs from brute force");
+				Assert::IsFalse(ray.empty(), L"Test data doesn't cover the ray query");
+			}
+
+			// Identical boxes have equal codes, the tree must still be valid.
+			std::vector<AABB> same(5000, AABB(Vec3d(1.f, 1.f, 1.f), Vec3d(2.f, 2.f, 2.f)));
+			tree.build(same.data(), same.size());
+			validate(tree);
+
+			setExecutor(nullptr);
+
+			tree.build(boxes.data(), 1);
+			Assert::AreEqual(static_cast<size_t>(1), tree.getNodes().size(), L"Single primitive tree incorrect");
+			validate(tree);
+
+			tree.build(boxes.data(), 0);
+			std::vector<unsigned int> result;
+			tree.queryOverlap(boxes[0], result);
+			Assert::IsTrue(result.empty() && tree.getBounds().isEmpty(), L"Empty tree query incorrect");
+		}
+
+		TEST_METHOD(EmptyLBVHTest)
+		{
+			// Never built tree.
+			LBVH tree;
+			tree.refit(static_cast<const AABB*>(nullptr));
+			tree.refit(nullptr, nullptr, true);
+			Assert::IsTrue(tree.getNodes().empty() && tree.getBounds().isEmpty(), L"Never built tree refit incorrect");
+			Assert::AreEqual(0.f, tree.getCost(), L"Never built tree cost incorrect");
+
+			// Tree rebuilt from no primitives.
+			const AABB box(Vec3d(0.f, 0.f, 0.f), Vec3d(1.f, 1.f, 1.f));
+			tree.build(&box, 1);
+			tree.build(&box, 0);
+			tree.refit(&box, true);
+
+			std::vector<unsigned int> result;
+			tree.queryOverlap(box, result);
+			Assert::IsTrue(result.empty() && tree.getBounds().isEmpty(), L"Empty tree refit incorrect");
+		}
+
+		TEST_METHOD(RefitLBVHTest)
+		{
+			ThreadPool pool(4);
+			setExecutor(&pool);
+
+			srand(13);
+			auto random = [](float range) { return static_cast<float>(rand()) / RAND_MAX * range; };
+			std::vector<AABB> boxes(10000);
+
+			for (auto& box : boxes)
+			{
+				const Vec3d center(random(100.f), random(100.f), random(100.f));
+				box = AABB(center, center + Vec3d(0.5f, 0.5f, 0.5f));
+			}
+
+			LBVH tree;
+			LBVH rotated;
+			tree.build(boxes.data(), boxes.size());
+			rotated.build(boxes.data(), boxes.size());
+			Assert::AreEqual(tree.getCost(), tree.getBuildCost(), L"Build cost incorrect");
+
+			// Scattering the primitives ruins the hierarchy, rotations should recover part of it.
+			for (int frame = 0; frame < 5; frame++)
+			{
+				for (auto& box : boxes)
+				{
+					const Vec3d offset(random(20.f) - 10.f, random(20.f) - 10.f, random(20.f) - 10.f);
+					box = AABB(box.min + offset, box.max + offset);
+				}
+
+				tree.refit(boxes.data());
+				rotated.refit(boxes.data(), true);
+				validate(tree);
+				validate(rotated);
+			}
+
+			Assert::IsTrue(tree.getCost() > 1.5f * tree.getBuildCost(), L"Refit cost didn't grow");
+			Assert::IsTrue(rotated.getCost() < tree.getCost(), L"Rotations didn't improve the tree");
+
+			const auto& nodes = rotated.getNodes();
+
+			for (size_t i = boxes.size() - 1; i < nodes.size(); i++)
+			{
+				const AABB& box = boxes[nodes[i].left];
+				Assert::IsTrue(nodes[i].bounds.min.x == box.min.x && nodes[i].bounds.max.z == box.max.z, L"Leaf bounds not refitted");
+			}
+
+			const AABB query(Vec3d(40.f, 40.f, 40.f), Vec3d(60.f, 60.f, 60.f));
+			std::vector<unsigned int> result;
+			std::vector<unsigned int> expected;
+			rotated.queryOverlap(query, result);
+			std::sort(result.begin(), result.end());
+
+			for (size_t i = 0; i < boxes.size(); i++)
+			{
+				if (boxes[i].overlaps(query))
+					expected.push_back(static_cast<unsigned int>(i));
+			}
+
+			Assert::IsTrue(!expected.empty() && expected == result, L"Query after refit differs from brute force");
+
+			setExecutor(nullptr);
+
+			// Rebuilding restores the quality.
+			tree.build(boxes.data(), boxes.size());
+			Assert::IsTrue(tree.getCost() < rotated.getCost(), L"Rebuild didn't restore the quality");
+		}
+
+		TEST_METHOD(MeshLBVHTest)
+		{
+			// 32x32 grid of quads in the XY plane.
+			const int size = 32;
+			std::vector<Vec3d> vertices;
+			std::vector<unsigned int> indices;
+
+			for (int y = 0; y <= size; y++)
+			{
+				for (int x = 0; x <= size; x++)
+					vertices.push_back(Vec3d(static_cast<float>(x), static_cast<float>(y), 0.f));
+			}
+
+			for (int y = 0; y < size; y++)
+			{
+				for (int x = 0; x < size; x++)
+				{
+					const unsigned int corner = y * (size + 1) + x;
+					const unsigned int quad[] = { corner, corner + 1, corner + size + 2, corner, corner + size + 2, corner + size + 1 };
+					indices.insert(indices.end(), quad, quad + 6);
+				}
+			}
+
+			LBVH tree;
+			tree.build(vertices.data(), indices.data(), indices.size() / 3);
+			validate(tree);
+
+			const AABB bounds = tree.getBounds();
+			Assert::IsTrue(bounds.min.x == 0.f && bounds.max.x == 32.f && bounds.max.y == 32.f && bounds.max.z == 0.f, L"Mesh bounds incorrect");
+
+			// A ray through the middle of the quad (10, 20) hits the bounds of its two triangles only.
+			std::vector<unsigned int> result;
+			tree.queryRay(Vec3d(10.3f, 20.6f, 5.f), Vec3d(0.f, 0.f, -1.f), 10.f, result);
+			std::sort(result.begin(), result.end());
+			Assert::AreEqual(static_cast<size_t>(2), result.size(), L"Mesh ray query incorrect");
+			Assert::AreEqual(static_cast<unsigned int>((20 * size + 10) * 2), result[0], L"Mesh ray query incorrect");
+
+			// Lifting the mesh moves the bounds along.
+			for (auto& vertex : vertices)
+				vertex.z = 3.f;
+
+			tree.refit(vertices.data(), indices.data(), true);
+			validate(tree);
+			Assert::IsTrue(tree.getBounds().min.z == 3.f && tree.getBounds().max.z == 3.f, L"Mesh refit bounds incorrect");
+		}
+	};
+}
@@ -0,0 +1,101 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "reMath/reMorton.h"
+#include "reMath/reParallel.h"
+#include <cstdlib>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace re;
+
+namespace Test
+{
+	TEST_CLASS(MortonUnitTest)
+	{
+	public:
+		TEST_METHOD(EncodeMortonTest)
+		{
+			Assert::AreEqual(0u, mortonEncode(0, 0, 0), L"Morton code incorrect");
+			Assert::AreEqual(7u, mortonEncode(1, 1, 1), L"Morton code incorrect");
+			Assert::AreEqual(4u, mortonEncode(0, 0, 1), L"Morton code incorrect");
+			Assert::AreEqual(0x3FFFFFFFu, mortonEncode(1023, 1023, 1023), L"Morton code incorrect");
+			Assert::AreEqual(0x09249249u, mortonEncode(0xFFFFFFFF, 0, 0), L"Higher coordinate bits not ignored");
+			Assert::IsTrue(mortonEncode64(0x1FFFFF, 0x1FFFFF, 0x1FFFFF) == 0x7FFFFFFFFFFFFFFFull, L"63-bit Morton code incorrect");
+			Assert::IsTrue(mortonEncode64(0, 0, 1u << 20) == 1ull << 62, L"63-bit Morton code incorrect");
+
+			srand(5);
+
+			for (int i = 0; i < 1000; i++)
+			{
+				const unsigned int x = static_cast<unsigned int>(rand()) * 131u + static_cast<unsigned int>(rand());
+				const unsigned int y = static_cast<unsigned int>(rand()) * 131u + static_cast<unsigned int>(rand());
+				const unsigned int z = static_cast<unsigned int>(rand()) * 131u + static_cast<unsigned int>(rand());
+
+				// Reference bit by bit interleaving.
+				unsigned long long expected = 0;
+
+				for (int bit = 0; bit < MORTON_BITS64; bit++)
+				{
+					expected |= static_cast<unsigned long long>((x >> bit) & 1) << (bit * 3);
+					expected |= static_cast<unsigned long long>((y >> bit) & 1) << (bit * 3 + 1);
+					expected |= static_cast<unsigned long long>((z >> bit) & 1) << (bit * 3 + 2);
+				}
+
+				Assert::IsTrue(expected == mortonEncode64(x, y, z), L"63-bit Morton code incorrect");
+				Assert::AreEqual(static_cast<unsigned int>(expected & 0x3FFFFFFF), mortonEncode(x, y, z), L"Morton code incorrect");
+
+				unsigned int dx, dy, dz;
+				mortonDecode(mortonEncode(x, y, z), dx, dy, dz);
+				Assert::IsTrue(dx == (x & 0x3FF) && dy == (y & 0x3FF) && dz == (z & 0x3FF), L"Morton decode incorrect");
+				mortonDecode64(mortonEncode64(x, y, z), dx, dy, dz);
+				Assert::IsTrue(dx == (x & 0x1FFFFF) && dy == (y & 0x1FFFFF) && dz == (z & 0x1FFFFF), L"63-bit Morton decode incorrect");
+			}
+
+			const AABB bounds(Vec3d(-1.f, -1.f, -1.f), Vec3d(1.f, 1.f, 1.f));
+			Assert::AreEqual(0u, mortonCode(Vec3d(-5.f, -1.f, -1.f), bounds), L"Point is not clamped to the bounds");
+			Assert::AreEqual(0x3FFFFFFFu, mortonCode(Vec3d(1.f, 1.f, 5.f), bounds), L"Point is not clamped to the bounds");
+			Assert::AreEqual(mortonEncode(512, 512, 512), mortonCode(Vec3d(0.f, 0.f, 0.f), bounds), L"Point code incorrect");
+			Assert::IsTrue(mortonEncode64(1u << 20, 1u << 20, 1u << 20) == mortonCode64(Vec3d(0.f, 0.f, 0.f), bounds), L"63-bit point code incorrect");
+		}
+
+		TEST_METHOD(SortMortonTest)
+		{
+			ThreadPool pool(4);
+			setExecutor(&pool);
+
+			srand(7);
+			std::vector<Vec3d> points(30000);
+
+			for (auto& point : points)
+				point.set(static_cast<float>(rand()) / RAND_MAX * 100.f, static_cast<float>(rand()) / RAND_MAX * 10.f, static_cast<float>(rand() % 4));
+
+			const std::vector<Vec3d> original(points);
+			std::vector<unsigned int> order(points.size());
+			mortonSort(points.data(), points.size(), order.data());
+
+			const AABB bounds = AABB::fromPoints(original.data(), original.size());
+			std::vector<bool> used(points.size(), false);
+
+			for (size_t i = 0; i < points.size(); i++)
+			{
+				Assert::IsTrue(original[order[i]].x == points[i].x && original[order[i]].y == points[i].y && original[order[i]].z == points[i].z, L"Sorted points don't match the order");
+				Assert::IsFalse(used[order[i]], L"Order is not a permutation");
+				used[order[i]] = true;
+
+				if (i > 0)
+				{
+					const unsigned int previous = mortonCode(points[i - 1], bounds);
+					const unsigned int current = mortonCode(points[i], bounds);
+					Assert::IsTrue(previous < current || (previous == current && order[i - 1] < order[i]), L"Points are not in stable Morton order");
+				}
+			}
+
+			setExecutor(nullptr);
+
+			Vec3d single(1.f, 2.f, 3.f);
+			unsigned int index = 5;
+			mortonSort(&single, 1, &index);
+			Assert::AreEqual(0u, index, L"Single point order incorrect");
+		}
+	};
+}
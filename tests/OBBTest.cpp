@@ -0,0 +1,144 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "reMath/reOBB.h"
+#include "reMath/reMatrix4.h"
+#include "reMath/reMathUtil.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace re;
+
+namespace Test
+{
+	TEST_CLASS(OBBUnitTest)
+	{
+	public:
+		TEST_METHOD(OBBFromPointsTest)
+		{
+			// Corners of a 6 x 4 x 2 box rotated around z by 30 degrees and moved to (1, 2, 3).
+			Matrix3 rotation;
+			rotation.setRotation(0.f, 0.f, toRadians(30.f));
+
+			std::vector<Vec3d> points;
+
+			for (int i = 0; i < 8; i++)
+			{
+				Vec3d corner(i & 1 ? 3.f : -3.f, i & 2 ? 2.f : -2.f, i & 4 ? 1.f : -1.f);
+				rotation.rotate(corner);
+				points.push_back(corner + Vec3d(1.f, 2.f, 3.f));
+			}
+
+			const OBB box = OBB::fromPoints(points.data(), points.size());
+			Assert::AreEqual(0.f, box.center.distanceTo(Vec3d(1.f, 2.f, 3.f)), 0.0001f, L"OBB center incorrect");
+
+			// Axes order is not defined, compare sorted extents.
+			float extents[3] = { box.extents.x, box.extents.y, box.extents.z };
+			std::sort(extents, extents + 3);
+			Assert::AreEqual(1.f, extents[0], 0.0001f, L"OBB extents incorrect");
+			Assert::AreEqual(2.f, extents[1], 0.0001f, L"OBB extents incorrect");
+			Assert::AreEqual(3.f, extents[2], 0.0001f, L"OBB extents incorrect");
+
+			for (const auto& p : points)
+				Assert::IsTrue(box.contains(p * 0.999f + box.center * 0.001f), L"OBB doesn't contain the source points");
+
+			// Axes form a right-handed orthonormal basis.
+			Assert::AreEqual(0.f, box.getAxis(0).dot(box.getAxis(1)), 0.0001f, L"OBB axes are not orthogonal");
+			Assert::AreEqual(1.f, box.getAxis(0).cross(box.getAxis(1)).dot(box.getAxis(2)), 0.0001f, L"OBB axes are not right-handed");
+
+			Assert::IsTrue(OBB::fromPoints(nullptr, 0).extents == Vec3d(0.f, 0.f, 0.f), L"Empty OBB is not empty");
+		}
+
+		TEST_METHOD(OBBTransformTest)
+		{
+			OBB box(Vec3d(1.f, 0.f, 0.f), Matrix3(), Vec3d(1.f, 2.f, 3.f));
+
+			Matrix4 matrix;
+			matrix.setRotation(0.f, 0.f, toRadians(90.f));
+			matrix.setTranslation(0.f, 0.f, 5.f);
+			box.transform(matrix);
+
+			Assert::AreEqual(0.f, box.center.distanceTo(Vec3d(1.f, 0.f, 0.f) * matrix), 0.0001f, L"OBB center transform incorrect");
+			Assert::AreEqual(2.f, box.extents.y, 0.0001f, L"OBB extents changed by rotation");
+			Assert::IsTrue(box.contains(Vec3d(1.5f, 1.5f, 2.5f) * matrix), L"Transformed OBB doesn't contain the point");
+			Assert::IsFalse(box.contains(Vec3d(1.f, 0.f, 0.f)), L"Transformed OBB contains the point outside");
+
+			// Uniform scale goes into the extents, axes stay unit length.
+			Matrix4 scale;
+			scale[0] = scale[5] = scale[10] = 2.f;
+			box.transform(scale);
+			Assert::AreEqual(4.f, box.extents.y, 0.0001f, L"OBB extents scale incorrect");
+			Assert::AreEqual(1.f, box.getAxis(0).length(), 0.0001f, L"OBB axis is not normalized");
+		}
+
+		TEST_METHOD(OBBOverlapTest)
+		{
+			const OBB a(Vec3d(0.f, 0.f, 0.f), Matrix3(), Vec3d(1.f, 1.f, 1.f));
+			Assert::IsTrue(a.overlaps(OBB(Vec3d(1.5f, 0.f, 0.f), Matrix3(), Vec3d(1.f, 1.f, 1.f))), L"Touching boxes don't overlap");
+			Assert::IsFalse(a.overlaps(OBB(Vec3d(2.5f, 0.f, 0.f), Matrix3(), Vec3d(1.f, 1.f, 1.f))), L"Separated boxes overlap");
+
+			// A box rotated by 45 degrees reaches further along the diagonal.
+			Matrix3 rotation;
+			rotation.setRotation(0.f, 0.f, toRadians(45.f));
+			Assert::IsTrue(a.overlaps(OBB(Vec3d(2.3f, 0.f, 0.f), rotation, Vec3d(1.f, 1.f, 1.f))), L"Rotated boxes don't overlap");
+			Assert::IsFalse(a.overlaps(OBB(Vec3d(2.5f, 0.f, 0.f), rotation, Vec3d(1.f, 1.f, 1.f))), L"Rotated boxes overlap");
+
+			// Edge to edge: only a cross product axis separates these boxes.
+			Matrix3 edge;
+			edge.setRotation(toRadians(45.f), toRadians(45.f), 0.f);
+			const OBB b(Vec3d(2.1f, 2.1f, 0.f), edge, Vec3d(1.f, 1.f, 1.f));
+			Assert::IsFalse(a.overlaps(b), L"Edge separated boxes overlap");
+			Assert::IsFalse(b.overlaps(a), L"Edge separated boxes overlap");
+			Assert::IsTrue(a.overlaps(OBB(Vec3d(1.9f, 1.9f, 0.f), edge, Vec3d(1.f, 1.f, 1.f))), L"Edge touching boxes don't overlap");
+		}
+
+		TEST_METHOD(OBBOverlapBatchTest)
+		{
+			srand(7);
+			auto random = [](float range) { return (static_cast<float>(rand()) / RAND_MAX * 2.f - 1.f) * range; };
+
+			Matrix3 rotation;
+			rotation.setRotation(0.3f, -0.2f, 0.7f);
+			const OBB box(Vec3d(0.f, 0.f, 0.f), rotation, Vec3d(1.f, 2.f, 0.5f));
+
+			std::vector<OBB> boxes(103);
+
+			for (auto& other : boxes)
+			{
+				other.center.set(random(5.f), random(5.f), random(5.f));
+				other.rotation.setRotation(random(3.f), random(3.f), random(3.f));
+				other.extents.set(0.2f + fabs(random(1.5f)), 0.2f + fabs(random(1.5f)), 0.2f + fabs(random(1.5f)));
+			}
+
+			std::unique_ptr<bool[]> results(new bool[boxes.size()]);
+			OBB::overlapN(box, boxes.data(), boxes.size(), results.get());
+
+			size_t overlapping = 0;
+
+			for (size_t i = 0; i < boxes.size(); i++)
+			{
+				Assert::AreEqual(box.overlaps(boxes[i]), results[i], L"Batch overlap differs from the single test");
+				Assert::AreEqual(boxes[i].overlaps(box), results[i], L"Overlap test is not symmetric");
+
+				// Any corner inside the other box means overlap.
+				for (int c = 0; c < 8; c++)
+				{
+					Vec3d corner(c & 1 ? boxes[i].extents.x : -boxes[i].extents.x,
+						c & 2 ? boxes[i].extents.y : -boxes[i].extents.y,
+						c & 4 ? boxes[i].extents.z : -boxes[i].extents.z);
+					boxes[i].rotation.rotate(corner);
+
+					if (box.contains(corner + boxes[i].center))
+						Assert::IsTrue(results[i], L"Box with a corner inside doesn't overlap");
+				}
+
+				overlapping += results[i] ? 1 : 0;
+			}
+
+			Assert::IsTrue(overlapping > 0 && overlapping < boxes.size(), L"Test data doesn't cover both outcomes");
+		}
+	};
+}
@@ -0,0 +1,160 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "reMath/reOcclusionBuffer.h"
+#include "reMath/reAABB.h"
+#include "reMath/reCamera.h"
+#include "reMath/reMathUtil.h"
+#include "reMath/reParallel.h"
+#include <cstdlib>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace re;
+
+namespace Test
+{
+	TEST_CLASS(OcclusionBufferUnitTest)
+	{
+	public:
+		TEST_METHOD(QuadOcclusionBufferTest)
+		{
+			// Camera at the origin looking along -Z, 90 degrees field of view.
+			const Matrix4 viewProjection = perspective(90.f, 1.f, 0.1f, 100.f) * lookAt(Vec3d(0.f), Vec3d(0.f, 0.f, -1.f), Vec3d(0.f, 1.f, 0.f));
+			const Vec3d quad[] = { Vec3d(-2.f, -2.f, 0.f), Vec3d(2.f, -2.f, 0.f), Vec3d(2.f, 2.f, 0.f), Vec3d(-2.f, 2.f, 0.f) };
+			const unsigned int front[] = { 0, 1, 2, 0, 2, 3 };
+			const unsigned int back[] = { 0, 2, 1, 0, 3, 2 };
+
+			Matrix4 world;
+			world.setTranslation(0.f, 0.f, -5.f);
+
+			OcclusionBuffer buffer(60, 60);
+			Assert::AreEqual(size_t(64), buffer.getWidth(), L"Width is not rounded up to tiles");
+
+			buffer.begin(viewProjection, 0.1f);
+			buffer.addOccluder(quad, 4, front, 2, world);
+			buffer.end();
+
+			Assert::AreEqual(0.2f, buffer.getDepth(32, 32), 0.00001f, L"Wrong occluder depth");
+			Assert::AreEqual(0.2f, buffer.getDepth(20, 44), 0.00001f, L"Wrong occluder depth");
+			Assert::AreEqual(0.f, buffer.getDepth(18, 32), L"Occluder is too large");
+			Assert::AreEqual(0.f, buffer.getDepth(32, 45), L"Occluder is too large");
+
+			Assert::IsFalse(buffer.isVisible(AABB(Vec3d(-1.f, -1.f, -9.f), Vec3d(1.f, 1.f, -7.f))), L"Box behind the occluder is visible");
+			Assert::IsTrue(buffer.isVisible(AABB(Vec3d(-1.f, -1.f, -4.f), Vec3d(1.f, 1.f, -3.f))), L"Box in front of the occluder is hidden");
+			Assert::IsTrue(buffer.isVisible(AABB(Vec3d(3.f, 3.f, -9.f), Vec3d(4.f, 4.f, -7.f))), L"Box beside the occluder is hidden");
+			Assert::IsTrue(buffer.isVisible(AABB(Vec3d(-3.f, -3.f, -8.f), Vec3d(3.f, 3.f, -7.f))), L"Box larger than the occluder is hidden");
+			Assert::IsTrue(buffer.isVisible(AABB(Vec3d(-1.f, -1.f, -1.f), Vec3d(1.f, 1.f, 1.f))), L"Box around the eye is hidden");
+			Assert::IsFalse(buffer.isVisible(AABB(Vec3d(-1.f, -1.f, 2.f), Vec3d(1.f, 1.f, 3.f))), L"Box behind the eye is visible");
+			Assert::IsFalse(buffer.isVisible(AABB(Vec3d(50.f, 0.f, -10.f), Vec3d(51.f, 1.f, -9.f))), L"Box outside the view is visible");
+
+			// Back faces are skipped unless the occluder is double-sided.
+			buffer.begin(viewProjection, 0.1f);
+			buffer.addOccluder(quad, 4, back, 2, world);
+			buffer.end();
+			Assert::AreEqual(0.f, buffer.getDepth(32, 32), L"Back face was drawn");
+			Assert::IsTrue(buffer.isVisible(AABB(Vec3d(-1.f, -1.f, -9.f), Vec3d(1.f, 1.f, -7.f))), L"Back face occludes");
+
+			Camera camera;
+			camera.lookAt(Vec3d(0.f), Vec3d(0.f, 0.f, -1.f), Vec3d(0.f, 1.f, 0.f));
+			camera.setPerspective(90.f, 1.f, 0.1f, 0.f);
+			camera.setDepthMode(Camera::DEPTH_REVERSED);
+			buffer.begin(camera);
+			buffer.addOccluder(quad, 4, back, 2, world, true);
+			buffer.end();
+			Assert::AreEqual(0.2f, buffer.getDepth(32, 32), 0.00001f, L"Double-sided occluder depth failed");
+			Assert::IsFalse(buffer.isVisible(AABB(Vec3d(-1.f, -1.f, -9.f), Vec3d(1.f, 1.f, -7.f))), L"Double-sided occluder failed");
+		}
+
+		TEST_METHOD(ClippingOcclusionBufferTest)
+		{
+			// Ground plane crossing the near and side planes, 1 / w at a pixel is -y of its view ray.
+			const Matrix4 viewProjection = perspective(90.f, 1.f, 0.1f, 100.f) * lookAt(Vec3d(0.f), Vec3d(0.f, 0.f, -1.f), Vec3d(0.f, 1.f, 0.f));
+			const Vec3d ground[] = { Vec3d(-100.f, -1.f, 100.f), Vec3d(100.f, -1.f, 100.f), Vec3d(100.f, -1.f, -100.f), Vec3d(-100.f, -1.f, -100.f) };
+			const unsigned int indices[] = { 0, 1, 2, 0, 2, 3 };
+
+			OcclusionBuffer buffer(64, 64);
+			buffer.begin(viewProjection, 0.1f);
+			buffer.addOccluder(ground, 4, indices, 2);
+			buffer.end();
+
+			for (size_t y = 0; y < 64; y++)
+			{
+				const float ray = (y + 0.5f) / 32.f - 1.f;
+
+				for (size_t x = 0; x < 64; x++)
+					Assert::AreEqual(ray < 0.f ? -ray : 0.f, buffer.getDepth(x, y), 0.0001f, L"Clipped plane depth failed");
+			}
+
+			Assert::IsFalse(buffer.isVisible(AABB(Vec3d(-1.f, -3.f, -10.f), Vec3d(1.f, -2.f, -8.f))), L"Box under the ground is visible");
+			Assert::IsTrue(buffer.isVisible(AABB(Vec3d(-1.f, -1.f, -10.f), Vec3d(1.f, 0.f, -8.f))), L"Box on the ground is hidden");
+		}
+
+		TEST_METHOD(ParallelOcclusionBufferTest)
+		{
+			srand(5);
+			auto random = [](float range) { return static_cast<float>(rand()) / RAND_MAX * range; };
+
+			// Random triangles around the view, many of them clipped.
+			std::vector<Vec3d> vertices;
+			std::vector<unsigned int> indices;
+
+			for (unsigned int i = 0; i < 5000; i++)
+			{
+				const Vec3d center(random(40.f) - 20.f, random(40.f) - 20.f, -random(40.f) + 1.f);
+
+				for (int k = 0; k < 3; k++)
+				{
+					indices.push_back(static_cast<unsigned int>(vertices.size()));
+					vertices.push_back(center + Vec3d(random(4.f) - 2.f, random(4.f) - 2.f, random(4.f) - 2.f));
+				}
+			}
+
+			std::vector<AABB> boxes;
+
+			for (int i = 0; i < 2000; i++)
+			{
+				const Vec3d center(random(60.f) - 30.f, random(60.f) - 30.f, -random(60.f));
+				boxes.push_back(AABB(center - Vec3d(random(1.f)), center + Vec3d(random(1.f))));
+			}
+
+			const Matrix4 viewProjection = perspective(60.f, 2.f, 0.5f, 100.f) * lookAt(Vec3d(0.f, 1.f, 3.f), Vec3d(0.f, 0.f, -10.f), Vec3d(0.f, 1.f, 0.f));
+
+			OcclusionBuffer serial(256, 128);
+			serial.begin(viewProjection, 0.5f);
+			serial.addOccluder(vertices.data(), vertices.size(), indices.data(), 2500, true);
+			serial.addOccluder(vertices.data(), vertices.size(), indices.data() + 7500, 2500, true);
+			serial.end();
+
+			ThreadPool pool(4);
+			setExecutor(&pool);
+
+			OcclusionBuffer parallel(256, 128);
+
+			for (int frame = 0; frame < 2; frame++)
+			{
+				parallel.begin(viewProjection, 0.5f);
+				parallel.addOccluder(vertices.data(), vertices.size(), indices.data(), 5000, true);
+				parallel.end();
+			}
+
+			bool visible[2000];
+			parallel.isVisibleN(boxes.data(), visible, boxes.size());
+
+			setExecutor(nullptr);
+
+			for (size_t y = 0; y < 128; y++)
+				for (size_t x = 0; x < 256; x++)
+					Assert::AreEqual(serial.getDepth(x, y), parallel.getDepth(x, y), L"Parallel rasterization differs");
+
+			size_t hidden = 0;
+
+			for (size_t i = 0; i < boxes.size(); i++)
+			{
+				Assert::AreEqual(serial.isVisible(boxes[i]), visible[i], L"Parallel visibility differs");
+				hidden += visible[i] ? 0 : 1;
+			}
+
+			Assert::IsTrue(hidden > 0 && hidden < boxes.size(), L"Unexpected visibility split");
+		}
+	};
+}
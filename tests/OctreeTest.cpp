@@ -0,0 +1,124 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "reMath/reOctree.h"
+#include "reMath/reCamera.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace re;
+
+namespace Test
+{
+	TEST_CLASS(OctreeUnitTest)
+	{
+	public:
+		TEST_METHOD(BasicOctreeTest)
+		{
+			Octree tree(AABB(Vec3d(0.f, 0.f, 0.f), Vec3d(100.f, 100.f, 100.f)));
+			Assert::AreEqual(static_cast<size_t>(1), tree.getNodeCount(), L"Empty tree has nodes besides root");
+
+			const unsigned int small = tree.insert(Vec3d(10.f, 10.f, 10.f), 0.1f);
+			const unsigned int large = tree.insert(Vec3d(30.f, 30.f, 30.f), 40.f);
+			const unsigned int outside = tree.insert(Vec3d(-50.f, 0.f, 0.f), 1.f);
+			Assert::AreEqual(static_cast<size_t>(3), tree.getObjectCount(), L"Object count incorrect");
+			Assert::IsTrue(tree.getNodeCount() > 1, L"Small object is not stored deeper");
+
+			std::vector<unsigned int> result;
+			tree.querySphere(Vec3d(10.f, 10.f, 11.f), 1.f, result);
+			std::sort(result.begin(), result.end());
+			Assert::AreEqual(static_cast<size_t>(2), result.size(), L"Sphere query result incorrect");
+			Assert::AreEqual(small, result[0], L"Sphere query result incorrect");
+			Assert::AreEqual(large, result[1], L"Sphere query result incorrect");
+
+			result.clear();
+			tree.querySphere(Vec3d(-50.f, 0.f, 0.f), 0.5f, result);
+			Assert::IsTrue(result.size() == 1 && result[0] == outside, L"Object outside of the bounds not found");
+
+			// Moving inside the cell keeps the node, removing everything releases the nodes.
+			const size_t nodes = tree.getNodeCount();
+			tree.move(small, Vec3d(10.01f, 10.f, 10.f), 0.1f);
+			Assert::AreEqual(nodes, tree.getNodeCount(), L"Move inside the cell changed nodes");
+			Assert::AreEqual(10.01f, tree.getPosition(small).x, L"Position not updated");
+
+			tree.remove(small);
+			tree.remove(large);
+			tree.remove(outside);
+			Assert::AreEqual(static_cast<size_t>(0), tree.getObjectCount(), L"Objects left after removal");
+			Assert::AreEqual(static_cast<size_t>(1), tree.getNodeCount(), L"Nodes left after removal");
+			Assert::AreEqual(outside, tree.insert(Vec3d(1.f, 1.f, 1.f), 1.f), L"Removed id is not reused");
+		}
+
+		TEST_METHOD(QueryOctreeTest)
+		{
+			srand(3);
+			auto random = [](float range) { return static_cast<float>(rand()) / RAND_MAX * range; };
+
+			Octree tree(AABB(Vec3d(-100.f, -100.f, -100.f), Vec3d(100.f, 100.f, 100.f)));
+			std::vector<unsigned int> ids;
+
+			for (int i = 0; i < 2000; i++)
+				ids.push_back(tree.insert(Vec3d(random(200.f) - 100.f, random(200.f) - 100.f, random(200.f) - 100.f), 0.1f + random(i % 50 ? 2.f : 30.f)));
+
+			Camera camera;
+			camera.lookAt(Vec3d(-20.f, 10.f, 90.f), Vec3d(10.f, 0.f, 0.f), Vec3d(0.f, 1.f, 0.f));
+			camera.setPerspective(60.f, 1.5f, 1.f, 120.f);
+
+			for (int frame = 0; frame < 3; frame++)
+			{
+				for (const auto id : ids)
+				{
+					const Vec3d offset(random(10.f) - 5.f, random(10.f) - 5.f, random(10.f) - 5.f);
+					tree.move(id, tree.getPosition(id) + offset, tree.getRadius(id));
+				}
+
+				std::vector<unsigned int> sphere;
+				std::vector<unsigned int> frustum;
+				std::vector<unsigned int> ray;
+				const Vec3d center(random(100.f) - 50.f, random(100.f) - 50.f, random(100.f) - 50.f);
+				const Vec3d origin(-120.f, random(40.f) - 20.f, random(40.f) - 20.f);
+				Vec3d direction(1.f, random(0.4f) - 0.2f, random(0.4f) - 0.2f);
+				direction.normalize();
+
+				tree.querySphere(center, 20.f, sphere);
+				tree.queryFrustum(camera, frustum);
+				tree.queryRay(origin, direction, 200.f, ray);
+				std::sort(sphere.begin(), sphere.end());
+				std::sort(frustum.begin(), frustum.end());
+				std::sort(ray.begin(), ray.end());
+
+				std::vector<unsigned int> expectedSphere;
+				std::vector<unsigned int> expectedFrustum;
+				std::vector<unsigned int> expectedRay;
+
+				for (const auto id : ids)
+				{
+					const Vec3d& position = tree.getPosition(id);
+					const float radius = tree.getRadius(id);
+
+					if (position.distanceTo(center) <= 20.f + radius)
+						expectedSphere.push_back(id);
+
+					if (camera.isSphereVisible(position, radius))
+						expectedFrustum.push_back(id);
+
+					const float t = std::max(0.f, std::min(200.f, (position - origin).dot(direction)));
+
+					if (position.distanceTo(origin + direction * t) <= radius)
+						expectedRay.push_back(id);
+				}
+
+				std::sort(expectedSphere.begin(), expectedSphere.end());
+				std::sort(expectedFrustum.begin(), expectedFrustum.end());
+				std::sort(expectedRay.begin(), expectedRay.end());
+
+				Assert::IsTrue(expectedSphere == sphere, L"Sphere query differs from brute force");
+				Assert::IsTrue(expectedFrustum == frustum, L"Frustum query differs from brute force");
+				Assert::IsTrue(expectedRay == ray, L"Ray query differs from brute force");
+				Assert::IsTrue(!sphere.empty() && !frustum.empty() && !ray.empty(), L"Test data doesn't cover the queries");
+			}
+		}
+	};
+}
@@ -0,0 +1,107 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "reMath/reParallel.h"
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace re;
+
+namespace Test
+{
+	TEST_CLASS(ParallelUnitTest)
+	{
+	public:
+		TEST_METHOD(BasicParallelTest)
+		{
+			// Serial executor is the default one.
+			Assert::AreEqual(static_cast<size_t>(1), getExecutor().concurrency(), L"Default executor is not serial");
+
+			// Chunks fit the cache but never go below the minimum size.
+			Assert::AreEqual(PARALLEL_MIN_CHUNK, chunkSize(1000000, 1000000, 8), L"Chunk size is below minimum");
+			Assert::AreEqual(static_cast<size_t>(5), chunkSize(5, 4, 8), L"Chunk size exceeds element count");
+			Assert::IsTrue(chunkSize(10000000, 16, 8) * 16 <= PARALLEL_CACHE_SIZE, L"Chunk size exceeds cache size");
+		}
+
+		TEST_METHOD(ThreadPoolParallelTest)
+		{
+			ThreadPool pool(4);
+			Assert::AreEqual(static_cast<size_t>(4), pool.concurrency(), L"Thread pool concurrency incorrect");
+			setExecutor(&pool);
+
+			// Every element is visited exactly once.
+			for (size_t count : { static_cast<size_t>(10), static_cast<size_t>(100000) })
+			{
+				std::vector<int> visits(count, 0);
+				parallelFor(count, sizeof(int), [&](size_t begin, size_t end)
+				{
+					for (size_t i = begin; i < end; i++)
+						visits[i]++;
+				});
+
+				for (size_t i = 0; i < count; i++)
+					Assert::AreEqual(1, visits[i], L"Element visited incorrect number of times");
+			}
+
+			// Nested loops run serially inside the workers.
+			std::vector<int> nested(64 * 2048, 0);
+			pool.run(64, [&](size_t task)
+			{
+				parallelFor(2048, sizeof(int), [&](size_t begin, size_t end)
+				{
+					for (size_t i = begin; i < end; i++)
+						nested[task * 2048 + i]++;
+				});
+			});
+
+			for (auto value : nested)
+				Assert::AreEqual(1, value, L"Nested parallel loop failed");
+
+			setExecutor(nullptr);
+		}
+
+		TEST_METHOD(RadixSortParallelTest)
+		{
+			ThreadPool pool(4);
+			setExecutor(&pool);
+
+			// Keys with few distinct values check stability, the payload is the original index.
+			std::vector<unsigned int> keys(50000);
+			std::vector<unsigned int> values(keys.size());
+
+			for (size_t i = 0; i < keys.size(); i++)
+			{
+				keys[i] = static_cast<unsigned int>((i * 2654435761u) % 1000) << 20;
+				values[i] = static_cast<unsigned int>(i);
+			}
+
+			const std::vector<unsigned int> original(keys);
+			radixSort(keys.data(), values.data(), keys.size());
+
+			for (size_t i = 0; i < keys.size(); i++)
+			{
+				Assert::AreEqual(original[values[i]], keys[i], L"Radix sort payload incorrect");
+
+				if (i > 0)
+				{
+					Assert::IsTrue(keys[i - 1] <= keys[i], L"Radix sort order incorrect");
+
+					if (keys[i - 1] == keys[i])
+						Assert::IsTrue(values[i - 1] < values[i], L"Radix sort is not stable");
+				}
+			}
+
+			setExecutor(nullptr);
+
+			unsigned int small[] = { 3, 1, 2 };
+			radixSort(small, nullptr, 3);
+			Assert::IsTrue(small[0] == 1 && small[1] == 2 && small[2] == 3, L"Serial radix sort incorrect");
+
+			// 64-bit keys differing only in the upper half.
+			unsigned long long wide[] = { 3ull << 40, 1ull << 40, 2ull << 40 | 1, 2ull << 40 };
+			unsigned int payload[] = { 0, 1, 2, 3 };
+			radixSort(wide, payload, 4);
+			Assert::IsTrue(wide[0] == 1ull << 40 && wide[1] == 2ull << 40 && wide[2] == (2ull << 40 | 1) && wide[3] == 3ull << 40, L"64-bit radix sort incorrect");
+			Assert::IsTrue(payload[0] == 1 && payload[1] == 3 && payload[2] == 2 && payload[3] == 0, L"64-bit radix sort payload incorrect");
+		}
+	};
+}
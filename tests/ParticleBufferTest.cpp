@@ -0,0 +1,179 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "reMath/reParticleBuffer.h"
+#include "reMath/reParallel.h"
+#include <cmath>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace re;
+
+namespace Test
+{
+	TEST_CLASS(ParticleBufferUnitTest)
+	{
+	public:
+		TEST_METHOD(MotionParticleBufferTest)
+		{
+			ParticleBuffer buffer(1003);
+			Assert::AreEqual(size_t(1003), buffer.getCapacity(), L"Wrong particle capacity");
+
+			for (int i = 0; i < 1003; i++)
+				Assert::IsTrue(buffer.emit(Vec3d(i * 0.1f, 50.f, 0.f), Vec3d(1.f, 2.f, -1.f), i, 100.f), L"Particle emit failed");
+
+			Assert::IsFalse(buffer.emit(Vec3d(0.f), Vec3d(0.f), 0, 1.f), L"Full buffer accepted a particle");
+
+			ThreadPool pool(4);
+			setExecutor(&pool);
+
+			// Semi-implicit Euler under gravity and drag in one update and in separate kernels.
+			ParticleBuffer separate(buffer);
+			ParticleForces forces;
+			forces.gravity.set(0.f, -10.f, 0.f);
+			forces.drag = 0.5f;
+			const float step = 0.01f;
+
+			for (int i = 0; i < 100; i++)
+			{
+				buffer.update(forces, step);
+				separate.applyGravity(forces.gravity, step);
+				separate.applyDrag(forces.drag, step);
+				separate.integrate(step);
+			}
+
+			setExecutor(nullptr);
+
+			Vec3d velocity(1.f, 2.f, -1.f);
+			Vec3d offset(0.f);
+			const float damping = expf(-forces.drag * step);
+
+			for (int i = 0; i < 100; i++)
+			{
+				velocity = (velocity + forces.gravity * step) * damping;
+				offset += velocity * step;
+			}
+
+			for (size_t i = 0; i < buffer.getCount(); i++)
+			{
+				Assert::IsTrue(buffer.getVelocity(i).distanceTo(velocity) < 0.0001f, L"Particle velocity failed");
+				Assert::IsTrue(buffer.getPosition(i).distanceTo(Vec3d(i * 0.1f, 50.f, 0.f) + offset) < 0.001f, L"Particle position failed");
+				Assert::IsTrue(buffer.getPosition(i) == separate.getPosition(i), L"Update differs from separate kernels");
+				Assert::AreEqual(1.f, buffer.getAge(i), 0.0001f, L"Particle age failed");
+				Assert::AreEqual(static_cast<unsigned int>(i), buffer.getColor(i), L"Particle color failed");
+			}
+		}
+
+		TEST_METHOD(CollisionParticleBufferTest)
+		{
+			ParticleBuffer buffer(50);
+
+			for (int i = 0; i < 50; i++)
+				buffer.emit(Vec3d(i * 0.2f - 5.f, 2.f + i * 0.05f, 0.3f), Vec3d(0.5f, -3.f, 0.f), 0, 100.f);
+
+			// Ground plane with a sphere lying on it.
+			const float ground[] = { 0.f, 1.f, 0.f, 0.f };
+			const Vec3d center(0.f, 0.5f, 0.f);
+			const float radius = 1.f;
+
+			ParticleForces forces;
+			forces.gravity.set(0.f, -10.f, 0.f);
+			forces.planes = ground;
+			forces.planeCount = 1;
+			forces.sphereCenters = &center;
+			forces.sphereRadii = &radius;
+			forces.sphereCount = 1;
+			forces.restitution = 0.5f;
+			forces.friction = 0.1f;
+
+			bool bounced = false;
+
+			for (int step = 0; step < 300; step++)
+			{
+				buffer.update(forces, 0.01f);
+
+				for (size_t i = 0; i < buffer.getCount(); i++)
+				{
+					const Vec3d position = buffer.getPosition(i);
+					Assert::IsTrue(position.y >= -0.00001f, L"Particle below the plane");
+					Assert::IsTrue(position.distanceTo(center) >= radius - 0.0001f, L"Particle inside the sphere");
+					bounced = bounced || buffer.getVelocity(i).y > 0.f;
+				}
+			}
+
+			Assert::IsTrue(bounced, L"No particle bounced");
+
+			// Single collider kernels: a particle moving into the plane is reflected with restitution and friction.
+			ParticleBuffer single(1);
+			single.emit(Vec3d(0.f, -0.5f, 0.f), Vec3d(2.f, -4.f, 0.f), 0, 1.f);
+			single.collidePlane(ground, 0.5f, 0.25f);
+			Assert::IsTrue(single.getPosition(0).distanceTo(Vec3d(0.f)) < 0.000001f, L"Plane push out failed");
+			Assert::IsTrue(single.getVelocity(0).distanceTo(Vec3d(1.5f, 2.f, 0.f)) < 0.000001f, L"Plane reflection failed");
+
+			single.collideSphere(Vec3d(0.f, -1.f, 0.f), 2.f, 1.f, 0.f);
+			Assert::IsTrue(single.getPosition(0).distanceTo(Vec3d(0.f, 1.f, 0.f)) < 0.00001f, L"Sphere push out failed");
+			Assert::IsTrue(single.getVelocity(0).distanceTo(Vec3d(1.5f, 2.f, 0.f)) < 0.00001f, L"Receding particle was reflected");
+		}
+
+		TEST_METHOD(CurlNoiseParticleBufferTest)
+		{
+			// Finite difference divergence of the velocity change is zero, the field is not.
+			const float h = 0.01f;
+			const Vec3d offsets[] = { Vec3d(h, 0.f, 0.f), Vec3d(-h, 0.f, 0.f), Vec3d(0.f, h, 0.f), Vec3d(0.f, -h, 0.f), Vec3d(0.f, 0.f, h), Vec3d(0.f, 0.f, -h), Vec3d(0.f) };
+			float magnitude = 0.f;
+
+			for (int sample = 0; sample < 20; sample++)
+			{
+				const Vec3d point(sinf(sample * 1.3f) * 4.f, cosf(sample * 0.7f) * 3.f, sample * 0.4f - 4.f);
+				ParticleBuffer buffer(7);
+
+				for (const Vec3d& offset : offsets)
+					buffer.emit(point + offset, Vec3d(0.f), 0, 1.f);
+
+				buffer.applyCurlNoise(2.f, 0.8f, 1.5f, 1.f);
+				const float divergence = (buffer.getVelocity(0).x - buffer.getVelocity(1).x + buffer.getVelocity(2).y - buffer.getVelocity(3).y +
+					buffer.getVelocity(4).z - buffer.getVelocity(5).z) / (2.f * h);
+
+				Assert::AreEqual(0.f, divergence, 0.01f, L"Curl noise is not divergence-free");
+				magnitude += buffer.getVelocity(6).length();
+
+				// Particles 0 - 3 take the SSE path, the last ones the scalar one.
+				Assert::IsTrue(buffer.getVelocity(6).distanceTo(buffer.getVelocity(0)) < 0.05f, L"Curl noise is not smooth");
+			}
+
+			Assert::IsTrue(magnitude / 20.f > 0.5f && magnitude / 20.f < 6.f, L"Curl noise strength is off");
+
+			ParticleBuffer lanes(5);
+
+			for (int i = 0; i < 5; i++)
+				lanes.emit(Vec3d(1.f, 2.f, 3.f), Vec3d(0.f), 0, 1.f);
+
+			lanes.applyCurlNoise(2.f, 0.8f, 1.5f, 1.f);
+			Assert::IsTrue(lanes.getVelocity(0).distanceTo(lanes.getVelocity(4)) < 0.00001f, L"SSE curl noise differs");
+		}
+
+		TEST_METHOD(CompactParticleBufferTest)
+		{
+			ParticleBuffer buffer(2000);
+
+			for (int i = 0; i < 2000; i++)
+				buffer.emit(Vec3d(static_cast<float>(i)), Vec3d(0.f), i, i % 3 ? 10.f : 0.5f);
+
+			buffer.integrate(1.f);
+			Assert::AreEqual(size_t(667), buffer.compact(), L"Wrong number of removed particles");
+			Assert::AreEqual(size_t(1333), buffer.getCount(), L"Wrong particle count after compaction");
+
+			// Living particles keep their order and attributes.
+			unsigned int expected = 1;
+
+			for (size_t i = 0; i < buffer.getCount(); i++)
+			{
+				Assert::AreEqual(expected, buffer.getColor(i), L"Compaction broke the order");
+				Assert::AreEqual(static_cast<float>(expected), buffer.getStream(ParticleBuffer::STREAM_POSITION_Y)[i], L"Compaction mixed attributes");
+				expected += expected % 3 == 1 ? 1 : 2;
+			}
+
+			Assert::AreEqual(size_t(0), buffer.compact(), L"Second compaction removed particles");
+			buffer.clear();
+			Assert::AreEqual(size_t(0), buffer.getCount(), L"Clear failed");
+		}
+	};
+}
@@ -0,0 +1,147 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "reMath/rePlane.h"
+#include "reMath/reSphere.h"
+#include "reMath/reMatrix4.h"
+#include "reMath/reCamera.h"
+#include "reMath/reParallel.h"
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace re;
+
+namespace Test
+{
+	TEST_CLASS(PlaneUnitTest)
+	{
+	public:
+		TEST_METHOD(ConstructionPlaneTest)
+		{
+			const Plane plane = Plane::fromPoints(Vec3d(0.f, 0.f, 1.f), Vec3d(2.f, 0.f, 1.f), Vec3d(0.f, 3.f, 1.f));
+			Assert::IsTrue(plane.normal.distanceTo(Vec3d(0.f, 0.f, 1.f)) < 0.000001f, L"Plane normal failed");
+			Assert::AreEqual(-1.f, plane.d, 0.000001f, L"Plane offset failed");
+			Assert::AreEqual(2.f, plane.distance(Vec3d(5.f, 5.f, 3.f)), 0.000001f, L"Plane distance failed");
+			Assert::IsTrue(plane.project(Vec3d(5.f, 5.f, 3.f)).distanceTo(Vec3d(5.f, 5.f, 1.f)) < 0.000001f, L"Plane projection failed");
+
+			Plane scaled(Vec3d(0.f, 0.f, 4.f), -4.f);
+			scaled.normalize();
+			Assert::IsTrue(scaled.normal == plane.normal && scaled.d == plane.d, L"Plane normalization failed");
+
+			// Least squares fit of noisy points, z = 0.5 x - 0.2 y + 3.
+			srand(7);
+			auto random = [](float range) { return static_cast<float>(rand()) / RAND_MAX * range; };
+			std::vector<Vec3d> points;
+
+			for (int i = 0; i < 200; i++)
+			{
+				const float x = random(20.f) - 10.f;
+				const float y = random(20.f) - 10.f;
+				points.push_back(Vec3d(x, y, 0.5f * x - 0.2f * y + 3.f + random(0.02f) - 0.01f));
+			}
+
+			const Plane fitted = Plane::fromPoints(points.data(), points.size());
+			Vec3d expected(0.5f, -0.2f, -1.f);
+			expected.normalize();
+			Assert::AreEqual(1.f, fabsf(fitted.normal.dot(expected)), 0.0001f, L"Fitted plane normal failed");
+
+			for (const Vec3d& point : points)
+				Assert::AreEqual(0.f, fitted.distance(point), 0.02f, L"Fitted plane distance failed");
+
+			// Frustum planes convert directly.
+			Camera camera;
+			camera.lookAt(Vec3d(0.f, 0.f, 5.f), Vec3d(0.f), Vec3d(0.f, 1.f, 0.f));
+			const Plane nearPlane(camera.getFrustumPlane(Camera::PLANE_NEAR));
+			Assert::AreEqual(1.f - camera.getNear(), nearPlane.distance(Vec3d(0.f, 0.f, 4.f)), 0.0001f, L"Frustum plane conversion failed");
+
+			float distance = 0.f;
+			Assert::IsTrue(plane.intersectsRay(Vec3d(1.f, 1.f, 5.f), Vec3d(0.f, 0.f, -2.f), distance), L"Ray missed the plane");
+			Assert::AreEqual(2.f, distance, 0.000001f, L"Ray distance failed");
+			Assert::IsFalse(plane.intersectsRay(Vec3d(1.f, 1.f, 5.f), Vec3d(0.f, 0.f, 2.f), distance), L"Ray pointing away hit the plane");
+			Assert::IsFalse(plane.intersectsRay(Vec3d(1.f, 1.f, 5.f), Vec3d(1.f, 0.f, 0.f), distance), L"Parallel ray hit the plane");
+
+			Assert::AreEqual(static_cast<int>(Plane::SIDE_FRONT), static_cast<int>(plane.classify(Sphere(Vec3d(0.f, 0.f, 3.f), 1.5f))), L"Sphere in front failed");
+			Assert::AreEqual(static_cast<int>(Plane::SIDE_BACK), static_cast<int>(plane.classify(Sphere(Vec3d(0.f, 0.f, -3.f), 1.5f))), L"Sphere behind failed");
+			Assert::AreEqual(static_cast<int>(Plane::SIDE_SPANNING), static_cast<int>(plane.classify(Sphere(Vec3d(0.f, 0.f, 2.f), 1.5f))), L"Sphere spanning failed");
+
+			// Empty spheres are classified as their center point.
+			Assert::AreEqual(static_cast<int>(Plane::SIDE_FRONT), static_cast<int>(plane.classify(Sphere(Vec3d(0.f, 0.f, 1.5f), -1.f))), L"Empty sphere in front failed");
+			Assert::AreEqual(static_cast<int>(Plane::SIDE_BACK), static_cast<int>(plane.classify(Sphere(Vec3d(0.f, 0.f, 0.5f), -1.f))), L"Empty sphere behind failed");
+			Assert::AreEqual(static_cast<int>(Plane::SIDE_ON), static_cast<int>(plane.classify(Sphere(Vec3d(2.f, 3.f, 1.f), -1.f))), L"Empty sphere on the plane failed");
+		}
+
+		TEST_METHOD(TransformPlaneTest)
+		{
+			// Affine matrices with shear, non-uniform scale and a mirror.
+			const float shear[] = { 2.f, 0.5f, 0.f, 0.f, 0.3f, 1.f, -0.4f, 0.f, 0.f, 0.2f, 3.f, 0.f, 1.f, -2.f, 5.f, 1.f };
+			const float mirror[] = { -1.f, 0.f, 0.f, 0.f, 0.f, 2.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 3.f, 0.f, 0.f, 1.f };
+
+			auto apply = [](const float* m, const Vec3d& p)
+			{
+				return Vec3d(p.x * m[0] + p.y * m[4] + p.z * m[8] + m[12], p.x * m[1] + p.y * m[5] + p.z * m[9] + m[13], p.x * m[2] + p.y * m[6] + p.z * m[10] + m[14]);
+			};
+
+			for (const float* m : { shear, mirror })
+			{
+				const Matrix4 matrix(m);
+				Plane plane = Plane::fromPoints(Vec3d(1.f, 0.f, 0.f), Vec3d(0.f, 2.f, 0.f), Vec3d(0.f, 0.f, 3.f));
+				const Vec3d onPlane[] = { Vec3d(1.f, 0.f, 0.f), Vec3d(0.5f, 1.f, 0.f), Vec3d(0.2f, 0.4f, 1.8f) };
+				const Vec3d front(2.f, 2.f, 2.f);
+
+				Plane planes[] = { plane, plane };
+				plane.transform(matrix);
+				Plane::transformN(matrix, planes, 2);
+
+				Assert::AreEqual(1.f, plane.normal.length(), 0.00001f, L"Transformed plane is not normalized");
+				Assert::IsTrue(planes[1].normal.distanceTo(plane.normal) < 0.000001f && fabsf(planes[1].d - plane.d) < 0.000001f, L"Batch plane transform differs");
+
+				for (const Vec3d& point : onPlane)
+					Assert::AreEqual(0.f, plane.distance(apply(m, point)), 0.00001f, L"Transformed point is off the plane");
+
+				Assert::IsTrue(plane.distance(apply(m, front)) > 0.f, L"Transformed plane flipped");
+			}
+		}
+
+		TEST_METHOD(BatchPlaneTest)
+		{
+			srand(11);
+			auto random = [](float range) { return static_cast<float>(rand()) / RAND_MAX * range; };
+
+			std::vector<Vec3d> points;
+
+			for (int i = 0; i < 100003; i++)
+				points.push_back(Vec3d(random(10.f) - 5.f, random(10.f) - 5.f, random(10.f) - 5.f));
+
+			Plane plane(Vec3d(1.f, -2.f, 0.5f), 0.7f);
+			plane.normalize();
+
+			ThreadPool pool(4);
+			setExecutor(&pool);
+
+			std::vector<float> distances(points.size());
+			Plane::distanceN(plane, points.data(), points.size(), distances.data());
+
+			for (size_t i = 0; i < points.size(); i++)
+				Assert::AreEqual(plane.distance(points[i]), distances[i], 0.00001f, L"Batch distance failed");
+
+			Assert::AreEqual(static_cast<int>(Plane::SIDE_SPANNING), static_cast<int>(Plane::classifyN(plane, points.data(), points.size())), L"Cloud does not span the plane");
+
+			setExecutor(nullptr);
+
+			// Polygons, the last point of five takes the scalar path.
+			std::vector<Vec3d> polygon;
+
+			for (int i = 0; i < 5; i++)
+				polygon.push_back(plane.project(points[i]) + plane.normal * 0.001f);
+
+			Assert::AreEqual(static_cast<int>(Plane::SIDE_FRONT), static_cast<int>(Plane::classifyN(plane, polygon.data(), polygon.size())), L"Polygon in front failed");
+			Assert::AreEqual(static_cast<int>(Plane::SIDE_ON), static_cast<int>(Plane::classifyN(plane, polygon.data(), polygon.size(), 0.01f)), L"Polygon on the plane failed");
+
+			polygon[0] += plane.normal * 0.1f;
+			polygon[4] -= plane.normal * 0.1f;
+			Assert::AreEqual(static_cast<int>(Plane::SIDE_SPANNING), static_cast<int>(Plane::classifyN(plane, polygon.data(), polygon.size(), 0.01f)), L"Spanning polygon failed");
+			Assert::AreEqual(static_cast<int>(Plane::SIDE_BACK), static_cast<int>(Plane::classifyN(plane, polygon.data() + 4, 1, 0.01f)), L"Point behind failed");
+		}
+	};
+}
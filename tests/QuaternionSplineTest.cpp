@@ -0,0 +1,115 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "reMath/reQuaternionSpline.h"
+#include "reMath/reVec3d.h"
+#include <cmath>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace re;
+
+namespace Test
+{
+	namespace
+	{
+		std::vector<Quaternion> createKeys()
+		{
+			std::vector<Quaternion> keys;
+
+			for (int i = 0; i < 8; i++)
+			{
+				Vec3d axis(sinf(i * 1.1f), 1.f, cosf(i * 0.7f));
+				axis.normalize();
+				Quaternion key = Quaternion::fromAxisAngle(axis, i * 0.6f);
+
+				// Sign flips must not change the curve.
+				if (i % 3 == 2)
+					key.negate();
+
+				keys.push_back(key);
+			}
+
+			return keys;
+		}
+
+		// Angular distance between two rotations.
+		float angleBetween(const Quaternion& first, const Quaternion& second)
+		{
+			const float cosine = fabsf(first.dot(second));
+			return 2.f * acosf(cosine > 1.f ? 1.f : cosine);
+		}
+
+		// Angular velocity left and right of a time must match for a C1 curve.
+		void checkContinuity(const QuaternionSpline& spline, float time)
+		{
+			const float step = 0.001f;
+			const Quaternion center = spline.evaluate(time);
+			const Quaternion left = (spline.evaluate(time - step).toConjugated() * center).log();
+			const Quaternion right = (center.toConjugated() * spline.evaluate(time + step)).log();
+			Assert::IsTrue((left - right).length() < 0.0005f, L"Spline is not C1 continuous");
+		}
+	}
+
+	TEST_CLASS(QuaternionSplineUnitTest)
+	{
+	public:
+		TEST_METHOD(SquadSplineTest)
+		{
+			const std::vector<Quaternion> keys = createKeys();
+			const QuaternionSpline spline(keys.data(), keys.size());
+			Assert::AreEqual(keys.size(), spline.getKeyCount(), L"Wrong key count");
+
+			for (size_t i = 0; i < keys.size(); i++)
+				Assert::IsTrue(angleBetween(keys[i], spline.evaluate(static_cast<float>(i))) < 0.001f, L"SQUAD misses a key");
+
+			for (int i = 1; i < 7; i++)
+				checkContinuity(spline, static_cast<float>(i));
+
+			// Out of range times are clamped.
+			Assert::IsTrue(angleBetween(keys.back(), spline.evaluate(100.f)) < 0.001f, L"SQUAD end clamp failed");
+		}
+
+		TEST_METHOD(BSplineTest)
+		{
+			const std::vector<Quaternion> keys = createKeys();
+			const QuaternionSpline spline(keys.data(), keys.size(), QuaternionSpline::INTERPOLATION_BSPLINE);
+
+			for (int i = 1; i < 7; i++)
+				checkContinuity(spline, static_cast<float>(i));
+
+			// Approximating curve stays close to the keys.
+			for (size_t i = 0; i < keys.size(); i++)
+				Assert::IsTrue(angleBetween(keys[i], spline.evaluate(static_cast<float>(i))) < 0.5f, L"B-spline is too far from a key");
+
+			// Batch evaluation matches the single one.
+			std::vector<float> times;
+
+			for (int i = 0; i <= 700; i++)
+				times.push_back(i * 0.01f);
+
+			std::vector<Quaternion> batch(times.size());
+			spline.evaluateN(times.data(), batch.data(), times.size());
+
+			for (size_t i = 0; i < times.size(); i++)
+			{
+				Assert::IsTrue(spline.evaluate(times[i]) == batch[i], L"Batch evaluation differs");
+				Assert::AreEqual(1.f, batch[i].length(), 0.000001f, L"Spline rotation is not normalized");
+			}
+		}
+
+		TEST_METHOD(DegenerateSplineTest)
+		{
+			const QuaternionSpline empty(nullptr, 0);
+			Assert::IsTrue(Quaternion() == empty.evaluate(0.5f), L"Empty spline is not identity");
+
+			const Quaternion key = Quaternion::fromEulerYRotation(0.5f);
+			const QuaternionSpline single(&key, 1, QuaternionSpline::INTERPOLATION_BSPLINE);
+			Assert::IsTrue(key == single.evaluate(0.5f), L"Single key spline failed");
+
+			// Identical keys give a constant curve.
+			const Quaternion same[] = { key, key, key };
+			const QuaternionSpline constant(same, 3);
+			Assert::IsTrue(angleBetween(key, constant.evaluate(1.3f)) < 0.0001f, L"Constant spline failed");
+		}
+	};
+}
@@ -1,6 +1,11 @@
 #include "stdafx.h"
 #include "CppUnitTest.h"
 #include "reMath/reQuaternion.h"
+#include "reMath/reVec3d.h"
+#include "reMath/reMatrix3.h"
+#include "reMath/reMatrix4.h"
+#include "reMath/reMathUtil.h"
+#include <cmath>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace re;
@@ -14,6 +19,128 @@ namespace Test
 		{
 			Quaternion q1(2.f, 3.f, 4.f, 5.f);
 			Assert::AreEqual(7.3484692283495342945918522241177f, q1.length(), L"Quaternion magnitutde incorrect");
+			Assert::AreEqual(54.f, q1.lengthSquared(), L"Quaternion squared magnitutde incorrect");
+
+			// Fast normalize.
+			q1.normalizeFast();
+			Assert::AreEqual(1.f, q1.length(), 0.0000005f, L"Quaternion fast normalization failed");
+
+			Quaternion q2(0.f, 0.f, 0.f, 0.f);
+			q2.normalizeFast();
+			Assert::IsTrue(Quaternion() == q2, L"Zero quaternion fast normalization failed");
+		}
+
+		TEST_METHOD(FromMatrixQuaternionTest)
+		{
+			// Angles close to 180 degrees around each axis select every case of Shepperd's method.
+			const Quaternion rotations[] = {
+				Quaternion(),
+				Quaternion(0.1f, 0.2f, 0.3f, 0.9f),
+				Quaternion(0.99f, 0.1f, 0.05f, 0.01f),
+				Quaternion(0.05f, -0.99f, 0.1f, 0.02f),
+				Quaternion(0.1f, 0.05f, 0.99f, -0.01f),
+				Quaternion(1.f, 0.f, 0.f, 0.f) };
+
+			for (Quaternion rotation : rotations)
+			{
+				rotation.normalize();
+				const Matrix4 matrix = rotation.getMatrix();
+				const Quaternion fromMatrix4 = Quaternion::fromMatrix(matrix);
+				const Quaternion fromMatrix3 = Quaternion::fromMatrix(Matrix3(matrix));
+
+				Assert::AreEqual(1.f, fabsf(rotation.dot(fromMatrix4)), 0.000001f, L"Quaternion from Matrix4 failed");
+				Assert::IsTrue(fromMatrix3 == fromMatrix4, L"Quaternion from Matrix3 differs from Matrix4");
+			}
+		}
+
+		TEST_METHOD(RotateQuaternionTest)
+		{
+			Quaternion rotation(0.3f, -0.5f, 0.2f, 0.7f);
+			rotation.normalize();
+
+			Vec3d vector(1.f, -2.f, 3.f);
+			Vec3d expected(vector);
+			rotation.getMatrix().rotate(expected);
+			rotation.rotate(vector);
+			Assert::IsTrue(vector.distanceTo(expected) < 0.00001f, L"Quaternion vector rotation failed");
+
+			// Quarter turn around Z maps X to Y.
+			float axis[] = { 1.f, 0.f, 0.f };
+			Quaternion::fromEulerZRotation(1.5707963f).rotate(axis);
+			Assert::AreEqual(0.f, axis[0], 0.000001f, L"Quaternion quarter turn failed");
+			Assert::AreEqual(1.f, axis[1], 0.000001f, L"Quaternion quarter turn failed");
+		}
+
+		TEST_METHOD(ConstructorsQuaternionTest)
+		{
+			const Quaternion axisAngle = Quaternion::fromAxisAngle(Vec3d(0.f, 0.f, 1.f), 1.2f);
+			const Quaternion euler = Quaternion::fromEulerZRotation(1.2f);
+			Assert::AreEqual(1.f, axisAngle.dot(euler), 0.000001f, L"Axis angle quaternion failed");
+
+			// Shortest arc for generic, equal and opposite directions.
+			const Vec3d directions[][2] = {
+				{ Vec3d(1.f, 2.f, 3.f), Vec3d(-2.f, 0.5f, 1.f) },
+				{ Vec3d(0.f, 3.f, 0.f), Vec3d(0.f, 1.f, 0.f) },
+				{ Vec3d(1.f, 2.f, 3.f), Vec3d(-2.f, -4.f, -6.f) },
+				{ Vec3d(0.f, 0.f, 1.f), Vec3d(0.f, 0.f, -1.f) } };
+
+			for (const auto& pair : directions)
+			{
+				const Quaternion rotation = Quaternion::fromTo(pair[0], pair[1]);
+				Vec3d from(pair[0]);
+				Vec3d to(pair[1]);
+				from.normalize();
+				to.normalize();
+				rotation.rotate(from);
+				Assert::IsTrue(from.distanceTo(to) < 0.00001f, L"Shortest arc quaternion failed");
+			}
+
+			// Look rotation turns -Z to forward and keeps Y in the up plane.
+			const Vec3d forward(1.f, -0.5f, 2.f);
+			const Quaternion look = Quaternion::lookRotation(forward, Vec3d(0.f, 1.f, 0.f));
+			Vec3d lookAxis(0.f, 0.f, -1.f);
+			Vec3d upAxis(0.f, 1.f, 0.f);
+			look.rotate(lookAxis);
+			look.rotate(upAxis);
+			Vec3d direction(forward);
+			direction.normalize();
+			Assert::IsTrue(lookAxis.distanceTo(direction) < 0.00001f, L"Look rotation forward failed");
+			Assert::AreEqual(0.f, upAxis.cross(direction).y, 0.00001f, L"Look rotation up failed");
+			Assert::IsTrue(upAxis.y > 0.f, L"Look rotation up is flipped");
+		}
+
+		TEST_METHOD(AlgebraQuaternionTest)
+		{
+			Quaternion q(0.3f, -0.5f, 0.2f, 0.7f);
+			const Quaternion identity = q * q.toInversed();
+			Assert::AreEqual(1.f, identity.w, 0.000001f, L"Quaternion inverse failed");
+			Assert::AreEqual(0.f, identity.x * identity.x + identity.y * identity.y + identity.z * identity.z, 0.000001f, L"Quaternion inverse failed");
+
+			q.normalize();
+			Assert::IsTrue((q.toConjugated() - q.toInversed()).length() < 0.000001f, L"Quaternion conjugate failed");
+
+			// Logarithm of a normalized quaternion is half the rotation vector, exp() reverts it.
+			const Quaternion logarithm = Quaternion::fromAxisAngle(Vec3d(1.f, 0.f, 0.f), 0.8f).log();
+			Assert::AreEqual(0.4f, logarithm.x, 0.000001f, L"Quaternion logarithm failed");
+			Assert::AreEqual(0.f, logarithm.w, 0.000001f, L"Quaternion logarithm failed");
+			Assert::IsTrue((q.log().exp() - q).length() < 0.000001f, L"Quaternion exponent failed");
+			Assert::IsTrue(Quaternion(0.f, 0.f, 0.f, 0.f).exp() == Quaternion(), L"Zero quaternion exponent failed");
+
+			// Near -identity the logarithm is a half turn and still reverts.
+			const Quaternion negative(1e-8f, 0.f, 0.f, -1.f);
+			Assert::AreEqual(PI, negative.log().x, 0.000001f, L"Quaternion logarithm near -identity failed");
+			Assert::IsTrue((negative.log().exp() - negative).length() < 0.000001f, L"Quaternion exponent near -identity failed");
+			const Quaternion flipped(0.f, 0.f, 0.f, -1.f);
+			Assert::IsTrue((flipped.log().exp() - flipped).length() < 0.000001f, L"Quaternion exponent of -identity failed");
+
+			// Swing and twist recombine into the original rotation, twist stays around the axis.
+			const Vec3d axis(0.f, 1.f, 0.f);
+			Quaternion swing, twist;
+			q.swingTwist(axis, swing, twist);
+			Assert::IsTrue((swing * twist - q).length() < 0.000001f, L"Swing twist decomposition failed");
+			Assert::AreEqual(0.f, twist.x, 0.000001f, L"Twist is not around the axis");
+			Assert::AreEqual(0.f, twist.z, 0.000001f, L"Twist is not around the axis");
+			Assert::AreEqual(0.f, swing.y, 0.000001f, L"Swing has a twist component");
 		}
 	};
 }
@@ -0,0 +1,146 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "reMath/reSphere.h"
+#include "reMath/reMatrix4.h"
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace re;
+
+namespace Test
+{
+	TEST_CLASS(SphereUnitTest)
+	{
+	public:
+		TEST_METHOD(MinimalSphereTest)
+		{
+			srand(13);
+			auto random = [](float range) { return static_cast<float>(rand()) / RAND_MAX * range; };
+			auto randomInBall = [&random](float radius)
+			{
+				Vec3d point;
+
+				do
+					point.set(random(2.f) - 1.f, random(2.f) - 1.f, random(2.f) - 1.f);
+				while (point.lengthSquared() > 1.f);
+
+				return point * radius;
+			};
+
+			// Minimal spheres supported by two, three and four points among interior points.
+			const float side = sqrtf(8.f / 9.f);
+			const Vec3d supports[][4] = {
+				{ Vec3d(2.f, 0.f, 0.f), Vec3d(-2.f, 0.f, 0.f), Vec3d(0.f), Vec3d(0.f) },
+				{ Vec3d(2.f, 0.f, 0.f), Vec3d(-1.f, sqrtf(3.f), 0.f), Vec3d(-1.f, -sqrtf(3.f), 0.f), Vec3d(0.f) },
+				{ Vec3d(0.f, 0.f, 2.f), Vec3d(2.f * side, 0.f, -2.f / 3.f), Vec3d(-side, sqrtf(2.f / 3.f) * 2.f, -2.f / 3.f), Vec3d(-side, -sqrtf(2.f / 3.f) * 2.f, -2.f / 3.f) }
+			};
+
+			for (int support = 0; support < 3; support++)
+			{
+				std::vector<Vec3d> points;
+
+				for (int i = 0; i < 500; i++)
+				{
+					// Interior points stay clear of the sphere of radius 2, also in the flat triangle case.
+					Vec3d point = randomInBall(1.5f);
+					point.z *= support == 1 ? 0.3f : 1.f;
+					points.push_back(point + Vec3d(1.f, -3.f, 2.f));
+				}
+
+				for (int i = 0; i < support + 2; i++)
+					points.insert(points.begin() + i * 97, supports[support][i] + Vec3d(1.f, -3.f, 2.f));
+
+				const Sphere minimal = Sphere::fromPointsMinimal(points.data(), points.size());
+				Assert::IsTrue(minimal.center.distanceTo(Vec3d(1.f, -3.f, 2.f)) < 0.0001f, L"Minimal sphere center failed");
+				Assert::AreEqual(2.f, minimal.radius, 0.0001f, L"Minimal sphere radius failed");
+
+				const Sphere ritter = Sphere::fromPoints(points.data(), points.size());
+				Assert::IsTrue(ritter.radius >= minimal.radius - 0.0001f && ritter.radius < minimal.radius * 1.25f, L"Ritter sphere size failed");
+
+				for (const Vec3d& point : points)
+					Assert::IsTrue(ritter.center.distanceTo(point) <= ritter.radius * 1.00001f, L"Ritter sphere misses a point");
+			}
+
+			// Random clouds: every point is inside, the minimal sphere is not larger than Ritter's.
+			for (int cloud = 0; cloud < 20; cloud++)
+			{
+				std::vector<Vec3d> points;
+
+				for (int i = 0; i < 10 + cloud * 20; i++)
+					points.push_back(Vec3d(random(10.f), random(4.f), random(cloud % 2 ? 0.f : 6.f)));
+
+				const Sphere minimal = Sphere::fromPointsMinimal(points.data(), points.size());
+				const Sphere ritter = Sphere::fromPoints(points.data(), points.size());
+				Assert::IsTrue(minimal.radius <= ritter.radius * 1.0001f, L"Minimal sphere is larger than Ritter's");
+
+				size_t boundary = 0;
+
+				for (const Vec3d& point : points)
+				{
+					const float distance = minimal.center.distanceTo(point);
+					Assert::IsTrue(distance <= minimal.radius * 1.0001f, L"Minimal sphere misses a point");
+					boundary += distance >= minimal.radius * 0.9999f ? 1 : 0;
+				}
+
+				Assert::IsTrue(boundary >= 2, L"Minimal sphere is not supported by the points");
+			}
+
+			// Degenerate sets.
+			const Vec3d same[] = { Vec3d(1.f, 2.f, 3.f), Vec3d(1.f, 2.f, 3.f), Vec3d(1.f, 2.f, 3.f) };
+			const Sphere point = Sphere::fromPointsMinimal(same, 3);
+			Assert::IsTrue(point.center == same[0] && point.radius == 0.f, L"Single point sphere failed");
+
+			const Vec3d line[] = { Vec3d(0.f, 1.f, 0.f), Vec3d(0.f, 4.f, 0.f), Vec3d(0.f, -2.f, 0.f), Vec3d(0.f, 3.f, 0.f) };
+			const Sphere segment = Sphere::fromPointsMinimal(line, 4);
+			Assert::IsTrue(segment.center.distanceTo(Vec3d(0.f, 1.f, 0.f)) < 0.00001f, L"Collinear sphere center failed");
+			Assert::AreEqual(3.f, segment.radius, 0.00001f, L"Collinear sphere radius failed");
+
+			Assert::IsTrue(Sphere::fromPoints(nullptr, 0).isEmpty(), L"Empty point set sphere is not empty");
+		}
+
+		TEST_METHOD(OperationsSphereTest)
+		{
+			Sphere sphere;
+			Assert::IsTrue(sphere.isEmpty(), L"Default sphere is not empty");
+			Assert::IsFalse(sphere.contains(Vec3d(0.f)) || sphere.contains(Vec3d(0.5f, 0.f, 0.f)), L"Empty sphere contains a point");
+			Assert::IsFalse(sphere.intersects(Sphere()), L"Empty spheres intersect");
+			Assert::IsFalse(sphere.intersects(Sphere(Vec3d(0.5f, 0.f, 0.f), 0.1f)) || Sphere(Vec3d(0.5f, 0.f, 0.f), 0.1f).intersects(sphere), L"Empty sphere intersects a sphere");
+
+			sphere.expand(Vec3d(1.f, 0.f, 0.f));
+			Assert::IsTrue(!sphere.isEmpty() && sphere.radius == 0.f, L"First point expand failed");
+
+			sphere.expand(Vec3d(-3.f, 0.f, 0.f));
+			Assert::IsTrue(sphere.center.distanceTo(Vec3d(-1.f, 0.f, 0.f)) < 0.000001f, L"Point expand center failed");
+			Assert::AreEqual(2.f, sphere.radius, 0.000001f, L"Point expand radius failed");
+			Assert::IsTrue(sphere.contains(Vec3d(-1.f, 1.9f, 0.f)) && !sphere.contains(Vec3d(-1.f, 2.1f, 0.f)), L"Sphere contains failed");
+
+			sphere.expand(Sphere(Vec3d(-1.f, 1.f, 0.f), 0.5f));
+			Assert::AreEqual(2.f, sphere.radius, L"Expand by an inner sphere changed the sphere");
+
+			sphere.expand(Sphere(Vec3d(5.f, 0.f, 0.f), 1.f));
+			Assert::IsTrue(sphere.center.distanceTo(Vec3d(1.5f, 0.f, 0.f)) < 0.000001f, L"Sphere expand center failed");
+			Assert::AreEqual(4.5f, sphere.radius, 0.000001f, L"Sphere expand radius failed");
+
+			sphere.expand(Sphere(Vec3d(0.f), 10.f));
+			Assert::IsTrue(sphere.center == Vec3d(0.f) && sphere.radius == 10.f, L"Expand by an outer sphere failed");
+
+			Assert::IsTrue(Sphere(Vec3d(0.f), 1.f).intersects(Sphere(Vec3d(3.f, 0.f, 0.f), 2.f)), L"Touching spheres do not intersect");
+			Assert::IsFalse(Sphere(Vec3d(0.f), 1.f).intersects(Sphere(Vec3d(3.f, 0.1f, 0.f), 2.f)), L"Separate spheres intersect");
+
+			Matrix4 matrix;
+			matrix.setRotation(0.f, 0.f, 1.5707963f);
+			matrix.setTranslation(1.f, 2.f, 3.f);
+			Sphere moved(Vec3d(1.f, 0.f, 0.f), 2.f);
+			moved.transform(matrix);
+			Assert::IsTrue(moved.center.distanceTo(Vec3d(1.f, 3.f, 3.f)) < 0.00001f, L"Sphere transform center failed");
+			Assert::AreEqual(2.f, moved.radius, 0.00001f, L"Rotation changed the radius");
+
+			Matrix4 scale;
+			scale.setScale(1.f, 3.f, -2.f);
+			moved.transform(scale);
+			Assert::AreEqual(6.f, moved.radius, 0.00001f, L"Sphere transform radius failed");
+		}
+	};
+}
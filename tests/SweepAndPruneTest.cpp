@@ -0,0 +1,123 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "reMath/reSweepAndPrune.h"
+#include "reMath/reParallel.h"
+#include <cstdlib>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace re;
+
+namespace Test
+{
+	TEST_CLASS(SweepAndPruneUnitTest)
+	{
+	public:
+		TEST_METHOD(BasicSweepAndPruneTest)
+		{
+			SweepAndPrune broadPhase;
+			const unsigned int a = broadPhase.add(AABB(Vec3d(0.f, 0.f, 0.f), Vec3d(1.f, 1.f, 1.f)));
+			const unsigned int b = broadPhase.add(AABB(Vec3d(0.5f, 0.5f, 0.5f), Vec3d(2.f, 2.f, 2.f)));
+			const unsigned int c = broadPhase.add(AABB(Vec3d(5.f, 0.f, 0.f), Vec3d(6.f, 1.f, 1.f)));
+			broadPhase.update();
+
+			Assert::AreEqual(static_cast<size_t>(1), broadPhase.getAddedPairs().size(), L"Added pairs incorrect");
+			Assert::IsTrue(broadPhase.isOverlapping(b, a), L"Overlapping pair not found");
+			Assert::IsFalse(broadPhase.isOverlapping(a, c), L"Separated pair found");
+
+			// Nothing changed, nothing reported.
+			broadPhase.update();
+			Assert::IsTrue(broadPhase.getAddedPairs().empty() && broadPhase.getRemovedPairs().empty(), L"Events without changes");
+
+			// Overlap on x only is not an overlap.
+			broadPhase.setBox(c, AABB(Vec3d(1.5f, 3.f, 0.f), Vec3d(2.5f, 4.f, 1.f)));
+			broadPhase.update();
+			Assert::IsTrue(broadPhase.getAddedPairs().empty(), L"Pair overlapping on one axis added");
+
+			broadPhase.setBox(c, AABB(Vec3d(1.5f, 1.5f, 0.f), Vec3d(2.5f, 4.f, 1.f)));
+			broadPhase.update();
+			Assert::AreEqual(static_cast<size_t>(1), broadPhase.getAddedPairs().size(), L"Moved pair not added");
+			Assert::IsTrue(broadPhase.isOverlapping(b, c), L"Moved pair not found");
+
+			broadPhase.remove(b);
+			broadPhase.update();
+			Assert::AreEqual(static_cast<size_t>(2), broadPhase.getRemovedPairs().size(), L"Removed object pairs not reported");
+			Assert::AreEqual(static_cast<size_t>(0), broadPhase.getPairCount(), L"Pairs left after removal");
+			Assert::AreEqual(b, broadPhase.add(AABB(Vec3d(0.f, 0.f, 0.f), Vec3d(0.1f, 0.1f, 0.1f))), L"Removed id is not reused");
+		}
+
+		TEST_METHOD(MovingSweepAndPruneTest)
+		{
+			ThreadPool pool(4);
+			setExecutor(&pool);
+
+			for (int axisCount : { 1, 3 })
+			{
+				srand(5);
+				auto random = [](float range) { return static_cast<float>(rand()) / RAND_MAX * range; };
+
+				std::vector<Vec3d> positions(300);
+				std::vector<unsigned int> ids;
+				SweepAndPrune broadPhase(axisCount);
+				std::set<std::pair<unsigned int, unsigned int>> pairs;
+
+				auto boxAt = [](const Vec3d& position) { return AABB(position, position + Vec3d(1.f, 1.f, 1.f)); };
+
+				for (auto& position : positions)
+				{
+					position.set(random(10.f), random(10.f), random(10.f));
+					ids.push_back(broadPhase.add(boxAt(position)));
+				}
+
+				for (int frame = 0; frame < 20; frame++)
+				{
+					// Every fifth frame teleports everything and rebuilds from scratch.
+					const bool teleport = frame % 5 == 4;
+
+					for (size_t i = 0; i < positions.size(); i++)
+					{
+						if (teleport)
+							positions[i].set(random(10.f), random(10.f), random(10.f));
+						else
+							positions[i] += Vec3d(random(0.4f) - 0.2f, random(0.4f) - 0.2f, random(0.4f) - 0.2f);
+
+						broadPhase.setBox(ids[i], boxAt(positions[i]));
+					}
+
+					if (teleport)
+						broadPhase.rebuild();
+					else
+						broadPhase.update();
+
+					// Events applied to the previous set give the brute force set.
+					for (const auto& pair : broadPhase.getRemovedPairs())
+						Assert::AreEqual(static_cast<size_t>(1), pairs.erase(std::make_pair(pair.first, pair.second)), L"Removed pair was not overlapping");
+
+					for (const auto& pair : broadPhase.getAddedPairs())
+					{
+						Assert::IsTrue(pair.first < pair.second, L"Pair ids are not ordered");
+						Assert::IsTrue(pairs.insert(std::make_pair(pair.first, pair.second)).second, L"Added pair was already overlapping");
+					}
+
+					size_t expected = 0;
+
+					for (size_t i = 0; i < ids.size(); i++)
+					{
+						for (size_t j = i + 1; j < ids.size(); j++)
+						{
+							const bool overlapping = broadPhase.getBox(ids[i]).overlaps(broadPhase.getBox(ids[j]));
+							expected += overlapping ? 1 : 0;
+							Assert::AreEqual(overlapping, pairs.count(std::make_pair(ids[i], ids[j])) == 1, L"Pair set differs from brute force");
+						}
+					}
+
+					Assert::AreEqual(expected, broadPhase.getPairCount(), L"Pair count incorrect");
+				}
+			}
+
+			setExecutor(nullptr);
+		}
+	};
+}
@@ -2,6 +2,7 @@
 #include "CppUnitTest.h"
 #include "reMath/reMathUtil.h"
 #include "reMath/reMatrix4.h"
+#include <cmath>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace re;
@@ -36,6 +37,13 @@ namespace Test
 			Assert::AreEqual(static_cast <unsigned char>(10), getLowNibble(42), L"Get low nibble failed.");
 			Assert::AreEqual(static_cast <unsigned char>(15), getLowNibble(127), L"Get low nibble failed.");
 
+			// Fast reciprocal square root.
+			for (float value : { 0.0001f, 0.5f, 2.f, 3.f, 12345.f, 1e20f })
+			{
+				const float expected = 1.f / sqrt(value);
+				Assert::AreEqual(expected, rsqrtFast(value), expected * 0.0000004f, L"Fast reciprocal square root failed.");
+			}
+
 			// Perspective matrix.
 			//auto matrix = perspective(45.f, 640.f / 480.f);
 		}
@@ -43,6 +43,22 @@ namespace Test
 			v1.set(1.f, 1.f);
 			Assert::AreEqual(4.0311288741492748261833066151519f, v1.distanceTo(v2), L"Distance to vector failed");
 			Assert::AreEqual(8.6023252670426267717294735350497f, v1.distanceTo(v3), L"Distance to vector failed");
+
+			// Squared length and distance.
+			Assert::AreEqual(2.f, v1.lengthSquared(), L"Vector squared magnitude incorrect");
+			Assert::AreEqual(16.25f, v1.distanceSquaredTo(v2), L"Squared distance to vector failed");
+
+			// Fast normalize.
+			v1.set(2.f, 3.f);
+			v1.normalizeFast();
+			Assert::AreEqual(1.f, v1.length(), 0.0000005f, L"Vector fast normalization failed");
+			Assert::AreEqual(0.554700196225229122018341733457f, v1.x, 0.0000003f, L"Vector fast normalization failed");
+
+			v1.set(0.f, 1e-20f);
+			Vec2d v4(v1);
+			v1.normalizeFast();
+			v4.normalize();
+			Assert::IsTrue(v4 == v1 && v1.y > 0.9999f, L"Tiny vector fast normalization failed");
 		}
 
 		TEST_METHOD(OperatorsVec2Test)
@@ -27,6 +27,23 @@ namespace Test
 			Assert::AreEqual(4.29651f, v1.distanceTo(v2), L"Distance calculation failed", LINE_INFO());
 			Assert::AreNotEqual(4.29651f, v1.distanceTo(v3), L"Distance calculation failed", LINE_INFO());
 
+			// Squared length and distance.
+			Assert::AreEqual(29.f, v1.lengthSquared(), L"Vector squared magnitude incorrect");
+			Assert::AreEqual(18.46f, v1.distanceSquaredTo(v2), 0.00001f, L"Squared distance calculation failed");
+
+			// Fast normalize.
+			Vec3d v4(v1);
+			v4.normalizeFast();
+			Assert::AreEqual(1.f, v4.length(), 0.0000005f, L"Vector fast normalization failed");
+			Assert::AreEqual(0.3713906763541037262931524476924f, v4.x, 0.0000003f, L"Vector fast normalization failed");
+
+			// Denormal squared length takes the exact path.
+			Vec3d v5(1e-20f, 0.f, 0.f);
+			Vec3d v6(v5);
+			v5.normalizeFast();
+			v6.normalize();
+			Assert::IsTrue(v6 == v5 && v5.x > 0.9999f, L"Tiny vector fast normalization failed");
+
 			// Normalize.
 			v1.normalize();
 			Assert::AreEqual(0.3713906763541037262931524476924f, v1.x, L"Vector normalization failed", LINE_INFO());
@@ -0,0 +1,50 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "reMath/reVecExpr.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace re;
+
+namespace Test
+{
+	TEST_CLASS(VecExprUnitTest)
+	{
+	public:
+		TEST_METHOD(BasicVecExprTest)
+		{
+			// Fused linear interpolation matches the operator-based one.
+			const Vec3d a(1.f, 2.f, 3.f);
+			const Vec3d b(5.f, -2.f, 7.f);
+			const Vec3d expected(a + (b - a) * 0.25f);
+			const auto result = expr::evaluate<Vec3d>(expr::ref(a) + (expr::ref(b) - expr::ref(a)) * 0.25f);
+			Assert::IsTrue(expected == result, L"Vec3d expression evaluation failed");
+
+			const Vec2d v1(1.f, 2.f);
+			const Vec2d v2(3.f, 4.f);
+			Vec2d v3;
+			expr::assign(v3, -(expr::ref(v1) * 2.f) + expr::ref(v2));
+			Assert::IsTrue(Vec2d(1.f, 0.f) == v3, L"Vec2d expression evaluation failed");
+
+			// Dot product of unevaluated expressions.
+			Assert::AreEqual(22.f, expr::dot(expr::ref(v1) + expr::ref(v1), expr::ref(v2)), L"Expression dot product failed");
+
+			// Quaternion lerp.
+			const Quaternion q1(0.f, 0.f, 0.f, 1.f);
+			const Quaternion q2(1.f, 0.f, 0.f, 0.f);
+			const auto q3 = expr::evaluate<Quaternion>(expr::lerp(expr::ref(q1), expr::ref(q2), 0.5f));
+			Assert::IsTrue(Quaternion(0.5f, 0.f, 0.f, 0.5f) == q3, L"Quaternion expression evaluation failed");
+		}
+
+		TEST_METHOD(StreamVecExprTest)
+		{
+			// Single pass over component streams.
+			const float x0[] = { 0.f, 1.f, 2.f, 3.f, 4.f };
+			const float x1[] = { 4.f, 5.f, 6.f, 7.f, 8.f };
+			float out[5];
+			expr::assign(out, 5, expr::lerp(expr::stream(x0, 5), expr::stream(x1, 5), 0.5f));
+
+			for (int i = 0; i < 5; i++)
+				Assert::AreEqual(static_cast<float>(i) + 2.f, out[i], L"Stream expression evaluation failed");
+		}
+	};
+}